@@ -482,7 +482,12 @@ function(dsn_setup_compiler_flags)
         else()
             add_definitions(-O2)
         endif()
-        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++1y" CACHE STRING "" FORCE)
+        if(DSN_ENABLE_COROUTINES)
+            # c++20 coroutines for dsn/cpp/coroutine.h, requires gcc 10+
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++2a -fcoroutines" CACHE STRING "" FORCE)
+        else()
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++1y" CACHE STRING "" FORCE)
+        endif()
         add_compile_options(-Wall)
         add_compile_options(-Werror)
         add_compile_options(-Wno-sign-compare)
@@ -503,6 +508,12 @@ function(dsn_setup_compiler_flags)
             add_compile_options(-WX)
         endif()
     endif()
+
+    if(DSN_DISABLE_JOIN_POINTS)
+        # turn all join points into no-ops (e.g., for release builds),
+        # toollets such as profiler, tracer and fault_injector then take no effect
+        add_definitions(-DDSN_DISABLE_JOIN_POINTS)
+    endif()
 endfunction(dsn_setup_compiler_flags)
 
 macro(ms_setup_boost STATIC_LINK PACKAGES BOOST_LIBS)
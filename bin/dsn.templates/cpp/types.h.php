@@ -40,7 +40,47 @@ if ($idl_type == "thrift")
 
 <?php
 foreach ($_PROG->structs as $s){
-    Echo "    GENERATED_TYPE_SERIALIZATION(".$s->name.", ".$idl_name.")".PHP_EOL;
-} ?>
+    $has_codec = ($idl_type == "thrift");
+    foreach ($s->fields as $f)
+    {
+        if ($f->id == "") $has_codec = false;
+    }
+    if (!$has_codec)
+    {
+        Echo "    GENERATED_TYPE_SERIALIZATION(".$s->name.", ".$idl_name.")".PHP_EOL;
+        continue;
+    }
+?>
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const <?=$s->name?>& val)
+    {
+<?php foreach ($s->fields as $f) { ?>
+        writer.write_field(<?=$f->id?>, val.<?=$f->name?>);
+<?php } ?>
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ <?=$s->name?>& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+<?php foreach ($s->fields as $f) { ?>
+            case <?=$f->id?>:
+                if (reader.read_field(type, val.<?=$f->name?>)) val.__isset.<?=$f->name?> = true;
+                break;
+<?php } ?>
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(<?=$s->name?>, THRIFT_CODEC)
+
+<?php } ?>
 
 <?=$_PROG->get_cpp_namespace_end()?>
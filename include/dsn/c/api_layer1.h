@@ -142,6 +142,24 @@ with which they control the application in many aspects in a declarative approac
   ; thread pool name
   name = THREAD_POOL_INVALID
 
+  ; for partitioned pools with worker_numa_nodes, whether thread hash selects a
+  ; NUMA node first (hash % nodes) and then a worker on it, so that the state
+  ; partitioned by the hash can be kept node-local
+  numa_local_thread_hash = false
+
+  ; for partitioned pools, when > 0, thread hashes are mapped to this many buckets,
+  ; which are assigned to workers through a table rebalanced according to the
+  ; bucket load, instead of hash % worker_count; a bucket only moves when it has
+  ; no task in flight so tasks of the same hash stay in order; see command 'engine'
+  partition_bucket_count = 0
+
+  ; how often (ms) the bucket load is checked for rebalancing
+  partition_rebalance_interval_ms = 1000
+
+  ; buckets are migrated when the load of the busiest worker is above this
+  ; ratio of the average
+  partition_rebalance_imbalance_ratio = 1.25
+
   ; whethe the threads share a single queue(partitioned=false) or not;
   ; the latter is usually for workload hash partitioning for avoiding locking
   partitioned = false
@@ -149,7 +167,8 @@ with which they control the application in many aspects in a declarative approac
   ; task queue aspects names, usually for tooling purpose
   queue_aspects =
 
-  ; task queue provider name
+  ; task queue provider name, e.g., dsn::tools::deadline_task_queue orders rpc requests
+  ; by their client deadlines within each priority and drops the late ones
   queue_factory_name = dsn::tools::hpc_concurrent_task_queue
 
   ; throttling: throttling threshold above which rpc requests will be dropped
@@ -158,12 +177,41 @@ with which they control the application in many aspects in a declarative approac
   ; what CPU cores are assigned to this pool, 0 for all
   worker_affinity_mask = 0
 
+  ; what CPU cores are assigned to this pool in cpu list format (e.g., 0-15,32-47),
+  ; overriding worker_affinity_mask when not empty
+  worker_affinity_cpus =
+
+  ; how long (us) an idle worker busy-spins for new tasks before yielding, trading cpu for latency
+  worker_idle_spin_us = 0
+
+  ; how long (us) an idle worker yields its cpu for new tasks after spinning and before parking
+  worker_idle_yield_us = 0
+
   ; task aspects names, usually for tooling purpose
   worker_aspects =
 
   ; thread/worker count
   worker_count = 2
 
+  ; elastic workers for non-partitioned pools: when larger than worker_count, 
+  ; workers are added up to this count when the queueing delay is above 
+  ; worker_scale_up_delay_us, and retired down to worker_count after the 
+  ; pool is idle for worker_scale_down_idle_ms; see command 'engine'
+  worker_count_max = 0
+
+  ; elastic workers: queueing delay (us) above which one more worker is activated
+  worker_scale_up_delay_us = 2000
+
+  ; elastic workers: how long (ms) the pool must be idle before one worker is retired
+  worker_scale_down_idle_ms = 10000
+
+  ; elastic workers: how often (ms) the queueing delay is checked
+  worker_scale_interval_ms = 100
+
+  ; what NUMA nodes (e.g., 0,1) the workers are evenly bound to,
+  ; overriding worker_affinity_cpus and worker_affinity_mask when not empty
+  worker_numa_nodes =
+
   ; task worker provider name
   worker_factory_name =
 
@@ -305,7 +353,10 @@ extern DSN_API bool        dsn_task_is_running_inside(dsn_task_t t);
  To release this burden from developers, rDSN provides task tracker which can be embedded into
  a context, and destroyed when the context is gone.
 
- \param task_bucket_count number of task buckets to reduce thread conflicts
+ Tasks are registered into per-thread slots of the tracker, so that registration and 
+ deregistration from different threads do not contend with each other.
+
+ \param task_bucket_count minimum number of slot buckets, threads beyond that chain their own slots
 
  \return task tracker handle
  */
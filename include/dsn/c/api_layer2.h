@@ -95,6 +95,27 @@ send an RPC request to a local application and execute
 */
 extern DSN_API void        dsn_hosted_app_commit_rpc_request(void* app_context_for_downcalls, dsn_message_t msg, bool exec_inline);
 
+/*!
+send a batch of committed write requests to a local application
+
+when the application implements \ref dsn_app_on_batched_write_requests, the whole batch
+is given to it in one call (always inline), and it applies and replies all of them;
+otherwise each request is executed separately as with \ref dsn_hosted_app_commit_rpc_request
+
+\param app_context_for_downcalls see \ref dsn_hosted_app_create
+\param decree sequence number of this batch
+\param requests the RPC requests, in commit order
+\param count request count
+\param exec_inline whether to execute the RPC handlers within this call or not
+*/
+extern DSN_API void        dsn_hosted_app_commit_rpc_requests(
+                                void* app_context_for_downcalls,
+                                int64_t decree,
+                                dsn_message_t* requests,
+                                int count,
+                                bool exec_inline
+                                );
+
 /*@}*/
 
 # ifdef __cplusplus
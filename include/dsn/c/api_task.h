@@ -149,7 +149,9 @@ extern DSN_API const char*           dsn_task_priority_to_string(dsn_task_priori
 /*!
 apps updates the value at dsn_task_queue_virtual_length_ptr(..) to control
 the length of a vitual queue (bound to current code + hash) to
-enable customized throttling, see spec of thread pool for more information
+enable customized throttling, see spec of thread pool for more information;
+for pools with partition_bucket_count the hash may be moved to another queue,
+so the pointer should be queried again instead of cached
 */
 extern DSN_API volatile int*         dsn_task_queue_virtual_length_ptr(
                                         dsn_task_code_t code,
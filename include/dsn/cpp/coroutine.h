@@ -0,0 +1,462 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     c++ coroutine (co_await) support for tasks, rpc calls and file io,
+ *     available when the compiler supports c++20 coroutines
+ *     (e.g., -std=c++2a -fcoroutines, see DSN_ENABLE_COROUTINES in dsn.cmake)
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# pragma once
+
+# include <dsn/cpp/clientlet.h>
+
+# if defined(__cpp_impl_coroutine) && defined(__has_include)
+# if __has_include(<coroutine>)
+# define DSN_HAS_COROUTINE 1
+# endif
+# endif
+
+# ifdef DSN_HAS_COROUTINE
+
+# include <coroutine>
+# include <exception>
+# include <optional>
+
+namespace dsn
+{
+    /*!
+    @addtogroup tasking
+    @{
+    */
+
+    //
+    // co_task<T> is the return type of coroutines using the awaitables below, e.g.,
+    //
+    //    co_task<int> get_value(rpc_address server)
+    //    {
+    //        auto r = co_await rpc::call_async<int>(server, RPC_GET_VALUE, 1);
+    //        co_return r.first == ERR_OK ? r.second : 0;
+    //    }
+    //
+    // a co_task is lazily started, either by being co_await-ed by another coroutine,
+    // or by start() for the outermost one whose frame is freed on completion.
+    //
+    // the awaitables resume the coroutine in the task of the given task code (or the
+    // rpc response task in the thread pool invoking the rpc), just as the callbacks
+    // of tasking::enqueue, rpc::call and file::read do, without allocating the
+    // callback objects; coroutine frames are allocated from the transient memory,
+    // aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__ (over-aligned locals are not supported).
+    //
+    // note the awaited tasks are not bound to any task tracker, as a cancelled
+    // task would never resume the coroutine.
+    //
+    template<typename T = void> class co_task;
+
+    namespace coroutine_detail
+    {
+        struct promise_base
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr      exception;
+            bool                    detached = false;
+
+            // called on each frame allocation and free when set, for tests only
+            typedef void (*frame_hook)(void* frame, size_t size, bool allocated);
+            static inline frame_hook frame_hook_for_test = nullptr;
+
+            // transient memory is not aligned, so the request is padded to align the frame
+            // and the distance back to the transient block is kept in the byte before it
+            static constexpr size_t frame_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+            static void* operator new(size_t size)
+            {
+                auto block = static_cast<char*>(dsn_transient_malloc(static_cast<uint32_t>(size + frame_alignment)));
+                auto frame = reinterpret_cast<char*>(
+                    (reinterpret_cast<uintptr_t>(block) + frame_alignment) & ~static_cast<uintptr_t>(frame_alignment - 1));
+                frame[-1] = static_cast<char>(frame - block);
+
+                if (frame_hook_for_test)
+                    frame_hook_for_test(frame, size, true);
+                return frame;
+            }
+
+            static void operator delete(void* ptr, size_t size)
+            {
+                if (frame_hook_for_test)
+                    frame_hook_for_test(ptr, size, false);
+
+                auto frame = static_cast<char*>(ptr);
+                dsn_transient_free(frame - static_cast<unsigned char>(frame[-1]));
+            }
+
+            struct final_awaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename TPromise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> h) noexcept
+                {
+                    auto& p = h.promise();
+                    if (p.continuation)
+                        return p.continuation;
+
+                    if (p.detached)
+                    {
+                        dassert(!p.exception, "unhandled exception in a started co_task");
+                        h.destroy();
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            final_awaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+            void rethrow_if_failed()
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+
+        template<typename T>
+        struct promise : promise_base
+        {
+            std::optional<T> value;
+
+            co_task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+            T result()
+            {
+                rethrow_if_failed();
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct promise<void> : promise_base
+        {
+            co_task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void result() { rethrow_if_failed(); }
+        };
+    }
+
+    template<typename T>
+    class co_task
+    {
+    public:
+        using promise_type = coroutine_detail::promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        explicit co_task(handle_type h) : _h(h) {}
+        co_task(co_task&& other) noexcept : _h(other._h) { other._h = nullptr; }
+        co_task(const co_task&) = delete;
+        co_task& operator=(const co_task&) = delete;
+        ~co_task()
+        {
+            if (_h)
+                _h.destroy();
+        }
+
+        // run the coroutine in the current thread until its first suspension,
+        // and free its frame on completion
+        void start()
+        {
+            dassert(_h, "co_task has already been started or awaited");
+            auto h = _h;
+            _h = nullptr;
+            h.promise().detached = true;
+            h.resume();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct awaiter
+            {
+                handle_type h;
+
+                bool await_ready() const noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+                {
+                    h.promise().continuation = continuation;
+                    return h;
+                }
+
+                T await_resume() { return h.promise().result(); }
+            };
+            return awaiter{ _h };
+        }
+
+    private:
+        handle_type _h;
+    };
+
+    namespace coroutine_detail
+    {
+        template<typename T>
+        inline co_task<T> promise<T>::get_return_object() noexcept
+        {
+            return co_task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+        }
+
+        inline co_task<void> promise<void>::get_return_object() noexcept
+        {
+            return co_task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+        }
+    }
+
+    namespace tasking
+    {
+        class sleep_awaiter
+        {
+        public:
+            sleep_awaiter(dsn_task_code_t code, std::chrono::milliseconds delay, int hash)
+                : _code(code), _delay(delay), _hash(hash)
+            {
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                dsn_task_t t = dsn_task_create(_code, &sleep_awaiter::exec, h.address(), _hash);
+                dsn_task_call(t, static_cast<int>(_delay.count()));
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            static void exec(void* context)
+            {
+                std::coroutine_handle<>::from_address(context).resume();
+            }
+
+        private:
+            dsn_task_code_t           _code;
+            std::chrono::milliseconds _delay;
+            int                       _hash;
+        };
+
+        // resume the coroutine after the delay in the thread pool of the task code
+        inline sleep_awaiter sleep(
+            dsn_task_code_t code,
+            std::chrono::milliseconds delay,
+            int hash = 0)
+        {
+            return sleep_awaiter(code, delay, hash);
+        }
+
+        // resume the coroutine in the thread pool of the task code
+        inline sleep_awaiter switch_to(dsn_task_code_t code, int hash = 0)
+        {
+            return sleep_awaiter(code, std::chrono::milliseconds(0), hash);
+        }
+    }
+    /*@}*/
+
+    /*!
+    @addtogroup rpc-client
+    @{
+    */
+    namespace rpc
+    {
+        //
+        // TResponse is dsn_message_t for the raw response message, which is add_ref-ed
+        // and must be released using dsn_msg_release_ref when not null
+        //
+        template<typename TResponse>
+        class call_awaiter
+        {
+        public:
+            call_awaiter(::dsn::rpc_address server, dsn_message_t request, int reply_thread_hash)
+                : _server(server), _request(request), _reply_thread_hash(reply_thread_hash)
+            {
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                _h = h;
+                dsn_task_t t = dsn_rpc_create_response_task_ex(
+                    _request,
+                    &call_awaiter::exec_rpc_response,
+                    nullptr,
+                    this,
+                    _reply_thread_hash
+                    );
+                dsn_rpc_call(_server.c_addr(), t);
+            }
+
+            std::pair< ::dsn::error_code, TResponse> await_resume() { return std::move(_result); }
+
+        private:
+            static void exec_rpc_response(dsn_error_t err, dsn_message_t req, dsn_message_t resp, void* context)
+            {
+                auto awaiter = static_cast<call_awaiter*>(context);
+                awaiter->_result.first = err;
+                if (err == ERR_OK)
+                {
+                    if constexpr (std::is_same<TResponse, dsn_message_t>::value)
+                    {
+                        dsn_msg_add_ref(resp);
+                        awaiter->_result.second = resp;
+                    }
+                    else
+                    {
+                        ::dsn::unmarshall(resp, awaiter->_result.second);
+                    }
+                }
+                awaiter->_h.resume();
+            }
+
+        private:
+            ::dsn::rpc_address                        _server;
+            dsn_message_t                             _request;
+            int                                       _reply_thread_hash;
+            std::coroutine_handle<>                   _h;
+            std::pair< ::dsn::error_code, TResponse>  _result{ ERR_OK, TResponse() };
+        };
+
+        inline call_awaiter<dsn_message_t> call_async(
+            ::dsn::rpc_address server,
+            dsn_message_t request,
+            int reply_thread_hash = 0
+            )
+        {
+            return call_awaiter<dsn_message_t>(server, request, reply_thread_hash);
+        }
+
+        template<typename TResponse, typename TRequest>
+        call_awaiter<TResponse> call_async(
+            ::dsn::rpc_address server,
+            dsn_task_code_t code,
+            TRequest&& req,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+            int thread_hash = 0, ///< if thread_hash == 0 && partition_hash != 0, thread_hash is computed from partition_hash
+            uint64_t partition_hash = 0,
+            int reply_thread_hash = 0
+            )
+        {
+            dsn_message_t msg = dsn_msg_create_request(code, static_cast<int>(timeout.count()), thread_hash, partition_hash);
+            ::dsn::marshall(msg, std::forward<TRequest>(req));
+            return call_awaiter<TResponse>(server, msg, reply_thread_hash);
+        }
+    }
+    /*@}*/
+
+    /*!
+    @addtogroup file
+    @{
+    */
+    namespace file
+    {
+        class aio_awaiter
+        {
+        public:
+            aio_awaiter(bool is_read, dsn_handle_t hFile, const char* buffer, int count, uint64_t offset,
+                dsn_task_code_t callback_code, int hash)
+                : _is_read(is_read), _file(hFile), _buffer(buffer), _count(count), _offset(offset),
+                _callback_code(callback_code), _hash(hash)
+            {
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                _h = h;
+                dsn_task_t t = dsn_file_create_aio_task(_callback_code, &aio_awaiter::exec_aio, this, _hash);
+                if (_is_read)
+                    dsn_file_read(_file, const_cast<char*>(_buffer), _count, _offset, t);
+                else
+                    dsn_file_write(_file, _buffer, _count, _offset, t);
+            }
+
+            std::pair< ::dsn::error_code, size_t> await_resume() const noexcept { return _result; }
+
+        private:
+            static void exec_aio(dsn_error_t err, size_t sz, void* context)
+            {
+                auto awaiter = static_cast<aio_awaiter*>(context);
+                awaiter->_result.first = err;
+                awaiter->_result.second = sz;
+                awaiter->_h.resume();
+            }
+
+        private:
+            bool                                   _is_read;
+            dsn_handle_t                           _file;
+            const char*                            _buffer;
+            int                                    _count;
+            uint64_t                               _offset;
+            dsn_task_code_t                        _callback_code;
+            int                                    _hash;
+            std::coroutine_handle<>                _h;
+            std::pair< ::dsn::error_code, size_t>  _result{ ERR_OK, 0 };
+        };
+
+        inline aio_awaiter read_async(
+            dsn_handle_t hFile,
+            char* buffer,
+            int count,
+            uint64_t offset,
+            dsn_task_code_t callback_code,
+            int hash = 0)
+        {
+            return aio_awaiter(true, hFile, buffer, count, offset, callback_code, hash);
+        }
+
+        inline aio_awaiter write_async(
+            dsn_handle_t hFile,
+            const char* buffer,
+            int count,
+            uint64_t offset,
+            dsn_task_code_t callback_code,
+            int hash = 0)
+        {
+            return aio_awaiter(false, hFile, buffer, count, offset, callback_code, hash);
+        }
+    }
+    /*@}*/
+}
+
+# endif // DSN_HAS_COROUTINE
@@ -60,6 +60,15 @@ namespace dsn
         layer2_handler(dsn_gpid gpid) : service_app(gpid) {}
         virtual void on_request(dsn_gpid gpid, bool is_write, dsn_message_t msg) = 0;
 
+    protected:
+        // apply a committed batch of write requests to a hosted app, in one call
+        // when the app handles batches itself (see replicated_service_app_type_1)
+        static void commit_requests(void* app_context_for_downcalls, int64_t decree,
+            dsn_message_t* requests, int count, bool exec_inline = true)
+        {
+            dsn_hosted_app_commit_rpc_requests(app_context_for_downcalls, decree, requests, count, exec_inline);
+        }
+
     public:
         static void on_layer2_rpc_request(void* app, dsn_gpid gpid, bool is_write, dsn_message_t msg)
         {
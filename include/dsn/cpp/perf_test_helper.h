@@ -62,6 +62,14 @@ namespace dsn {
             std::vector<int> perf_test_payload_bytes;
             std::vector<int> perf_test_timeouts_ms;
             std::vector<int> perf_test_hybrid_request_ratio; // e.g., 1,1,1
+
+            // perf_test_rates_qps:
+            //   - if not empty, the cases are open-loop, issuing requests on the
+            //     schedule of each target qps (constant or poisson arrivals) instead
+            //     of keeping perf_test_concurrency requests in flight
+            std::vector<int> perf_test_rates_qps;
+            std::string      perf_test_arrival;
+            int              perf_test_knee_latency_factor;
         };
 
         CONFIG_BEGIN(perf_test_opts)
@@ -71,7 +79,136 @@ namespace dsn {
             CONFIG_FLD_INT_LIST(perf_test_payload_bytes, "size list: byte size of each rpc request test")
             CONFIG_FLD_INT_LIST(perf_test_timeouts_ms, "timeout list: timeout (ms) for each rpc call")
             CONFIG_FLD_INT_LIST(perf_test_hybrid_request_ratio, "hybrid request ratio, e.g., 1,2,1 - the numbers are ordered by the task code appeared in task code registration")
+            CONFIG_FLD_INT_LIST(perf_test_rates_qps, "open-loop target qps list, e.g., 1000,2000,4000; empty for the closed-loop perf_test_concurrency cases")
+            CONFIG_FLD_STRING(perf_test_arrival, "constant", "inter-arrival times of open-loop requests: constant or poisson")
+            CONFIG_FLD(int, uint64, perf_test_knee_latency_factor, 10, "an open-loop rate is saturated when its p99 latency exceeds the one of the lowest rate by this factor")
         CONFIG_END
+
+        //
+        // log-linear latency histogram: values below 64 are exact, larger ones
+        // fall into 32 sub-buckets per power of two (~3% error); the bucket
+        // layout is fixed, so histograms of different cases, clients or runs
+        // are merged by adding up the bucket counts
+        //
+        class latency_histogram
+        {
+        public:
+            enum
+            {
+                SUB_BUCKET_BITS = 5,
+                SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,
+                LINEAR_COUNT = 2 * SUB_BUCKET_COUNT,
+                BUCKET_COUNT = LINEAR_COUNT + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT
+            };
+
+            latency_histogram() { clear(); }
+            latency_histogram(const latency_histogram& r) { *this = r; }
+
+            latency_histogram& operator = (const latency_histogram& r)
+            {
+                for (int i = 0; i < BUCKET_COUNT; i++)
+                    _counts[i].store(r._counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                _total.store(r._total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return *this;
+            }
+
+            void clear()
+            {
+                for (auto& c : _counts)
+                    c.store(0, std::memory_order_relaxed);
+                _total.store(0, std::memory_order_relaxed);
+            }
+
+            void record(uint64_t value, uint64_t count = 1)
+            {
+                _counts[bucket_of(value)].fetch_add(count, std::memory_order_relaxed);
+                _total.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            void merge(const latency_histogram& r)
+            {
+                for (int i = 0; i < BUCKET_COUNT; i++)
+                {
+                    auto c = r._counts[i].load(std::memory_order_relaxed);
+                    if (c > 0)
+                        _counts[i].fetch_add(c, std::memory_order_relaxed);
+                }
+                _total.fetch_add(r._total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+
+            uint64_t count() const { return _total.load(std::memory_order_relaxed); }
+            uint64_t bucket_count(int bucket) const { return _counts[bucket].load(std::memory_order_relaxed); }
+
+            // the upper bound of the bucket holding the p-th (0.0 ~ 1.0) value,
+            // or 0 when the histogram is empty
+            uint64_t percentile(double p) const
+            {
+                uint64_t total = count();
+                if (total == 0)
+                    return 0;
+
+                uint64_t rank = (uint64_t)(p * (double)total + 0.5);
+                if (rank == 0)
+                    rank = 1;
+                if (rank > total)
+                    rank = total;
+
+                uint64_t seen = 0;
+                for (int i = 0; i < BUCKET_COUNT; i++)
+                {
+                    seen += bucket_count(i);
+                    if (seen >= rank)
+                        return bucket_upper_bound(i);
+                }
+                return bucket_upper_bound(BUCKET_COUNT - 1);
+            }
+
+            static int bucket_of(uint64_t value)
+            {
+                if (value < LINEAR_COUNT)
+                    return (int)value;
+
+                int shift = highest_bit(value) - SUB_BUCKET_BITS;
+                int sub = (int)(value >> shift) - SUB_BUCKET_COUNT;
+                return LINEAR_COUNT + (shift - 1) * SUB_BUCKET_COUNT + sub;
+            }
+
+            static uint64_t bucket_lower_bound(int bucket)
+            {
+                if (bucket < LINEAR_COUNT)
+                    return (uint64_t)bucket;
+
+                int shift = (bucket - LINEAR_COUNT) / SUB_BUCKET_COUNT + 1;
+                uint64_t top = (uint64_t)((bucket - LINEAR_COUNT) % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT);
+                return top << shift;
+            }
+
+            static uint64_t bucket_upper_bound(int bucket)
+            {
+                if (bucket < LINEAR_COUNT)
+                    return (uint64_t)bucket;
+
+                int shift = (bucket - LINEAR_COUNT) / SUB_BUCKET_COUNT + 1;
+                return bucket_lower_bound(bucket) + ((1ULL << shift) - 1);
+            }
+
+        private:
+            static int highest_bit(uint64_t v)
+            {
+                int r = 0;
+                if (v >> 32) { v >>= 32; r += 32; }
+                if (v >> 16) { v >>= 16; r += 16; }
+                if (v >> 8) { v >>= 8; r += 8; }
+                if (v >> 4) { v >>= 4; r += 4; }
+                if (v >> 2) { v >>= 2; r += 2; }
+                if (v >> 1) { r += 1; }
+                return r;
+            }
+
+        private:
+            std::atomic<uint64_t> _counts[BUCKET_COUNT];
+            std::atomic<uint64_t> _total;
+        };
         
         class perf_client_helper
         {
@@ -85,6 +222,10 @@ namespace dsn {
             void end_send_one(void* context, error_code err);
 
             virtual void send_one(int payload_bytes, int key_space_size, const std::vector<double>& ratios) = 0;
+
+            // called before the first request of each case, e.g., to prepare
+            // the keys and values of the case from its config section
+            virtual void on_case_start(const char* config_section, int payload_bytes, int key_space_size) {}
             
         private:
 
@@ -96,6 +237,8 @@ namespace dsn {
                 int  key_space_size;
                 int  concurrency;
                 int  timeout_ms;
+                int  rate_qps; // > 0 for open-loop cases
+                bool poisson_arrival;
                 std::vector<double> ratios;
 
                 // statistics 
@@ -109,6 +252,11 @@ namespace dsn {
                 double succ_qps;
                 double succ_throughput_MB_s;
 
+                // latency of successful requests, measured from the intended
+                // send time in open-loop cases so that the time a request waits
+                // behind a slow one is not omitted
+                latency_histogram succ_latency;
+
                 perf_test_case& operator = (const perf_test_case& r)
                 {
                     id = r.id;
@@ -117,6 +265,8 @@ namespace dsn {
                     key_space_size = r.key_space_size;
                     timeout_ms = r.timeout_ms;
                     concurrency = r.concurrency;
+                    rate_qps = r.rate_qps;
+                    poisson_arrival = r.poisson_arrival;
                     ratios = r.ratios;
 
                     timeout_rounds.store(r.timeout_rounds.load());
@@ -129,6 +279,7 @@ namespace dsn {
                     succ_latency_avg_ns = r.succ_latency_avg_ns;
                     succ_qps = r.succ_qps;
                     succ_throughput_MB_s = r.succ_throughput_MB_s;
+                    succ_latency = r.succ_latency;
 
                     return *this;
                 }
@@ -139,7 +290,7 @@ namespace dsn {
                 }
 
                 perf_test_case() : id(0), seconds(0), payload_bytes(0), key_space_size(1000),
-                    concurrency(0), timeout_ms(0), timeout_rounds(0), error_rounds(0), succ_rounds(0),
+                    concurrency(0), timeout_ms(0), rate_qps(0), poisson_arrival(false), timeout_rounds(0), error_rounds(0), succ_rounds(0),
                     succ_latency_avg_ns(0), succ_qps(0), succ_throughput_MB_s(0)
                 {}
             };
@@ -148,6 +299,7 @@ namespace dsn {
             {
                 const char* name;
                 const char* config_section;
+                int knee_latency_factor;
                 std::vector<perf_test_case> cases;
             };
 
@@ -160,6 +312,27 @@ namespace dsn {
 
             void start_next_case();
 
+            // issue the open-loop requests which are due
+            void on_open_loop_tick();
+
+            std::string case_to_string(const char* name, const perf_test_case& cs) const;
+
+            // the saturation knee of each open-loop rate sweep: the highest rate
+            // sustained before the first saturated one (0 for none)
+            struct open_loop_knee
+            {
+                int payload_bytes;
+                int timeout_ms;
+                int knee_qps;
+                int saturated_qps;
+            };
+
+            void find_knees(const perf_test_suite& s, std::vector<open_loop_knee>& knees) const;
+
+            std::string knees_to_string(const perf_test_suite& s) const;
+
+            std::string to_json(uint64_t ts) const;
+
         private:
             perf_client_helper(const perf_client_helper&) = delete;
             
@@ -176,6 +349,11 @@ namespace dsn {
             uint64_t         _case_start_ts_ns;
             uint64_t         _case_end_ts_ns;
 
+            // open-loop cases, only touched by the pacer timer
+            task_ptr         _pacer;
+            uint64_t         _next_send_ts_ns;
+            uint64_t         _intended_send_ts_ns;
+
             std::vector<perf_test_suite> _suits;
             int                         _current_suit_index;
             int                         _current_case_index;
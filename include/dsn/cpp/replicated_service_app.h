@@ -55,6 +55,11 @@ namespace dsn
         // for stateful apps with layer 2 support
         //
 
+        //
+        // apply and reply a committed batch of write requests at once (see
+        // dsn_hosted_app_commit_rpc_requests), instead of having them dispatched
+        // one by one to the rpc handlers; the requests are still owned by the caller
+        //
         virtual void on_batched_write_requests(int64_t decree, dsn_message_t* requests, int count) { }
 
         virtual int get_physical_error() { return 0; }
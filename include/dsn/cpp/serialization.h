@@ -42,6 +42,7 @@
 
 #ifdef DSN_USE_THRIFT_SERIALIZATION
 # include <dsn/cpp/serialization_helper/thrift_helper.h>
+# include <dsn/cpp/serialization_helper/thrift_binary_codec.h>
 #endif
 
 #ifdef DSN_USE_PROTOBUF_SERIALIZATION
@@ -75,6 +76,16 @@ namespace dsn
         case DSF_THRIFT_BINARY: unmarshall_thrift_binary(reader, value); break; \
         case DSF_THRIFT_JSON: unmarshall_thrift_json(reader, value); break;
 
+// same wire format as THRIFT, but the binary format is done by thrift_binary_codec
+// with the thrift_binary_write/read functions generated for the type
+#define THRIFT_CODEC_MARSHALLER \
+        case DSF_THRIFT_BINARY: marshall_thrift_binary_codec(writer, value); break; \
+        case DSF_THRIFT_JSON: marshall_thrift_json(writer, value); break;
+
+#define THRIFT_CODEC_UNMARSHALLER \
+        case DSF_THRIFT_BINARY: unmarshall_thrift_binary_codec(reader, value); break; \
+        case DSF_THRIFT_JSON: unmarshall_thrift_json(reader, value); break;
+
     //the following 2 functions is for thrift basic type serialization
     template<typename T>
     inline void marshall(binary_writer& writer, const T &value, dsn_msg_serialize_format fmt)
@@ -98,6 +109,8 @@ namespace dsn
 #else
 #define THRIFT_MARSHALLER {}
 #define THRIFT_UNMARSHALLER {}
+#define THRIFT_CODEC_MARSHALLER {}
+#define THRIFT_CODEC_UNMARSHALLER {}
 #endif
 
 #ifdef DSN_USE_PROTOBUF_SERIALIZATION
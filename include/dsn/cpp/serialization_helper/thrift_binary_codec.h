@@ -0,0 +1,821 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     non-virtual thrift binary protocol codec for the generated types
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# pragma once
+
+# include <dsn/cpp/serialization_helper/thrift_helper.h>
+# include <map>
+# include <set>
+# include <vector>
+# include <type_traits>
+
+namespace dsn {
+
+    class thrift_binary_writer;
+    class thrift_binary_reader;
+
+    //
+    // thrift type tag written in the field/container headers, T_STRUCT is the
+    // default as all the rDSN builtin types (blob, rpc_address, ...) are declared
+    // as structs in the idl while they are encoded specially in the binary protocol
+    //
+    template<typename T, typename TEnable = void>
+    struct thrift_binary_type
+    {
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::T_STRUCT;
+    };
+
+    template<typename T>
+    struct thrift_binary_type<T, typename std::enable_if<std::is_enum<T>::value>::type>
+    {
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::T_I32;
+    };
+
+# define DEFINE_THRIFT_BINARY_TYPE(cpp_type, thrift_type) \
+    template<> struct thrift_binary_type<cpp_type> \
+    { \
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::thrift_type; \
+    };
+
+    DEFINE_THRIFT_BINARY_TYPE(bool, T_BOOL)
+    DEFINE_THRIFT_BINARY_TYPE(int8_t, T_BYTE)
+    DEFINE_THRIFT_BINARY_TYPE(uint8_t, T_BYTE)
+    DEFINE_THRIFT_BINARY_TYPE(int16_t, T_I16)
+    DEFINE_THRIFT_BINARY_TYPE(uint16_t, T_I16)
+    DEFINE_THRIFT_BINARY_TYPE(int32_t, T_I32)
+    DEFINE_THRIFT_BINARY_TYPE(uint32_t, T_I32)
+    DEFINE_THRIFT_BINARY_TYPE(int64_t, T_I64)
+    DEFINE_THRIFT_BINARY_TYPE(uint64_t, T_I64)
+    DEFINE_THRIFT_BINARY_TYPE(double, T_DOUBLE)
+    DEFINE_THRIFT_BINARY_TYPE(std::string, T_STRING)
+
+    template<typename T>
+    struct thrift_binary_type<std::vector<T>>
+    {
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::T_LIST;
+    };
+
+    template<typename T>
+    struct thrift_binary_type<std::set<T>>
+    {
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::T_SET;
+    };
+
+    template<typename TKey, typename TValue>
+    struct thrift_binary_type<std::map<TKey, TValue>>
+    {
+        static const ::apache::thrift::protocol::TType value = ::apache::thrift::protocol::T_MAP;
+    };
+
+    namespace thrift_binary_detail
+    {
+        // whether thrift_binary_write/read is provided for T, either below for the
+        // base types or by the code generator for a struct (found through ADL)
+        template<typename T>
+        auto check_codec(T*) -> decltype(
+            thrift_binary_write(std::declval<thrift_binary_writer&>(), std::declval<const T&>()),
+            thrift_binary_read(std::declval<thrift_binary_reader&>(), std::declval<T&>()),
+            std::true_type());
+
+        template<typename>
+        std::false_type check_codec(...);
+
+        template<typename T>
+        struct has_codec : decltype(check_codec<T>(nullptr)) {};
+    }
+
+    //
+    // thrift_binary_writer emits the thrift binary protocol (strict, big-endian)
+    // straight into the buffers of the underlying binary_writer; for a
+    // rpc_write_stream the window is got by binary_writer::next, i.e., it is
+    // the message buffer allocated by dsn_msg_write_next, and the unused tail
+    // is given back on flush so that the stream commits only what is written
+    //
+    class thrift_binary_writer
+    {
+    public:
+        explicit thrift_binary_writer(binary_writer& writer)
+            : _writer(writer), _ptr(nullptr), _end(nullptr)
+        {
+        }
+
+        ~thrift_binary_writer() { flush(); }
+
+        binary_writer& underlying_writer() { return _writer; }
+
+        void flush()
+        {
+            if (_ptr != _end)
+            {
+                _writer.backup(static_cast<int>(_end - _ptr));
+            }
+            _ptr = _end = nullptr;
+        }
+
+        void write_bytes(const char* data, int sz)
+        {
+            if (_end - _ptr < sz && !acquire(sz))
+            {
+                // not enough space left in the current buffer,
+                // let the underlying writer handle the buffer boundary
+                _writer.write(data, sz);
+                return;
+            }
+            memcpy(_ptr, data, (size_t)sz);
+            _ptr += sz;
+        }
+
+        void write_byte(int8_t val)
+        {
+            char b = static_cast<char>(val);
+            write_bytes(&b, 1);
+        }
+
+        void write_bool(bool val) { write_byte(val ? 1 : 0); }
+
+        void write_i16(int16_t val)
+        {
+            uint16_t u = static_cast<uint16_t>(val);
+            char b[2] = { static_cast<char>(u >> 8), static_cast<char>(u) };
+            write_bytes(b, 2);
+        }
+
+        void write_i32(int32_t val)
+        {
+            uint32_t u = static_cast<uint32_t>(val);
+            char b[4] = {
+                static_cast<char>(u >> 24), static_cast<char>(u >> 16),
+                static_cast<char>(u >> 8), static_cast<char>(u)
+            };
+            write_bytes(b, 4);
+        }
+
+        void write_i64(int64_t val)
+        {
+            uint64_t u = static_cast<uint64_t>(val);
+            char b[8] = {
+                static_cast<char>(u >> 56), static_cast<char>(u >> 48),
+                static_cast<char>(u >> 40), static_cast<char>(u >> 32),
+                static_cast<char>(u >> 24), static_cast<char>(u >> 16),
+                static_cast<char>(u >> 8), static_cast<char>(u)
+            };
+            write_bytes(b, 8);
+        }
+
+        void write_double(double val)
+        {
+            static_assert(sizeof(double) == sizeof(int64_t), "double must be 64 bits");
+            int64_t bits;
+            memcpy(&bits, &val, sizeof(bits));
+            write_i64(bits);
+        }
+
+        void write_string(const char* data, int len)
+        {
+            write_i32(len);
+            if (len > 0) write_bytes(data, len);
+        }
+
+        void write_field_begin(::apache::thrift::protocol::TType type, int16_t id)
+        {
+            char b[3] = {
+                static_cast<char>(type),
+                static_cast<char>(static_cast<uint16_t>(id) >> 8),
+                static_cast<char>(id)
+            };
+            write_bytes(b, 3);
+        }
+
+        void write_field_stop() { write_byte(::apache::thrift::protocol::T_STOP); }
+
+        void write_list_begin(::apache::thrift::protocol::TType elem_type, uint32_t size)
+        {
+            write_byte(static_cast<int8_t>(elem_type));
+            write_i32(static_cast<int32_t>(size));
+        }
+
+        void write_set_begin(::apache::thrift::protocol::TType elem_type, uint32_t size)
+        {
+            write_list_begin(elem_type, size);
+        }
+
+        void write_map_begin(::apache::thrift::protocol::TType key_type, ::apache::thrift::protocol::TType value_type, uint32_t size)
+        {
+            write_byte(static_cast<int8_t>(key_type));
+            write_byte(static_cast<int8_t>(value_type));
+            write_i32(static_cast<int32_t>(size));
+        }
+
+        template<typename T>
+        void write_value(const T& val)
+        {
+            write_value_internal(val, thrift_binary_detail::has_codec<T>());
+        }
+
+        template<typename T>
+        void write_field(int16_t id, const T& val)
+        {
+            write_field_begin(thrift_binary_type<T>::value, id);
+            write_value(val);
+        }
+
+    private:
+        bool acquire(int sz)
+        {
+            flush();
+
+            void* data;
+            int size;
+            _writer.next(&data, &size);
+            _ptr = static_cast<char*>(data);
+            _end = _ptr + size;
+            if (size >= sz)
+                return true;
+
+            flush();
+            return false;
+        }
+
+        template<typename T>
+        void write_value_internal(const T& val, std::true_type)
+        {
+            thrift_binary_write(*this, val);
+        }
+
+        // types without a generated codec go through the virtual protocol
+        template<typename T>
+        void write_value_internal(const T& val, std::false_type)
+        {
+            flush();
+            ::dsn::binary_writer_transport trans(_writer);
+            boost::shared_ptr< ::dsn::binary_writer_transport> transport(&trans, [](::dsn::binary_writer_transport*) {});
+            ::apache::thrift::protocol::TBinaryProtocol proto(transport);
+            marshall_base(&proto, val);
+        }
+
+    private:
+        binary_writer& _writer;
+        char*          _ptr;
+        char*          _end;
+    };
+
+    //
+    // thrift_binary_reader decodes the thrift binary protocol directly from the
+    // remaining buffer of the underlying binary_reader; binary fields (blob) are
+    // returned as views into the received buffer instead of copies, and when
+    // the buffer is owned by a rpc message the view holds a reference on that
+    // message so that it is safe to keep it after the message is handled
+    //
+    class thrift_binary_reader
+    {
+    public:
+        explicit thrift_binary_reader(binary_reader& reader)
+            : _reader(reader), _msg(nullptr)
+        {
+            auto stream = dynamic_cast<rpc_read_stream*>(&reader);
+            if (stream != nullptr)
+                _msg = stream->native_handle();
+            reset();
+        }
+
+        ~thrift_binary_reader() { sync(); }
+
+        binary_reader& underlying_reader() { return _reader; }
+
+        // advance the underlying reader to the current read position
+        void sync()
+        {
+            int consumed = static_cast<int>(_ptr - _start);
+            if (consumed > 0)
+            {
+                _reader.skip(consumed);
+            }
+            reset();
+        }
+
+        const char* read_bytes(int sz)
+        {
+            if (sz < 0 || _end - _ptr < sz)
+            {
+                dassert(false, "read beyond the end of buffer, size = %d, remaining = %d",
+                    sz, static_cast<int>(_end - _ptr));
+                return nullptr;
+            }
+            const char* p = _ptr;
+            _ptr += sz;
+            return p;
+        }
+
+        int8_t read_byte()
+        {
+            const char* p = read_bytes(1);
+            return p ? static_cast<int8_t>(p[0]) : 0;
+        }
+
+        bool read_bool() { return read_byte() != 0; }
+
+        int16_t read_i16()
+        {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(read_bytes(2));
+            if (p == nullptr) return 0;
+            return static_cast<int16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+        }
+
+        int32_t read_i32()
+        {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(read_bytes(4));
+            if (p == nullptr) return 0;
+            return static_cast<int32_t>(
+                (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+                | (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]));
+        }
+
+        int64_t read_i64()
+        {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(read_bytes(8));
+            if (p == nullptr) return 0;
+            uint64_t u = 0;
+            for (int i = 0; i < 8; i++)
+                u = (u << 8) | p[i];
+            return static_cast<int64_t>(u);
+        }
+
+        double read_double()
+        {
+            int64_t bits = read_i64();
+            double val;
+            memcpy(&val, &bits, sizeof(val));
+            return val;
+        }
+
+        void read_string(/*out*/ std::string& val)
+        {
+            int32_t len = read_i32();
+            const char* p = read_bytes(len);
+            if (p != nullptr)
+                val.assign(p, (size_t)len);
+            else
+                val.clear();
+        }
+
+        // zero-copy, see the class comment
+        void read_binary(/*out*/ blob& val)
+        {
+            int32_t len = read_i32();
+            const char* p = read_bytes(len);
+            if (p == nullptr)
+            {
+                val = blob();
+                return;
+            }
+
+            int offset = static_cast<int>(p - _buffer.data());
+            if (_buffer.has_holder())
+            {
+                val = _buffer.range(offset, len);
+            }
+            else if (_msg != nullptr)
+            {
+                if (!_pinned.has_holder())
+                {
+                    dsn_message_t msg = _msg;
+                    dsn_msg_add_ref(msg);
+                    std::shared_ptr<char> holder(
+                        const_cast<char*>(_buffer.data()),
+                        [msg](char*) { dsn_msg_release_ref(msg); }
+                        );
+                    _pinned.assign(std::move(holder), 0, _buffer.length());
+                }
+                val = _pinned.range(offset, len);
+            }
+            else
+            {
+                std::shared_ptr<char> buffer(::dsn::make_shared_array<char>(len));
+                memcpy(buffer.get(), p, (size_t)len);
+                val.assign(std::move(buffer), 0, len);
+            }
+        }
+
+        // return false when the field stop is met
+        bool read_field_begin(/*out*/ ::apache::thrift::protocol::TType& type, /*out*/ int16_t& id)
+        {
+            type = static_cast< ::apache::thrift::protocol::TType>(read_byte());
+            if (type == ::apache::thrift::protocol::T_STOP)
+            {
+                id = 0;
+                return false;
+            }
+            id = read_i16();
+            return true;
+        }
+
+        void read_list_begin(/*out*/ ::apache::thrift::protocol::TType& elem_type, /*out*/ uint32_t& size)
+        {
+            elem_type = static_cast< ::apache::thrift::protocol::TType>(read_byte());
+            size = read_container_size();
+        }
+
+        void read_set_begin(/*out*/ ::apache::thrift::protocol::TType& elem_type, /*out*/ uint32_t& size)
+        {
+            read_list_begin(elem_type, size);
+        }
+
+        void read_map_begin(
+            /*out*/ ::apache::thrift::protocol::TType& key_type,
+            /*out*/ ::apache::thrift::protocol::TType& value_type,
+            /*out*/ uint32_t& size)
+        {
+            key_type = static_cast< ::apache::thrift::protocol::TType>(read_byte());
+            value_type = static_cast< ::apache::thrift::protocol::TType>(read_byte());
+            size = read_container_size();
+        }
+
+        void skip(::apache::thrift::protocol::TType type)
+        {
+            using namespace ::apache::thrift::protocol;
+            switch (type)
+            {
+            case T_BOOL:
+            case T_BYTE:
+                read_bytes(1);
+                break;
+            case T_I16:
+                read_bytes(2);
+                break;
+            case T_I32:
+                read_bytes(4);
+                break;
+            case T_I64:
+            case T_U64:
+            case T_DOUBLE:
+                read_bytes(8);
+                break;
+            case T_STRING:
+                read_bytes(read_i32());
+                break;
+            case T_STRUCT:
+                {
+                    TType ftype;
+                    int16_t fid;
+                    while (read_field_begin(ftype, fid))
+                        skip(ftype);
+                }
+                break;
+            case T_MAP:
+                {
+                    TType ktype, vtype;
+                    uint32_t size;
+                    read_map_begin(ktype, vtype, size);
+                    for (uint32_t i = 0; i < size; i++)
+                    {
+                        skip(ktype);
+                        skip(vtype);
+                    }
+                }
+                break;
+            case T_SET:
+            case T_LIST:
+                {
+                    TType etype;
+                    uint32_t size;
+                    read_list_begin(etype, size);
+                    for (uint32_t i = 0; i < size; i++)
+                        skip(etype);
+                }
+                break;
+            default:
+                dassert(false, "cannot skip unknown thrift type %d", static_cast<int>(type));
+                break;
+            }
+        }
+
+        template<typename T>
+        void read_value(/*out*/ T& val)
+        {
+            read_value_internal(val, thrift_binary_detail::has_codec<T>());
+        }
+
+        // read the field value if the type matches, or skip it as the thrift
+        // generated code does
+        template<typename T>
+        bool read_field(::apache::thrift::protocol::TType type, /*out*/ T& val)
+        {
+            if (type == thrift_binary_type<T>::value)
+            {
+                read_value(val);
+                return true;
+            }
+            else
+            {
+                skip(type);
+                return false;
+            }
+        }
+
+    private:
+        void reset()
+        {
+            _buffer = _reader.get_remaining_buffer();
+            _start = _ptr = _buffer.data();
+            _end = _ptr + _reader.get_remaining_size();
+            _pinned = blob();
+        }
+
+        uint32_t read_container_size()
+        {
+            int32_t size = read_i32();
+            // every element takes at least one byte
+            if (size < 0 || size > _end - _ptr)
+            {
+                dassert(false, "invalid container size %d, remaining = %d",
+                    size, static_cast<int>(_end - _ptr));
+                return 0;
+            }
+            return static_cast<uint32_t>(size);
+        }
+
+        template<typename T>
+        void read_value_internal(/*out*/ T& val, std::true_type)
+        {
+            thrift_binary_read(*this, val);
+        }
+
+        // types without a generated codec go through the virtual protocol
+        template<typename T>
+        void read_value_internal(/*out*/ T& val, std::false_type)
+        {
+            sync();
+            {
+                ::dsn::binary_reader_transport trans(_reader);
+                boost::shared_ptr< ::dsn::binary_reader_transport> transport(&trans, [](::dsn::binary_reader_transport*) {});
+                ::apache::thrift::protocol::TBinaryProtocol proto(transport);
+                unmarshall_base(&proto, val);
+            }
+            reset();
+        }
+
+    private:
+        binary_reader& _reader;
+        dsn_message_t  _msg;
+        blob           _buffer;  // remaining buffer of _reader when reset
+        blob           _pinned;  // _buffer with a reference on _msg as holder
+        const char*    _start;
+        const char*    _ptr;
+        const char*    _end;
+    };
+
+    //----------------- base types -------------------
+# define DEFINE_THRIFT_BINARY_BASE_CODEC(cpp_type, wire_type, method) \
+    inline void thrift_binary_write(thrift_binary_writer& writer, const cpp_type& val) \
+    { \
+        writer.write_##method(static_cast<wire_type>(val)); \
+    } \
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ cpp_type& val) \
+    { \
+        val = static_cast<cpp_type>(reader.read_##method()); \
+    }
+
+    DEFINE_THRIFT_BINARY_BASE_CODEC(bool, bool, bool)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(int8_t, int8_t, byte)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(uint8_t, int8_t, byte)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(int16_t, int16_t, i16)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(uint16_t, int16_t, i16)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(int32_t, int32_t, i32)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(uint32_t, int32_t, i32)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(int64_t, int64_t, i64)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(uint64_t, int64_t, i64)
+    DEFINE_THRIFT_BINARY_BASE_CODEC(double, double, double)
+
+    template<typename T>
+    inline typename std::enable_if<std::is_enum<T>::value>::type
+    thrift_binary_write(thrift_binary_writer& writer, const T& val)
+    {
+        writer.write_i32(static_cast<int32_t>(val));
+    }
+
+    template<typename T>
+    inline typename std::enable_if<std::is_enum<T>::value>::type
+    thrift_binary_read(thrift_binary_reader& reader, /*out*/ T& val)
+    {
+        val = static_cast<T>(reader.read_i32());
+    }
+
+    inline void thrift_binary_write(thrift_binary_writer& writer, const std::string& val)
+    {
+        writer.write_string(val.data(), static_cast<int>(val.length()));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ std::string& val)
+    {
+        reader.read_string(val);
+    }
+
+    inline void thrift_binary_write(thrift_binary_writer& writer, const blob& val)
+    {
+        writer.write_string(val.data(), static_cast<int>(val.length()));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ blob& val)
+    {
+        reader.read_binary(val);
+    }
+
+    //----------------- rDSN builtin types, same encoding as their TBinaryProtocol read/write -------------------
+    inline void thrift_binary_write(thrift_binary_writer& writer, const rpc_address& val)
+    {
+        dassert(val.type() == HOST_TYPE_INVALID || val.type() == HOST_TYPE_IPV4,
+            "only invalid or ipv4 can be serialized to binary");
+        writer.write_i64(static_cast<int64_t>(val.c_addr().u.value));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ rpc_address& val)
+    {
+        dsn_address_t addr;
+        addr.u.value = static_cast<uint64_t>(reader.read_i64());
+        val = addr;
+        dassert(val.type() == HOST_TYPE_INVALID || val.type() == HOST_TYPE_IPV4,
+            "only invalid or ipv4 can be deserialized from binary");
+    }
+
+    inline void thrift_binary_write(thrift_binary_writer& writer, const gpid& val)
+    {
+        writer.write_i64(static_cast<int64_t>(val.value()));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ gpid& val)
+    {
+        dsn_gpid id;
+        id.value = static_cast<uint64_t>(reader.read_i64());
+        val = gpid(id);
+    }
+
+    inline void thrift_binary_write(thrift_binary_writer& writer, const task_code& val)
+    {
+        const char* name = val.to_string();
+        writer.write_string(name, static_cast<int>(strlen(name)));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ task_code& val)
+    {
+        std::string name;
+        reader.read_string(name);
+        val = task_code(dsn_task_code_from_string(name.c_str(), TASK_CODE_INVALID));
+    }
+
+    inline void thrift_binary_write(thrift_binary_writer& writer, const error_code& val)
+    {
+        const char* name = val.to_string();
+        writer.write_string(name, static_cast<int>(strlen(name)));
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ error_code& val)
+    {
+        std::string name;
+        reader.read_string(name);
+        val = error_code(dsn_error_from_string(name.c_str(), ERR_UNKNOWN));
+    }
+
+    //----------------- containers -------------------
+    template<typename T>
+    inline void thrift_binary_write(thrift_binary_writer& writer, const std::vector<T>& val)
+    {
+        writer.write_list_begin(thrift_binary_type<T>::value, static_cast<uint32_t>(val.size()));
+        for (auto& e : val)
+            writer.write_value(e);
+    }
+
+    template<typename T>
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ std::vector<T>& val)
+    {
+        ::apache::thrift::protocol::TType elem_type;
+        uint32_t size;
+        reader.read_list_begin(elem_type, size);
+        val.clear();
+        val.resize(size);
+        for (uint32_t i = 0; i < size; i++)
+            reader.read_value(val[i]);
+    }
+
+    // std::vector<bool> is packed and yields proxies instead of bool references
+    inline void thrift_binary_write(thrift_binary_writer& writer, const std::vector<bool>& val)
+    {
+        writer.write_list_begin(::apache::thrift::protocol::T_BOOL, static_cast<uint32_t>(val.size()));
+        for (bool e : val)
+            writer.write_bool(e);
+    }
+
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ std::vector<bool>& val)
+    {
+        ::apache::thrift::protocol::TType elem_type;
+        uint32_t size;
+        reader.read_list_begin(elem_type, size);
+        val.clear();
+        val.reserve(size);
+        for (uint32_t i = 0; i < size; i++)
+            val.push_back(reader.read_bool());
+    }
+
+    template<typename T>
+    inline void thrift_binary_write(thrift_binary_writer& writer, const std::set<T>& val)
+    {
+        writer.write_set_begin(thrift_binary_type<T>::value, static_cast<uint32_t>(val.size()));
+        for (auto& e : val)
+            writer.write_value(e);
+    }
+
+    template<typename T>
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ std::set<T>& val)
+    {
+        ::apache::thrift::protocol::TType elem_type;
+        uint32_t size;
+        reader.read_set_begin(elem_type, size);
+        val.clear();
+        for (uint32_t i = 0; i < size; i++)
+        {
+            T e;
+            reader.read_value(e);
+            val.insert(std::move(e));
+        }
+    }
+
+    template<typename TKey, typename TValue>
+    inline void thrift_binary_write(thrift_binary_writer& writer, const std::map<TKey, TValue>& val)
+    {
+        writer.write_map_begin(thrift_binary_type<TKey>::value, thrift_binary_type<TValue>::value, static_cast<uint32_t>(val.size()));
+        for (auto& kv : val)
+        {
+            writer.write_value(kv.first);
+            writer.write_value(kv.second);
+        }
+    }
+
+    template<typename TKey, typename TValue>
+    inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ std::map<TKey, TValue>& val)
+    {
+        ::apache::thrift::protocol::TType key_type, value_type;
+        uint32_t size;
+        reader.read_map_begin(key_type, value_type, size);
+        val.clear();
+        for (uint32_t i = 0; i < size; i++)
+        {
+            TKey key;
+            reader.read_value(key);
+            reader.read_value(val[key]);
+        }
+    }
+
+    //
+    // same envelope as marshall_thrift_internal/unmarshall_thrift_internal, i.e., the value
+    // is the field 0 of an anonymous struct, so the two paths are interchangeable on the wire
+    //
+    template<typename T>
+    inline void marshall_thrift_binary_codec(binary_writer& writer, const T& val)
+    {
+        thrift_binary_writer w(writer);
+        w.write_field_begin(get_thrift_type(val), 0);
+        w.write_value(val);
+        w.write_field_stop();
+    }
+
+    template<typename T>
+    inline void unmarshall_thrift_binary_codec(binary_reader& reader, /*out*/ T& val)
+    {
+        thrift_binary_reader r(reader);
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        r.read_field_begin(type, id);
+        r.read_value(val);
+        r.read_field_begin(type, id);
+    }
+}
@@ -65,6 +65,7 @@ DEFINE_TASK_CODE_AIO(LPC_AIO_TEST_WRITE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAU
 DEFINE_TASK_CODE_AIO(LPC_AIO_TEST_NFS, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
 
 extern void run_all_unit_tests_when_necessary();
+extern void run_all_benchmarks_when_necessary();
 
 class test_client :
     public ::dsn::serverlet<test_client>,
@@ -130,6 +131,7 @@ public:
         // client
         else
         {
+            run_all_benchmarks_when_necessary();
             run_all_unit_tests_when_necessary();
         }
         
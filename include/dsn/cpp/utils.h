@@ -201,6 +201,9 @@ namespace dsn {
 
             extern bool create_file(const std::string& path);
 
+            // truncate or extend (with zeros) an existing regular file to sz bytes
+            extern bool resize_file(const std::string& path, int64_t sz);
+
             extern bool get_current_directory(std::string& path);
 
             extern bool last_write_time(std::string& path, time_t& tm);
@@ -158,8 +158,20 @@ public:
         clock_gettime(CLOCK_REALTIME, &ts);
         ts.tv_sec += timeout_milliseconds / 1000;
         ts.tv_nsec += timeout_milliseconds % 1000 * 1000000;
-        
-        return sem_timedwait(&m_sema, &ts) == 0;
+        if (ts.tv_nsec >= 1000000000)
+        {
+            // sem_timedwait fails at once with EINVAL otherwise
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+
+        int rc;
+        do
+        {
+            rc = sem_timedwait(&m_sema, &ts);
+        }
+        while (rc == -1 && errno == EINTR);
+        return rc == 0;
     }
 
     void signal()
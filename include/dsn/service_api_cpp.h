@@ -44,6 +44,7 @@
 # include <dsn/cpp/rpc_stream.h>
 # include <dsn/cpp/zlocks.h>
 # include <dsn/cpp/clientlet.h>
+# include <dsn/cpp/coroutine.h>
 # include <dsn/cpp/serverlet.h>
 # include <dsn/cpp/service_app.h>
 # include <dsn/cpp/address.h>
@@ -41,6 +41,10 @@
 
 namespace dsn {
 
+/*!
+  admission controller decides whether the tasks are accepted by the bound queue,
+  configured by [threadpool.*] admission_controller_factory_name/arguments
+ */
 class admission_controller
 {
 public:
@@ -51,7 +55,11 @@ public:
     admission_controller(task_queue* q, std::vector<std::string>& sargs) : _queue(q) {}
     virtual ~admission_controller() {}
     
+    // called on enqueue, only rpc requests can be rejected, which are replied with ERR_BUSY
     virtual bool is_task_accepted(task* task) = 0;
+
+    // called by the worker right before executing a task from the bound queue
+    virtual void on_task_dequeued(task* task) {}
         
     task_queue* bound_queue() const { return _queue; }
     
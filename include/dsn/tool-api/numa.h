@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     cpu sets of any size and the NUMA topology of the machine
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# pragma once
+
+# include <dsn/service_api_c.h>
+# include <string>
+# include <vector>
+
+namespace dsn {
+
+/*!
+@addtogroup tool-api-providers
+@{
+*/
+/*!
+  a set of cpu ids, not limited to 64 cpus as the affinity masks are
+ */
+class cpu_set
+{
+public:
+    // cpus whose bit is set in the mask
+    DSN_API static cpu_set from_mask(uint64_t mask);
+
+    // from a cpu list in the format of /sys/devices/system/node/node0/cpulist,
+    // e.g., "0-15,32-47", returns false when the list is malformed
+    DSN_API static bool parse(const char* list, /*out*/ cpu_set& cpus);
+
+    void add(int cpu)
+    {
+        size_t w = static_cast<size_t>(cpu) / 64;
+        if (w >= _words.size())
+            _words.resize(w + 1, 0);
+        _words[w] |= ((uint64_t)1 << (cpu % 64));
+    }
+
+    bool contains(int cpu) const
+    {
+        size_t w = static_cast<size_t>(cpu) / 64;
+        return w < _words.size() && (_words[w] & ((uint64_t)1 << (cpu % 64))) != 0;
+    }
+
+    void merge(const cpu_set& other)
+    {
+        if (other._words.size() > _words.size())
+            _words.resize(other._words.size(), 0);
+        for (size_t i = 0; i < other._words.size(); i++)
+            _words[i] |= other._words[i];
+    }
+
+    bool empty() const { return count() == 0; }
+    DSN_API int count() const;
+    DSN_API int max_cpu() const; // -1 when empty
+
+    // the n-th cpu (in increasing order) in the set, n is taken modulo count()
+    DSN_API int nth(int n) const;
+
+    DSN_API std::string to_string() const;
+
+private:
+    std::vector<uint64_t> _words;
+};
+
+/*!
+  NUMA nodes and their cpus, got from /sys/devices/system/node on linux;
+  other platforms are seen as a single node with all the cpus
+ */
+class numa_topology
+{
+public:
+    DSN_API static const numa_topology& instance();
+
+    int node_count() const { return static_cast<int>(_node_cpus.size()); }
+    const cpu_set& node_cpus(int node) const { return _node_cpus[node]; }
+    const cpu_set& all_cpus() const { return _all_cpus; }
+
+    // -1 if the cpu is unknown
+    DSN_API int node_of_cpu(int cpu) const;
+
+    // the only node the cpus belong to, or -1 if they span multiple nodes
+    DSN_API int node_of_cpus(const cpu_set& cpus) const;
+
+private:
+    numa_topology();
+
+    std::vector<cpu_set> _node_cpus;
+    cpu_set              _all_cpus;
+};
+
+// bind the current thread to the given cpus, and remember its NUMA node
+// if all the cpus are on the same node
+DSN_API bool bind_current_thread_to_cpus(const cpu_set& cpus);
+
+// the NUMA node the current thread is bound to, -1 if not bound to a single node
+DSN_API int  get_current_numa_node();
+DSN_API void set_current_numa_node(int node);
+/*@}*/
+} // end namespace
@@ -179,7 +179,7 @@ private:
 
     mutable std::atomic<task_state> _state;
     uint64_t               _task_id; 
-    std::atomic<void*>     _wait_event;
+    std::atomic<int>       _wait_count; // threads blocked in wait(), which wait on _state
     int                    _hash;
     int                    _delay_milliseconds;
     bool                   _wait_for_cancel;
@@ -299,20 +299,34 @@ public:
 
     DSN_API void enqueue() override;
 
+    // absolute deadline (ns) derived from the client timeout, 0 for unknown,
+    // maintained by deadline-aware task queues
+    uint64_t deadline_ns() const { return _deadline_ns; }
+    void     set_deadline_ns(uint64_t deadline_ns) { _deadline_ns = deadline_ns; }
+
+    // skip the rpc handler when executed, e.g., the client has already timed out
+    void     drop_before_execution() { _dropped = true; }
+
     void  exec() override
     {
-        if (0 == _enqueue_ts_ns
+        if (!_dropped && (0 == _enqueue_ts_ns
             || dsn_now_ns() - _enqueue_ts_ns < 
-            static_cast<uint64_t>(_request->header->client.timeout_ms) * 1000000ULL)
+            static_cast<uint64_t>(_request->header->client.timeout_ms) * 1000000ULL))
         {
             _handler->run(_request);
         }
+        else if (1 == _handler->release_ref())
+        {
+            delete _handler;
+        }
     }
 
 protected:
     message_ex      *_request;
     rpc_handler_info* _handler;
     uint64_t         _enqueue_ts_ns;
+    uint64_t         _deadline_ns;
+    bool             _dropped;
 };
 
 typedef void(*dsn_rpc_response_handler_replace_t)(
@@ -358,11 +372,27 @@ public:
         }
     }
 
+private:
+    // state for replace_callback, embedded to avoid an allocation per hooked call
+    struct hook_context
+    {
+        dsn_rpc_response_handler_t old_callback;
+        dsn_task_cancelled_handler_t old_on_cancel;
+        void* old_context;
+
+        dsn_rpc_response_handler_replace_t new_callback;
+        uint64_t new_context;
+    };
+
+    static void hook_callback(dsn_error_t err, dsn_message_t req, dsn_message_t resp, void* ctx);
+    static void hook_on_cancel(void* ctx);
+
 private:
     message_ex*                _request;
     message_ex*                _response;
     task_worker_pool *         _caller_pool;
     dsn_rpc_response_handler_t _cb;
+    hook_context               _hook;
 
     friend class rpc_engine;    
 };
@@ -43,6 +43,7 @@ namespace dsn {
 
 class task_worker;
 class task_worker_pool;
+class service_node;
 class admission_controller;
 
 /*!
@@ -78,6 +79,8 @@ public:
     int               increase_count(int count = 1) { _queue_length_counter->add(count);  return _queue_length.fetch_add(count, std::memory_order_relaxed) + count;}
     const safe_string & get_name() { return _name; }    
     task_worker_pool* pool() const { return _pool; }
+    const threadpool_spec& pool_spec() const { return *_spec; }
+    DSN_API service_node* node() const;
     bool              is_shared() const { return _worker_count > 1; }
     int               worker_count() const { return _worker_count; }
     task_worker*      owner_worker() const { return _owner_worker; } // when not is_shared()
@@ -90,7 +93,7 @@ public:
 private:
     friend class task_worker_pool;
     void set_owner_worker(task_worker* worker) { _owner_worker = worker; }
-    void enqueue_internal(task* task);
+    bool enqueue_internal(task* task); // false when the task is rejected
     
 private:
     task_worker_pool*      _pool;
@@ -308,8 +308,20 @@ struct threadpool_spec
     worker_priority_t       worker_priority;
     bool                    worker_share_core;
     uint64_t                worker_affinity_mask;
+    safe_string             worker_affinity_cpus;
+    safe_string             worker_numa_nodes;
+    int                     worker_idle_spin_us;
+    int                     worker_idle_yield_us;
+    int                     worker_count_max;    // elastic workers when > worker_count
+    int                     worker_scale_up_delay_us;
+    int                     worker_scale_down_idle_ms;
+    int                     worker_scale_interval_ms;
     int                     dequeue_batch_size;
     bool                    partitioned;         // false by default
+    bool                    numa_local_thread_hash;
+    int                     partition_bucket_count; // skew-aware partitioning when > 0
+    int                     partition_rebalance_interval_ms;
+    double                  partition_rebalance_imbalance_ratio;
     safe_string             queue_factory_name;
     safe_string             worker_factory_name;
     safe_list<safe_string>  queue_aspects;
@@ -334,7 +346,19 @@ CONFIG_BEGIN(threadpool_spec)
     CONFIG_FLD_ENUM(worker_priority_t, worker_priority, THREAD_xPRIORITY_NORMAL, THREAD_xPRIORITY_INVALID, false, "thread priority")
     CONFIG_FLD(bool, bool, worker_share_core, true, "whether the threads share all assigned cores")
     CONFIG_FLD(uint64_t, uint64, worker_affinity_mask, 0, "what CPU cores are assigned to this pool, 0 for all")
+    CONFIG_FLD_STRING(worker_affinity_cpus, "", "what CPU cores are assigned to this pool in cpu list format (e.g., 0-15,32-47), overriding worker_affinity_mask when not empty")
+    CONFIG_FLD_STRING(worker_numa_nodes, "", "what NUMA nodes (e.g., 0,1) the workers are evenly bound to, overriding worker_affinity_cpus and worker_affinity_mask when not empty")
+    CONFIG_FLD(int, uint64, worker_idle_spin_us, 0, "how long (us) an idle worker busy-spins for new tasks before yielding, trading cpu for latency")
+    CONFIG_FLD(int, uint64, worker_idle_yield_us, 0, "how long (us) an idle worker yields its cpu for new tasks after spinning and before parking")
+    CONFIG_FLD(int, uint64, worker_count_max, 0, "elastic workers for non-partitioned pools: when larger than worker_count, workers are added up to this count when the queueing delay is above worker_scale_up_delay_us, and retired down to worker_count after the pool is idle for worker_scale_down_idle_ms")
+    CONFIG_FLD(int, uint64, worker_scale_up_delay_us, 2000, "elastic workers: queueing delay (us) above which one more worker is activated")
+    CONFIG_FLD(int, uint64, worker_scale_down_idle_ms, 10000, "elastic workers: how long (ms) the pool must be idle before one worker is retired")
+    CONFIG_FLD(int, uint64, worker_scale_interval_ms, 100, "elastic workers: how often (ms) the queueing delay is checked")
     CONFIG_FLD(bool, bool, partitioned, false, "whethe the threads share a single queue(partitioned=false) or not; the latter is usually for workload hash partitioning for avoiding locking")
+    CONFIG_FLD(bool, bool, numa_local_thread_hash, false, "for partitioned pools with worker_numa_nodes, whether thread hash selects a NUMA node first (hash % nodes) and then a worker on it, so that the state partitioned by the hash can be kept node-local")
+    CONFIG_FLD(int, uint64, partition_bucket_count, 0, "for partitioned pools, when > 0, thread hashes are mapped to this many buckets, which are assigned to workers through a table rebalanced according to the bucket load, instead of hash % worker_count")
+    CONFIG_FLD(int, uint64, partition_rebalance_interval_ms, 1000, "for partitioned pools with partition_bucket_count, how often (ms) the bucket load is checked for rebalancing")
+    CONFIG_FLD(double, double, partition_rebalance_imbalance_ratio, 1.25, "for partitioned pools with partition_bucket_count, buckets are migrated when the load of the busiest worker is above this ratio of the average")
     CONFIG_FLD_STRING(queue_factory_name, "", "task queue provider name")
     CONFIG_FLD_STRING(worker_factory_name, "", "task worker provider name")
     CONFIG_FLD_STRING_LIST(queue_aspects, "task queue aspects names, usually for tooling purpose")
@@ -50,10 +50,12 @@ namespace dsn
     // automatically cancelled to avoid invalid context access
     //
     class task_tracker;
+    struct tracker_slot;
+    struct tracker_node;
     class trackable_task
     {
     public:
-        trackable_task() : _task(nullptr), _owner(nullptr), _dl_bucket_id(0)
+        trackable_task() : _task(nullptr), _owner(nullptr), _node(nullptr)
         {}
         virtual ~trackable_task() {}
 
@@ -62,26 +64,9 @@ namespace dsn
         task_tracker* tracker() const { return _owner; }
 
     private:
-        friend class task_tracker;
-
-        enum owner_delete_state
-        {
-            OWNER_DELETE_NOT_LOCKED = 0,
-            OWNER_DELETE_LOCKED = 1,
-            OWNER_DELETE_FINISHED = 2
-        };
-
-        dsn_task_t  _task;
-        task_tracker *_owner;
-        std::atomic<owner_delete_state> _deleting_owner;
-
-        // double-linked list for put into _owner
-        dlink      _dl;
-        int        _dl_bucket_id;
-
-    private:
-        owner_delete_state owner_delete_prepare();
-        void               owner_delete_commit();
+        dsn_task_t    _task;
+        task_tracker  *_owner;
+        tracker_node  *_node; // registration in _owner, see task_tracker
     };
 
     //
@@ -89,9 +74,22 @@ namespace dsn
     // there can be multiple task_tracker in the system, mostly
     // defined during set_tracker in main
     //
+    // tasks are registered into a slot of the tracker owned by the
+    // current thread, so that registration only takes the lock of that
+    // slot, which no other thread takes but cancel/wait_outstanding_tasks;
+    // threads are hashed into buckets, each holding a lock-free chain of
+    // the slots of its threads; deregistration from any thread is
+    // a single cas on the registration node, and the node is unlinked
+    // later on by the owner thread of the slot (deferred removal).
+    // cancel/wait_outstanding_tasks only handle the tasks registered
+    // before the call (by epoch), so they terminate even when new
+    // tasks keep coming in.
+    //
     class task_tracker
     {
     public:
+        // task_bucket_count is the minimum number of slot buckets,
+        // threads beyond that chain their slots in the buckets
         explicit task_tracker(int task_bucket_count = 13);
         virtual ~task_tracker();
 
@@ -99,65 +97,14 @@ namespace dsn
         void wait_outstanding_tasks();
         
     private:
-
         friend class trackable_task;
-        const int                      _task_bucket_count;
-        ::dsn::utils::ex_lock_nr_spin  *_outstanding_tasks_lock;
-        dlink                          *_outstanding_tasks;
-    };
-
-    // ------- inlined implementation ----------
-    inline void trackable_task::set_tracker(task_tracker* owner, dsn_task_t task)
-    {
-        dassert(_owner == nullptr, "task tracker is already set");
-        _owner = owner;
-        _task = task;
-        _deleting_owner.store(OWNER_DELETE_NOT_LOCKED, std::memory_order_release);
+        tracker_slot* get_current_slot();
+        tracker_node* register_task(dsn_task_t task);
+        void handle_outstanding_tasks(bool cancel);
 
-        if (nullptr != _owner)
-        {
-            _dl_bucket_id = static_cast<int>(::dsn::utils::get_current_tid() % _owner->_task_bucket_count);
-            {
-                utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_owner->_outstanding_tasks_lock[_dl_bucket_id]);
-                _dl.insert_after(&_owner->_outstanding_tasks[_dl_bucket_id]);
-            }
-        }
-    }
-
-    inline void trackable_task::unset_tracker()
-    {
-        if (nullptr != _owner)
-        {
-            auto s = owner_delete_prepare();
-            switch (s)
-            {
-            case OWNER_DELETE_NOT_LOCKED:
-                owner_delete_commit();
-                break;
-            case OWNER_DELETE_LOCKED:
-                while (OWNER_DELETE_LOCKED == _deleting_owner.load(std::memory_order_consume))
-                {
-                }
-                break;
-            case OWNER_DELETE_FINISHED:
-                break;
-            }
-            _owner = nullptr;
-        }
-    }
-
-    inline trackable_task::owner_delete_state trackable_task::owner_delete_prepare()
-    {
-        return _deleting_owner.exchange(OWNER_DELETE_LOCKED, std::memory_order_acquire);
-    }
-
-    inline void trackable_task::owner_delete_commit()
-    {
-        {
-            utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_owner->_outstanding_tasks_lock[_dl_bucket_id]);
-            _dl.remove();
-        }
-
-        _deleting_owner.store(OWNER_DELETE_FINISHED, std::memory_order_relaxed);
-    }
+    private:
+        const int                      _bucket_count;
+        std::atomic<tracker_slot*>     *_buckets; // heads of the slot chains
+        std::atomic<uint64_t>          _epoch;
+    };
 }
@@ -41,6 +41,7 @@
 # include <dsn/utility/dlib.h>
 # include <dsn/tool-api/perf_counter.h>
 # include <thread>
+# include <atomic>
 
 namespace dsn {
  
@@ -71,12 +72,17 @@ public:
 
     DSN_API virtual void loop(); // run tasks from _input_queue
 
+    // for elastic pools, resume the worker if it is in standby
+    DSN_API void wake_up();
+
     // inquery
     const safe_string& name() const { return _name; }
     int index() const { return _index; }
     int native_tid() const { return _native_tid; }
     task_worker_pool* pool() const { return _owner_pool; }
     task_queue* queue() const { return _input_queue; }
+    bool is_started() const { return _is_running; }
+    uint64_t processed_task_count() const { return _processed_task_count.load(std::memory_order_relaxed); }
     DSN_API const threadpool_spec& pool_spec() const;
     DSN_API static task_worker* current();
 
@@ -89,7 +95,8 @@ private:
     std::thread      *_thread;
     bool             _is_running;
     utils::notify_event _started;
-    int              _processed_task_count;
+    utils::notify_event _standby_event;
+    std::atomic<uint64_t> _processed_task_count; // written by this worker only
 
 public:
     DSN_API static void set_name(const char* name);
@@ -98,6 +105,7 @@ public:
 
 private:
     void run_internal();
+    void standby();
 
 public:
     /*!
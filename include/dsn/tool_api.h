@@ -57,6 +57,7 @@
 # include <dsn/tool-api/global_checkers.h>
 # include <dsn/tool-api/task_queue.h>
 # include <dsn/tool-api/task_worker.h>
+# include <dsn/tool-api/numa.h>
 # include <dsn/tool-api/admission_controller.h>
 # include <dsn/tool-api/network.h>
 # include <dsn/tool-api/aio_provider.h>
@@ -36,15 +36,27 @@
 # pragma once
 
 # include <dsn/utility/extensible_object.h>
+# include <atomic>
+# include <vector>
 
 
 namespace dsn
 {
 
+//
+// advices are kept in a linked list for being installed by names, and also in a
+// contiguous array rebuilt on each change for being executed, so that a join point
+// without any advice costs only an inline check; all the join points are compiled
+// out when DSN_DISABLE_JOIN_POINTS is defined (see dsn.cmake), which also disables
+// the tools relying on them (e.g., profiler, tracer, and fault injector)
+//
 class join_point_base
 {
 public:
     join_point_base(const char* name);
+    ~join_point_base();
+    join_point_base(const join_point_base&) = delete;
+    join_point_base& operator=(const join_point_base&) = delete;
 
     bool put_front(void* fn, const char* name, bool is_native = false);
     bool put_back(void* fn, const char* name, bool is_native = false);
@@ -54,6 +66,15 @@ public:
     bool put_replace(const char* base, void* fn, const char* name);
 
     const char* name() const { return _name.c_str(); }
+
+    bool empty() const
+    {
+# ifdef DSN_DISABLE_JOIN_POINTS
+        return true;
+# else
+        return _advices_empty.load(std::memory_order_acquire);
+# endif
+    }
         
 protected:
     struct advice_entry
@@ -65,12 +86,28 @@ protected:
         advice_entry *prev;            
     };
 
+    struct advice_slot
+    {
+        void        *func;
+        bool         is_native;
+    };
+
     advice_entry _hdr;
     std::string  _name;
+
+    // executed advices in order, never changed once published, see rebuild_advices;
+    // both are published with release so that the executing threads may read them
+    // without a lock while the advices are changed (by one thread at a time)
+    std::atomic<std::vector<advice_slot>*> _advices;
+    std::atomic<bool>                      _advices_empty;
     
 private:
     advice_entry* new_entry(void* fn, const char* name, bool is_native);
     advice_entry* get_by_name(const char* name);
+    void rebuild_advices();
+
+    // replaced advice arrays are kept until destruction as they may still be executed
+    std::vector<std::vector<advice_slot>*> _retired_advices;
 };
 
 struct join_point_unused_type {};
@@ -97,18 +134,19 @@ public:
     TReturn execute(T1 p1, T2 p2, T3 p3, TReturn default_return_value)
     {
         TReturn returnValue = default_return_value;
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return returnValue;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                returnValue = (*(point_prototype*)&p->func)(p1, p2, p3);
+                returnValue = (*(point_prototype*)&a.func)(p1, p2, p3);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1, p2, p3);
+                (*(advice_prototype*)&a.func)(p1, p2, p3);
             }
-            p = p->next;
         }
         return returnValue;
     }
@@ -133,18 +171,19 @@ public:
 
     void execute(T1 p1, T2 p2, T3 p3)
     {
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                (*(point_prototype*)&p->func)(p1, p2, p3);
+                (*(point_prototype*)&a.func)(p1, p2, p3);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1, p2, p3);
+                (*(advice_prototype*)&a.func)(p1, p2, p3);
             }
-            p = p->next;
         }
     }
 };
@@ -169,18 +208,19 @@ public:
     TReturn execute(T1 p1, T2 p2, TReturn default_return_value)
     {
         TReturn returnValue = default_return_value;
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return returnValue;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                returnValue = (*(point_prototype*)&p->func)(p1, p2);
+                returnValue = (*(point_prototype*)&a.func)(p1, p2);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1, p2);
+                (*(advice_prototype*)&a.func)(p1, p2);
             }
-            p = p->next;
         }
         return returnValue;
     }
@@ -205,18 +245,19 @@ public:
 
     void execute(T1 p1, T2 p2)
     {
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                (*(point_prototype*)&p->func)(p1, p2);
+                (*(point_prototype*)&a.func)(p1, p2);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1, p2);
+                (*(advice_prototype*)&a.func)(p1, p2);
             }
-            p = p->next;
         }
     }
 };
@@ -241,18 +282,19 @@ public:
     TReturn execute(T1 p1, TReturn default_return_value)
     {
         TReturn returnValue = default_return_value;
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return returnValue;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                returnValue = (*(point_prototype*)&p->func)(p1);
+                returnValue = (*(point_prototype*)&a.func)(p1);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1);
+                (*(advice_prototype*)&a.func)(p1);
             }
-            p = p->next;
         }
         return returnValue;
     }
@@ -277,18 +319,19 @@ public:
 
     void execute(T1 p1)
     {
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                (*(point_prototype*)&p->func)(p1);
+                (*(point_prototype*)&a.func)(p1);
             }
             else
             {
-                (*(advice_prototype*)&p->func)(p1);
+                (*(advice_prototype*)&a.func)(p1);
             }
-            p = p->next;
         }
     }
 };
@@ -312,18 +355,19 @@ public:
     TReturn execute(TReturn default_return_value)
     {
         TReturn returnValue = default_return_value;
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return returnValue;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                returnValue = (*(point_prototype*)&p->func)();
+                returnValue = (*(point_prototype*)&a.func)();
             }
             else
             {
-                (*(advice_prototype*)&p->func)();
+                (*(advice_prototype*)&a.func)();
             }
-            p = p->next;
         }
         return returnValue;
     }
@@ -348,18 +392,19 @@ public:
 
     void execute()
     {
-        advice_entry* p = _hdr.next;
-        while (p != &_hdr)
+        if (empty())
+            return;
+
+        for (auto& a : *_advices.load(std::memory_order_acquire))
         {
-            if (p->is_native)
+            if (a.is_native)
             {
-                (*(point_prototype*)&p->func)();
+                (*(point_prototype*)&a.func)();
             }
             else
             {
-                (*(advice_prototype*)&p->func)();
+                (*(advice_prototype*)&a.func)();
             }
-            p = p->next;
         }
     }
 };
@@ -36,11 +36,62 @@
 #pragma once
 
 # include <queue>
+# include <vector>
+# include <algorithm>
 # include <cassert>
 # include <dsn/utility/synchronize.h>
 
 namespace dsn { namespace utils {
 
+//
+// a std::queue-like container ordered by the earliest deadline (FIFO for the same deadline),
+// which can be used as TQueue of priority_queue below;
+// TDeadline()(obj) returns the absolute deadline of obj, and it is called once on push
+//
+template<typename T, typename TDeadline>
+class deadline_queue
+{
+public:
+    deadline_queue() : _seq(0) {}
+
+    void push(const T& obj)
+    {
+        _heap.push_back(entry{ TDeadline()(obj), _seq++, obj });
+        std::push_heap(_heap.begin(), _heap.end(), later());
+    }
+
+    const T& front() const { return _heap.front().obj; }
+    uint64_t front_deadline() const { return _heap.front().deadline; }
+
+    void pop()
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), later());
+        _heap.pop_back();
+    }
+
+    size_t size() const { return _heap.size(); }
+    bool empty() const { return _heap.empty(); }
+
+private:
+    struct entry
+    {
+        uint64_t deadline;
+        uint64_t seq;
+        T        obj;
+    };
+
+    struct later
+    {
+        bool operator()(const entry& l, const entry& r) const
+        {
+            return l.deadline > r.deadline || (l.deadline == r.deadline && l.seq > r.seq);
+        }
+    };
+
+    std::vector<entry> _heap;
+    uint64_t           _seq;
+};
+
 template<typename T, int priority_count, typename TQueue = std::queue<T>>
 class priority_queue
 {
@@ -123,23 +174,41 @@ public:
 
     virtual long enqueue(T obj, uint32_t priority)
     { 
+        int woken;
+        return enqueue(obj, priority, woken);
+    }
+
+    // woken is how many idle consumers are woken up from the kernel
+    long enqueue(T obj, uint32_t priority, /*out*/ int& woken)
+    {
         auto r = priority_queue<T, priority_count, TQueue>::enqueue(obj, priority);
-        _sema.signal();
+        woken = _sema.signal();
         return r;
     }
 
     virtual T dequeue(/*out*/ long& ct, int millieseconds = 0xffffffff)
     {
-        if (!_sema.wait(millieseconds))
+        return dequeue(ct, millieseconds, nullptr);
+    }
+
+    T dequeue(/*out*/ long& ct, int millieseconds, /*out*/ idle_wait_result* wr)
+    {
+        if (!_sema.wait(millieseconds, wr))
         {
             ct = 0;
             return nullptr;
         }
         return priority_queue<T, priority_count, TQueue>::dequeue(ct);
     }
+
+    // how long the consumers spin and then yield before parking when the queue is empty
+    void set_idle_policy(int spin_us, int yield_us)
+    {
+        _sema.set_policy(spin_us, yield_us);
+    }
     
 private:
-    semaphore _sema;
+    spin_park_semaphore _sema;
 };
 
 }} // end namespace
@@ -42,6 +42,20 @@
 # include <dsn/ext/hpc-locks/benaphore.h>
 # include <dsn/ext/hpc-locks/autoresetevent.h>
 # include <dsn/ext/hpc-locks/rwlock.h>
+# include <atomic>
+# include <chrono>
+# include <thread>
+# include <climits>
+
+# if defined(__linux__)
+# include <cerrno>
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# else
+# include <mutex>
+# include <condition_variable>
+# endif
 
 namespace dsn {
     namespace utils {
@@ -200,6 +214,281 @@ namespace dsn {
             LightweightSemaphore _sema;
         };
 
+        //
+        // semaphore for idle workers which busy-spins for spin_us, then yields
+        // for yield_us, and only then parks in the kernel; signal wakes up parked
+        // waiters only for the tokens that the spinning/yielding waiters (including
+        // the ones woken up but not running yet) cannot take, so that a burst of
+        // enqueues does not turn into a burst of futex wakes
+        //
+        struct idle_wait_result
+        {
+            bool     spin_hit;   // got the token while spinning/yielding
+            bool     parked;     // parked in the kernel at least once
+            uint64_t park_ns;    // time spent parked
+        };
+
+        class spin_park_semaphore
+        {
+        public:
+            spin_park_semaphore(int spin_us = 0, int yield_us = 0)
+                : _count(0), _spinning(0), _parked(0)
+            {
+                set_policy(spin_us, yield_us);
+            }
+
+            void set_policy(int spin_us, int yield_us)
+            {
+                _spin_ns = static_cast<int64_t>(spin_us > 0 ? spin_us : 0) * 1000;
+                _yield_ns = static_cast<int64_t>(yield_us > 0 ? yield_us : 0) * 1000;
+            }
+
+            // return how many parked waiters are woken up
+            int signal(int count = 1)
+            {
+                int tokens = _count.fetch_add(count) + count;
+                if (_parked.load() == 0)
+                    return 0;
+
+                int wake = tokens - _spinning.load();
+                if (wake > count)
+                    wake = count;
+
+                int woken = 0;
+                while (woken < wake)
+                {
+                    int parked = _parked.load();
+                    if (parked == 0)
+                        break;
+                    if (_parked.compare_exchange_weak(parked, parked - 1))
+                    {
+                        // the woken waiter is accounted as spinning till it gets a token or parks again
+                        _spinning.fetch_add(1);
+                        _sema.signal();
+                        woken++;
+                    }
+                }
+                return woken;
+            }
+
+            bool wait(int milliseconds = TIME_MS_MAX, /*out*/ idle_wait_result* result = nullptr)
+            {
+                idle_wait_result r = { false, false, 0 };
+                bool ok = wait_internal(milliseconds, r);
+                if (result) *result = r;
+                return ok;
+            }
+
+        private:
+            bool try_acquire()
+            {
+                int c = _count.load(std::memory_order_relaxed);
+                while (c > 0)
+                {
+                    if (_count.compare_exchange_weak(c, c - 1, std::memory_order_acquire))
+                        return true;
+                }
+                return false;
+            }
+
+            // called with this waiter accounted in _spinning
+            bool spin_acquire()
+            {
+                if (_spin_ns == 0 && _yield_ns == 0)
+                    return try_acquire();
+
+                auto start = std::chrono::steady_clock::now();
+                int64_t elapsed_ns = 0;
+                for (int i = 0; ; i++)
+                {
+                    if (try_acquire())
+                        return true;
+
+                    if (elapsed_ns >= _spin_ns)
+                        std::this_thread::yield();
+                    else
+                        std::atomic_signal_fence(std::memory_order_acquire);
+
+                    if ((i & 63) == 0 || elapsed_ns >= _spin_ns)
+                    {
+                        elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+                        if (elapsed_ns >= _spin_ns + _yield_ns)
+                            return try_acquire();
+                    }
+                }
+            }
+
+            // this waiter leaves the parked state by itself; when a signaler has
+            // already claimed it, the kernel token is on the way and must be consumed
+            void leave_parked()
+            {
+                int parked = _parked.load();
+                while (parked > 0)
+                {
+                    if (_parked.compare_exchange_weak(parked, parked - 1))
+                        return;
+                }
+                _sema.wait();
+                _spinning.fetch_sub(1);
+            }
+
+            bool wait_internal(int milliseconds, /*out*/ idle_wait_result& r)
+            {
+                if (try_acquire())
+                    return true;
+
+                bool infinite = (TIME_MS_MAX == static_cast<unsigned int>(milliseconds));
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(infinite ? 0 : milliseconds);
+
+                _spinning.fetch_add(1);
+                while (true)
+                {
+                    if (spin_acquire())
+                    {
+                        _spinning.fetch_sub(1);
+                        // without spin/yield phases it is merely the re-check before parking
+                        r.spin_hit = (_spin_ns > 0 || _yield_ns > 0);
+                        return true;
+                    }
+
+                    // park, and check again after being visible as parked
+                    _parked.fetch_add(1);
+                    _spinning.fetch_sub(1);
+                    if (try_acquire())
+                    {
+                        leave_parked();
+                        return true;
+                    }
+
+                    r.parked = true;
+                    auto park_start = std::chrono::steady_clock::now();
+                    bool woken;
+                    if (infinite)
+                    {
+                        _sema.wait();
+                        woken = true;
+                    }
+                    else
+                    {
+                        auto remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - park_start).count();
+                        woken = (remaining_ns > 0 && _sema.wait(static_cast<int>((remaining_ns + 999999) / 1000000)));
+                    }
+                    r.park_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - park_start).count();
+
+                    if (!woken)
+                    {
+                        // timeout
+                        leave_parked();
+                        return try_acquire();
+                    }
+
+                    // woken up by signal, which has moved this waiter to _spinning
+                    if (try_acquire())
+                    {
+                        _spinning.fetch_sub(1);
+                        return true;
+                    }
+                }
+            }
+
+        private:
+            std::atomic<int> _count;     // available tokens
+            std::atomic<int> _spinning;  // waiters which will check _count before parking
+            std::atomic<int> _parked;    // waiters parked and not claimed by any signaler yet
+            int64_t          _spin_ns;
+            int64_t          _yield_ns;
+            Semaphore        _sema;
+        };
+
+        //
+        // wait/wake on the value of a 32-bit atomic word, so that objects like 
+        // tasks can be waited on without an event per object; it is futex on 
+        // linux, and a global table of condition variables keyed by address
+        // on other platforms; wait may return spuriously so callers must check
+        // the word again
+        //
+        class address_wait
+        {
+        public:
+            // block as long as *addr == expected, return false on timeout
+            template<typename T>
+            static bool wait(std::atomic<T>* addr, T expected, int milliseconds = TIME_MS_MAX)
+            {
+                static_assert(sizeof(std::atomic<T>) == sizeof(int), "only 32-bit words can be waited on");
+                return wait_internal(reinterpret_cast<std::atomic<int>*>(addr), static_cast<int>(expected), milliseconds);
+            }
+
+            // wake up all waiters on addr, called after *addr is changed
+            template<typename T>
+            static void wake_all(std::atomic<T>* addr)
+            {
+                static_assert(sizeof(std::atomic<T>) == sizeof(int), "only 32-bit words can be waited on");
+                wake_all_internal(reinterpret_cast<std::atomic<int>*>(addr));
+            }
+
+        private:
+# if defined(__linux__)
+            static bool wait_internal(std::atomic<int>* addr, int expected, int milliseconds)
+            {
+                struct timespec ts, *pts = nullptr;
+                if (TIME_MS_MAX != static_cast<unsigned int>(milliseconds))
+                {
+                    ts.tv_sec = milliseconds / 1000;
+                    ts.tv_nsec = (milliseconds % 1000) * 1000000L;
+                    pts = &ts;
+                }
+
+                long r = ::syscall(SYS_futex, reinterpret_cast<int*>(addr), FUTEX_WAIT_PRIVATE, expected, pts, nullptr, 0);
+                return !(r == -1 && errno == ETIMEDOUT);
+            }
+
+            static void wake_all_internal(std::atomic<int>* addr)
+            {
+                ::syscall(SYS_futex, reinterpret_cast<int*>(addr), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+            }
+# else
+            struct bucket
+            {
+                std::mutex              lock;
+                std::condition_variable cond;
+            };
+
+            static bucket& get_bucket(std::atomic<int>* addr)
+            {
+                static bucket s_buckets[257];
+                return s_buckets[(reinterpret_cast<uintptr_t>(addr) >> 3) % 257];
+            }
+
+            static bool wait_internal(std::atomic<int>* addr, int expected, int milliseconds)
+            {
+                auto& b = get_bucket(addr);
+                std::unique_lock<std::mutex> l(b.lock);
+                if (addr->load() != expected)
+                    return true;
+
+                if (TIME_MS_MAX == static_cast<unsigned int>(milliseconds))
+                {
+                    b.cond.wait(l);
+                    return true;
+                }
+                else
+                    return b.cond.wait_for(l, std::chrono::milliseconds(milliseconds)) == std::cv_status::no_timeout;
+            }
+
+            static void wake_all_internal(std::atomic<int>* addr)
+            {
+                // the bucket is shared by other addresses, so wake them all
+                auto& b = get_bucket(addr);
+                {
+                    std::lock_guard<std::mutex> l(b.lock);
+                }
+                b.cond.notify_all();
+            }
+# endif
+        };
+
         //--------------------- helpers --------------------------------------
         template<typename T>
         class auto_lock
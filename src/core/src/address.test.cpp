@@ -35,10 +35,54 @@
 
 # include <dsn/cpp/address.h>
 # include "group_address.h"
+# include "uri_address.h"
+# include <dsn/tool_api.h>
 # include <gtest/gtest.h>
+# include <atomic>
+# include <thread>
 
 using namespace ::dsn;
 
+// counts the live instances so that the tests can check no resolver leaks
+class partition_resolver_for_test : public dist::partition_resolver
+{
+public:
+    partition_resolver_for_test(rpc_address meta_server, const char* app_path)
+        : dist::partition_resolver(meta_server, app_path)
+    {
+        ++s_live;
+    }
+
+    ~partition_resolver_for_test() { --s_live; }
+
+    virtual void resolve(
+        uint64_t partition_hash,
+        std::function<void(dist::partition_resolver::resolve_result&&)>&& callback,
+        int timeout_ms
+        ) override
+    {
+        dist::partition_resolver::resolve_result result;
+        result.err = ERR_SERVICE_NOT_FOUND;
+        callback(std::move(result));
+    }
+
+    virtual void on_access_failure(int partition_index, error_code err) override {}
+
+    virtual int get_partition_index(int partition_count, uint64_t partition_hash) override
+    {
+        return (int)(partition_hash % (uint64_t)partition_count);
+    }
+
+    static std::atomic<int> s_live;
+};
+
+std::atomic<int> partition_resolver_for_test::s_live(0);
+
+void address_test_module_init()
+{
+    tools::register_component_provider<partition_resolver_for_test>("dsn::dist::partition_resolver_for_test");
+}
+
 static inline uint32_t host_ipv4(uint8_t sec1, uint8_t sec2, uint8_t sec3, uint8_t sec4)
 {
     uint32_t ip = 0;
@@ -279,3 +323,95 @@ TEST(core, dsn_group)
 
     dsn_group_destroy(g);
 }
+
+TEST(core, rpc_uri_address_resolver_cache)
+{
+    // no uri-resolver section is configured for this uri
+    rpc_uri_address u("dsn://unknown-meta-server:34601/app1");
+    ASSERT_EQ(std::string("app1"), u.get_uri_components().second);
+    ASSERT_EQ(nullptr, u.get_resolver());
+    ASSERT_EQ(nullptr, u.get_resolver());
+
+    // invalidating a missing resolver changes nothing
+    u.invalidate_resolver(nullptr);
+    ASSERT_EQ(nullptr, u.get_resolver());
+}
+
+TEST(core, rpc_uri_address_resolver_refresh)
+{
+    // resolve from the test thread first, which has the rpc context
+    {
+        rpc_uri_address u("dsn://resolver-for-test/app1");
+        auto r = u.get_resolver();
+        if (r == nullptr)
+            return;
+
+        ASSERT_EQ(r.get(), u.get_resolver().get());
+        ASSERT_STREQ("app1", r->get_app_path().c_str());
+
+        // a reset of the app resolver is seen by the next call
+        u.invalidate_resolver(r.get());
+        auto r2 = u.get_resolver();
+        ASSERT_NE(nullptr, r2);
+        ASSERT_NE(r.get(), r2.get());
+
+        // a stale reset is ignored
+        u.invalidate_resolver(r.get());
+        ASSERT_EQ(r2.get(), u.get_resolver().get());
+
+        // resolvers of other uris are not refreshed
+        rpc_uri_address other("dsn://resolver-for-test/app2");
+        auto o = other.get_resolver();
+        ASSERT_NE(nullptr, o);
+        u.invalidate_resolver(r2.get());
+        ASSERT_EQ(o.get(), other.get_resolver().get());
+    }
+
+    // refreshes racing the readers, each reader must always get a live resolver
+    {
+        rpc_uri_address u("dsn://resolver-for-test/app1");
+        auto first = u.get_resolver();
+        ASSERT_NE(nullptr, first);
+
+        std::atomic<bool> stop(false);
+        std::atomic<int> errors(0);
+        std::atomic<int> refreshes(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+        {
+            threads.emplace_back([&]()
+            {
+                while (!stop.load())
+                {
+                    auto r = u.get_resolver();
+                    if (r == nullptr || strcmp("app1", r->get_app_path().c_str()) != 0)
+                        ++errors;
+                }
+            });
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            threads.emplace_back([&]()
+            {
+                for (int j = 0; j < 2000; j++)
+                {
+                    u.invalidate_resolver(u.get_resolver().get());
+                    ++refreshes;
+                }
+            });
+        }
+
+        for (int i = 4; i < (int)threads.size(); i++)
+            threads[i].join();
+        stop.store(true);
+        for (int i = 0; i < 4; i++)
+            threads[i].join();
+
+        EXPECT_EQ(0, errors.load());
+        EXPECT_EQ(4000, refreshes.load());
+        EXPECT_NE(first.get(), u.get_resolver().get());
+    }
+
+    // only the resolvers held by the uri_resolver for app1 and app2 are left
+    EXPECT_EQ(2, partition_resolver_for_test::s_live.load());
+}
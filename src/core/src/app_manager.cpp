@@ -112,6 +112,29 @@ DSN_API void dsn_hosted_app_commit_rpc_request(void* app_context, dsn_message_t
     }
 }
 
+DSN_API void dsn_hosted_app_commit_rpc_requests(
+    void* app_context,
+    int64_t decree,
+    dsn_message_t* requests,
+    int count,
+    bool exec_inline
+    )
+{
+    auto app = (::dsn::app_manager::app_internal*)(app_context);
+    auto on_batch = app->model->layer2.apps.calls.on_batched_write_requests;
+
+    if (on_batch != nullptr)
+    {
+        on_batch(app->app_context, decree, requests, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            dsn_hosted_app_commit_rpc_request(app_context, requests[i], exec_inline);
+        }
+    }
+}
 
 namespace dsn 
 {
@@ -0,0 +1,201 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the coroutine awaitables.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include <dsn/service_api_cpp.h>
+# include <dsn/cpp/coroutine.h>
+# include <gtest/gtest.h>
+# include <dsn/cpp/test_utils.h>
+
+# ifdef DSN_HAS_COROUTINE
+
+# include <atomic>
+# include <future>
+# include <thread>
+
+static co_task<std::string> coroutine_worker_name(int hash)
+{
+    co_await tasking::switch_to(LPC_TEST_HASH, hash);
+    co_return std::string(task::get_current_worker()->name().c_str());
+}
+
+static co_task<> coroutine_test_sleep(std::promise<std::string>& result)
+{
+    auto name = co_await coroutine_worker_name(1);
+
+    uint64_t start = dsn_now_ms();
+    co_await tasking::sleep(LPC_TEST_HASH, std::chrono::milliseconds(10), 1);
+    EXPECT_GE(dsn_now_ms() - start, 10u);
+
+    result.set_value(name);
+}
+
+TEST(core, coroutine_sleep)
+{
+    std::promise<std::string> result;
+    auto f = result.get_future();
+    coroutine_test_sleep(result).start();
+
+    auto name = f.get();
+    EXPECT_TRUE(name.substr(0, name.length() - 2) == "client.THREAD_POOL_DEFAULT");
+}
+
+static co_task<> coroutine_test_rpc(std::promise<std::pair<error_code, std::string>>& result)
+{
+    ::dsn::rpc_address server("localhost", 20101);
+    auto r = co_await rpc::call_async<std::string>(server, RPC_TEST_HASH, 0, std::chrono::milliseconds(0), 1);
+    result.set_value(r);
+}
+
+TEST(core, coroutine_rpc)
+{
+    std::promise<std::pair<error_code, std::string>> result;
+    auto f = result.get_future();
+    coroutine_test_rpc(result).start();
+
+    auto r = f.get();
+    EXPECT_TRUE(r.first == ERR_OK);
+    EXPECT_TRUE(r.second == "server");
+}
+
+static co_task<> coroutine_test_aio(std::promise<bool>& result)
+{
+    const char* str = "hello coroutine";
+    int len = static_cast<int>(strlen(str));
+    char buffer[64];
+
+    auto fp = dsn_file_open("tmp_coroutine_file", O_RDWR | O_CREAT | O_BINARY, 0666);
+    EXPECT_TRUE(fp != nullptr);
+
+    auto w = co_await file::write_async(fp, str, len, 0, LPC_AIO_TEST);
+    EXPECT_TRUE(w.first == ERR_OK && w.second == static_cast<size_t>(len));
+
+    auto r = co_await file::read_async(fp, buffer, sizeof(buffer), 0, LPC_AIO_TEST);
+    EXPECT_TRUE(r.first == ERR_OK && r.second == static_cast<size_t>(len));
+
+    dsn_file_close(fp);
+    result.set_value(memcmp(buffer, str, len) == 0);
+}
+
+TEST(core, coroutine_aio)
+{
+    if (task::get_current_disk() == nullptr) return;
+
+    std::promise<bool> result;
+    auto f = result.get_future();
+    coroutine_test_aio(result).start();
+
+    EXPECT_TRUE(f.get());
+    EXPECT_TRUE(utils::filesystem::remove_path("tmp_coroutine_file"));
+}
+
+// frames allocated and freed while the hook is set, and any misaligned one
+static std::atomic<int> s_frame_allocs(0);
+static std::atomic<int> s_frame_frees(0);
+static std::atomic<int> s_misaligned_frames(0);
+
+static void coroutine_test_frame_hook(void* frame, size_t size, bool allocated)
+{
+    if (allocated)
+    {
+        s_frame_allocs++;
+        if (reinterpret_cast<uintptr_t>(frame) % __STDCPP_DEFAULT_NEW_ALIGNMENT__ != 0)
+            s_misaligned_frames++;
+    }
+    else
+        s_frame_frees++;
+}
+
+static co_task<> coroutine_hops(int count, std::promise<void>& done)
+{
+    for (int i = 0; i < count; i++)
+    {
+        co_await tasking::switch_to(LPC_TEST_HASH, 1);
+    }
+    done.set_value();
+}
+
+static co_task<int> coroutine_aligned_child(int i)
+{
+    alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) char local[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    local[0] = static_cast<char>(i);
+    co_await tasking::switch_to(LPC_TEST_HASH, 1);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(local) % __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    co_return local[0];
+}
+
+static co_task<> coroutine_children(int count, std::promise<int>& done)
+{
+    int sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += co_await coroutine_aligned_child(i);
+    }
+    done.set_value(sum);
+}
+
+TEST(core, coroutine_no_extra_allocation)
+{
+    const int count = 100;
+
+    // awaiting tasks allocates nothing but the frame of the outermost coroutine
+    s_frame_allocs = 0;
+    s_frame_frees = 0;
+    s_misaligned_frames = 0;
+    coroutine_detail::promise_base::frame_hook_for_test = coroutine_test_frame_hook;
+
+    std::promise<void> done;
+    auto f1 = done.get_future();
+    coroutine_hops(count, done).start();
+    f1.get();
+
+    // the frame is freed by the worker right after set_value
+    while (s_frame_frees.load() != 1)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(1, s_frame_allocs.load());
+
+    // each awaited co_task costs its own frame only, aligned for the locals
+    std::promise<int> sum;
+    auto f2 = sum.get_future();
+    coroutine_children(count, sum).start();
+    EXPECT_EQ(count * (count - 1) / 2, f2.get());
+
+    while (s_frame_frees.load() != 2 + count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(2 + count, s_frame_allocs.load());
+    EXPECT_EQ(0, s_misaligned_frames.load());
+
+    coroutine_detail::promise_base::frame_hook_for_test = nullptr;
+}
+
+# endif // DSN_HAS_COROUTINE
@@ -701,6 +701,34 @@ static void file_utils_test_file_size()
     EXPECT_FALSE(ret);
 }
 
+static void file_utils_test_resize_file()
+{
+    std::string path;
+    int64_t sz;
+    bool ret;
+
+    path = "./file_utils_temp_resize.txt";
+    ret = dsn::utils::filesystem::resize_file(path, 10);
+    EXPECT_FALSE(ret);
+
+    ret = dsn::utils::filesystem::create_file(path);
+    EXPECT_TRUE(ret);
+    ret = dsn::utils::filesystem::resize_file(path, 4096);
+    EXPECT_TRUE(ret);
+    ret = dsn::utils::filesystem::file_size(path, sz);
+    EXPECT_TRUE(ret);
+    EXPECT_TRUE(sz == 4096);
+
+    ret = dsn::utils::filesystem::resize_file(path, 100);
+    EXPECT_TRUE(ret);
+    ret = dsn::utils::filesystem::file_size(path, sz);
+    EXPECT_TRUE(ret);
+    EXPECT_TRUE(sz == 100);
+
+    ret = dsn::utils::filesystem::remove_path(path);
+    EXPECT_TRUE(ret);
+}
+
 static void file_utils_test_path_exists()
 {
     std::string path;
@@ -915,6 +943,7 @@ TEST(core, file_utils)
     file_utils_test_get_file_name();
     file_utils_test_create();
     file_utils_test_file_size();
+    file_utils_test_resize_file();
     file_utils_test_path_exists();
     file_utils_test_get_paths();
     file_utils_test_rename();
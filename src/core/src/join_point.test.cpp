@@ -35,6 +35,8 @@
 
 # include <dsn/utility/join_point.h>
 # include <gtest/gtest.h>
+# include <atomic>
+# include <thread>
 
 using namespace ::dsn;
 
@@ -157,3 +159,75 @@ TEST(core, join_point)
     ASSERT_EQ(check_vec, jp_vec);
     }
 }
+
+static std::vector<int> s_executed;
+static void join_point_advice_1(int v) { s_executed.push_back(v * 10 + 1); }
+static void join_point_advice_2(int v) { s_executed.push_back(v * 10 + 2); }
+static bool join_point_native(int v) { s_executed.push_back(v * 10); return false; }
+
+TEST(core, join_point_execute)
+{
+    join_point<bool, int> jp("join_point_execute");
+    ASSERT_TRUE(jp.empty());
+    ASSERT_TRUE(jp.execute(1, true));
+    ASSERT_TRUE(s_executed.empty());
+
+    jp.put_back(join_point_advice_2, "2");
+    jp.put_front(join_point_advice_1, "1");
+    jp.put_native(join_point_native);
+# ifndef DSN_DISABLE_JOIN_POINTS
+    ASSERT_FALSE(jp.empty());
+    ASSERT_FALSE(jp.execute(1, true));
+    ASSERT_EQ(std::vector<int>({ 10, 11, 12 }), s_executed);
+
+    s_executed.clear();
+    jp.remove("native");
+    jp.remove("1");
+    ASSERT_TRUE(jp.execute(2, true));
+    ASSERT_EQ(std::vector<int>({ 22 }), s_executed);
+
+    jp.remove("2");
+    ASSERT_TRUE(jp.empty());
+# else
+    ASSERT_TRUE(jp.empty());
+    ASSERT_TRUE(jp.execute(1, true));
+    ASSERT_TRUE(s_executed.empty());
+# endif
+}
+
+static std::atomic<int> s_concurrent_executed(0);
+static void join_point_advice_concurrent(int v) { s_concurrent_executed += v; }
+
+TEST(core, join_point_execute_while_changed)
+{
+    join_point<void, int> jp("join_point_execute_while_changed");
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> executors;
+    for (int i = 0; i < 4; i++)
+    {
+        executors.emplace_back([&jp, &stop]()
+        {
+            while (!stop.load())
+                jp.execute(1);
+        });
+    }
+
+    // the executors see either the old or the new advices, never a partial array
+    const char* names[] = { "1", "2", "3", "4" };
+    for (int round = 0; round < 1000; round++)
+    {
+        for (auto name : names)
+            jp.put_back(join_point_advice_concurrent, name);
+        for (auto name : names)
+            jp.remove(name);
+    }
+
+    stop.store(true);
+    for (auto& t : executors)
+        t.join();
+
+    ASSERT_TRUE(jp.empty());
+    int executed = s_concurrent_executed.load();
+    jp.execute(1);
+    ASSERT_EQ(executed, s_concurrent_executed.load());
+}
@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for latency_histogram.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include <dsn/cpp/perf_test_helper.h>
+# include <gtest/gtest.h>
+
+using namespace ::dsn::service;
+
+TEST(core, latency_histogram_buckets)
+{
+    // small values are exact
+    for (uint64_t v = 0; v < latency_histogram::LINEAR_COUNT; v++)
+    {
+        ASSERT_EQ((int)v, latency_histogram::bucket_of(v));
+        ASSERT_EQ(v, latency_histogram::bucket_lower_bound((int)v));
+        ASSERT_EQ(v, latency_histogram::bucket_upper_bound((int)v));
+    }
+
+    // larger ones fall into contiguous buckets with ~3% error
+    uint64_t values[] = { 64, 65, 127, 128, 1000, 123456, 1000000007ULL, 0xffffffffffffULL, ~0ULL };
+    for (auto v : values)
+    {
+        int b = latency_histogram::bucket_of(v);
+        ASSERT_LT(b, (int)latency_histogram::BUCKET_COUNT);
+        ASSERT_LE(latency_histogram::bucket_lower_bound(b), v);
+        ASSERT_GE(latency_histogram::bucket_upper_bound(b), v);
+        ASSERT_LE((double)(latency_histogram::bucket_upper_bound(b) - latency_histogram::bucket_lower_bound(b)),
+            (double)v / 32.0);
+    }
+
+    for (int b = 1; b < latency_histogram::BUCKET_COUNT; b++)
+    {
+        ASSERT_EQ(latency_histogram::bucket_upper_bound(b - 1) + 1, latency_histogram::bucket_lower_bound(b));
+    }
+}
+
+TEST(core, latency_histogram_percentile_merge)
+{
+    latency_histogram h1, h2;
+    ASSERT_EQ(0u, h1.percentile(0.99));
+
+    for (uint64_t v = 1; v <= 1000; v++)
+        h1.record(v * 1000);
+    h2.record(10000000, 10);
+
+    ASSERT_EQ(1000u, h1.count());
+    auto p50 = h1.percentile(0.5);
+    ASSERT_GE(p50, 500000u);
+    ASSERT_LE(p50, 500000u + 500000u / 32);
+    ASSERT_GE(h1.percentile(1.0), 1000000u);
+
+    h1.merge(h2);
+    ASSERT_EQ(1010u, h1.count());
+    ASSERT_GE(h1.percentile(0.999), 10000000u);
+    ASSERT_LE(h1.percentile(0.98), 1000000u + 1000000u / 32);
+
+    latency_histogram h3(h1);
+    ASSERT_EQ(h1.count(), h3.count());
+    ASSERT_EQ(h1.percentile(0.9), h3.percentile(0.9));
+
+    h3.clear();
+    ASSERT_EQ(0u, h3.count());
+}
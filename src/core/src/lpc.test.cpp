@@ -37,6 +37,9 @@
 # include <gtest/gtest.h>
 # include <dsn/service_api_cpp.h>
 # include <dsn/cpp/test_utils.h>
+# include <atomic>
+# include <thread>
+# include <vector>
 
 void on_lpc_test(void* p)
 {
@@ -60,3 +63,32 @@ TEST(core, lpc)
 
     EXPECT_TRUE(result.substr(0, result.length() - 2) == "client.THREAD_POOL_DEFAULT");
 }
+
+TEST(core, lpc_wait_multiple_waiters)
+{
+    std::atomic<bool> go(false);
+    auto t = ::dsn::tasking::enqueue(LPC_TEST_HASH, nullptr, [&go]()
+    {
+        while (!go.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+
+    EXPECT_FALSE(t->wait(10));
+
+    std::atomic<int> woken(0);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; i++)
+    {
+        waiters.emplace_back([t, &woken]()
+        {
+            t->wait();
+            ++woken;
+        });
+    }
+
+    go = true;
+    for (auto& w : waiters)
+        w.join();
+    EXPECT_EQ(4, woken.load());
+    EXPECT_TRUE(t->wait(0));
+}
@@ -0,0 +1,261 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     micro benchmark driver, see micro_benchmark.h
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "micro_benchmark.h"
+# include <dsn/cpp/utils.h>
+# include <cmath>
+# include <cstdio>
+# include <fstream>
+# include <iomanip>
+# include <map>
+# include <sstream>
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "micro.benchmark"
+
+namespace dsn {
+    namespace bench {
+
+        struct benchmark_entry
+        {
+            std::string    name; // group.name
+            benchmark_func func;
+        };
+
+        static std::vector<benchmark_entry>& all_benchmarks()
+        {
+            static std::vector<benchmark_entry> benchmarks;
+            return benchmarks;
+        }
+
+        benchmark_registrar::benchmark_registrar(const char* group, const char* name, benchmark_func f)
+        {
+            benchmark_entry e;
+            e.name = std::string(group) + "." + name;
+            e.func = f;
+            all_benchmarks().push_back(e);
+        }
+
+        void benchmark_state::get_result(/*out*/ benchmark_result& result) const
+        {
+            std::vector<double> sorted(_samples);
+            std::sort(sorted.begin(), sorted.end());
+
+            auto percentile = [&sorted](double p)
+            {
+                size_t i = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+                return sorted[std::min(i, sorted.size() - 1)];
+            };
+
+            double sum = 0;
+            for (auto s : sorted)
+                sum += s;
+            double mean = sum / (double)sorted.size();
+            double var = 0;
+            for (auto s : sorted)
+                var += (s - mean) * (s - mean);
+
+            result.iterations_per_sample = _iterations_per_sample;
+            result.samples = (int)sorted.size();
+            result.min_ns = sorted.front();
+            result.mean_ns = mean;
+            result.stddev_ns = sorted.size() > 1 ? std::sqrt(var / (double)(sorted.size() - 1)) : 0.0;
+            result.p50_ns = percentile(0.5);
+            result.p90_ns = percentile(0.9);
+            result.p99_ns = percentile(0.99);
+            result.max_ns = sorted.back();
+            result.ops_per_sec = result.p50_ns > 0 ? 1000000000.0 / result.p50_ns : 0.0;
+            result.mb_per_sec = result.p50_ns > 0 ?
+                (double)_bytes_per_op / 1024.0 / 1024.0 * result.ops_per_sec : 0.0;
+        }
+
+        // one benchmark per line, so that baselines can be read back
+        // without a json library
+        static std::string to_json(const std::vector<benchmark_result>& results)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2);
+            ss << "{\"benchmarks\": [" << std::endl;
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                auto& r = results[i];
+                ss << "  {\"name\": \"" << r.name << "\""
+                    << ", \"p50_ns\": " << r.p50_ns
+                    << ", \"p90_ns\": " << r.p90_ns
+                    << ", \"p99_ns\": " << r.p99_ns
+                    << ", \"min_ns\": " << r.min_ns
+                    << ", \"max_ns\": " << r.max_ns
+                    << ", \"mean_ns\": " << r.mean_ns
+                    << ", \"stddev_ns\": " << r.stddev_ns
+                    << ", \"ops_per_sec\": " << r.ops_per_sec
+                    << ", \"mb_per_sec\": " << r.mb_per_sec
+                    << ", \"samples\": " << r.samples
+                    << ", \"iterations_per_sample\": " << r.iterations_per_sample
+                    << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+            }
+            ss << "]}" << std::endl;
+            return ss.str();
+        }
+
+        // name -> p50_ns of the lines written by to_json
+        static bool load_baseline(const std::string& path, /*out*/ std::map<std::string, double>& baseline)
+        {
+            std::ifstream in(path.c_str());
+            if (!in)
+                return false;
+
+            const std::string name_key = "\"name\": \"";
+            const std::string p50_key = "\"p50_ns\": ";
+            std::string line;
+            while (std::getline(in, line))
+            {
+                auto n = line.find(name_key);
+                auto p = line.find(p50_key);
+                if (n == std::string::npos || p == std::string::npos)
+                    continue;
+
+                n += name_key.length();
+                auto e = line.find('"', n);
+                if (e == std::string::npos)
+                    continue;
+
+                baseline[line.substr(n, e - n)] = atof(line.c_str() + p + p50_key.length());
+            }
+            return true;
+        }
+    }
+}
+
+using namespace ::dsn::bench;
+
+// returns the number of regressions against the baseline
+static int compare_with_baseline(const std::vector<benchmark_result>& results, const std::string& path, double threshold_percent)
+{
+    std::map<std::string, double> baseline;
+    if (!load_baseline(path, baseline))
+    {
+        printf("baseline %s not found, skip the comparison\n", path.c_str());
+        return 0;
+    }
+
+    int regressions = 0;
+    printf("\n%-40s %14s %14s %9s\n", "benchmark", "baseline(ns)", "p50(ns)", "change");
+    for (auto& r : results)
+    {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0)
+        {
+            printf("%-40s %14s %14.2f %9s\n", r.name.c_str(), "-", r.p50_ns, "new");
+            continue;
+        }
+
+        double change = (r.p50_ns - it->second) / it->second * 100.0;
+        bool regressed = change > threshold_percent;
+        if (regressed)
+            regressions++;
+
+        printf("%-40s %14.2f %14.2f %+8.1f%%%s\n", r.name.c_str(), it->second, r.p50_ns, change,
+            regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+bool run_all_benchmarks_enabled()
+{
+    return dsn_config_get_value_bool("core", "benchmark", false,
+        "runs all micro benchmarks instead of the unit tests or not, default is false");
+}
+
+void run_all_benchmarks_when_necessary()
+{
+    if (!run_all_benchmarks_enabled())
+        return;
+
+    benchmark_options opts;
+    opts.warmup_ns = dsn_config_get_value_uint64("core", "benchmark_warmup_ms", 200,
+        "how long each benchmark runs before being measured") * 1000000ULL;
+    opts.sample_ns = dsn_config_get_value_uint64("core", "benchmark_sample_ms", 10,
+        "how long each measured sample of a benchmark takes") * 1000000ULL;
+    opts.repetitions = (int)dsn_config_get_value_uint64("core", "benchmark_repetitions", 50,
+        "how many samples are taken for each benchmark");
+    if (opts.repetitions <= 0)
+        opts.repetitions = 1;
+
+    std::string filter = dsn_config_get_value_string("core", "benchmark_filter", "",
+        "only runs the benchmarks whose group.name contains this string, empty for all");
+    std::string output = dsn_config_get_value_string("core", "benchmark_output", "benchmark.json",
+        "json file the results are written to");
+    std::string baseline = dsn_config_get_value_string("core", "benchmark_baseline", "",
+        "json file written by a previous run, to compare the p50 latency with");
+    double threshold = dsn_config_get_value_double("core", "benchmark_regression_percent", 10.0,
+        "a benchmark regresses when its p50 latency grows by more than this percentage");
+
+    std::vector<benchmark_result> results;
+    printf("%-40s %12s %12s %12s %12s %10s %14s\n",
+        "benchmark", "p50(ns)", "p90(ns)", "p99(ns)", "stddev(ns)", "samples", "ops/s");
+    for (auto& b : all_benchmarks())
+    {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos)
+            continue;
+
+        benchmark_state state(opts);
+        b.func(state);
+        dassert(state.finished(), "benchmark %s does not call state.run", b.name.c_str());
+
+        benchmark_result r;
+        state.get_result(r);
+        r.name = b.name;
+        results.push_back(r);
+
+        printf("%-40s %12.2f %12.2f %12.2f %12.2f %10d %14.0f\n",
+            r.name.c_str(), r.p50_ns, r.p90_ns, r.p99_ns, r.stddev_ns, r.samples, r.ops_per_sec);
+        fflush(stdout);
+    }
+
+    if (!output.empty())
+    {
+        std::ofstream out(output.c_str(), std::ios::out);
+        out << to_json(results);
+        out.close();
+        printf("\nresults are written to %s\n", output.c_str());
+    }
+
+    int regressions = 0;
+    if (!baseline.empty())
+        regressions = compare_with_baseline(results, baseline, threshold);
+
+    dsn_exit(regressions > 0 ? 1 : 0);
+}
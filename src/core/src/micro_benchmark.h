@@ -0,0 +1,152 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     micro benchmarks for the runtime hot paths, which are compiled into
+ *     dsn.core like the unit tests (so they can reach the internal classes),
+ *     and run instead of the tests when [core] benchmark = true
+ *
+ *     BENCHMARK(core, crc32_4k)
+ *     {
+ *         ... setup ...
+ *         state.set_bytes_per_op(4096);
+ *         state.run([&]() { state.consume(dsn_crc32_compute(buf, 4096, 0)); });
+ *     }
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# pragma once
+
+# include <dsn/service_api_c.h>
+# include <algorithm>
+# include <string>
+# include <vector>
+
+namespace dsn {
+    namespace bench {
+
+        struct benchmark_options
+        {
+            uint64_t warmup_ns;
+            uint64_t sample_ns;
+            int      repetitions;
+        };
+
+        // per-op statistics over the samples of one benchmark
+        struct benchmark_result
+        {
+            std::string name;
+            uint64_t    iterations_per_sample;
+            int         samples;
+            double      min_ns;
+            double      mean_ns;
+            double      stddev_ns;
+            double      p50_ns;
+            double      p90_ns;
+            double      p99_ns;
+            double      max_ns;
+            double      ops_per_sec;
+            double      mb_per_sec; // 0 when no bytes are set
+        };
+
+        class benchmark_state
+        {
+        public:
+            benchmark_state(const benchmark_options& opts)
+                : _opts(opts), _bytes_per_op(0), _iterations_per_sample(0), _sink(0) {}
+
+            // warms op up for warmup_ns (which also calibrates how many calls
+            // make one sample of about sample_ns), and then takes the
+            // samples; the state of op is not reset between the calls
+            template<typename TOp>
+            void run(TOp&& op)
+            {
+                dassert(_samples.empty(), "run can only be called once per benchmark");
+
+                uint64_t iterations = 1;
+                uint64_t elapsed_ns = 0;
+                uint64_t start_ns = dsn_now_ns();
+                while (true)
+                {
+                    uint64_t ts = dsn_now_ns();
+                    for (uint64_t i = 0; i < iterations; i++)
+                        op();
+                    elapsed_ns = dsn_now_ns() - ts;
+
+                    if (dsn_now_ns() - start_ns >= _opts.warmup_ns && elapsed_ns > 0)
+                        break;
+                    if (elapsed_ns < _opts.sample_ns)
+                        iterations *= 2;
+                }
+
+                _iterations_per_sample = std::max((uint64_t)1,
+                    (uint64_t)((double)iterations * (double)_opts.sample_ns / (double)elapsed_ns));
+
+                _samples.reserve(_opts.repetitions);
+                for (int r = 0; r < _opts.repetitions; r++)
+                {
+                    uint64_t ts = dsn_now_ns();
+                    for (uint64_t i = 0; i < _iterations_per_sample; i++)
+                        op();
+                    uint64_t te = dsn_now_ns();
+                    _samples.push_back((double)(te - ts) / (double)_iterations_per_sample);
+                }
+            }
+
+            void set_bytes_per_op(uint64_t bytes) { _bytes_per_op = bytes; }
+
+            // keeps the computation of a value from being optimized away
+            template<typename T>
+            void consume(const T& v) { _sink = _sink + (uint64_t)v; }
+
+            bool finished() const { return !_samples.empty(); }
+            void get_result(/*out*/ benchmark_result& result) const;
+
+        private:
+            benchmark_options     _opts;
+            uint64_t              _bytes_per_op;
+            uint64_t              _iterations_per_sample;
+            std::vector<double>   _samples; // ns per op
+            volatile uint64_t     _sink;
+        };
+
+        typedef void (*benchmark_func)(benchmark_state& state);
+
+        class benchmark_registrar
+        {
+        public:
+            benchmark_registrar(const char* group, const char* name, benchmark_func f);
+        };
+    }
+}
+
+# define BENCHMARK(group, name) \
+    static void group##_##name##_benchmark(::dsn::bench::benchmark_state& state); \
+    static ::dsn::bench::benchmark_registrar group##_##name##_benchmark_registrar(#group, #name, group##_##name##_benchmark); \
+    static void group##_##name##_benchmark(::dsn::bench::benchmark_state& state)
@@ -0,0 +1,203 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     NFS remote copy performance test
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ */
+
+# include <dsn/service_api_cpp.h>
+# include <dsn/tool_api.h>
+# include <dsn/cpp/test_utils.h>
+# include <gtest/gtest.h>
+# include <fstream>
+
+using namespace ::dsn;
+
+static void nfs_perf_prepare_dir(const char* dir, uint64_t total_size_mb, int file_count)
+{
+    utils::filesystem::remove_path(dir);
+    dassert(utils::filesystem::create_directory(dir), "create directory %s failed", dir);
+
+    const int chunk_bytes = 1024 * 1024;
+    std::unique_ptr<char[]> chunk(new char[chunk_bytes]);
+    for (int i = 0; i < chunk_bytes; i++)
+    {
+        chunk[i] = (char)dsn_random32(0, 255);
+    }
+
+    uint64_t file_size_mb = total_size_mb / file_count;
+    for (int i = 0; i < file_count; i++)
+    {
+        std::string path = utils::filesystem::path_combine(dir, std::string("file.") + std::to_string(i));
+        std::ofstream os(path.c_str(), std::ios::binary);
+        for (uint64_t j = 0; j < file_size_mb; j++)
+        {
+            // vary the content so that each block is different
+            chunk[j % chunk_bytes] ^= (char)(i + 1);
+            os.write(chunk.get(), chunk_bytes);
+        }
+        os.close();
+    }
+}
+
+static uint64_t nfs_perf_copy(const char* src_dir, const char* dst_dir, bool overwrite)
+{
+    utils::notify_event done;
+    error_code err;
+    auto tic = std::chrono::steady_clock::now();
+    file::copy_remote_directory(
+        rpc_address("localhost", 20101),
+        src_dir,
+        dst_dir,
+        overwrite,
+        LPC_AIO_TEST_NFS,
+        nullptr,
+        [&](error_code ec, size_t sz)
+        {
+            err = ec;
+            done.notify();
+        }
+        );
+    done.wait();
+    auto toc = std::chrono::steady_clock::now();
+    EXPECT_EQ(ERR_OK, err);
+    return std::chrono::duration_cast<std::chrono::microseconds>(toc - tic).count();
+}
+
+static uint64_t nfs_perf_file_crc(const std::string& path)
+{
+    std::ifstream is(path.c_str(), std::ios::binary);
+    std::unique_ptr<char[]> buffer(new char[1024 * 1024]);
+    uint64_t crc = 0;
+    while (is.read(buffer.get(), 1024 * 1024) || is.gcount() > 0)
+    {
+        crc = dsn_crc64_compute(buffer.get(), (size_t)is.gcount(), crc);
+    }
+    return crc;
+}
+
+TEST(perf_core, nfs)
+{
+    // if in dsn_mimic_app() and nfs_io_mode == IOE_PER_QUEUE
+    if (task::get_current_nfs() == nullptr) return;
+
+    uint64_t total_size_mb = dsn_config_get_value_uint64("nfs.perf.test", "total_size_mb",
+        2048, "total size (MB) of the directory copied in the nfs perf test");
+    int file_count = (int)dsn_config_get_value_uint64("nfs.perf.test", "file_count",
+        16, "file count of the directory copied in the nfs perf test");
+    int rounds = (int)dsn_config_get_value_uint64("nfs.perf.test", "rounds",
+        3, "how many times the directory is copied in the nfs perf test");
+
+    nfs_perf_prepare_dir("nfs_perf_dir", total_size_mb, file_count);
+
+    for (int r = 0; r < rounds; r++)
+    {
+        utils::filesystem::remove_path("nfs_perf_dir_copy");
+
+        uint64_t us = nfs_perf_copy("nfs_perf_dir", "nfs_perf_dir_copy", false);
+        std::cout << "nfs copy round " << r
+            << " total_size_mb = " << total_size_mb
+            << " file_count = " << file_count
+            << " elapsed_ms = " << us / 1000
+            << " throughput = " << double(total_size_mb) * 1000000 / us << " MB/s" << std::endl;
+
+        for (int i = 0; i < file_count; i++)
+        {
+            int64_t sz1, sz2;
+            std::string name = std::string("file.") + std::to_string(i);
+            ASSERT_TRUE(utils::filesystem::file_size(utils::filesystem::path_combine("nfs_perf_dir", name), sz1));
+            ASSERT_TRUE(utils::filesystem::file_size(utils::filesystem::path_combine("nfs_perf_dir_copy", name), sz2));
+            ASSERT_EQ(sz1, sz2);
+        }
+    }
+
+    utils::filesystem::remove_path("nfs_perf_dir");
+    utils::filesystem::remove_path("nfs_perf_dir_copy");
+}
+
+TEST(perf_core, nfs_delta)
+{
+    if (task::get_current_nfs() == nullptr) return;
+
+    uint64_t total_size_mb = dsn_config_get_value_uint64("nfs.perf.test", "total_size_mb",
+        2048, "total size (MB) of the directory copied in the nfs perf test");
+    int file_count = (int)dsn_config_get_value_uint64("nfs.perf.test", "file_count",
+        16, "file count of the directory copied in the nfs perf test");
+    int changed_blocks = (int)dsn_config_get_value_uint64("nfs.perf.test", "changed_blocks_per_file",
+        8, "how many 4 KB pieces of each file are modified before the delta copy");
+
+    nfs_perf_prepare_dir("nfs_perf_dir", total_size_mb, file_count);
+    utils::filesystem::remove_path("nfs_perf_dir_copy");
+
+    uint64_t full_us = nfs_perf_copy("nfs_perf_dir", "nfs_perf_dir_copy", true);
+
+    // modify a few pieces of each source file, and shrink the last one
+    uint64_t file_size = total_size_mb / file_count * 1024 * 1024;
+    std::string buffer(4096, 'x');
+    for (int i = 0; i < file_count; i++)
+    {
+        std::string path = utils::filesystem::path_combine("nfs_perf_dir", std::string("file.") + std::to_string(i));
+        std::fstream fs(path.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        for (int j = 0; j < changed_blocks; j++)
+        {
+            fs.seekp((std::streamoff)dsn_random64(0, file_size - buffer.size()));
+            fs.write(buffer.c_str(), buffer.size());
+        }
+        fs.close();
+
+        if (i == file_count - 1)
+        {
+            ASSERT_TRUE(utils::filesystem::resize_file(path, file_size / 2));
+        }
+    }
+
+    uint64_t delta_us = nfs_perf_copy("nfs_perf_dir", "nfs_perf_dir_copy", true);
+
+    std::cout << "nfs delta copy total_size_mb = " << total_size_mb
+        << " file_count = " << file_count
+        << " changed_blocks_per_file = " << changed_blocks
+        << " full_copy_ms = " << full_us / 1000
+        << " delta_copy_ms = " << delta_us / 1000 << std::endl;
+
+    for (int i = 0; i < file_count; i++)
+    {
+        std::string name = std::string("file.") + std::to_string(i);
+        std::string path1 = utils::filesystem::path_combine("nfs_perf_dir", name);
+        std::string path2 = utils::filesystem::path_combine("nfs_perf_dir_copy", name);
+        int64_t sz1, sz2;
+        ASSERT_TRUE(utils::filesystem::file_size(path1, sz1));
+        ASSERT_TRUE(utils::filesystem::file_size(path2, sz2));
+        ASSERT_EQ(sz1, sz2);
+        ASSERT_EQ(nfs_perf_file_crc(path1), nfs_perf_file_crc(path2));
+    }
+
+    utils::filesystem::remove_path("nfs_perf_dir");
+    utils::filesystem::remove_path("nfs_perf_dir_copy");
+}
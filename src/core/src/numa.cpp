@@ -0,0 +1,312 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     cpu sets of any size and the NUMA topology of the machine
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include <dsn/tool-api/numa.h>
+# include <dsn/cpp/utils.h>
+# include <dsn/utility/ports.h>
+# include <thread>
+# include <fstream>
+# include <sstream>
+# include <cstdlib>
+# include <algorithm>
+
+# ifndef _WIN32
+# include <pthread.h>
+# include <sched.h>
+# ifdef __APPLE__
+# include <mach/thread_policy.h>
+# endif
+# ifdef __FreeBSD__
+# include <pthread_np.h>
+# ifndef cpu_set_t
+# define cpu_set_t cpuset_t
+# endif
+# endif
+# endif
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "numa"
+
+namespace dsn {
+
+static __thread int tls_numa_node = -1;
+
+/*static*/ cpu_set cpu_set::from_mask(uint64_t mask)
+{
+    cpu_set cpus;
+    for (int i = 0; i < 64; i++)
+    {
+        if ((mask & ((uint64_t)1 << i)) != 0)
+            cpus.add(i);
+    }
+    return cpus;
+}
+
+/*static*/ bool cpu_set::parse(const char* list, /*out*/ cpu_set& cpus)
+{
+    cpus = cpu_set();
+
+    std::vector<std::string> ranges;
+    utils::split_args(list, ranges, ',');
+    for (auto& r : ranges)
+    {
+        if (r.empty())
+            continue;
+
+        char* end;
+        long first = strtol(r.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-')
+            last = strtol(end + 1, &end, 10);
+        if (*end != '\0' || first < 0 || last < first || last >= 65536)
+            return false;
+
+        for (long c = first; c <= last; c++)
+            cpus.add(static_cast<int>(c));
+    }
+    return true;
+}
+
+int cpu_set::count() const
+{
+    int c = 0;
+    for (auto w : _words)
+    {
+        while (w != 0)
+        {
+            w &= (w - 1);
+            c++;
+        }
+    }
+    return c;
+}
+
+int cpu_set::max_cpu() const
+{
+    for (int i = static_cast<int>(_words.size()) * 64 - 1; i >= 0; i--)
+    {
+        if (contains(i))
+            return i;
+    }
+    return -1;
+}
+
+int cpu_set::nth(int n) const
+{
+    int c = count();
+    if (c == 0)
+        return -1;
+
+    n %= c;
+    for (int i = 0; i < static_cast<int>(_words.size()) * 64; i++)
+    {
+        if (contains(i) && n-- == 0)
+            return i;
+    }
+    return -1;
+}
+
+std::string cpu_set::to_string() const
+{
+    std::stringstream ss;
+    int max = max_cpu();
+    bool first = true;
+    for (int i = 0; i <= max; i++)
+    {
+        if (!contains(i))
+            continue;
+
+        int j = i;
+        while (j + 1 <= max && contains(j + 1))
+            j++;
+
+        if (!first) ss << ",";
+        first = false;
+        if (j == i) ss << i;
+        else ss << i << "-" << j;
+        i = j;
+    }
+    return ss.str();
+}
+
+numa_topology::numa_topology()
+{
+# ifdef __linux__
+    for (int node = 0; ; node++)
+    {
+        std::stringstream path;
+        path << "/sys/devices/system/node/node" << node << "/cpulist";
+        std::ifstream in(path.str());
+        if (!in)
+            break;
+
+        std::string list;
+        std::getline(in, list);
+        cpu_set cpus;
+        if (!cpu_set::parse(list.c_str(), cpus))
+        {
+            derror("invalid cpu list '%s' in %s, NUMA topology is ignored", list.c_str(), path.str().c_str());
+            _node_cpus.clear();
+            break;
+        }
+        _node_cpus.push_back(cpus);
+    }
+# endif
+
+    if (_node_cpus.empty())
+    {
+        cpu_set cpus;
+        int nr_cpu = static_cast<int>(std::thread::hardware_concurrency());
+        for (int i = 0; i < nr_cpu; i++)
+            cpus.add(i);
+        _node_cpus.push_back(cpus);
+    }
+
+    for (auto& cpus : _node_cpus)
+        _all_cpus.merge(cpus);
+}
+
+/*static*/ const numa_topology& numa_topology::instance()
+{
+    static numa_topology s_topology;
+    return s_topology;
+}
+
+int numa_topology::node_of_cpu(int cpu) const
+{
+    for (int i = 0; i < node_count(); i++)
+    {
+        if (_node_cpus[i].contains(cpu))
+            return i;
+    }
+    return -1;
+}
+
+int numa_topology::node_of_cpus(const cpu_set& cpus) const
+{
+    int node = -1;
+    int max = cpus.max_cpu();
+    for (int i = 0; i <= max; i++)
+    {
+        if (!cpus.contains(i))
+            continue;
+
+        int n = node_of_cpu(i);
+        if (n == -1 || (node != -1 && n != node))
+            return -1;
+        node = n;
+    }
+    return node;
+}
+
+bool bind_current_thread_to_cpus(const cpu_set& cpus)
+{
+    dassert(!cpus.empty(), "cannot bind a thread to an empty cpu set");
+
+    int err = 0;
+# ifdef _WIN32
+    // processor groups are not supported, only the first 64 cpus can be used
+    DWORD_PTR mask = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        if (cpus.contains(i))
+            mask |= ((DWORD_PTR)1 << i);
+    }
+    if (mask == 0 || ::SetThreadAffinityMask(::GetCurrentThread(), mask) == 0)
+    {
+        err = static_cast<int>(::GetLastError());
+    }
+# elif defined(__APPLE__)
+    // only affinity tags are supported, threads with the same tag are scheduled close to each other
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        if (cpus.contains(i))
+            mask |= ((uint64_t)1 << i);
+    }
+    thread_affinity_policy_data_t policy;
+    policy.affinity_tag = static_cast<integer_t>(mask);
+    err = static_cast<int>(thread_policy_set(
+        static_cast<thread_t>(::dsn::utils::get_current_tid()),
+        THREAD_AFFINITY_POLICY,
+        (thread_policy_t)&policy,
+        THREAD_AFFINITY_POLICY_COUNT
+        ));
+# elif defined(__linux__)
+    int max = cpus.max_cpu();
+    size_t size = CPU_ALLOC_SIZE(max + 1);
+    cpu_set_t* set = CPU_ALLOC(max + 1);
+    CPU_ZERO_S(size, set);
+    for (int i = 0; i <= max; i++)
+    {
+        if (cpus.contains(i))
+            CPU_SET_S(i, size, set);
+    }
+    err = pthread_setaffinity_np(pthread_self(), size, set);
+    CPU_FREE(set);
+# else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    int max = std::min(cpus.max_cpu(), static_cast<int>(CPU_SETSIZE) - 1);
+    for (int i = 0; i <= max; i++)
+    {
+        if (cpus.contains(i))
+            CPU_SET(i, &set);
+    }
+    err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+# endif
+
+    if (err != 0)
+    {
+        dwarn("Fail to set thread affinity to cpus %s. err = %d", cpus.to_string().c_str(), err);
+        return false;
+    }
+
+    set_current_numa_node(numa_topology::instance().node_of_cpus(cpus));
+    return true;
+}
+
+int get_current_numa_node()
+{
+    return tls_numa_node;
+}
+
+void set_current_numa_node(int node)
+{
+    tls_numa_node = node;
+}
+
+} // end namespace
@@ -0,0 +1,92 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for cpu_set and numa_topology.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include <dsn/tool-api/numa.h>
+# include <gtest/gtest.h>
+# include <thread>
+
+using namespace ::dsn;
+
+TEST(core, cpu_set_parse)
+{
+    cpu_set cpus;
+    ASSERT_TRUE(cpu_set::parse("0-3,8,62-65,130", cpus));
+    EXPECT_EQ(10, cpus.count());
+    EXPECT_EQ(130, cpus.max_cpu());
+    EXPECT_TRUE(cpus.contains(64));
+    EXPECT_FALSE(cpus.contains(7));
+    EXPECT_EQ("0-3,8,62-65,130", cpus.to_string());
+
+    // nth is taken modulo count
+    EXPECT_EQ(0, cpus.nth(0));
+    EXPECT_EQ(8, cpus.nth(4));
+    EXPECT_EQ(130, cpus.nth(9));
+    EXPECT_EQ(0, cpus.nth(10));
+
+    EXPECT_FALSE(cpu_set::parse("3-1", cpus));
+    EXPECT_FALSE(cpu_set::parse("1,x", cpus));
+    ASSERT_TRUE(cpu_set::parse("", cpus));
+    EXPECT_TRUE(cpus.empty());
+    EXPECT_EQ(-1, cpus.nth(0));
+
+    cpus = cpu_set::from_mask(0x8000000000000005ULL);
+    EXPECT_EQ("0,2,63", cpus.to_string());
+    cpus.merge(cpu_set::from_mask(0x2));
+    EXPECT_EQ("0-2,63", cpus.to_string());
+}
+
+TEST(core, numa_topology)
+{
+    auto& topology = numa_topology::instance();
+    ASSERT_GE(topology.node_count(), 1);
+
+    cpu_set all;
+    for (int i = 0; i < topology.node_count(); i++)
+    {
+        EXPECT_FALSE(topology.node_cpus(i).empty());
+        EXPECT_EQ(i, topology.node_of_cpus(topology.node_cpus(i)));
+        all.merge(topology.node_cpus(i));
+    }
+    EXPECT_EQ(all.to_string(), topology.all_cpus().to_string());
+
+    std::thread t([&topology]()
+    {
+        EXPECT_EQ(-1, get_current_numa_node());
+        if (bind_current_thread_to_cpus(topology.node_cpus(0)))
+        {
+            EXPECT_EQ(0, get_current_numa_node());
+        }
+    });
+    t.join();
+}
@@ -36,6 +36,8 @@
 # include <dsn/utility/priority_queue.h>
 # include <gtest/gtest.h>
 # include <thread>
+# include <atomic>
+# include <vector>
 
 using namespace ::dsn::utils;
 
@@ -155,3 +157,111 @@ TEST(core, blocking_priority_queue)
     t1.join();
     t2.join();
 }
+
+TEST(core, blocking_priority_queue_idle_policy)
+{
+    const int producer_count = 3, consumer_count = 4, item_count = 20000;
+
+    for (int spin_us : { 0, 50 })
+    {
+        my_blocking_priority_queue q("my_blocking_priority_queue_idle");
+        q.set_idle_policy(spin_us, spin_us);
+
+        std::atomic<int> consumed(0), spin_hits(0), wakeups(0);
+        std::vector<std::thread> consumers;
+        for (int i = 0; i < consumer_count; i++)
+        {
+            consumers.emplace_back([&q, &consumed, &spin_hits]() {
+                while (true)
+                {
+                    long ct;
+                    idle_wait_result wr;
+                    queue_data* d = q.dequeue(ct, 0xffffffff, &wr);
+                    ASSERT_NE(nullptr, d);
+                    if (wr.spin_hit)
+                        spin_hits++;
+                    bool stop = (d->queue_index < 0);
+                    delete d;
+                    if (stop)
+                        break;
+                    consumed++;
+                }
+            });
+        }
+
+        std::vector<std::thread> producers;
+        for (int i = 0; i < producer_count; i++)
+        {
+            producers.emplace_back([&q, &wakeups, i]() {
+                for (int j = 0; j < item_count; j++)
+                {
+                    int woken;
+                    q.enqueue(new queue_data(j % 3, i), j % 3, woken);
+                    wakeups += woken;
+                    if (j % 1000 == 0)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+
+        for (auto& t : producers)
+            t.join();
+
+        // stop the consumers after all items are consumed, as items are not dequeued in fifo order
+        for (int i = 0; i < 10000 && consumed.load() < producer_count * item_count; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // before the stop items can wake anyone up, so a lost wakeup shows here
+        EXPECT_EQ(producer_count * item_count, consumed.load());
+        for (int i = 0; i < consumer_count; i++)
+        {
+            int woken;
+            q.enqueue(new queue_data(2, -1), 2, woken);
+        }
+        for (auto& t : consumers)
+            t.join();
+
+        // every item is consumed, while workers are not woken up per item
+        ASSERT_EQ(producer_count * item_count, consumed.load());
+        ASSERT_EQ(0, q.count());
+        ASSERT_LT(wakeups.load(), producer_count * item_count);
+        if (spin_us == 0)
+        {
+            ASSERT_EQ(0, spin_hits.load());
+        }
+    }
+}
+
+struct queue_data_deadline
+{
+    uint64_t operator()(queue_data* d) const { return static_cast<uint64_t>(d->queue_index); }
+};
+
+typedef priority_queue<queue_data*, 3, deadline_queue<queue_data*, queue_data_deadline>> my_deadline_priority_queue;
+TEST(core, deadline_priority_queue)
+{
+    my_deadline_priority_queue q("my_deadline_priority_queue");
+
+    // queue_index as the deadline
+    std::vector<queue_data> datas;
+    datas.push_back(queue_data(1, 30));
+    datas.push_back(queue_data(1, 10));
+    datas.push_back(queue_data(2, 50));
+    datas.push_back(queue_data(1, 20));
+    datas.push_back(queue_data(1, 10));
+    datas.push_back(queue_data(0, 5));
+
+    for (auto& d : datas)
+    {
+        q.enqueue(&d, d.priority);
+    }
+
+    // higher priority first, then earlier deadline, then FIFO
+    std::vector<queue_data*> expected = { &datas[2], &datas[1], &datas[4], &datas[3], &datas[0], &datas[5] };
+    for (auto e : expected)
+    {
+        long ct;
+        ASSERT_EQ(e, q.dequeue(ct));
+    }
+    ASSERT_EQ(0, q.count());
+}
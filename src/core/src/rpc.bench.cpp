@@ -0,0 +1,199 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     micro benchmarks for rpc messages, the client matcher and the
+ *     message parsers
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "micro_benchmark.h"
+# include "message_parser_manager.h"
+# include "rpc_engine.h"
+# include <dsn/tool-api/rpc_message.h>
+# include <dsn/cpp/serialization.h>
+
+using namespace ::dsn;
+
+DEFINE_TASK_CODE_RPC(RPC_CODE_FOR_BENCHMARK, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+
+BENCHMARK(core, message_ex_create_request)
+{
+    state.run([&]()
+    {
+        message_ex* m = message_ex::create_request(RPC_CODE_FOR_BENCHMARK, 1000, 0);
+        m->add_ref();
+        m->release_ref();
+    });
+}
+
+BENCHMARK(core, message_ex_create_response)
+{
+    message_ex* request = message_ex::create_request(RPC_CODE_FOR_BENCHMARK, 1000, 0);
+    request->add_ref();
+    state.run([&]()
+    {
+        message_ex* m = request->create_response();
+        m->add_ref();
+        m->release_ref();
+    });
+    request->release_ref();
+}
+
+BENCHMARK(core, message_ex_serialize_256)
+{
+    std::string value(256, 'x');
+    state.set_bytes_per_op(value.length());
+    state.run([&]()
+    {
+        message_ex* m = message_ex::create_request(RPC_CODE_FOR_BENCHMARK, 1000, 0);
+        m->add_ref();
+        ::dsn::marshall((dsn_message_t)m, value);
+        m->release_ref();
+    });
+}
+
+// register a request in the matcher of the current node, and match it with
+// an empty reply which terminates it early, i.e., what a call and its reply
+// cost in the matcher, plus the response task enqueue
+BENCHMARK(core, rpc_client_matcher_call_reply)
+{
+    rpc_client_matcher* matcher = task::get_current_rpc()->matcher();
+    service_node* node = task::get_current_node();
+    state.run([&]()
+    {
+        message_ex* request = message_ex::create_request(RPC_CODE_FOR_BENCHMARK, 10000, 0);
+        rpc_response_task* call = new rpc_response_task(request, nullptr, nullptr, nullptr, 0, node);
+        matcher->on_call(request, call);
+        matcher->on_recv_reply(nullptr, request->header->id, nullptr, 0);
+    });
+}
+
+//
+// the parsers come from the plugin modules, so they are created through
+// the parser manager with their registered header formats
+//
+static message_parser* create_parser(const char* format)
+{
+    auto fmt = network_header_format::from_string(format, NET_HDR_INVALID);
+    dassert(fmt != NET_HDR_INVALID, "header format %s is not registered, load dsn.tools.common in [modules]", format);
+    return message_parser_manager::instance().create_parser(fmt);
+}
+
+static void parse_benchmark(::dsn::bench::benchmark_state& state, message_parser* parser, const std::string& bytes)
+{
+    message_reader reader(64 * 1024);
+    state.set_bytes_per_op(bytes.length());
+    state.run([&]()
+    {
+        char* ptr = reader.read_buffer_ptr((unsigned int)bytes.length());
+        memcpy(ptr, bytes.data(), bytes.length());
+        reader.mark_read((unsigned int)bytes.length());
+
+        int read_next;
+        message_ex* msg = parser->get_message_on_receive(&reader, read_next);
+        dassert(msg != nullptr, "parse message failed, read_next = %d", read_next);
+        msg->add_ref();
+        msg->release_ref();
+    });
+    delete parser;
+}
+
+BENCHMARK(core, dsn_message_parser_256)
+{
+    message_parser* parser = create_parser("NET_HDR_DSN");
+
+    // the bytes sent for a request with a 256-byte body
+    message_ex* request = message_ex::create_request(RPC_CODE_FOR_BENCHMARK, 1000, 0);
+    request->add_ref();
+    ::dsn::marshall((dsn_message_t)request, std::string(256, 'x'));
+    parser->prepare_on_send(request);
+    std::vector<message_parser::send_buf> buffers(parser->get_buffer_count_on_send(request));
+    int count = parser->get_buffers_on_send(request, &buffers[0]);
+
+    std::string bytes;
+    for (int i = 0; i < count; i++)
+        bytes.append((const char*)buffers[i].buf, buffers[i].sz);
+    request->release_ref();
+
+    parse_benchmark(state, parser, bytes);
+}
+
+static void append_be32(std::string& s, uint32_t v)
+{
+    char b[4] = { (char)(v >> 24), (char)(v >> 16), (char)(v >> 8), (char)v };
+    s.append(b, 4);
+}
+
+BENCHMARK(core, thrift_message_parser_256)
+{
+    message_parser* parser = create_parser("NET_HDR_THRIFT");
+
+    // thrift binary call of RPC_CODE_FOR_BENCHMARK(1: string) with a 256-byte string
+    std::string name = dsn_task_code_to_string(RPC_CODE_FOR_BENCHMARK);
+    std::string body;
+    append_be32(body, 0x80010001); // VERSION_1 | T_CALL
+    append_be32(body, (uint32_t)name.length());
+    body.append(name);
+    append_be32(body, 1); // seqid
+    body.push_back((char)11); // T_STRING
+    body.push_back((char)0);
+    body.push_back((char)1); // field id
+    append_be32(body, 256);
+    body.append(256, 'x');
+    body.push_back((char)0); // T_STOP
+
+    std::string bytes("THFT", 4);
+    append_be32(bytes, 0); // hdr_version
+    append_be32(bytes, 48); // hdr_length
+    append_be32(bytes, 0); // hdr_crc32
+    append_be32(bytes, (uint32_t)body.length());
+    append_be32(bytes, 0); // body_crc32
+    append_be32(bytes, 1); // app_id
+    append_be32(bytes, 0); // partition_index
+    append_be32(bytes, 1000); // client_timeout
+    append_be32(bytes, 0); // client_thread_hash
+    append_be32(bytes, 0); // client_partition_hash
+    append_be32(bytes, 0);
+    bytes.append(body);
+
+    parse_benchmark(state, parser, bytes);
+}
+
+BENCHMARK(core, http_message_parser_256)
+{
+    message_parser* parser = create_parser("NET_HDR_HTTP");
+
+    std::string bytes = std::string("POST /DSF_THRIFT_JSON/0/")
+        + dsn_task_code_to_string(RPC_CODE_FOR_BENCHMARK)
+        + " HTTP/1.1\r\nContent-Length: 256\r\n\r\n"
+        + std::string(256, 'x');
+
+    parse_benchmark(state, parser, bytes);
+}
@@ -801,6 +801,66 @@ namespace dsn {
 
     DEFINE_TASK_CODE(LPC_RPC_DELAY_CALL, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
 
+    // replacement response callback for uri calls, with timeout_ts_ms as the
+    // preallocated hook state kept in rpc_response_task (no allocation per call)
+    static void rpc_uri_call_response_hook(
+        dsn_rpc_response_handler_t callback,
+        dsn_error_t err,
+        dsn_message_t req,
+        dsn_message_t resp,
+        void* context,
+        uint64_t timeout_ts_ms)
+    {
+        auto req2 = (message_ex*)(req);
+        if (req2->header->gpid.value != 0 && err != ERR_OK && err != ERR_HANDLER_NOT_FOUND)
+        {
+            auto resolver = req2->server_address.uri_address()->get_resolver();
+            if (nullptr != resolver)
+            {
+                resolver->on_access_failure(req2->header->gpid.u.partition_index, err);
+
+                // still got time, retry
+                uint64_t nms = dsn_now_ms();
+                uint64_t gap = 8 << req2->send_retry_count;
+                if (gap > 1000)
+                    gap = 1000;
+                if (nms + gap < timeout_ts_ms)
+                {
+                    req2->send_retry_count++;
+                    req2->header->client.timeout_ms = static_cast<int>(timeout_ts_ms - nms - gap);
+                    auto ctask = dynamic_cast<rpc_response_task*>(task::get_current_task());
+                    ctask->reset_callback();
+                    ctask->set_retry(false);
+                    ctask->add_ref(); // released later after dsn_rpc_call
+
+                    // sleep 10 milliseconds before retry
+                    tasking::enqueue(
+                        LPC_RPC_DELAY_CALL,
+                        nullptr,
+                        [server = req2->server_address.c_addr(), ctask]()
+                        {
+                            dsn_rpc_call(server, ctask);
+                            ctask->release_ref(); // added when set-retry
+                        },
+                        0,
+                        std::chrono::milliseconds(gap)
+                        );
+                    return;
+                }
+                else
+                {
+                    derror("service access failed (%s), no more time for further tries, set error = ERR_TIMEOUT, trace_id = %016" PRIx64,
+                        error_code(err).to_string(), req2->header->trace_id);
+                    err = ERR_TIMEOUT;
+                }
+            }
+        }
+
+        // any other cases (except return above)
+        if (callback)
+            callback(err, req, resp, context);
+    }
+
     void rpc_engine::call_uri(rpc_address addr, message_ex* request, rpc_response_task* call)
     {
         dbg_dassert(addr.type() == HOST_TYPE_URI, "only URI is now supported");
@@ -822,110 +882,82 @@ namespace dsn {
                 request->release_ref();
             }
         }
-        else // resolver != nullptr
+        else if (call != nullptr)
         {
-            if (call)
-            {
-                call->replace_callback(
-                    [](dsn_rpc_response_handler_t callback,
-                        dsn_error_t err,
-                        dsn_message_t req,
-                        dsn_message_t resp,
-                        void* context,
-                        uint64_t timeout_ts_ms)
-                    {
-                        auto req2 = (message_ex*)(req);
-                        if (req2->header->gpid.value != 0 && err != ERR_OK && err != ERR_HANDLER_NOT_FOUND)
-                        {
-                            auto resolver = req2->server_address.uri_address()->get_resolver();
-                            if (nullptr != resolver)
-                            {
-                                resolver->on_access_failure(req2->header->gpid.u.partition_index, err);
-
-                                // still got time, retry
-                                uint64_t nms = dsn_now_ms();
-                                uint64_t gap = 8 << req2->send_retry_count;
-                                if (gap > 1000)
-                                    gap = 1000;
-                                if (nms + gap < timeout_ts_ms)
-                                {
-                                    req2->send_retry_count++;
-                                    req2->header->client.timeout_ms = static_cast<int>(timeout_ts_ms - nms - gap);
-                                    auto ctask = dynamic_cast<rpc_response_task*>(task::get_current_task());
-                                    ctask->reset_callback();
-                                    ctask->set_retry(false);
-                                    ctask->add_ref(); // released later after dsn_rpc_call
-                                                                        
-                                    // sleep 10 milliseconds before retry
-                                    tasking::enqueue(
-                                        LPC_RPC_DELAY_CALL,
-                                        nullptr,
-                                        [server = req2->server_address.c_addr(), ctask]()
-                                        {
-                                            dsn_rpc_call(server, ctask);
-                                            ctask->release_ref(); // added when set-retry
-                                        },
-                                        0,
-                                        std::chrono::milliseconds(gap)
-                                        );
-                                    return;
-                                }
-                                else
-                                {
-                                    derror("service access failed (%s), no more time for further tries, set error = ERR_TIMEOUT, trace_id = %016" PRIx64,
-                                        error_code(err).to_string(), req2->header->trace_id);
-                                    err = ERR_TIMEOUT;
-                                }
-                            }
-                        }
-                        
-                        // any other cases (except return above)
-                        if (callback)
-                            callback(err, req, resp, context);
-                    },
-                    dsn_now_ms() + hdr.client.timeout_ms
-                    );
-            }
+            call->replace_callback(rpc_uri_call_response_hook, dsn_now_ms() + hdr.client.timeout_ms);
 
+            // the resolver is captured so that a failure invalidates the one
+            // actually used, it is alive whenever it invokes this callback
+            auto r = resolver.get();
             resolver->resolve(
                 hdr.client.partition_hash,
-                [=](dist::partition_resolver::resolve_result&& result) mutable
+                [this, call, r](dist::partition_resolver::resolve_result&& result)
                 {
-                    if (result.err == ERR_OK)
-                    {
-                        // update gpid when necessary
-                        auto& hdr2 = request->header;
-                        if (hdr2->gpid.value != result.pid.value)
-                        {
-                            dassert(hdr2->gpid.value == 0, "inconsistent gpid");
-                            hdr2->gpid = result.pid;
-
-                            // update thread hash if not assigned by applications
-                            if (hdr2->client.thread_hash == 0)
-                            {
-                                hdr2->client.thread_hash = dsn_gpid_to_thread_hash(result.pid);
-                            }
-                        }
-
-                        call_address(result.address, request, call);
-                    }
-                    else
-                    {                        
-                        if (call != nullptr)
-                        {
-                            call->enqueue(result.err, nullptr);
-                        }
-                        else
-                        {
-                            // as ref_count for request may be zero
-                            request->add_ref();
-                            request->release_ref();
-                        }
-                    }
+                    on_uri_resolved(result, call->get_request(), call, r);
                 },
                 hdr.client.timeout_ms
                 );
         }
+        else
+        {
+            auto r = resolver.get();
+            resolver->resolve(
+                hdr.client.partition_hash,
+                [this, request, r](dist::partition_resolver::resolve_result&& result)
+                {
+                    on_uri_resolved(result, request, nullptr, r);
+                },
+                hdr.client.timeout_ms
+                );
+        }
+    }
+
+    void rpc_engine::on_uri_resolved(
+        dist::partition_resolver::resolve_result& result,
+        message_ex* request,
+        rpc_response_task* call,
+        dist::partition_resolver* resolver
+        )
+    {
+        if (result.err == ERR_OK)
+        {
+            // update gpid when necessary
+            auto& hdr2 = request->header;
+            if (hdr2->gpid.value != result.pid.value)
+            {
+                dassert(hdr2->gpid.value == 0, "inconsistent gpid");
+                hdr2->gpid = result.pid;
+
+                // update thread hash if not assigned by applications
+                if (hdr2->client.thread_hash == 0)
+                {
+                    hdr2->client.thread_hash = dsn_gpid_to_thread_hash(result.pid);
+                }
+            }
+
+            call_address(result.address, request, call);
+        }
+        else
+        {
+            // the app is gone (e.g., dropped and re-created), so the resolver used by
+            // this call is stale and must be re-created for later calls; it is not
+            // necessarily the current one, which may have been refreshed meanwhile
+            if (result.err == ERR_APP_NOT_EXIST)
+            {
+                request->server_address.uri_address()->invalidate_resolver(resolver);
+            }
+
+            if (call != nullptr)
+            {
+                call->enqueue(result.err, nullptr);
+            }
+            else
+            {
+                // as ref_count for request may be zero
+                request->add_ref();
+                request->release_ref();
+            }
+        }
     }
 
     void rpc_engine::call_group(rpc_address addr, message_ex* request, rpc_response_task* call)
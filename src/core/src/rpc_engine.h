@@ -37,6 +37,7 @@
 
 # include <dsn/tool-api/task.h>
 # include <dsn/tool-api/network.h>
+# include <dsn/tool-api/partition_resolver.h>
 # include <dsn/utility/synchronize.h>
 # include <dsn/tool-api/global_config.h>
 # include <dsn/utility/configuration.h>
@@ -166,6 +167,7 @@ public:
 
     // call with URI address only
     void call_uri(rpc_address addr, message_ex* request, rpc_response_task* call);
+    void on_uri_resolved(dist::partition_resolver::resolve_result& result, message_ex* request, rpc_response_task* call, dist::partition_resolver* resolver);
 
     // call with group address only
     void call_group(rpc_address addr, message_ex* request, rpc_response_task* call);
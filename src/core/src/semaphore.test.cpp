@@ -34,8 +34,11 @@
  */
 
 # include <dsn/ext/hpc-locks/sema.h>
+# include <dsn/utility/synchronize.h>
 # include <gtest/gtest.h>
+# include <atomic>
 # include <thread>
+# include <vector>
 
 TEST(core, Semaphore)
 {
@@ -111,3 +114,132 @@ TEST(core, LightweightSemaphore)
     t2.join();
 }
 
+
+TEST(core, address_wait)
+{
+    std::atomic<int> word(0);
+
+    // value differs, or timeout
+    ASSERT_TRUE(dsn::utils::address_wait::wait(&word, 1, 10));
+    ASSERT_FALSE(dsn::utils::address_wait::wait(&word, 0, 10));
+
+    std::atomic<int> woken(0);
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; i++)
+    {
+        waiters.emplace_back([&word, &woken]()
+        {
+            while (word.load() == 0)
+                dsn::utils::address_wait::wait(&word, 0);
+            ++woken;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    word.store(1);
+    dsn::utils::address_wait::wake_all(&word);
+
+    for (auto& w : waiters)
+        w.join();
+    ASSERT_EQ(4, woken.load());
+}
+
+TEST(core, spin_park_semaphore_no_lost_wakeup)
+{
+    const int producer_count = 4, consumer_count = 4, signal_count = 20000;
+    const int total = producer_count * signal_count;
+    const int timeout_ms = 5000;
+
+    for (int spin_us : { 0, 20 })
+    {
+        dsn::utils::spin_park_semaphore s(spin_us, spin_us);
+        std::atomic<int> acquired(0), timeouts(0), late(0);
+
+        // every consumer takes a fixed share of the tokens, so a lost wakeup
+        // either times a wait out or leaves a token unclaimed for the whole timeout
+        std::vector<std::thread> consumers;
+        for (int i = 0; i < consumer_count; i++)
+        {
+            consumers.emplace_back([&]()
+            {
+                for (int j = 0; j < total / consumer_count; j++)
+                {
+                    dsn::utils::idle_wait_result r;
+                    if (!s.wait(timeout_ms, &r))
+                        ++timeouts;
+                    else if (r.park_ns >= (uint64_t)timeout_ms * 1000000ULL)
+                        ++late;
+                    else
+                        ++acquired;
+                }
+            });
+        }
+
+        std::vector<std::thread> producers;
+        for (int i = 0; i < producer_count; i++)
+        {
+            producers.emplace_back([&, i]()
+            {
+                for (int j = 0; j < signal_count; )
+                {
+                    // single and batched signals, with pauses so that the consumers park
+                    int count = (i % 2 == 0) ? 1 : std::min(1 + j % 4, signal_count - j);
+                    s.signal(count);
+                    j += count;
+                    if (j % 2000 < count)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+
+        for (auto& t : producers)
+            t.join();
+        for (auto& t : consumers)
+            t.join();
+
+        ASSERT_EQ(0, timeouts.load());
+        ASSERT_EQ(0, late.load());
+        ASSERT_EQ(total, acquired.load());
+
+        // and no token is left over
+        ASSERT_FALSE(s.wait(0));
+    }
+}
+
+TEST(core, spin_park_semaphore_wake_parked)
+{
+    const int waiter_count = 4;
+    dsn::utils::spin_park_semaphore s;
+
+    for (int batch : { 1, waiter_count })
+    {
+        std::atomic<int> woken(0), parked(0);
+        std::vector<std::thread> waiters;
+        for (int i = 0; i < waiter_count; i++)
+        {
+            waiters.emplace_back([&]()
+            {
+                dsn::utils::idle_wait_result r;
+                if (s.wait(5000, &r))
+                    ++woken;
+                if (r.parked)
+                    ++parked;
+            });
+        }
+
+        // without spinning the waiters park right away
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        int signaled = 0;
+        for (int i = 0; i < waiter_count; i += batch)
+            signaled += s.signal(batch);
+
+        for (auto& t : waiters)
+            t.join();
+
+        // each token wakes exactly one parked waiter
+        EXPECT_EQ(waiter_count, signaled);
+        EXPECT_EQ(waiter_count, woken.load());
+        EXPECT_EQ(waiter_count, parked.load());
+        EXPECT_FALSE(s.wait(0));
+    }
+}
@@ -141,7 +141,7 @@ __thread uint16_t tls_dsn_lower32_task_id_mask = 0;
 }
 
 task::task(dsn_task_code_t code, void* context, dsn_task_cancelled_handler_t on_cancel, int hash, service_node* node)
-    : _state(TASK_STATE_READY), _wait_event(nullptr)
+    : _state(TASK_STATE_READY), _wait_count(0)
 {
     _spec = task_spec::get(code);
     _context = context;
@@ -174,14 +174,7 @@ task::task(dsn_task_code_t code, void* context, dsn_task_cancelled_handler_t on_
 
 task::~task()
 {
-    // ATTENTION: should do unset_tracker defore delete _wait_event
     _context_tracker.unset_tracker();
-
-    if (nullptr != _wait_event.load())
-    {
-        delete (utils::notify_event*)_wait_event.load();
-        _wait_event.store(nullptr);
-    }
 }
 
 bool task::set_retry(bool enqueue_immediately /*= true*/)
@@ -212,7 +205,9 @@ void task::exec_internal()
         _spec->on_task_begin.execute(this);
 
         exec();
-        if (_state.compare_exchange_strong(RUNNING_STATE, TASK_STATE_FINISHED, std::memory_order_release, std::memory_order_relaxed))
+
+        // seq_cst state changes pair with the seq_cst _wait_count updates in wait()
+        if (_state.compare_exchange_strong(RUNNING_STATE, TASK_STATE_FINISHED, std::memory_order_seq_cst, std::memory_order_relaxed))
         {
             _spec->on_task_end.execute(this);
         }
@@ -230,7 +225,7 @@ void task::exec_internal()
             else
             {
                 // for cancelled
-                if (_state.compare_exchange_strong(READY_STATE, TASK_STATE_CANCELLED, std::memory_order_release, std::memory_order_relaxed))
+                if (_state.compare_exchange_strong(READY_STATE, TASK_STATE_CANCELLED, std::memory_order_seq_cst, std::memory_order_relaxed))
                 {
                     _spec->on_task_cancelled.execute(this);
                 }
@@ -252,11 +247,9 @@ void task::exec_internal()
     // inline for performance
     if (notify_if_necessary)
     {
-        void* evt = _wait_event.load();
-        if (evt != nullptr)
+        if (_wait_count.load() > 0)
         {
-            auto nevt = (utils::notify_event*)evt;
-            nevt->notify();
+            utils::address_wait::wake_all(&_state);
             spec().on_task_wait_notified.execute(this);
         }
     }    
@@ -272,11 +265,9 @@ void task::exec_internal()
 
 void task::signal_waiters()
 {
-    void* evt = _wait_event.load();
-    if (evt != nullptr)
+    if (_wait_count.load() > 0)
     {
-        auto nevt = (utils::notify_event*)evt;
-        nevt->notify();
+        utils::address_wait::wake_all(&_state);
     }
 }
 
@@ -297,27 +288,38 @@ bool task::wait(int timeout_milliseconds, bool on_cancel)
         return true;
     }
 
-    // TODO: using event pool instead
-    void* evt = _wait_event.load();
-    if (evt == nullptr)
-    {
-        evt = new utils::notify_event();
-
-        void* null_h = nullptr;
-        if (!_wait_event.compare_exchange_strong(null_h, evt))
-        {
-            delete (utils::notify_event*)evt;
-            evt = _wait_event.load();
-        }
-    }
-
     spec().on_task_wait_pre.execute(get_current_task(), this, (uint32_t)timeout_milliseconds);
 
+    // wait on the state word directly, so no event is allocated, 
+    // and signalers only wake when there are waiters (_wait_count)
     bool ret = (state() >= TASK_STATE_FINISHED);
     if (!ret)
     {
-        auto nevt = (utils::notify_event*)evt;
-        ret = (nevt->wait_for(timeout_milliseconds));
+        bool infinite = (TIME_MS_MAX == static_cast<unsigned int>(timeout_milliseconds));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(infinite ? 0 : timeout_milliseconds);
+
+        _wait_count.fetch_add(1);
+        while (true)
+        {
+            auto s = _state.load();
+            if (s >= TASK_STATE_FINISHED)
+            {
+                ret = true;
+                break;
+            }
+
+            int wait_ms = timeout_milliseconds;
+            if (!infinite)
+            {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                if (remaining <= 0)
+                    break;
+                wait_ms = static_cast<int>(remaining);
+            }
+
+            utils::address_wait::wait(&_state, s, wait_ms);
+        }
+        _wait_count.fetch_sub(1);
     }
 
     spec().on_task_wait_post.execute(get_current_task(), this, ret);
@@ -345,7 +347,7 @@ bool task::cancel(bool wait_until_finished, /*out*/ bool* finished /*= nullptr*/
         return false;
     }
     
-    if (_state.compare_exchange_strong(READY_STATE, TASK_STATE_CANCELLED, std::memory_order_relaxed))
+    if (_state.compare_exchange_strong(READY_STATE, TASK_STATE_CANCELLED, std::memory_order_seq_cst, std::memory_order_relaxed))
     {
         succ = true;
         finish = true;
@@ -556,7 +558,9 @@ rpc_request_task::rpc_request_task(message_ex* request, rpc_handler_info* h, ser
         node),
     _request(request),
     _handler(h),
-    _enqueue_ts_ns(0)
+    _enqueue_ts_ns(0),
+    _deadline_ns(0),
+    _dropped(false)
 {
     dbg_dassert (TASK_TYPE_RPC_REQUEST == spec().type, 
         "%s is not a RPC_REQUEST task, please use DEFINE_TASK_CODE_RPC to define the task code",
@@ -656,17 +660,7 @@ void rpc_response_task::enqueue()
     }
 }
 
-struct hook_context : public transient_object
-{
-    dsn_rpc_response_handler_t old_callback;
-    dsn_task_cancelled_handler_t old_on_cancel;
-    void* old_context;
-
-    dsn_rpc_response_handler_replace_t new_callback;
-    uint64_t new_context;
-};
-
-static void rpc_response_task_hook_callback(dsn_error_t err, dsn_message_t req, dsn_message_t resp, void* ctx)
+void rpc_response_task::hook_callback(dsn_error_t err, dsn_message_t req, dsn_message_t resp, void* ctx)
 {
     auto nc = (hook_context*)ctx;
     nc->new_callback(
@@ -677,54 +671,46 @@ static void rpc_response_task_hook_callback(dsn_error_t err, dsn_message_t req,
         nc->old_context,
         nc->new_context
     );
-    delete nc;
-};
+}
 
-static void rpc_response_task_hook_on_cancel(void* ctx)
+void rpc_response_task::hook_on_cancel(void* ctx)
 {
     auto nc = (hook_context*)ctx;
     if (nc->old_on_cancel != nullptr)
     {
         nc->old_on_cancel(nc->old_context);
     }
-    delete nc;
 }
 
 void rpc_response_task::replace_callback(dsn_rpc_response_handler_replace_t callback, uint64_t context)
 {
-    hook_context* nc = new hook_context();
-    nc->old_callback = _cb;
-    nc->old_context = _context;
-    nc->old_on_cancel = _on_cancel;
-    nc->new_callback = callback;
-    nc->new_context = context;
+    dassert(_cb != hook_callback, "callback can only be replaced once before reset_callback is called");
 
-    _context = nc;
-    _cb = rpc_response_task_hook_callback;
-    _on_cancel = rpc_response_task_hook_on_cancel;
+    _hook.old_callback = _cb;
+    _hook.old_context = _context;
+    _hook.old_on_cancel = _on_cancel;
+    _hook.new_callback = callback;
+    _hook.new_context = context;
+
+    _context = &_hook;
+    _cb = hook_callback;
+    _on_cancel = hook_on_cancel;
     _is_null = false;
 }
 
 bool rpc_response_task::reset_callback()
 {
-    if (_cb == rpc_response_task_hook_callback && _on_cancel == rpc_response_task_hook_on_cancel)
+    if (_cb == hook_callback && _on_cancel == hook_on_cancel)
     {
         if (state() != TASK_STATE_READY &&
             state() != TASK_STATE_RUNNING)
             return false;
 
         // ready or running
-        auto nc = (hook_context*)_context;
-        _context = nc->old_context;
-        _cb = nc->old_callback;
-        _on_cancel = nc->old_on_cancel;
+        _context = _hook.old_context;
+        _cb = _hook.old_callback;
+        _on_cancel = _hook.old_on_cancel;
         _is_null = (_cb == nullptr);
-
-        if (state() != TASK_STATE_RUNNING)
-        {
-            delete nc;
-        }
-
         return true;
     }
     else
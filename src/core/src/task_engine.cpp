@@ -36,6 +36,9 @@
 # include "task_engine.h"
 # include <dsn/tool-api/perf_counter.h>
 # include <dsn/utility/factory_store.h>
+# include <dsn/cpp/utils.h>
+# include <algorithm>
+# include <cstdlib>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -52,13 +55,72 @@ task_worker_pool::task_worker_pool(const threadpool_spec& opts, task_engine* own
 {
     _is_running = false;
     _per_node_timer_svc = nullptr;
+
+    _elastic = false;
+    _max_worker_count = _spec.worker_count;
+    _active_worker_count.store(_spec.worker_count, std::memory_order_relaxed);
+    _scaler = nullptr;
+    _stopping = false;
+
+    _buckets = nullptr;
+    _bucket_count = 0;
+    _rebalancer = nullptr;
+}
+
+task_worker_pool::~task_worker_pool()
+{
+    stop();
+
+    delete[] _buckets;
+    _buckets = nullptr;
 }
 
 void task_worker_pool::create()
 {
     if (_is_running)
         return;
-    
+
+    auto& topology = numa_topology::instance();
+    if (_spec.worker_numa_nodes != "")
+    {
+        std::vector<std::string> nodes;
+        utils::split_args(_spec.worker_numa_nodes.c_str(), nodes, ',');
+        for (auto& n : nodes)
+        {
+            int node = atoi(n.c_str());
+            dassert(node >= 0 && node < topology.node_count(),
+                "invalid NUMA node %s in worker_numa_nodes of %s, there are %d nodes",
+                n.c_str(), _spec.name.c_str(), topology.node_count());
+            _numa_nodes.push_back(node);
+        }
+    }
+    else if (_spec.worker_affinity_cpus != "")
+    {
+        dassert(cpu_set::parse(_spec.worker_affinity_cpus.c_str(), _affinity_cpus) && !_affinity_cpus.empty(),
+            "invalid worker_affinity_cpus '%s' of %s", _spec.worker_affinity_cpus.c_str(), _spec.name.c_str());
+    }
+    else if (_spec.worker_affinity_mask > 0)
+    {
+        _affinity_cpus = cpu_set::from_mask(_spec.worker_affinity_mask);
+    }
+
+    if (_spec.worker_count_max > _spec.worker_count)
+    {
+        if (_spec.partitioned)
+        {
+            dwarn("worker_count_max is ignored for partitioned thread pool %s", _spec.name.c_str());
+        }
+        else if (service_engine::fast_instance().spec().tool == "simulator")
+        {
+            dwarn("worker_count_max is ignored for thread pool %s under simulator", _spec.name.c_str());
+        }
+        else
+        {
+            _elastic = true;
+            _max_worker_count = _spec.worker_count_max;
+        }
+    }
+
     int qCount = _spec.partitioned ?  _spec.worker_count : 1;
     for (int i = 0; i < qCount; i++)
     {
@@ -93,7 +155,9 @@ void task_worker_pool::create()
         }
     }
 
-    for (int i = 0; i < _spec.worker_count; i++)
+    // all workers are created here for elastic pools, while only 
+    // worker_count of them are started in start()
+    for (int i = 0; i < _max_worker_count; i++)
     {
         auto q = _queues[qCount == 1 ? 0 : i];
         task_worker* worker = factory_store<task_worker>::create(_spec.worker_factory_name.c_str(), PROVIDER_TYPE_MAIN, this, q, i, nullptr);
@@ -108,6 +172,128 @@ void task_worker_pool::create()
 
         _workers.push_back(worker);
     }
+
+    if (_spec.partitioned && _spec.numa_local_thread_hash && !_numa_nodes.empty())
+    {
+        // nodes are in the order of their first worker
+        std::vector<int> slots(topology.node_count(), -1);
+        for (int i = 0; i < _spec.worker_count; i++)
+        {
+            int node = worker_numa_node(i);
+            if (slots[node] == -1)
+            {
+                slots[node] = static_cast<int>(_numa_node_queues.size());
+                _numa_node_queues.emplace_back();
+            }
+            _numa_node_queues[slots[node]].push_back(static_cast<unsigned int>(i));
+        }
+    }
+
+    if (_spec.partitioned && _spec.partition_bucket_count > 0)
+    {
+        if (!_numa_node_queues.empty())
+        {
+            dwarn("partition_bucket_count is ignored for thread pool %s with numa_local_thread_hash", _spec.name.c_str());
+        }
+        else
+        {
+            _bucket_count = _spec.partition_bucket_count;
+            _buckets = new partition_bucket[_bucket_count];
+            for (int i = 0; i < _bucket_count; i++)
+            {
+                _buckets[i].state.store(static_cast<uint64_t>(i % _spec.worker_count) << 32, std::memory_order_relaxed);
+                _buckets[i].enqueued.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+size_t task_worker_pool::worker_numa_slot(int index) const
+{
+    // the always-on workers are evenly assigned to the nodes in order,
+    // and then so are the elastic ones
+    size_t nodes = _numa_nodes.size();
+    if (index < _spec.worker_count)
+        return index * nodes / _spec.worker_count;
+    else
+        return (index - _spec.worker_count) * nodes / (_max_worker_count - _spec.worker_count);
+}
+
+int task_worker_pool::worker_numa_node(int index) const
+{
+    if (_numa_nodes.empty())
+        return -1;
+
+    return _numa_nodes[worker_numa_slot(index)];
+}
+
+cpu_set task_worker_pool::worker_cpus(int index) const
+{
+    cpu_set cpus;
+    int local_index = index;
+    if (!_numa_nodes.empty())
+    {
+        size_t slot = worker_numa_slot(index);
+        cpus = numa_topology::instance().node_cpus(_numa_nodes[slot]);
+
+        // index among the workers assigned to the same node, the elastic ones after the others
+        local_index = 0;
+        for (int i = 0; i < index; i++)
+        {
+            if (worker_numa_slot(i) == slot)
+                local_index++;
+        }
+    }
+    else if (!_affinity_cpus.empty())
+    {
+        cpus = _affinity_cpus;
+    }
+    else if (_spec.worker_share_core)
+    {
+        return cpus;
+    }
+    else
+    {
+        cpus = numa_topology::instance().all_cpus();
+    }
+
+    if (_spec.worker_share_core)
+        return cpus;
+
+    cpu_set one;
+    one.add(cpus.nth(local_index));
+    return one;
+}
+
+unsigned int task_worker_pool::queue_index(task* t) const
+{
+    return queue_index_of_hash(t->hash());
+}
+
+unsigned int task_worker_pool::queue_index_of_hash(int hash) const
+{
+    if (!_spec.partitioned)
+        return 0;
+
+    if (_buckets != nullptr)
+        return static_cast<unsigned int>(_buckets[bucket_index(hash)].state.load(std::memory_order_acquire) >> 32);
+
+    unsigned int h = static_cast<unsigned int>(hash);
+    if (!_numa_node_queues.empty())
+    {
+        // a hash always maps to the same node and then the same worker on it,
+        // wherever it is enqueued from, so its tasks are still serialized
+        unsigned int nodes = static_cast<unsigned int>(_numa_node_queues.size());
+        auto& qs = _numa_node_queues[h % nodes];
+        return qs[(h / nodes) % static_cast<unsigned int>(qs.size())];
+    }
+
+    return h % static_cast<unsigned int>(_queues.size());
+}
+
+void task_worker_pool::on_partitioned_task_done(int hash)
+{
+    _buckets[bucket_index(hash)].state.fetch_sub(1, std::memory_order_release);
 }
 
 void task_worker_pool::start()
@@ -116,14 +302,19 @@ void task_worker_pool::start()
         return;
 
     for (auto& wk : _workers)
-        wk->start();
+    {
+        if (wk->index() < active_worker_count())
+            wk->start();
+    }
 
-    ddebug("[%s] thread pool [%s] started, pool_code = %s, worker_count = %d, worker_share_core = %s, partitioned = %s, ...",
+    ddebug("[%s] thread pool [%s] started, pool_code = %s, worker_count = %d, worker_count_max = %d, worker_share_core = %s, partitioned = %s, numa_nodes = %s, ...",
         _node->name(), _spec.name.c_str(),
         dsn_threadpool_code_to_string(_spec.pool_code),
         _spec.worker_count,
+        _max_worker_count,
         _spec.worker_share_core ? "true" : "false",
-        _spec.partitioned ? "true" : "false");
+        _spec.partitioned ? "true" : "false",
+        _spec.worker_numa_nodes != "" ? _spec.worker_numa_nodes.c_str() : "none");
 
     // setup cached ptrs for fast timer service access
     if (service_engine::fast_instance().spec().timer_io_mode == IOE_PER_QUEUE)
@@ -141,6 +332,260 @@ void task_worker_pool::start()
     }
 
     _is_running = true;
+
+    if (_elastic)
+    {
+        _active_workers_counter = perf_counter::get_counter(_node->name(), "engine", (_spec.name + ".active.workers").c_str(),
+            COUNTER_TYPE_NUMBER, "active workers of the elastic thread pool", true);
+        _queueing_delay_counter = perf_counter::get_counter(_node->name(), "engine", (_spec.name + ".queueing.delay(us)").c_str(),
+            COUNTER_TYPE_NUMBER, "estimated queueing delay (us) of the elastic thread pool", true);
+        _active_workers_counter->set(active_worker_count());
+
+        _scaler = new std::thread(std::bind(&task_worker_pool::scale_workers, this));
+    }
+
+    if (_buckets != nullptr)
+    {
+        _bucket_migrations_counter = perf_counter::get_counter(_node->name(), "engine", (_spec.name + ".bucket.migrations").c_str(),
+            COUNTER_TYPE_RATE, "how many partition buckets are migrated between workers per second", true);
+
+        _rebalancer = new std::thread(std::bind(&task_worker_pool::rebalance_partitions, this));
+    }
+}
+
+void task_worker_pool::stop()
+{
+    if (!_is_running || _stopping.exchange(true))
+        return;
+
+    if (_scaler != nullptr)
+    {
+        _scaler_event.notify();
+        _scaler->join();
+        delete _scaler;
+        _scaler = nullptr;
+    }
+
+    if (_rebalancer != nullptr)
+    {
+        _rebalancer_event.notify();
+        _rebalancer->join();
+        delete _rebalancer;
+        _rebalancer = nullptr;
+    }
+}
+
+//
+// the queueing delay is estimated using Little's law, i.e., 
+// queue length / throughput over the last interval, so that it does not 
+// depend on the profiler; one worker is activated per interval when the 
+// delay is above the target, and one is retired when the pool has been
+// idle (empty queue and delay below half of the target) for the cooldown
+//
+void task_worker_pool::scale_workers()
+{
+    task_worker::set_name((_spec.name + ".scaler").c_str());
+
+    auto interval = std::chrono::milliseconds(std::max(_spec.worker_scale_interval_ms, 1));
+    uint64_t target_us = static_cast<uint64_t>(_spec.worker_scale_up_delay_us);
+    uint64_t cooldown_ms = static_cast<uint64_t>(_spec.worker_scale_down_idle_ms);
+
+    auto last_ts = std::chrono::steady_clock::now();
+    auto last_busy_ts = last_ts;
+    uint64_t last_processed = 0;
+    for (auto& wk : _workers)
+        last_processed += wk->processed_task_count();
+
+    while (!_stopping.load(std::memory_order_acquire))
+    {
+        _scaler_event.wait_for(static_cast<int>(interval.count()));
+        if (_stopping.load(std::memory_order_acquire))
+            break;
+
+        auto now = std::chrono::steady_clock::now();
+        uint64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(now - last_ts).count();
+        last_ts = now;
+
+        uint64_t processed = 0;
+        for (auto& wk : _workers)
+            processed += wk->processed_task_count();
+        uint64_t done = processed - last_processed;
+        last_processed = processed;
+
+        uint64_t qlen = static_cast<uint64_t>(std::max(_queues[0]->count(), 0));
+        uint64_t delay_us;
+        if (qlen == 0)
+            delay_us = 0;
+        else if (done == 0)
+            delay_us = elapsed_us; // stuck for the whole interval at least
+        else
+            delay_us = qlen * elapsed_us / done;
+        _queueing_delay_counter->set(delay_us);
+
+        int active = active_worker_count();
+        if (delay_us > target_us && active < _max_worker_count)
+        {
+            _active_worker_count.store(active + 1, std::memory_order_relaxed);
+
+            auto wk = _workers[active];
+            if (wk->is_started())
+                wk->wake_up();
+            else
+                wk->start();
+
+            last_busy_ts = now;
+            add_scale_decision("up", active + 1, delay_us);
+        }
+        else if (qlen > 0 || delay_us * 2 > target_us)
+        {
+            last_busy_ts = now;
+        }
+        else if (active > _spec.worker_count 
+            && static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - last_busy_ts).count()) >= cooldown_ms)
+        {
+            // the worker goes standby after its current batch
+            _active_worker_count.store(active - 1, std::memory_order_relaxed);
+
+            last_busy_ts = now;
+            add_scale_decision("down", active - 1, delay_us);
+        }
+    }
+}
+
+void task_worker_pool::add_scale_decision(const char* action, int active_count, uint64_t delay_us)
+{
+    _active_workers_counter->set(active_count);
+    ddebug("[%s] thread pool [%s] scaled %s to %d workers, queueing delay = %" PRIu64 " us",
+        _node->name(), _spec.name.c_str(), action, active_count, delay_us);
+
+    scale_decision d;
+    d.ts_ms = dsn_now_ms();
+    d.action = action;
+    d.active_count = active_count;
+    d.delay_us = delay_us;
+
+    utils::auto_lock< ::dsn::utils::ex_lock_nr> l(_scale_history_lock);
+    _scale_history.push_back(d);
+    if (_scale_history.size() > 16)
+        _scale_history.pop_front();
+}
+
+//
+// every interval, the load (enqueued tasks) of each bucket is collected,
+// and while the busiest queue is above imbalance_ratio x average, a 
+// bucket of it is moved to the idlest queue; the bucket is chosen so that 
+// the gap of the two queues narrows the most, hence a single hot bucket
+// is never bounced around; a bucket can only move when it has no task in
+// flight, so busy buckets are retried shortly and then skipped this round
+//
+void task_worker_pool::rebalance_partitions()
+{
+    task_worker::set_name((_spec.name + ".balancer").c_str());
+
+    auto interval = std::chrono::milliseconds(std::max(_spec.partition_rebalance_interval_ms, 1));
+    const int max_moves = 4;
+    const int max_tries = 64;
+
+    std::vector<uint64_t> last(_bucket_count), load(_bucket_count);
+    std::vector<unsigned int> owner(_bucket_count);
+    std::vector<bool> skipped(_bucket_count);
+    std::vector<uint64_t> qload(_queues.size());
+    for (int b = 0; b < _bucket_count; b++)
+        last[b] = _buckets[b].enqueued.load(std::memory_order_relaxed);
+
+    while (!_stopping.load(std::memory_order_acquire))
+    {
+        _rebalancer_event.wait_for(static_cast<int>(interval.count()));
+        if (_stopping.load(std::memory_order_acquire))
+            break;
+
+        uint64_t total = 0;
+        std::fill(qload.begin(), qload.end(), 0);
+        for (int b = 0; b < _bucket_count; b++)
+        {
+            uint64_t e = _buckets[b].enqueued.load(std::memory_order_relaxed);
+            load[b] = e - last[b];
+            last[b] = e;
+            owner[b] = static_cast<unsigned int>(_buckets[b].state.load(std::memory_order_acquire) >> 32);
+            skipped[b] = false;
+            qload[owner[b]] += load[b];
+            total += load[b];
+        }
+
+        double limit = static_cast<double>(total) / qload.size() * _spec.partition_rebalance_imbalance_ratio;
+        for (int moves = 0; moves < max_moves; )
+        {
+            unsigned int hot = 0, cold = 0;
+            for (unsigned int q = 1; q < qload.size(); q++)
+            {
+                if (qload[q] > qload[hot]) hot = q;
+                if (qload[q] < qload[cold]) cold = q;
+            }
+            if (total == 0 || static_cast<double>(qload[hot]) <= limit)
+                break;
+
+            uint64_t gap = qload[hot] - qload[cold];
+            int best = -1;
+            for (int b = 0; b < _bucket_count; b++)
+            {
+                if (owner[b] != hot || skipped[b] || load[b] == 0 || load[b] >= gap)
+                    continue;
+
+                // the gap after moving b is |gap - 2 x load[b]|
+                if (best == -1 || std::llabs(static_cast<long long>(gap) - 2 * static_cast<long long>(load[b]))
+                    < std::llabs(static_cast<long long>(gap) - 2 * static_cast<long long>(load[best])))
+                    best = b;
+            }
+            if (best == -1)
+                break;
+
+            bool moved = false;
+            for (int i = 0; i < max_tries && !moved; i++)
+            {
+                moved = migrate_bucket(best, hot, cold, load[best]);
+                if (!moved)
+                    std::this_thread::yield();
+            }
+
+            if (moved)
+            {
+                qload[hot] -= load[best];
+                qload[cold] += load[best];
+                owner[best] = cold;
+                moves++;
+            }
+            else
+            {
+                skipped[best] = true;
+            }
+        }
+    }
+}
+
+bool task_worker_pool::migrate_bucket(int bucket, unsigned int from, unsigned int to, uint64_t load)
+{
+    // succeeds only when the bucket has no task in flight, and enqueue
+    // reads the queue and counts the task in one atomic op
+    uint64_t expected = static_cast<uint64_t>(from) << 32;
+    if (!_buckets[bucket].state.compare_exchange_strong(expected, static_cast<uint64_t>(to) << 32, std::memory_order_acq_rel))
+        return false;
+
+    _bucket_migrations_counter->increment();
+    dinfo("[%s] thread pool [%s] moved bucket %d (load = %" PRIu64 ") from worker %u to %u",
+        _node->name(), _spec.name.c_str(), bucket, load, from, to);
+
+    bucket_migration m;
+    m.ts_ms = dsn_now_ms();
+    m.bucket = bucket;
+    m.from = from;
+    m.to = to;
+    m.load = load;
+
+    utils::auto_lock< ::dsn::utils::ex_lock_nr> l(_migration_history_lock);
+    _migration_history.push_back(m);
+    if (_migration_history.size() > 16)
+        _migration_history.pop_front();
+    return true;
 }
 
 void task_worker_pool::add_timer(task* t)
@@ -152,7 +597,7 @@ void task_worker_pool::add_timer(task* t)
         _per_node_timer_svc->add_timer(t);
     else
     {
-        unsigned int idx = (_spec.partitioned ? static_cast<unsigned int>(t->hash()) % static_cast<unsigned int>(_queues.size()) : 0);
+        unsigned int idx = queue_index(t);
         _per_queue_timer_svcs[idx]->add_timer(t);
     }
 }
@@ -166,8 +611,21 @@ void task_worker_pool::enqueue(task* t)
 
     if (_is_running)
     {
-        unsigned int idx = (_spec.partitioned ? static_cast<unsigned int>(t->hash()) % static_cast<unsigned int>(_queues.size()) : 0);
-        return _queues[idx]->enqueue_internal(t);
+        if (_buckets != nullptr)
+        {
+            // the task is counted in flight and mapped to the queue atomically, see migrate_bucket
+            int hash = t->hash();
+            auto& b = _buckets[bucket_index(hash)];
+            uint64_t state = b.state.fetch_add(1, std::memory_order_acq_rel);
+            b.enqueued.fetch_add(1, std::memory_order_relaxed);
+
+            if (!_queues[static_cast<unsigned int>(state >> 32)]->enqueue_internal(t))
+                on_partitioned_task_done(hash);
+            return;
+        }
+
+        unsigned int idx = queue_index(t);
+        _queues[idx]->enqueue_internal(t);
     }
     else
     {
@@ -187,6 +645,13 @@ bool task_worker_pool::shared_same_worker_with_current_task(task* tsk) const
             return false;
         else if (_workers.size() == 1)
             return true;
+        else if (_spec.partitioned && (!_numa_node_queues.empty() || _buckets != nullptr))
+        {
+            // the queue depends on the NUMA nodes or the bucket table
+            task_worker* worker = task::get_current_worker();
+            return worker != nullptr && worker->pool() == this
+                && static_cast<unsigned int>(worker->index()) == queue_index(tsk);
+        }
         else if (_spec.partitioned)
         {
             unsigned int sz = static_cast<unsigned int>(_workers.size());
@@ -208,6 +673,19 @@ void task_worker_pool::get_runtime_info(const safe_string& indent,
 {
     auto indent2 = indent + "\t";
     ss << indent << "contains " << _workers.size() << " threads with " << _queues.size() << " queues" << std::endl;
+
+    if (_elastic)
+    {
+        ss << indent2 << "elastic with " << active_worker_count() << " active workers in [" 
+            << _spec.worker_count << ", " << _max_worker_count << "], recent decisions:" << std::endl;
+
+        utils::auto_lock< ::dsn::utils::ex_lock_nr> l(_scale_history_lock);
+        for (auto& d : _scale_history)
+        {
+            ss << indent2 << "\t" << d.ts_ms << " ms: scaled " << d.action << " to " << d.active_count
+                << " workers, queueing delay = " << d.delay_us << " us" << std::endl;
+        }
+    }
     
     for (auto& q : _queues)
     {
@@ -217,11 +695,47 @@ void task_worker_pool::get_runtime_info(const safe_string& indent,
         }
     }
 
+    if (_buckets != nullptr)
+    {
+        // bucket ranges of each worker, e.g., 0-3,8,10-11
+        ss << indent2 << _bucket_count << " partition buckets (thread hash % " << _bucket_count << "):" << std::endl;
+        for (unsigned int q = 0; q < _queues.size(); q++)
+        {
+            ss << indent2 << "\t" << q << " <= ";
+            int start = -1, count = 0;
+            for (int b = 0; b <= _bucket_count; b++)
+            {
+                bool owned = (b < _bucket_count && queue_index_of_hash(b) == q);
+                if (owned && start == -1)
+                {
+                    start = b;
+                }
+                else if (!owned && start != -1)
+                {
+                    ss << (count++ > 0 ? "," : "") << start;
+                    if (b - 1 > start)
+                        ss << "-" << (b - 1);
+                    start = -1;
+                }
+            }
+            ss << std::endl;
+        }
+
+        ss << indent2 << "recent bucket migrations:" << std::endl;
+        utils::auto_lock< ::dsn::utils::ex_lock_nr> l(_migration_history_lock);
+        for (auto& m : _migration_history)
+        {
+            ss << indent2 << "\t" << m.ts_ms << " ms: bucket " << m.bucket << " (load = " << m.load 
+                << ") moved from " << m.from << " to " << m.to << std::endl;
+        }
+    }
+
     for (auto& wk : _workers)
     {
         if (wk)
         {
-            ss << indent2 << wk->index() << " (TID = " << wk->native_tid() << ") attached with queue " << wk->queue()->get_name() << std::endl;
+            ss << indent2 << wk->index() << " (TID = " << wk->native_tid() << ") attached with queue " << wk->queue()->get_name()
+                << (wk->index() < active_worker_count() ? "" : (wk->is_started() ? " (standby)" : " (not started)")) << std::endl;
         }
     }
 }
@@ -285,7 +799,7 @@ volatile int* task_engine::get_task_queue_virtual_length_ptr(
     )
 {
     auto pl = get_pool(task_spec::get(code)->pool_code);
-    auto idx = (pl->spec().partitioned ? hash % pl->spec().worker_count : 0);
+    auto idx = pl->queue_index_of_hash(hash);
     return pl->queues()[idx]->get_virtual_length_ptr();
 }
 
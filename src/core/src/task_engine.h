@@ -41,6 +41,10 @@
 # include <dsn/tool-api/perf_counter.h>
 # include <dsn/tool-api/task_worker.h>
 # include <dsn/tool-api/timer_service.h>
+# include <dsn/tool-api/numa.h>
+# include <atomic>
+# include <deque>
+# include <thread>
 
 namespace dsn {
 
@@ -56,11 +60,16 @@ class task_worker_pool
 {
 public:
     task_worker_pool(const threadpool_spec& opts, task_engine* owner);
+    ~task_worker_pool();
 
     // service management
     void create();    
     void start();
 
+    // stop and join the background threads of the pool (i.e., the scaler and
+    // the rebalancer), which must not touch the pool afterwards
+    void stop();
+
     // task procecessing
     void enqueue(task* task);
     void on_dequeue(int count);
@@ -79,6 +88,43 @@ public:
     std::vector<task_worker*>& workers() { return _workers; }
     std::vector<admission_controller*>& controllers() { return _controllers; }
 
+    // NUMA node the worker is bound to, -1 when worker_numa_nodes is not set
+    int worker_numa_node(int index) const;
+
+    // cpus the worker is bound to, empty for no binding
+    cpu_set worker_cpus(int index) const;
+
+    // elastic workers, see threadpool_spec::worker_count_max; workers with
+    // index >= active_worker_count() are not started yet or in standby
+    bool is_elastic() const { return _elastic; }
+    int active_worker_count() const { return _active_worker_count.load(std::memory_order_relaxed); }
+    int max_worker_count() const { return _max_worker_count; }
+
+    // skew-aware partitioning, see threadpool_spec::partition_bucket_count
+    bool has_partition_buckets() const { return _buckets != nullptr; }
+
+    // queue for the tasks with the given thread hash in partitioned pools
+    unsigned int queue_index_of_hash(int hash) const;
+
+    // called by the workers after executing a task when has_partition_buckets()
+    void on_partitioned_task_done(int hash);
+
+private:
+    // which queue the task goes to, i.e., queue_index_of_hash(t->hash())
+    unsigned int queue_index(task* t) const;
+
+    // index into _numa_nodes of the node the worker is bound to
+    size_t worker_numa_slot(int index) const;
+
+    // loop of the _scaler thread for elastic pools
+    void scale_workers();
+    void add_scale_decision(const char* action, int active_count, uint64_t delay_us);
+
+    // loop of the _rebalancer thread for partitioned pools with buckets
+    void rebalance_partitions();
+    bool migrate_bucket(int bucket, unsigned int from, unsigned int to, uint64_t load);
+    int bucket_index(int hash) const { return static_cast<int>(static_cast<unsigned int>(hash) % static_cast<unsigned int>(_bucket_count)); }
+
 private:
     threadpool_spec                    _spec;
     task_engine*                       _owner;
@@ -88,11 +134,63 @@ private:
     std::vector<task_queue*>           _queues;    
     std::vector<admission_controller*> _controllers;
 
+    // parsed from worker_numa_nodes and worker_affinity_cpus/mask
+    std::vector<int>                   _numa_nodes;
+    cpu_set                            _affinity_cpus;
+    std::vector<std::vector<unsigned int>> _numa_node_queues; // queue indices of each node with workers, see numa_local_thread_hash
+
+    // elastic workers
+    struct scale_decision
+    {
+        uint64_t    ts_ms;
+        const char* action;
+        int         active_count;
+        uint64_t    delay_us;
+    };
+
+    bool                               _elastic;
+    int                                _max_worker_count; // worker_count_max for elastic pools
+    std::atomic<int>                   _active_worker_count;
+    std::thread                        *_scaler;
+    ::dsn::utils::notify_event         _scaler_event; // wakes up the scaler to stop
+    perf_counter_ptr                   _active_workers_counter;
+    perf_counter_ptr                   _queueing_delay_counter;
+    ::dsn::utils::ex_lock_nr           _scale_history_lock;
+    std::deque<scale_decision>         _scale_history; // recent decisions for command 'engine'
+
+    // skew-aware partitioning, thread hash => bucket => queue; a bucket is 
+    // only migrated when it has no task in flight (queued or executing),
+    // so that the tasks with the same hash are still executed in order
+    struct partition_bucket
+    {
+        std::atomic<uint64_t> state;    // queue index << 32 | tasks in flight
+        std::atomic<uint64_t> enqueued; // load stats
+        char                  padding[64 - 2 * sizeof(uint64_t)];
+    };
+
+    struct bucket_migration
+    {
+        uint64_t     ts_ms;
+        int          bucket;
+        unsigned int from;
+        unsigned int to;
+        uint64_t     load;
+    };
+
+    partition_bucket                   *_buckets;
+    int                                _bucket_count;
+    std::thread                        *_rebalancer;
+    ::dsn::utils::notify_event         _rebalancer_event; // wakes up the rebalancer to stop
+    perf_counter_ptr                   _bucket_migrations_counter;
+    ::dsn::utils::ex_lock_nr           _migration_history_lock;
+    std::deque<bucket_migration>       _migration_history; // recent migrations for command 'engine'
+
     // cached ptrs for fast access
     timer_service*                     _per_node_timer_svc;
     std::vector<timer_service*>        _per_queue_timer_svcs;
 
     bool                              _is_running;
+    std::atomic<bool>                 _stopping;
 };
 
 class task_engine
@@ -114,6 +212,8 @@ public:
 
     bool is_started() const { return _is_running; }
 
+    // the queue currently serving the hash; for pools with partition buckets the
+    // hash may move to another queue later, so the pointer must not be cached
     volatile int* get_task_queue_virtual_length_ptr(
         dsn_task_code_t code,
         int hash
@@ -38,6 +38,9 @@
 # include <dsn/tool_api.h>
 # include <gtest/gtest.h>
 # include <sstream>
+# include <algorithm>
+# include <thread>
+# include <atomic>
 
 using namespace ::dsn;
 
@@ -74,6 +77,10 @@ void task_engine_module_init()
 
 DEFINE_THREAD_POOL_CODE(THREAD_POOL_FOR_TEST_1)
 DEFINE_THREAD_POOL_CODE(THREAD_POOL_FOR_TEST_2)
+DEFINE_THREAD_POOL_CODE(THREAD_POOL_FOR_TEST_ELASTIC)
+DEFINE_TASK_CODE(LPC_TEST_ELASTIC, TASK_PRIORITY_COMMON, THREAD_POOL_FOR_TEST_ELASTIC)
+DEFINE_THREAD_POOL_CODE(THREAD_POOL_FOR_TEST_BUCKETS)
+DEFINE_TASK_CODE(LPC_TEST_BUCKETS, TASK_PRIORITY_COMMON, THREAD_POOL_FOR_TEST_BUCKETS)
 
 TEST(core, task_engine)
 {
@@ -143,6 +150,189 @@ TEST(core, task_engine)
     ASSERT_EQ(nullptr, controllers2[1]);
 }
 
+TEST(core, task_engine_elastic_workers)
+{
+    if(dsn::service_engine::fast_instance().spec().tool == "simulator")
+        return;
+
+    task_engine* engine = task::get_current_node2()->computation();
+    task_worker_pool* pool = engine->get_pool(THREAD_POOL_FOR_TEST_ELASTIC);
+    if (pool == nullptr)
+        return;
+
+    ASSERT_TRUE(pool->is_elastic());
+    ASSERT_EQ(4u, pool->workers().size());
+    ASSERT_EQ(1, pool->active_worker_count());
+
+    // queueing delay is far above the target with one worker
+    std::vector<task_ptr> tasks;
+    for (int i = 0; i < 50; i++)
+    {
+        tasks.push_back(tasking::enqueue(LPC_TEST_ELASTIC, nullptr, []()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }));
+    }
+
+    int max_active = 0;
+    for (auto& t : tasks)
+    {
+        t->wait();
+        max_active = std::max(max_active, pool->active_worker_count());
+    }
+    EXPECT_GT(max_active, 1);
+
+    safe_vector<safe_string> args;
+    safe_sstream oss;
+    pool->get_runtime_info("  ", args, oss);
+    printf("%s\n", oss.str().c_str());
+
+    // retired one by one after being idle for worker_scale_down_idle_ms
+    for (int i = 0; i < 100 && pool->active_worker_count() > 1; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(1, pool->active_worker_count());
+
+    // no more scaling once the pool is stopped, while the workers keep running
+    pool->stop();
+    tasks.clear();
+    for (int i = 0; i < 20; i++)
+    {
+        tasks.push_back(tasking::enqueue(LPC_TEST_ELASTIC, nullptr, []()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }));
+    }
+    for (auto& t : tasks)
+    {
+        t->wait();
+        EXPECT_EQ(1, pool->active_worker_count());
+    }
+}
+
+TEST(core, task_engine_partition_buckets)
+{
+    if(dsn::service_engine::fast_instance().spec().tool == "simulator")
+        return;
+
+    task_engine* engine = task::get_current_node2()->computation();
+    task_worker_pool* pool = engine->get_pool(THREAD_POOL_FOR_TEST_BUCKETS);
+    if (pool == nullptr)
+        return;
+
+    ASSERT_TRUE(pool->has_partition_buckets());
+
+    // all hot hashes are in the buckets of worker 0 initially
+    const int hashes[] = { 0, 2, 4, 6 };
+    for (auto h : hashes)
+        ASSERT_EQ(0u, pool->queue_index_of_hash(h));
+
+    // tasks of the same hash must still run in order
+    std::atomic<int> seqs[8];
+    for (auto& sq : seqs)
+        sq.store(0);
+    std::atomic<int> out_of_order(0);
+
+    int next_seq[8] = { 0 };
+    for (int round = 0; round < 100; round++)
+    {
+        std::vector<task_ptr> tasks;
+        for (int i = 0; i < 3; i++)
+        {
+            for (auto h : hashes)
+            {
+                int seq = next_seq[h]++;
+                tasks.push_back(tasking::enqueue(LPC_TEST_BUCKETS, nullptr, [&seqs, &out_of_order, h, seq]()
+                {
+                    if (seqs[h].fetch_add(1) != seq)
+                        ++out_of_order;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }, h));
+            }
+        }
+        for (auto& t : tasks)
+            t->wait();
+    }
+
+    EXPECT_EQ(0, out_of_order.load());
+
+    int moved = 0;
+    for (auto h : hashes)
+    {
+        if (pool->queue_index_of_hash(h) != 0)
+            moved++;
+    }
+    EXPECT_GT(moved, 0);
+
+    // keep enqueuing while buckets are migrated, with one producer per hash so that
+    // the enqueue order of each hash is well defined; the odd hashes are all in the
+    // buckets of worker 1 initially
+    const int odd_hashes[] = { 1, 3, 5, 7 };
+    for (auto h : odd_hashes)
+        ASSERT_EQ(1u, pool->queue_index_of_hash(h));
+
+    std::atomic<int> executed[8];
+    for (auto& e : executed)
+        e.store(0);
+    std::atomic<int> migrations(0);
+
+    std::vector<std::thread> producers;
+    for (auto h : odd_hashes)
+    {
+        producers.emplace_back([pool, h, &executed, &out_of_order, &migrations]()
+        {
+            unsigned int last = pool->queue_index_of_hash(h);
+            uint64_t end_ms = dsn_now_ms() + 500;
+            int seq = 0;
+            while (dsn_now_ms() < end_ms)
+            {
+                tasking::enqueue(LPC_TEST_BUCKETS, nullptr, [&executed, &out_of_order, h, seq]()
+                {
+                    if (executed[h].fetch_add(1) != seq)
+                        ++out_of_order;
+                }, h);
+                seq++;
+
+                unsigned int q = pool->queue_index_of_hash(h);
+                if (q != last)
+                {
+                    ++migrations;
+                    last = q;
+                }
+                // short pauses let the buckets drain now and then, so that they can move
+                if (seq % 16 == 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            while (executed[h].load() != seq)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    }
+    for (auto& p : producers)
+        p.join();
+
+    EXPECT_EQ(0, out_of_order.load());
+    EXPECT_GT(migrations.load(), 0);
+
+    safe_vector<safe_string> args;
+    safe_sstream oss;
+    pool->get_runtime_info("  ", args, oss);
+    printf("%s\n", oss.str().c_str());
+
+    // the rebalancer is joined on stop, and no bucket moves afterwards
+    pool->stop();
+    std::vector<unsigned int> owners;
+    for (int h = 0; h < 8; h++)
+        owners.push_back(pool->queue_index_of_hash(h));
+    std::vector<task_ptr> tasks;
+    for (int i = 0; i < 200; i++)
+        tasks.push_back(tasking::enqueue(LPC_TEST_BUCKETS, nullptr, []() {}, 1));
+    for (auto& t : tasks)
+        t->wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int h = 0; h < 8; h++)
+        EXPECT_EQ(owners[h], pool->queue_index_of_hash(h));
+}
+
 /*
 TEST(core, task_engine)
 {
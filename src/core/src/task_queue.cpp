@@ -38,6 +38,7 @@
 # include <dsn/tool-api/perf_counter.h>
 # include <dsn/tool-api/network.h>
 # include <cstdio>
+# include <algorithm>
 # include "rpc_engine.h"
 
 # ifdef __TITLE__
@@ -55,7 +56,7 @@ task_queue::task_queue(task_worker_pool* pool, int index, task_queue* inner_prov
     _name = pool->spec().name + '.';
     _name.append(num);
     _owner_worker = nullptr;
-    _worker_count = _pool->spec().partitioned ? 1 : _pool->spec().worker_count;
+    _worker_count = _pool->spec().partitioned ? 1 : _pool->max_worker_count();
     _queue_length_counter = perf_counter::get_counter(_pool->node()->name(), "engine", (_name + ".queue.length").c_str(), COUNTER_TYPE_NUMBER, "task queue length", true);
     _virtual_queue_length = 0;
     _spec = (threadpool_spec*)&pool->spec();
@@ -66,8 +67,27 @@ task_queue::~task_queue()
     perf_counter::remove_counter(_queue_length_counter->full_name());
 }
 
-void task_queue::enqueue_internal(task* task)
+service_node* task_queue::node() const
 {
+    return _pool->node();
+}
+
+bool task_queue::enqueue_internal(task* task)
+{
+    if (_controller != nullptr && !_controller->is_task_accepted(task))
+    {
+        dassert(task->spec().type == TASK_TYPE_RPC_REQUEST,
+            "only rpc requests can be rejected by admission controller, task = %s",
+            task->spec().name.c_str());
+
+        auto rtask = static_cast<rpc_request_task*>(task);
+        auto resp = rtask->get_request()->create_response();
+        task::get_current_rpc()->reply(resp, ERR_BUSY);
+
+        task->release_ref(); // added in task::enqueue(pool)
+        return false;
+    }
+
     auto& sp = task->spec();
     auto throttle_mode = sp.rpc_request_throttling_mode;
     if (throttle_mode != TM_NONE)
@@ -114,13 +134,14 @@ void task_queue::enqueue_internal(task* task)
                     );
 
                 task->release_ref(); // added in task::enqueue(pool)
-                return;
+                return false;
             }
         }
     }
 
     tls_dsn.last_worker_queue_size = increase_count();
     enqueue(task);
+    return true;
 }
 
 }
@@ -26,16 +26,18 @@
 
 /*
  * Description:
- *     What is this file about?
+ *     task tracker with per-thread task slots
  *
  * Revision history:
  *     xxxx-xx-xx, author, first version
- *     xxxx-xx-xx, author, fix bug about xxx
+ *     Oct., 2026, per-thread slots with deferred removal and epoch based cancel/wait
  */
 
 # include <dsn/tool-api/task_tracker.h>
 # include <dsn/tool-api/task.h>
 # include <dsn/tool_api.h>
+# include <algorithm>
+# include <vector>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -44,20 +46,225 @@
 
 namespace dsn 
 {
+    //
+    // registration of a task in a tracker, it is kept in the slot of the
+    // registering thread and is only unlinked under the lock of that
+    // slot, so that the task can go away (on any thread) with a single
+    // cas on state before the unlink happens
+    //
+    struct tracker_node
+    {
+        enum node_state
+        {
+            NODE_LIVE = 0,      // task is alive and tracked
+            NODE_LOCKED = 1,    // tracker is cancelling/waiting the task
+            NODE_DONE = 2,      // tracker is done with the task
+            NODE_RELEASED = 3,  // task is gone, to be recycled by the slot
+            NODE_ORPHANED = 4   // tracker is gone, to be deleted by the task
+        };
+
+        dlink             dl;
+        dsn_task_t        task;
+        uint64_t          epoch;
+        std::atomic<int>  state;
+        tracker_node      *next_free;
+    };
+
+    struct tracker_slot
+    {
+        // taken by the single owner thread of this slot on registration,
+        // and by cancel/wait_outstanding_tasks only otherwise, so it is
+        // never contended but by a (rare) cancel/wait running concurrently
+        ::dsn::utils::ex_lock_nr_spin lock;
+        dlink            tasks;
+        int              count; // nodes linked in tasks
+        int              sweep_threshold;
+        tracker_node     *free_nodes;
+        const int        owner; // index of the owner thread
+        tracker_slot     *next; // next slot in the same bucket, immutable once published
+
+        explicit tracker_slot(int owner_index)
+            : count(0), sweep_threshold(16), free_nodes(nullptr), owner(owner_index), next(nullptr)
+        {}
+
+        // recycle released nodes, called with lock held
+        void sweep()
+        {
+            auto n = tasks.next();
+            while (n != &tasks)
+            {
+                auto nd = CONTAINING_RECORD(n, tracker_node, dl);
+                n = n->next();
+                if (nd->state.load(std::memory_order_acquire) == tracker_node::NODE_RELEASED)
+                {
+                    nd->dl.remove();
+                    nd->next_free = free_nodes;
+                    free_nodes = nd;
+                    count--;
+                }
+            }
+        }
+    };
+
+    // dense index of the current thread for picking its slot
+    static std::atomic<int> s_tracker_thread_count(0);
+    static __thread int s_tracker_thread_index = -1;
+
+    void trackable_task::set_tracker(task_tracker* owner, dsn_task_t task)
+    {
+        dassert(_owner == nullptr, "task tracker is already set");
+        _owner = owner;
+        _task = task;
+
+        if (nullptr != _owner)
+        {
+            _node = _owner->register_task(task);
+        }
+    }
+
+    void trackable_task::unset_tracker()
+    {
+        if (nullptr == _owner)
+            return;
+
+        int s = _node->state.load(std::memory_order_acquire);
+        while (true)
+        {
+            switch (s)
+            {
+            case tracker_node::NODE_LIVE:
+            case tracker_node::NODE_DONE:
+                // the node is recycled by its slot later on, and must 
+                // not be touched anymore once the cas succeeds
+                if (_node->state.compare_exchange_weak(s, tracker_node::NODE_RELEASED, std::memory_order_acq_rel))
+                    goto done;
+                break;
+            case tracker_node::NODE_LOCKED:
+                s = _node->state.load(std::memory_order_acquire);
+                break;
+            case tracker_node::NODE_ORPHANED:
+                delete _node;
+                goto done;
+            default:
+                dassert(false, "invalid tracker node state %d", s);
+                goto done;
+            }
+        }
+
+    done:
+        _node = nullptr;
+        _owner = nullptr;
+    }
 
     task_tracker::task_tracker(int task_bucket_count)
-        : _task_bucket_count(task_bucket_count)
+        : _bucket_count(std::max(task_bucket_count, 64)), _epoch(0)
     {
-        _outstanding_tasks_lock = new ::dsn::utils::ex_lock_nr_spin[_task_bucket_count];
-        _outstanding_tasks = new dlink[_task_bucket_count];
+        _buckets = new std::atomic<tracker_slot*>[_bucket_count];
+        for (int i = 0; i < _bucket_count; i++)
+        {
+            _buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
     }
 
     task_tracker::~task_tracker()
     {
         cancel_outstanding_tasks();
 
-        delete[] _outstanding_tasks;
-        delete[] _outstanding_tasks_lock;
+        for (int i = 0; i < _bucket_count; i++)
+        {
+            auto s = _buckets[i].load(std::memory_order_acquire);
+            while (s != nullptr)
+            {
+                // assuming nobody is putting tasks into it anymore,
+                // nodes of the tasks still alive are left to the tasks
+                auto n = s->tasks.next();
+                while (n != &s->tasks)
+                {
+                    auto nd = CONTAINING_RECORD(n, tracker_node, dl);
+                    n = n->next();
+                    nd->dl.remove();
+
+                    int st = nd->state.load(std::memory_order_acquire);
+                    while (st != tracker_node::NODE_RELEASED
+                        && !nd->state.compare_exchange_weak(st, tracker_node::NODE_ORPHANED, std::memory_order_acq_rel))
+                    {
+                    }
+
+                    if (st == tracker_node::NODE_RELEASED)
+                        delete nd;
+                }
+
+                while (s->free_nodes)
+                {
+                    auto nd = s->free_nodes;
+                    s->free_nodes = nd->next_free;
+                    delete nd;
+                }
+
+                auto next = s->next;
+                delete s;
+                s = next;
+            }
+        }
+
+        delete[] _buckets;
+    }
+
+    tracker_slot* task_tracker::get_current_slot()
+    {
+        if (s_tracker_thread_index == -1)
+        {
+            s_tracker_thread_index = s_tracker_thread_count++;
+        }
+
+        // threads beyond the bucket count chain their own slots in the
+        // bucket instead of sharing one, the slots are only added here
+        // and only by their owners, so there is no duplicate to race with
+        auto& bucket = _buckets[s_tracker_thread_index % _bucket_count];
+        auto head = bucket.load(std::memory_order_acquire);
+        for (auto s = head; s != nullptr; s = s->next)
+        {
+            if (s->owner == s_tracker_thread_index)
+                return s;
+        }
+
+        auto ns = new tracker_slot(s_tracker_thread_index);
+        do
+        {
+            ns->next = head;
+        } while (!bucket.compare_exchange_weak(head, ns, std::memory_order_acq_rel));
+        return ns;
+    }
+
+    tracker_node* task_tracker::register_task(dsn_task_t task)
+    {
+        auto s = get_current_slot();
+        utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(s->lock);
+
+        // amortized recycle of the nodes released by the tasks
+        if (s->free_nodes == nullptr && s->count >= s->sweep_threshold)
+        {
+            s->sweep();
+            s->sweep_threshold = std::max(16, s->count * 2);
+        }
+
+        tracker_node* nd;
+        if (s->free_nodes)
+        {
+            nd = s->free_nodes;
+            s->free_nodes = nd->next_free;
+        }
+        else
+        {
+            nd = new tracker_node();
+        }
+
+        nd->task = task;
+        nd->epoch = _epoch.load(std::memory_order_relaxed);
+        nd->state.store(tracker_node::NODE_LIVE, std::memory_order_relaxed);
+        nd->dl.insert_after(&s->tasks);
+        s->count++;
+        return nd;
     }
 
     // TODO:
@@ -80,102 +287,69 @@ namespace dsn
 
     static __thread tls_tracker_hack s_hack;
 
-    void task_tracker::wait_outstanding_tasks()
+    void task_tracker::handle_outstanding_tasks(bool cancel)
     {
-        for (int i = 0; i < _task_bucket_count; i++)
+        // only tasks registered before this call are handled
+        uint64_t epoch = _epoch.fetch_add(1, std::memory_order_acq_rel);
+        std::vector<tracker_node*> locked_nodes;
+
+        for (int i = 0; i < _bucket_count; i++)
         {
-            while (true)
+            for (auto s = _buckets[i].load(std::memory_order_acquire); s != nullptr; s = s->next)
             {
-                trackable_task::owner_delete_state prepare_state;
-                trackable_task *tcm;
-
                 {
-                    utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_outstanding_tasks_lock[i]);
-                    auto n = _outstanding_tasks[i].next();
-                    if (n != &_outstanding_tasks[i])
-                    {
-                        tcm = CONTAINING_RECORD(n, trackable_task, _dl);
+                    utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(s->lock);
+                    s->sweep();
 
-                        // try to get the lock
-                        prepare_state = tcm->owner_delete_prepare();
+                    for (auto n = s->tasks.next(); n != &s->tasks; n = n->next())
+                    {
+                        auto nd = CONTAINING_RECORD(n, tracker_node, dl);
+                        int st = tracker_node::NODE_LIVE;
+                        if (nd->epoch <= epoch
+                            && nd->state.compare_exchange_strong(st, tracker_node::NODE_LOCKED, std::memory_order_acquire))
+                        {
+                            locked_nodes.push_back(nd);
+                        }
                     }
-                    else
-                        break; // assuming nobody is putting tasks into it anymore
                 }
 
-                task* tsk;
-                switch (prepare_state)
+                // wait/cancel outside the slot lock, the locked nodes stay
+                // linked as their tasks wait in unset_tracker for NODE_DONE
+                for (auto nd : locked_nodes)
                 {
-                // tracker get the lock
-                case trackable_task::OWNER_DELETE_NOT_LOCKED:
                     if (s_hack.under_simulation())
                     {
-                        tsk = (task*)(tcm->_task);
-                        tsk->add_ref();    // released after delete commit           
-                        tcm->owner_delete_commit();
+                        auto tsk = (task*)(nd->task);
+                        tsk->add_ref();    // released after delete commit
+                        nd->state.store(tracker_node::NODE_DONE, std::memory_order_release);
 
-                        tsk->wait(); // wait outside the delete spin lock
+                        if (cancel)
+                            tsk->cancel(true);
+                        else
+                            tsk->wait();
                         tsk->release_ref(); // added before delete commit
                     }
                     else
                     {
-                        dsn_task_wait(tcm->_task);
-                        tcm->owner_delete_commit();
+                        if (cancel)
+                            dsn_task_cancel(nd->task, true);
+                        else
+                            dsn_task_wait(nd->task);
+                        nd->state.store(tracker_node::NODE_DONE, std::memory_order_release);
                     }
-                    break;
-                case trackable_task::OWNER_DELETE_LOCKED:
-                case trackable_task::OWNER_DELETE_FINISHED:
-                    break;
                 }
+                locked_nodes.clear();
             }
         }
     }
 
-    void task_tracker::cancel_outstanding_tasks()
+    void task_tracker::wait_outstanding_tasks()
     {
-        for (int i = 0; i < _task_bucket_count; i++)
-        {
-            while (true)
-            {
-                trackable_task::owner_delete_state prepare_state;
-                trackable_task *tcm;
-
-                {
-                    utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_outstanding_tasks_lock[i]);
-                    auto n = _outstanding_tasks[i].next();
-                    if (n != &_outstanding_tasks[i])
-                    {
-                        tcm = CONTAINING_RECORD(n, trackable_task, _dl);
-                        prepare_state = tcm->owner_delete_prepare();
-                    }
-                    else
-                        break; // assuming nobody is putting tasks into it anymore
-                }
-
-                task* tsk;
-                switch (prepare_state)
-                {
-                case trackable_task::OWNER_DELETE_NOT_LOCKED:
-                    if (s_hack.under_simulation())
-                    {
-                        tsk = (task*)(tcm->_task);
-                        tsk->add_ref();    // released after delete commit           
-                        tcm->owner_delete_commit();
+        handle_outstanding_tasks(false);
+    }
 
-                        tsk->cancel(true); // cancel outside the delete spin lock
-                        tsk->release_ref(); // added before delete commit
-                    }
-                    else
-                    {
-                        dsn_task_cancel(tcm->_task, true);
-                        tcm->owner_delete_commit();
-                    }
-                    break;
-                case trackable_task::OWNER_DELETE_LOCKED:
-                case trackable_task::OWNER_DELETE_FINISHED:
-                    break;
-                }
-            }
-        }
+    void task_tracker::cancel_outstanding_tasks()
+    {
+        handle_outstanding_tasks(true);
     }
 }
@@ -0,0 +1,97 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for task_tracker.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include <dsn/cpp/clientlet.h>
+# include <dsn/cpp/test_utils.h>
+# include <gtest/gtest.h>
+# include <atomic>
+# include <mutex>
+# include <vector>
+
+using namespace ::dsn;
+
+DEFINE_TASK_CODE(LPC_TEST_TRACKER, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+TEST(core, task_tracker_cross_thread)
+{
+    const int spawner_count = 8;
+    const int task_count = 50;
+
+    clientlet* cl = new clientlet();
+    std::atomic<int> executed(0);
+    std::mutex lock;
+    std::vector<task_ptr> tasks;
+
+    // tasks are registered on several worker threads, and released
+    // on this thread
+    auto spawn = [&](std::chrono::milliseconds delay)
+    {
+        std::vector<task_ptr> spawners;
+        for (int i = 0; i < spawner_count; i++)
+        {
+            spawners.push_back(tasking::enqueue(LPC_TEST_TRACKER, nullptr, [&, delay]()
+            {
+                for (int j = 0; j < task_count; j++)
+                {
+                    auto t = tasking::enqueue(LPC_TEST_TRACKER, cl, [&]() { ++executed; }, 0, delay);
+                    std::lock_guard<std::mutex> l(lock);
+                    tasks.push_back(t);
+                }
+            }, i));
+        }
+        for (auto& t : spawners)
+            t->wait();
+    };
+
+    spawn(std::chrono::seconds(30));
+    EXPECT_EQ(spawner_count * task_count, (int)tasks.size());
+
+    dsn_task_tracker_cancel_all(cl->tracker());
+    EXPECT_EQ(0, executed.load());
+    for (auto& t : tasks)
+        EXPECT_FALSE(t->cancel(false));
+    tasks.clear();
+
+    // cancelled ones are not waited again
+    dsn_task_tracker_wait_all(cl->tracker());
+
+    spawn(std::chrono::milliseconds(0));
+    dsn_task_tracker_wait_all(cl->tracker());
+    EXPECT_EQ(spawner_count * task_count, executed.load());
+
+    // tasks still referenced here outlive the tracker
+    delete cl;
+    tasks.clear();
+}
@@ -77,7 +77,7 @@ task_worker::task_worker(task_worker_pool* pool, task_queue* q, int index, task_
     _is_running = false;
 
     _thread = nullptr;
-    _processed_task_count = 0;
+    _processed_task_count.store(0, std::memory_order_relaxed);
 }
 
 task_worker::~task_worker()
@@ -103,6 +103,7 @@ void task_worker::stop()
         return;
 
     _is_running = false;
+    _standby_event.notify();
 
     _thread->join();
     delete _thread;
@@ -296,35 +297,11 @@ void task_worker::run_internal()
     set_name(name().c_str());
     set_priority(pool_spec().worker_priority);
     
-    if (true == pool_spec().worker_share_core)
+    // binding to cpus of any number (e.g., > 64) or to NUMA nodes, see task_worker_pool::worker_cpus
+    cpu_set cpus = pool()->worker_cpus(_index);
+    if (!cpus.empty())
     {
-        if (pool_spec().worker_affinity_mask > 0) 
-        {
-            set_affinity(pool_spec().worker_affinity_mask);
-        }
-    }
-    else
-    {
-        uint64_t current_mask = pool_spec().worker_affinity_mask;
-        if (0 == current_mask)
-        {
-            derror("mask for %s is set to 0x0, mostly due to that #core > 64, set to 64 now",
-                pool_spec().name.c_str()
-                );
-
-            current_mask = ~((uint64_t)0);
-        }
-        for (int i = 0; i < _index; ++i)
-        {            
-            current_mask &= (current_mask - 1);
-            if (0 == current_mask)
-            {
-                current_mask = pool_spec().worker_affinity_mask;
-            }
-        }
-        current_mask -= (current_mask & (current_mask - 1));
-
-        set_affinity(current_mask);
+        bind_current_thread_to_cpus(cpus);
     }
 
     _started.notify();
@@ -337,7 +314,10 @@ void task_worker::run_internal()
 void task_worker::loop()
 {
     task_queue* q = queue();
+    admission_controller* controller = q->controller();
     int best_batch_size = pool_spec().dequeue_batch_size;
+    bool elastic = pool()->is_elastic();
+    bool bucketed = pool()->has_partition_buckets();
 
     //try {
         while (_is_running)
@@ -354,7 +334,19 @@ void task_worker::loop()
             {                
                 next = task->next;
                 task->next = nullptr;
-                task->exec_internal();                
+                if (controller != nullptr)
+                    controller->on_task_dequeued(task);
+                if (bucketed)
+                {
+                    // the task may be gone after execution
+                    int hash = task->hash();
+                    task->exec_internal();
+                    pool()->on_partitioned_task_done(hash);
+                }
+                else
+                {
+                    task->exec_internal();
+                }
                 task = next;
 # ifndef NDEBUG
                 count++;
@@ -369,7 +361,13 @@ void task_worker::loop()
                 );
 # endif
 
-            _processed_task_count += batch_size;
+            _processed_task_count.store(
+                _processed_task_count.load(std::memory_order_relaxed) + batch_size,
+                std::memory_order_relaxed);
+
+            // retired by the pool (see task_worker_pool::scale_workers)
+            if (elastic && _index >= pool()->active_worker_count())
+                standby();
         }
     /*}
     catch (std::exception& ex)
@@ -378,6 +376,20 @@ void task_worker::loop()
     }*/
 }
 
+void task_worker::standby()
+{
+    dinfo("%s goes standby", name().c_str());
+    while (_is_running && _index >= pool()->active_worker_count())
+    {
+        _standby_event.wait();
+    }
+}
+
+void task_worker::wake_up()
+{
+    _standby_event.notify();
+}
+
 const threadpool_spec& task_worker::pool_spec() const
 {
     return pool()->spec();
@@ -0,0 +1,341 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for thrift_binary_codec.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include <dsn/service_api_cpp.h>
+# include <dsn/cpp/serialization.h>
+# include <gtest/gtest.h>
+
+# ifdef DSN_USE_THRIFT_SERIALIZATION
+
+using namespace ::dsn;
+using namespace ::apache::thrift::protocol;
+
+DEFINE_TASK_CODE_RPC(RPC_THRIFT_CODEC_TEST, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+// written as the thrift compiler and the dsn code generator do
+// for a struct { 1:string name; 2:dsn.blob data; 3:list<i32> ids; 4:map<string, i64> sizes; 5:double ratio; }
+class codec_test_item
+{
+public:
+    std::string name;
+    blob data;
+    std::vector<int32_t> ids;
+    std::map<std::string, int64_t> sizes;
+    double ratio = 0;
+
+    uint32_t write(TProtocol* oprot) const
+    {
+        uint32_t xfer = 0;
+        xfer += oprot->writeStructBegin("codec_test_item");
+        xfer += oprot->writeFieldBegin("name", T_STRING, 1);
+        xfer += oprot->writeString(name);
+        xfer += oprot->writeFieldEnd();
+        xfer += oprot->writeFieldBegin("data", T_STRUCT, 2);
+        xfer += data.write(oprot);
+        xfer += oprot->writeFieldEnd();
+        xfer += oprot->writeFieldBegin("ids", T_LIST, 3);
+        xfer += oprot->writeListBegin(T_I32, static_cast<uint32_t>(ids.size()));
+        for (auto id : ids)
+            xfer += oprot->writeI32(id);
+        xfer += oprot->writeListEnd();
+        xfer += oprot->writeFieldEnd();
+        xfer += oprot->writeFieldBegin("sizes", T_MAP, 4);
+        xfer += oprot->writeMapBegin(T_STRING, T_I64, static_cast<uint32_t>(sizes.size()));
+        for (auto& kv : sizes)
+        {
+            xfer += oprot->writeString(kv.first);
+            xfer += oprot->writeI64(kv.second);
+        }
+        xfer += oprot->writeMapEnd();
+        xfer += oprot->writeFieldEnd();
+        xfer += oprot->writeFieldBegin("ratio", T_DOUBLE, 5);
+        xfer += oprot->writeDouble(ratio);
+        xfer += oprot->writeFieldEnd();
+        xfer += oprot->writeFieldStop();
+        xfer += oprot->writeStructEnd();
+        return xfer;
+    }
+
+    uint32_t read(TProtocol* iprot)
+    {
+        uint32_t xfer = 0;
+        std::string fname;
+        TType ftype;
+        int16_t fid;
+        xfer += iprot->readStructBegin(fname);
+        while (true)
+        {
+            xfer += iprot->readFieldBegin(fname, ftype, fid);
+            if (ftype == T_STOP)
+                break;
+            switch (fid)
+            {
+            case 1: xfer += iprot->readString(name); break;
+            case 2: xfer += data.read(iprot); break;
+            case 3:
+                {
+                    TType etype;
+                    uint32_t size;
+                    xfer += iprot->readListBegin(etype, size);
+                    ids.resize(size);
+                    for (uint32_t i = 0; i < size; i++)
+                        xfer += iprot->readI32(ids[i]);
+                    xfer += iprot->readListEnd();
+                }
+                break;
+            case 4:
+                {
+                    TType ktype, vtype;
+                    uint32_t size;
+                    xfer += iprot->readMapBegin(ktype, vtype, size);
+                    for (uint32_t i = 0; i < size; i++)
+                    {
+                        std::string k;
+                        xfer += iprot->readString(k);
+                        xfer += iprot->readI64(sizes[k]);
+                    }
+                    xfer += iprot->readMapEnd();
+                }
+                break;
+            case 5: xfer += iprot->readDouble(ratio); break;
+            default: xfer += iprot->skip(ftype); break;
+            }
+            xfer += iprot->readFieldEnd();
+        }
+        xfer += iprot->readStructEnd();
+        return xfer;
+    }
+};
+
+inline void thrift_binary_write(thrift_binary_writer& writer, const codec_test_item& val)
+{
+    writer.write_field(1, val.name);
+    writer.write_field(2, val.data);
+    writer.write_field(3, val.ids);
+    writer.write_field(4, val.sizes);
+    writer.write_field(5, val.ratio);
+    writer.write_field_stop();
+}
+
+inline void thrift_binary_read(thrift_binary_reader& reader, /*out*/ codec_test_item& val)
+{
+    TType type;
+    int16_t id;
+    while (reader.read_field_begin(type, id))
+    {
+        switch (id)
+        {
+        case 1: reader.read_field(type, val.name); break;
+        case 2: reader.read_field(type, val.data); break;
+        case 3: reader.read_field(type, val.ids); break;
+        case 4: reader.read_field(type, val.sizes); break;
+        case 5: reader.read_field(type, val.ratio); break;
+        default: reader.skip(type); break;
+        }
+    }
+}
+
+static std::vector<codec_test_item> make_items(int count)
+{
+    std::vector<codec_test_item> items(count);
+    for (int i = 0; i < count; i++)
+    {
+        auto& it = items[i];
+        it.name = "item." + std::to_string(i);
+        std::string payload(static_cast<size_t>(i * 7), static_cast<char>('a' + i % 26));
+        std::shared_ptr<char> buffer(make_shared_array<char>(payload.length() + 1));
+        memcpy(buffer.get(), payload.c_str(), payload.length());
+        it.data.assign(std::move(buffer), 0, static_cast<unsigned int>(payload.length()));
+        it.ids = { i, -i, i * 1000000 };
+        it.sizes["x"] = -1;
+        it.sizes["y." + std::to_string(i)] = 1LL << (i % 63);
+        it.ratio = i / 3.0;
+    }
+    return items;
+}
+
+static void check_items(const std::vector<codec_test_item>& expected, const std::vector<codec_test_item>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(expected[i].name, actual[i].name);
+        ASSERT_EQ(expected[i].data.length(), actual[i].data.length());
+        EXPECT_EQ(0, memcmp(expected[i].data.data(), actual[i].data.data(), expected[i].data.length()));
+        EXPECT_EQ(expected[i].ids, actual[i].ids);
+        EXPECT_EQ(expected[i].sizes, actual[i].sizes);
+        EXPECT_EQ(expected[i].ratio, actual[i].ratio);
+    }
+}
+
+static std::string to_bytes(binary_writer& writer)
+{
+    blob bb = writer.get_buffer();
+    return std::string(bb.data(), bb.length());
+}
+
+TEST(core, thrift_binary_codec_wire_compatible)
+{
+    auto items = make_items(50);
+
+    // small buffers so that both paths cross the buffer boundaries
+    binary_writer proto_writer(64), codec_writer(64);
+    marshall_thrift_binary(proto_writer, items);
+    marshall_thrift_binary_codec(codec_writer, items);
+
+    std::string proto_bytes = to_bytes(proto_writer);
+    std::string codec_bytes = to_bytes(codec_writer);
+    ASSERT_EQ(proto_bytes.length(), codec_bytes.length());
+    EXPECT_EQ(proto_bytes, codec_bytes);
+
+    // cross decoding
+    {
+        binary_reader reader(blob(proto_bytes.c_str(), 0, static_cast<unsigned int>(proto_bytes.length())));
+        std::vector<codec_test_item> out;
+        unmarshall_thrift_binary_codec(reader, out);
+        EXPECT_EQ(0, reader.get_remaining_size());
+        check_items(items, out);
+    }
+    {
+        binary_reader reader(blob(codec_bytes.c_str(), 0, static_cast<unsigned int>(codec_bytes.length())));
+        std::vector<codec_test_item> out;
+        unmarshall_thrift_binary(reader, out);
+        EXPECT_EQ(0, reader.get_remaining_size());
+        check_items(items, out);
+    }
+}
+
+TEST(core, thrift_binary_codec_zero_copy_blob)
+{
+    codec_test_item item = make_items(10)[9];
+    binary_writer writer;
+    marshall_thrift_binary_codec(writer, item);
+    blob bb = writer.get_buffer();
+
+    // the blob field refers to the received buffer instead of a copy
+    binary_reader reader(bb);
+    codec_test_item out;
+    unmarshall_thrift_binary_codec(reader, out);
+    EXPECT_EQ(0, reader.get_remaining_size());
+    EXPECT_EQ(bb.buffer_ptr(), out.data.buffer_ptr());
+    EXPECT_GE(out.data.data(), bb.data());
+    EXPECT_LE(out.data.data() + out.data.length(), bb.data() + bb.length());
+    EXPECT_EQ(0, memcmp(item.data.data(), out.data.data(), item.data.length()));
+
+    // no holder to share, so it is copied
+    std::string bytes(bb.data(), bb.length());
+    binary_reader raw_reader(blob(bytes.c_str(), 0, static_cast<unsigned int>(bytes.length())));
+    codec_test_item raw_out;
+    unmarshall_thrift_binary_codec(raw_reader, raw_out);
+    EXPECT_TRUE(raw_out.data.has_holder());
+    EXPECT_EQ(0, memcmp(item.data.data(), raw_out.data.data(), item.data.length()));
+
+    // a whole struct can be skipped
+    binary_reader skip_reader(bb);
+    thrift_binary_reader r(skip_reader);
+    TType type;
+    int16_t id;
+    ASSERT_TRUE(r.read_field_begin(type, id));
+    r.skip(type);
+    ASSERT_FALSE(r.read_field_begin(type, id));
+    r.sync();
+    EXPECT_EQ(0, skip_reader.get_remaining_size());
+}
+
+TEST(core, thrift_binary_codec_vector_bool)
+{
+    std::vector<bool> flags;
+    for (int i = 0; i < 37; i++)
+        flags.push_back(i % 3 == 0);
+
+    binary_writer writer;
+    marshall_thrift_binary_codec(writer, flags);
+    blob bb = writer.get_buffer();
+
+    // one byte per element after the field and list headers
+    EXPECT_EQ(3 + 5 + 37 + 1, (int)bb.length());
+
+    binary_reader reader(bb);
+    std::vector<bool> out = { true };
+    unmarshall_thrift_binary_codec(reader, out);
+    EXPECT_EQ(0, reader.get_remaining_size());
+    EXPECT_EQ(flags, out);
+}
+
+TEST(core, thrift_binary_codec_rpc_stream)
+{
+    auto items = make_items(20);
+    std::vector<bool> flags = { true, false, false, true, true };
+
+    dsn_message_t request = dsn_msg_create_request(RPC_THRIFT_CODEC_TEST, 0, 0, 0);
+    dsn_msg_add_ref(request);
+    {
+        rpc_write_stream writer(request);
+        marshall_thrift_binary_codec(writer, items);
+        marshall_thrift_binary_codec(writer, flags);
+    }
+
+    // the received message is one segment without a holder for the stream,
+    // so the blob fields pin the message instead of being copied
+    dsn_message_t receive = dsn_msg_copy(request, true, true);
+    dsn_msg_add_ref(receive);
+    std::vector<codec_test_item> out;
+    std::vector<bool> out_flags;
+    const char* body = (const char*)dsn_msg_rw_ptr(receive, 0);
+    size_t body_size = dsn_msg_body_size(receive);
+    {
+        rpc_read_stream reader(receive);
+        unmarshall_thrift_binary_codec(reader, out);
+        unmarshall_thrift_binary_codec(reader, out_flags);
+        EXPECT_EQ(0, reader.get_remaining_size());
+    }
+    check_items(items, out);
+    EXPECT_EQ(flags, out_flags);
+
+    for (auto& it : out)
+    {
+        if (it.data.length() == 0)
+            continue;
+        EXPECT_EQ(out.back().data.buffer_ptr(), it.data.buffer_ptr());
+        EXPECT_GE(it.data.data(), body);
+        EXPECT_LE(it.data.data() + it.data.length(), body + body_size);
+    }
+
+    // the blobs keep the message alive after it is released here
+    dsn_msg_release_ref(receive);
+    dsn_msg_release_ref(request);
+    check_items(items, out);
+}
+
+# endif
@@ -42,18 +42,22 @@
 
 extern void task_engine_module_init();
 extern void command_manager_module_init();
+extern void address_test_module_init();
+extern bool run_all_benchmarks_enabled();
 
 void run_all_unit_tests_prepare_when_necessary()
 {
-    // check gtest enabled or not
+    // check gtest or micro benchmarks enabled or not
     if (!dsn_config_get_value_bool("core", "gtest", false,
-        "runs all gtest cases or not, default is false"))
+        "runs all gtest cases or not, default is false")
+        && !run_all_benchmarks_enabled())
         return;
 
     // register test-required apps etc.
     // register all tools
     task_engine_module_init();
     command_manager_module_init();
+    address_test_module_init();
 
     // register all possible services
     dsn::register_app<test_client>("test");
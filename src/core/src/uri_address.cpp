@@ -41,6 +41,7 @@
 # include <dsn/utility/configuration.h>
 # include <dsn/utility/factory_store.h>
 # include <dsn/tool-api/task.h>
+# include <algorithm>
 
 namespace dsn
 {
@@ -126,20 +127,187 @@ namespace dsn
 
     //---------------------------------------------------------------
 
+    // a hazard slot per thread reading rpc_uri_address::_resolver: a resolver
+    // published in any slot is not released by refresh_resolver(), so readers
+    // only write to their own cache line before they add_ref the resolver
+    struct resolver_hazard_slot
+    {
+        alignas(64) std::atomic<bool> owned;
+        std::atomic<dist::partition_resolver*> resolver;
+    };
+
+    static const int MAX_RESOLVER_HAZARD_SLOTS = 1024;
+    static resolver_hazard_slot s_hazard_slots[MAX_RESOLVER_HAZARD_SLOTS];
+
+    class resolver_hazard_owner
+    {
+    public:
+        resolver_hazard_owner() : _slot(nullptr)
+        {
+            for (auto& s : s_hazard_slots)
+            {
+                bool owned = false;
+                if (!s.owned.load(std::memory_order_relaxed) && s.owned.compare_exchange_strong(owned, true))
+                {
+                    _slot = &s;
+                    break;
+                }
+            }
+        }
+
+        ~resolver_hazard_owner()
+        {
+            if (_slot != nullptr)
+                _slot->owned.store(false, std::memory_order_release);
+        }
+
+        // nullptr when all the slots are taken
+        std::atomic<dist::partition_resolver*>* slot() { return _slot ? &_slot->resolver : nullptr; }
+
+    private:
+        resolver_hazard_slot* _slot;
+    };
+
+    static std::atomic<dist::partition_resolver*>* resolver_hazard()
+    {
+        static thread_local resolver_hazard_owner owner;
+        return owner.slot();
+    }
+
     rpc_uri_address::rpc_uri_address(const char * uri)
-        : _uri(uri)
+        : _resolver(nullptr), _resolver_version(~0ULL), _uri_resolver_ptr(nullptr), _resolver_mgr(nullptr), _uri(uri)
     {
         _uri_address.assign_uri(this);
-        auto r1 = task::get_current_rpc()->uri_resolver_mgr()->get(this);
-        if (r1.get())
+
+        // resolve eagerly when possible so the first call needs no lock
+        auto rpc = task::get_current_rpc();
+        if (rpc)
         {
-            _resolver = r1->get_app_resolver(get_uri_components().second.c_str());
+            _resolver_mgr = rpc->uri_resolver_mgr();
+            refresh_resolver();
         }
     }
 
     rpc_uri_address::~rpc_uri_address()
     {
-        _resolver = nullptr;
+        auto r = _resolver.exchange(nullptr);
+        if (r != nullptr)
+            r->release_ref();
+        for (auto& old : _retired)
+            old->release_ref();
+    }
+
+    dist::partition_resolver_ptr rpc_uri_address::get_resolver()
+    {
+        auto ur = _uri_resolver_ptr.load(std::memory_order_acquire);
+        if (_resolver_version.load(std::memory_order_acquire) != (ur ? ur->version() : 0))
+            refresh_resolver();
+
+        auto hazard = resolver_hazard();
+        if (hazard == nullptr)
+        {
+            // too many reading threads, the replaced resolvers are only released under _lock
+            utils::auto_lock<utils::ex_lock_nr> l(_lock);
+            return dist::partition_resolver_ptr(_resolver.load());
+        }
+
+        // publish the resolver and check it is still current, so that the
+        // refresh_resolver() replacing it either sees the hazard or is seen here
+        dist::partition_resolver* r;
+        do
+        {
+            r = _resolver.load();
+            hazard->store(r);
+        } while (r != _resolver.load());
+
+        dist::partition_resolver_ptr rp(r);
+        hazard->store(nullptr, std::memory_order_release);
+        return rp;
+    }
+
+    void rpc_uri_address::refresh_resolver()
+    {
+        utils::auto_lock<utils::ex_lock_nr> l(_lock);
+
+        if (_resolver_mgr == nullptr)
+        {
+            auto rpc = task::get_current_rpc();
+            if (rpc == nullptr)
+                return;
+            _resolver_mgr = rpc->uri_resolver_mgr();
+        }
+
+        if (_uri_resolver == nullptr)
+        {
+            _uri_resolver = _resolver_mgr->get(this);
+            _uri_resolver_ptr.store(_uri_resolver.get(), std::memory_order_release);
+        }
+
+        // read version first so that any concurrent reset forces another refresh
+        auto version = _uri_resolver ? _uri_resolver->version() : 0;
+        if (_resolver_version.load(std::memory_order_relaxed) == version)
+            return;
+
+        dist::partition_resolver* r = nullptr;
+        if (_uri_resolver != nullptr)
+        {
+            auto rp = _uri_resolver->get_app_resolver(get_uri_components().second.c_str());
+            r = rp.get();
+
+            // released when replaced or in dtor, as the uri_resolver may drop it anytime
+            if (r != nullptr)
+                r->add_ref();
+        }
+
+        auto old = _resolver.exchange(r);
+        _resolver_version.store(version, std::memory_order_release);
+
+        // the in-flight calls hold their own references to the old resolver, so it
+        // is only a matter of the readers which have loaded it but not add_ref-ed yet,
+        // it is kept until a later refresh or the dtor rather than waited for here
+        if (old != nullptr)
+            _retired.push_back(old);
+        release_retired_resolvers();
+    }
+
+    void rpc_uri_address::release_retired_resolvers()
+    {
+        if (_retired.empty())
+            return;
+
+        std::vector<dist::partition_resolver*> hazards;
+        for (auto& s : s_hazard_slots)
+        {
+            if (!s.owned.load(std::memory_order_acquire))
+                continue;
+            auto r = s.resolver.load();
+            if (r != nullptr)
+                hazards.push_back(r);
+        }
+
+        auto it = std::remove_if(_retired.begin(), _retired.end(),
+            [&hazards](dist::partition_resolver* old)
+            {
+                if (std::find(hazards.begin(), hazards.end(), old) != hazards.end())
+                    return false;
+                old->release_ref();
+                return true;
+            });
+        _retired.erase(it, _retired.end());
+    }
+
+    void rpc_uri_address::invalidate_resolver(dist::partition_resolver* stale)
+    {
+        std::shared_ptr<uri_resolver> ur;
+        {
+            utils::auto_lock<utils::ex_lock_nr> l(_lock);
+            ur = _uri_resolver;
+        }
+
+        if (ur != nullptr)
+        {
+            ur->reset_app_resolver(get_uri_components().second.c_str(), stale);
+        }
     }
     
     std::pair<std::string, std::string> rpc_uri_address::get_uri_components()
@@ -159,7 +327,7 @@ namespace dsn
     //---------------------------------------------------------------
 
     uri_resolver::uri_resolver(const char* name, const char* factory, const char* arguments)
-        : _name(name), _factory(factory), _arguments(arguments)
+        : _version(0), _name(name), _factory(factory), _arguments(arguments)
     {
         _meta_server.assign_group(dsn_group_build(name));
 
@@ -217,6 +385,20 @@ namespace dsn
         return rv;
     }
 
+    void uri_resolver::reset_app_resolver(const char* app, dist::partition_resolver* stale)
+    {
+        {
+            service::zauto_write_lock l(_apps_lock);
+            auto it = _apps.find(app);
+            if (it == _apps.end() || it->second.get() != stale)
+                return;
+            _apps.erase(it);
+        }
+
+        ddebug("reset partition resolver for app %s under %s", app, _name.c_str());
+        _version.fetch_add(1, std::memory_order_release);
+    }
+
     std::map<std::string, dist::partition_resolver_ptr> uri_resolver::get_all_app_resolvers()
     {
         std::map<std::string, dist::partition_resolver_ptr> result;
@@ -38,10 +38,15 @@
 # include <dsn/cpp/address.h>
 # include <dsn/tool-api/partition_resolver.h>
 # include <algorithm> // for std::find()
+# include <atomic>
 # include <dsn/utility/configuration.h>
+# include <dsn/utility/synchronize.h>
 
 namespace dsn
 {
+    class uri_resolver;
+    class uri_resolver_manager;
+
     /** A RPC URI address. */
     class rpc_uri_address
     {
@@ -69,10 +74,37 @@ namespace dsn
 
         const char* uri() const { return _uri.c_str(); }
 
-        dist::partition_resolver_ptr get_resolver() { return _resolver; }
+        /**
+        * Gets the partition resolver for this uri, which is resolved once and
+        * cached until the version of its uri_resolver changes, so the common
+        * path takes no lock, does no map lookup and writes no shared memory
+        * but the reference count of the resolver.
+        *
+        * \return the resolver, or nullptr when no uri-resolver is configured
+        *         for the uri; the reference keeps it alive after it is replaced
+        */
+        dist::partition_resolver_ptr get_resolver();
+
+        /**
+        * Drops the given (stale) resolver from the owning uri_resolver, so that
+        * the next get_resolver() on any uri address creates a fresh one.
+        */
+        void invalidate_resolver(dist::partition_resolver* stale);
 
     private:
-        ::dsn::dist::partition_resolver_ptr _resolver;
+        void refresh_resolver();
+
+        // release the replaced resolvers no thread is about to add_ref, under _lock
+        void release_retired_resolvers();
+
+    private:
+        std::atomic<dist::partition_resolver*> _resolver; ///< current resolver, holding one reference
+        std::atomic<uint64_t> _resolver_version; ///< version of _uri_resolver when _resolver is set
+        std::atomic<uri_resolver*> _uri_resolver_ptr; ///< _uri_resolver once it is found
+        std::vector<dist::partition_resolver*> _retired; ///< replaced resolvers, each holding one reference
+        std::shared_ptr<uri_resolver> _uri_resolver;
+        uri_resolver_manager* _resolver_mgr;
+        utils::ex_lock_nr _lock; ///< serialize refresh_resolver
         std::string _uri;
         rpc_address _uri_address;
     };
@@ -95,15 +127,22 @@ namespace dsn
         
         dist::partition_resolver_ptr get_app_resolver(const char* app);
 
+        void reset_app_resolver(const char* app, dist::partition_resolver* stale);
+
         std::map<std::string, dist::partition_resolver_ptr> get_all_app_resolvers();
 
         const char* get_factory() const { return _factory.c_str(); }
 
         const char* get_arguments() const { return _arguments.c_str(); }
 
+        // changed when an app resolver is reset, so that rpc_uri_address
+        // refreshes the resolver it caches
+        uint64_t version() const { return _version.load(std::memory_order_acquire); }
+
     private:
         std::unordered_map<std::string, dist::partition_resolver_ptr > _apps; ///< app-path to app-resolver map
         service::zrwlock_nr _apps_lock;
+        std::atomic<uint64_t> _version;
 
         rpc_address _meta_server;
         std::string _name;
@@ -135,4 +174,3 @@ namespace dsn
         setup_resolvers();
     }
 }
-
@@ -0,0 +1,212 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     micro benchmarks for blob, crc, priority_queue, transient memory,
+ *     perf counters and join points
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "micro_benchmark.h"
+# include "transient_memory.h"
+# include <dsn/cpp/blob.h>
+# include <dsn/utility/join_point.h>
+# include <dsn/utility/priority_queue.h>
+# include <dsn/tool-api/task_spec.h>
+
+using namespace ::dsn;
+
+BENCHMARK(core, blob_create_64)
+{
+    state.set_bytes_per_op(64);
+    state.run([&]()
+    {
+        blob b(make_shared_array<char>(64), 64);
+        state.consume(b.length());
+    });
+}
+
+BENCHMARK(core, blob_create_4k)
+{
+    state.set_bytes_per_op(4096);
+    state.run([&]()
+    {
+        blob b(make_shared_array<char>(4096), 4096);
+        state.consume(b.length());
+    });
+}
+
+BENCHMARK(core, blob_range)
+{
+    blob b(make_shared_array<char>(4096), 4096);
+    state.run([&]()
+    {
+        blob r = b.range(100, 1000);
+        state.consume(r.length());
+    });
+}
+
+static void crc32_benchmark(::dsn::bench::benchmark_state& state, size_t size)
+{
+    std::vector<char> buffer(size);
+    for (size_t i = 0; i < size; i++)
+        buffer[i] = (char)i;
+
+    state.set_bytes_per_op(size);
+    state.run([&]()
+    {
+        state.consume(dsn_crc32_compute(&buffer[0], size, 0));
+    });
+}
+
+BENCHMARK(core, crc32_64)
+{
+    crc32_benchmark(state, 64);
+}
+
+BENCHMARK(core, crc32_4k)
+{
+    crc32_benchmark(state, 4096);
+}
+
+BENCHMARK(core, crc32_64k)
+{
+    crc32_benchmark(state, 65536);
+}
+
+BENCHMARK(core, priority_queue_enqueue_dequeue)
+{
+    // keep some items queued so the dequeue does not hit the empty path
+    std::vector<uint64_t> items(1024);
+    utils::priority_queue<uint64_t*, 3> q("bench");
+    for (size_t i = 0; i < items.size(); i++)
+        q.enqueue(&items[i], (uint32_t)(i % 3));
+
+    uint32_t i = 0;
+    state.run([&]()
+    {
+        q.enqueue(&items[i % items.size()], i % 3);
+        state.consume(*q.dequeue());
+        i++;
+    });
+}
+
+BENCHMARK(core, tls_trans_malloc_64)
+{
+    tls_trans_mem_init(1024 * 1024);
+    state.run([&]()
+    {
+        void* ptr = tls_trans_malloc(64);
+        state.consume((uint64_t)(size_t)ptr);
+        tls_trans_free(ptr);
+    });
+}
+
+BENCHMARK(core, tls_trans_malloc_4k)
+{
+    tls_trans_mem_init(1024 * 1024);
+    state.run([&]()
+    {
+        void* ptr = tls_trans_malloc(4096);
+        state.consume((uint64_t)(size_t)ptr);
+        tls_trans_free(ptr);
+    });
+}
+
+BENCHMARK(core, perf_counter_number_increment)
+{
+    auto c = dsn_perf_counter_create("bench", "number_increment", COUNTER_TYPE_NUMBER, "micro benchmark");
+    state.run([&]()
+    {
+        dsn_perf_counter_increment(c);
+    });
+    dsn_perf_counter_remove(c);
+}
+
+BENCHMARK(core, perf_counter_rate_increment)
+{
+    auto c = dsn_perf_counter_create("bench", "rate_increment", COUNTER_TYPE_RATE, "micro benchmark");
+    state.run([&]()
+    {
+        dsn_perf_counter_increment(c);
+    });
+    dsn_perf_counter_remove(c);
+}
+
+BENCHMARK(core, perf_counter_percentile_set)
+{
+    auto c = dsn_perf_counter_create("bench", "percentile_set", COUNTER_TYPE_NUMBER_PERCENTILES, "micro benchmark");
+    uint64_t v = 0;
+    state.run([&]()
+    {
+        dsn_perf_counter_set(c, v++);
+    });
+    dsn_perf_counter_remove(c);
+}
+
+static uint64_t s_join_point_count;
+static void join_point_advice(void*, void*)
+{
+    s_join_point_count++;
+}
+
+BENCHMARK(core, join_point_execute_empty)
+{
+    join_point<void, void*, void*> jp("bench.empty");
+    state.run([&]()
+    {
+        jp.execute(nullptr, nullptr);
+    });
+}
+
+BENCHMARK(core, join_point_execute_2_advices)
+{
+    join_point<void, void*, void*> jp("bench.2_advices");
+    jp.put_back(join_point_advice, "advice1");
+    jp.put_back(join_point_advice, "advice2");
+    state.run([&]()
+    {
+        jp.execute(nullptr, nullptr);
+    });
+    state.consume(s_join_point_count);
+}
+
+DEFINE_TASK_CODE(LPC_BENCH_TASK_HOOKS, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+// the join points every task passes through, with no toollets configured
+BENCHMARK(core, join_point_task_hooks)
+{
+    auto spec = task_spec::get(LPC_BENCH_TASK_HOOKS);
+    state.run([&]()
+    {
+        spec->on_task_enqueue.execute(nullptr, nullptr);
+        spec->on_task_begin.execute(nullptr);
+        spec->on_task_end.execute(nullptr);
+    });
+}
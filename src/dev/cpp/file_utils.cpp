@@ -78,6 +78,8 @@
 # include <libproc.h>
 #endif
 
+# include <unistd.h>
+
 # define getcwd_ getcwd
 # define rmdir_ rmdir
 # define mkdir_(path) mkdir(path, 0775)
@@ -857,6 +859,53 @@ out_error:
                 return true;
             }
 
+            bool resize_file(const std::string& path, int64_t sz)
+            {
+                std::string npath;
+                int err;
+
+                if (path.empty() || sz < 0)
+                {
+                    return false;
+                }
+
+                err = get_normalized_path(path, npath);
+                if (err != 0)
+                {
+                    return false;
+                }
+
+                if (!dsn::utils::filesystem::path_exists_internal(npath, FTW_F))
+                {
+                    return false;
+                }
+
+#ifdef _WIN32
+                int fd;
+                if (::_sopen_s(&fd, npath.c_str(), _O_WRONLY | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0)
+                {
+                    err = errno;
+                }
+                else
+                {
+                    err = ::_chsize_s(fd, sz);
+                    ::close_(fd);
+                }
+#else
+                if (::truncate(npath.c_str(), static_cast<off_t>(sz)) != 0)
+                {
+                    err = errno;
+                }
+#endif
+                if (err != 0)
+                {
+                    dwarn("resize_file %s to %" PRId64 " failed, err = %s", path.c_str(), sz, strerror(err));
+                    return false;
+                }
+
+                return true;
+            }
+
             bool get_absolute_path(const std::string& path1, std::string& path2)
             {
                 bool succ;
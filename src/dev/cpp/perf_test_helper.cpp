@@ -34,6 +34,7 @@
  */
 # include <dsn/cpp/perf_test_helper.h>
 # include <fstream>
+# include <cmath>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -44,11 +45,15 @@
 
 namespace dsn {
     namespace service {
+
+        DEFINE_TASK_CODE(LPC_PERF_TEST_OPEN_LOOP_TICK, TASK_PRIORITY_HIGH, THREAD_POOL_DEFAULT)
         
         perf_client_helper::perf_client_helper()
         {
             _case_count = 0;
             _live_rpc_count = 0;
+            _next_send_ts_ns = 0;
+            _intended_send_ts_ns = 0;
 
             if (!read_config("task..default", _default_opts))
             {
@@ -119,13 +124,23 @@ namespace dsn {
                 ratio_sum += (double)r;
             }
 
+            bool open_loop = (opt.perf_test_rates_qps.size() > 0);
+            bool poisson = (opt.perf_test_arrival == "poisson");
+            dassert(poisson || opt.perf_test_arrival == "constant",
+                "invalid perf_test_arrival '%s' in [%s], must be constant or poisson",
+                opt.perf_test_arrival.c_str(), s.config_section);
+
+            // open-loop cases sweep the rates instead of the concurrency
+            const std::vector<int>& loads = open_loop ? opt.perf_test_rates_qps : opt.perf_test_concurrency;
+
+            s.knee_latency_factor = opt.perf_test_knee_latency_factor;
             s.cases.clear();
             for (auto& bytes : opt.perf_test_payload_bytes)
             {
                 int last_index = static_cast<int>(opt.perf_test_timeouts_ms.size()) - 1;
                 for (int i = last_index; i >= 0; i--)
                 {
-                    for (auto& cc : opt.perf_test_concurrency)
+                    for (auto& ld : loads)
                     {
                         perf_test_case c;
                         c.id = ++_case_count;
@@ -133,7 +148,9 @@ namespace dsn {
                         c.payload_bytes = bytes;
                         c.key_space_size = opt.perf_test_key_space_size;
                         c.timeout_ms = opt.perf_test_timeouts_ms[i];
-                        c.concurrency = cc;                        
+                        c.concurrency = open_loop ? 0 : ld;
+                        c.rate_qps = open_loop ? ld : 0;
+                        c.poisson_arrival = poisson;
                         c.ratios.resize(max_request_kind_count_for_hybrid_test, 0.0);
                         
                         double ratio = 0.0;
@@ -160,7 +177,9 @@ namespace dsn {
 
         void* perf_client_helper::prepare_send_one()
         {
-            uint64_t nts_ns = ::dsn_now_ns();
+            // open-loop requests are sent by the pacer only, and their latency
+            // counts from when they were due
+            uint64_t nts_ns = _current_case->rate_qps > 0 ? _intended_send_ts_ns : ::dsn_now_ns();
             ++_live_rpc_count;
             return (void*)(size_t)(nts_ns);
         }
@@ -183,12 +202,21 @@ namespace dsn {
 
                 auto d = nts_ns - start_ts;
                 _current_case->succ_rounds_sum_ns += d;
+                _current_case->succ_latency.record(d);
                 if (d < _current_case->min_latency_ns)
                     _current_case->min_latency_ns = d;
                 if (d > _current_case->max_latency_ns)
                     _current_case->max_latency_ns = d;
             }
 
+            // the pacer holds one count until the case ends, and keeps sending
+            if (_current_case->rate_qps > 0)
+            {
+                if (--_live_rpc_count == 0)
+                    finalize_case();
+                return;
+            }
+
             // if completed
             if (_quiting_current_case)
             {
@@ -237,20 +265,7 @@ namespace dsn {
             cs.succ_throughput_MB_s = (double)cs.succ_rounds * (double)cs.payload_bytes / 1024.0 / 1024.0 / ((double)(nts - _case_start_ts_ns) / 1000.0 / 1000.0 / 1000.0);
             cs.succ_latency_avg_ns = (double)cs.succ_rounds_sum_ns / (double)cs.succ_rounds;
 
-            std::stringstream ss;
-            ss << "TEST " << _name << "(" << cs.id << "/" << _case_count << ")::"
-                << "  concurency: " << cs.concurrency
-                << ", timeout(ms): " << cs.timeout_ms
-                << ", payload(byte): " << cs.payload_bytes
-                << ", tmo/err/suc(#): " << cs.timeout_rounds << "/" << cs.error_rounds << "/" << cs.succ_rounds
-                << ", latency(ns): " << cs.succ_latency_avg_ns << "(avg), "
-                << cs.min_latency_ns << "(min), "
-                << cs.max_latency_ns << "(max)"
-                << ", qps: " << cs.succ_qps << "#/s"
-                << ", thp: " << cs.succ_throughput_MB_s << "MB/s"                
-                ;
-
-            dwarn(ss.str().c_str());
+            dwarn(case_to_string(_name.c_str(), cs).c_str());
 
             start_next_case();
         }
@@ -279,19 +294,9 @@ namespace dsn {
                     {
                         for (auto& cs : s.cases)
                         {
-                            ss << "TEST " << s.name << "(" << cs.id << "/" << _case_count << ")::"
-                                << "  concurency: " << cs.concurrency
-                                << ", timeout(ms): " << cs.timeout_ms
-                                << ", payload(byte): " << cs.payload_bytes
-                                << ", tmo/err/suc(#): " << cs.timeout_rounds << "/" << cs.error_rounds << "/" << cs.succ_rounds
-                                << ", latency(ns): " << cs.succ_latency_avg_ns << "(avg), "
-                                << cs.min_latency_ns << "(min), "
-                                << cs.max_latency_ns << "(max)"
-                                << ", qps: " << cs.succ_qps << "#/s"
-                                << ", thp: " << cs.succ_throughput_MB_s << "MB/s"
-                                << std::endl;
-                                ;
+                            ss << case_to_string(s.name, cs) << std::endl;
                         }
+                        ss << knees_to_string(s);
                     }
 
                     dwarn(ss.str().c_str());
@@ -312,6 +317,13 @@ namespace dsn {
                         result_f << ss.str() << std::endl;
                         result_f.close();
 
+                        std::stringstream jfns;
+                        jfns << "perf-result-" << ts << ".json";
+                        std::string json_report = ::dsn::utils::filesystem::path_combine(data_dir, jfns.str());
+                        std::ofstream json_f(json_report.c_str(), std::ios::out);
+                        json_f << to_json(ts) << std::endl;
+                        json_f.close();
+
                         report += ".config.ini";
                         dsn_config_dump(report.c_str());
 
@@ -331,6 +343,7 @@ namespace dsn {
             cs.error_rounds = 0;
             cs.max_latency_ns = 0;
             cs.min_latency_ns = std::numeric_limits<uint64_t>::max();
+            cs.succ_latency.clear();
 
             // setup for the case
             _current_case = &cs;
@@ -349,10 +362,217 @@ namespace dsn {
             dwarn(ss.str().c_str());
 
             // start
-            send_one(_current_case->payload_bytes, _current_case->key_space_size, _current_case->ratios);
+            on_case_start(suit.config_section, _current_case->payload_bytes, _current_case->key_space_size);
+            if (_current_case->rate_qps > 0)
+            {
+                ++_live_rpc_count;
+                _next_send_ts_ns = dsn_now_ns();
+                _pacer = tasking::enqueue_timer(
+                    LPC_PERF_TEST_OPEN_LOOP_TICK,
+                    nullptr,
+                    [this]() { on_open_loop_tick(); },
+                    std::chrono::milliseconds(1)
+                    );
+            }
+            else
+            {
+                send_one(_current_case->payload_bytes, _current_case->key_space_size, _current_case->ratios);
+            }
+        }
+
+        void perf_client_helper::on_open_loop_tick()
+        {
+            uint64_t nts_ns = dsn_now_ns();
+            if (nts_ns >= _case_end_ts_ns)
+            {
+                dsn_task_cancel_current_timer();
+                _quiting_current_case = true;
+                if (--_live_rpc_count == 0)
+                    finalize_case();
+                return;
+            }
+
+            // requests due since the last tick are all sent now, with their
+            // intended send time, whatever the completion of earlier ones
+            double interval_ns = 1000000000.0 / (double)_current_case->rate_qps;
+            while (_next_send_ts_ns <= nts_ns)
+            {
+                _intended_send_ts_ns = _next_send_ts_ns;
+                send_one(_current_case->payload_bytes, _current_case->key_space_size, _current_case->ratios);
+
+                if (_current_case->poisson_arrival)
+                {
+                    double u = dsn_probability();
+                    if (u >= 1.0)
+                        u = 0.999999999;
+                    _next_send_ts_ns += std::max((uint64_t)(-std::log(1.0 - u) * interval_ns), (uint64_t)1);
+                }
+                else
+                {
+                    _next_send_ts_ns += std::max((uint64_t)interval_ns, (uint64_t)1);
+                }
+            }
+        }
+
+        std::string perf_client_helper::case_to_string(const char* name, const perf_test_case& cs) const
+        {
+            std::stringstream ss;
+            ss << "TEST " << name << "(" << cs.id << "/" << _case_count << ")::";
+            if (cs.rate_qps > 0)
+                ss << "  rate(qps): " << cs.rate_qps << (cs.poisson_arrival ? "(poisson)" : "(constant)");
+            else
+                ss << "  concurency: " << cs.concurrency;
+            ss  << ", timeout(ms): " << cs.timeout_ms
+                << ", payload(byte): " << cs.payload_bytes
+                << ", tmo/err/suc(#): " << cs.timeout_rounds << "/" << cs.error_rounds << "/" << cs.succ_rounds
+                << ", latency(ns): " << cs.succ_latency_avg_ns << "(avg), "
+                << cs.min_latency_ns << "(min), "
+                << cs.max_latency_ns << "(max), "
+                << cs.succ_latency.percentile(0.5) << "(p50), "
+                << cs.succ_latency.percentile(0.99) << "(p99), "
+                << cs.succ_latency.percentile(0.999) << "(p999)"
+                << ", qps: " << cs.succ_qps << "#/s"
+                << ", thp: " << cs.succ_throughput_MB_s << "MB/s"
+                ;
+            return ss.str();
         }
-    }
-}
 
+        void perf_client_helper::find_knees(const perf_test_suite& s, std::vector<open_loop_knee>& knees) const
+        {
+            // the rate sweeps are the runs of open-loop cases with the same
+            // payload and timeout; a rate is saturated when the achieved qps
+            // falls behind the target or the tail latency blows up
+            knees.clear();
+            uint64_t base_p99 = 0;
+            bool saturated = false;
+            for (size_t i = 0; i < s.cases.size(); i++)
+            {
+                auto& cs = s.cases[i];
+                if (cs.rate_qps == 0)
+                    continue;
+
+                if (knees.empty()
+                    || knees.back().payload_bytes != cs.payload_bytes
+                    || knees.back().timeout_ms != cs.timeout_ms)
+                {
+                    open_loop_knee k;
+                    k.payload_bytes = cs.payload_bytes;
+                    k.timeout_ms = cs.timeout_ms;
+                    k.knee_qps = 0;
+                    k.saturated_qps = 0;
+                    knees.push_back(k);
+
+                    base_p99 = cs.succ_latency.percentile(0.99);
+                    saturated = false;
+                }
 
+                if (saturated)
+                    continue;
 
+                auto p99 = cs.succ_latency.percentile(0.99);
+                if (cs.succ_qps < 0.95 * (double)cs.rate_qps
+                    || (base_p99 > 0 && p99 > base_p99 * (uint64_t)s.knee_latency_factor))
+                {
+                    knees.back().saturated_qps = cs.rate_qps;
+                    saturated = true;
+                }
+                else
+                {
+                    knees.back().knee_qps = cs.rate_qps;
+                }
+            }
+        }
+
+        std::string perf_client_helper::knees_to_string(const perf_test_suite& s) const
+        {
+            std::vector<open_loop_knee> knees;
+            find_knees(s, knees);
+
+            std::stringstream ss;
+            for (auto& k : knees)
+            {
+                ss << "TEST " << s.name << "::  payload(byte): " << k.payload_bytes
+                    << ", timeout(ms): " << k.timeout_ms
+                    << ", knee(qps): " << k.knee_qps
+                    << ", saturated(qps): ";
+                if (k.saturated_qps > 0)
+                    ss << k.saturated_qps;
+                else
+                    ss << "none";
+                ss << std::endl;
+            }
+            return ss.str();
+        }
+
+        std::string perf_client_helper::to_json(uint64_t ts) const
+        {
+            // the non-empty histogram buckets are dumped as [lower, upper, count],
+            // so that results of several clients or runs can be merged
+            std::stringstream ss;
+            ss << "{\"ts\": " << ts << ", \"suites\": [";
+            for (size_t si = 0; si < _suits.size(); si++)
+            {
+                auto& s = _suits[si];
+                ss << (si > 0 ? ", " : "") << "{\"name\": \"" << s.name << "\", \"cases\": [";
+                for (size_t ci = 0; ci < s.cases.size(); ci++)
+                {
+                    auto& cs = s.cases[ci];
+                    bool has_succ = cs.succ_rounds > 0;
+                    ss << (ci > 0 ? ", " : "") << "{"
+                        << "\"id\": " << cs.id
+                        << ", \"seconds\": " << cs.seconds
+                        << ", \"payload_bytes\": " << cs.payload_bytes
+                        << ", \"timeout_ms\": " << cs.timeout_ms
+                        << ", \"concurrency\": " << cs.concurrency
+                        << ", \"rate_qps\": " << cs.rate_qps
+                        << ", \"arrival\": \"" << (cs.rate_qps == 0 ? "closed" : (cs.poisson_arrival ? "poisson" : "constant")) << "\""
+                        << ", \"timeout_rounds\": " << cs.timeout_rounds
+                        << ", \"error_rounds\": " << cs.error_rounds
+                        << ", \"succ_rounds\": " << cs.succ_rounds
+                        << ", \"qps\": " << cs.succ_qps
+                        << ", \"throughput_MB_s\": " << cs.succ_throughput_MB_s
+                        << ", \"latency_ns\": {"
+                        << "\"avg\": " << (has_succ ? cs.succ_latency_avg_ns : 0.0)
+                        << ", \"min\": " << (has_succ ? (uint64_t)cs.min_latency_ns : 0)
+                        << ", \"max\": " << (uint64_t)cs.max_latency_ns
+                        << ", \"p50\": " << cs.succ_latency.percentile(0.5)
+                        << ", \"p90\": " << cs.succ_latency.percentile(0.9)
+                        << ", \"p99\": " << cs.succ_latency.percentile(0.99)
+                        << ", \"p999\": " << cs.succ_latency.percentile(0.999)
+                        << "}, \"histogram\": [";
+
+                    bool first = true;
+                    for (int b = 0; b < latency_histogram::BUCKET_COUNT; b++)
+                    {
+                        auto c = cs.succ_latency.bucket_count(b);
+                        if (c == 0)
+                            continue;
+                        ss << (first ? "" : ", ") << "["
+                            << latency_histogram::bucket_lower_bound(b) << ", "
+                            << latency_histogram::bucket_upper_bound(b) << ", "
+                            << c << "]";
+                        first = false;
+                    }
+                    ss << "]}";
+                }
+
+                std::vector<open_loop_knee> knees;
+                find_knees(s, knees);
+                ss << "], \"knees\": [";
+                for (size_t ki = 0; ki < knees.size(); ki++)
+                {
+                    auto& k = knees[ki];
+                    ss << (ki > 0 ? ", " : "") << "{"
+                        << "\"payload_bytes\": " << k.payload_bytes
+                        << ", \"timeout_ms\": " << k.timeout_ms
+                        << ", \"knee_qps\": " << k.knee_qps
+                        << ", \"saturated_qps\": " << k.saturated_qps
+                        << "}";
+                }
+                ss << "]}";
+            }
+            ss << "]}";
+            return ss.str();
+        }
+    }
+}
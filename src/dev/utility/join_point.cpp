@@ -44,6 +44,32 @@ join_point_base::join_point_base(const char* name)
     _name = std::string(name);
     _hdr.next = _hdr.prev = &_hdr;
     _hdr.name = "";
+    _advices.store(new std::vector<advice_slot>(), std::memory_order_relaxed);
+    _advices_empty.store(true, std::memory_order_relaxed);
+}
+
+join_point_base::~join_point_base()
+{
+    delete _advices.load(std::memory_order_relaxed);
+    for (auto a : _retired_advices)
+        delete a;
+}
+
+void join_point_base::rebuild_advices()
+{
+    auto advices = new std::vector<advice_slot>();
+    for (auto p = _hdr.next; p != &_hdr; p = p->next)
+    {
+        advice_slot slot;
+        slot.func = p->func;
+        slot.is_native = p->is_native;
+        advices->push_back(slot);
+    }
+
+    // the array before the flag, so that a non-empty flag is never seen with an older array
+    _retired_advices.push_back(_advices.load(std::memory_order_relaxed));
+    _advices.store(advices, std::memory_order_release);
+    _advices_empty.store(advices->empty(), std::memory_order_release);
 }
 
 bool join_point_base::put_front(void* fn, const char* name, bool is_native)
@@ -56,6 +82,7 @@ bool join_point_base::put_front(void* fn, const char* name, bool is_native)
     e1->prev = e;
     e->prev = &_hdr;
 
+    rebuild_advices();
     return true;
 }
 
@@ -69,6 +96,7 @@ bool join_point_base::put_back(void* fn, const char* name, bool is_native)
     _hdr.prev = e;
     e->prev = e1;
 
+    rebuild_advices();
     return true;
 }
 
@@ -90,6 +118,7 @@ bool join_point_base::put_before(const char* base, void* fn, const char* name, b
     e0->prev = e;
     e->prev = e1;
     
+    rebuild_advices();
     return true;
 }
 
@@ -111,6 +140,7 @@ bool join_point_base::put_after(const char* base, void* fn, const char* name, bo
     e0->next = e;
     e->next = e1;
     
+    rebuild_advices();
     return true;
 }
 
@@ -127,6 +157,7 @@ bool join_point_base::put_replace(const char* base, void* fn, const char* name)
     {
         e0->func = fn;
         e0->name = name;
+        rebuild_advices();
         return true;
     }
 }
@@ -144,6 +175,7 @@ bool join_point_base::remove(const char* name)
     e0->next->prev = e0->prev;
     e0->prev->next = e0->next;
 
+    rebuild_advices();
     return true;
 }
 
@@ -0,0 +1,19 @@
+@ECHO OFF
+@MKDIR perf-result-batch
+@RMDIR /Q /S data
+
+:: compares per-request and batched application of committed writes at several batch
+:: sizes, with the batch size driven by how long a mutation waits for more requests
+
+:: %batch_pending_ms% - how long (ms) a mutation waits for more requests
+FOR %%P IN (1,5,20,50) DO (
+    :: %batched_write% - whether simple_kv applies a committed batch with one store pass
+    FOR %%B IN (false true) DO (
+        CALL dsn.app.simple_kv perf-config.ini -cargs replica_count=3;tcp_network_provider=dsn::tools::asio_network_provider;udp_network_provider=dsn::tools::asio_udp_provider;aio_provider=dsn::tools::native_aio_provider;batch_pending_ms=%%P;batched_write=%%B
+        MKDIR perf-result-batch\pending-%%P.batched-%%B
+        XCOPY /Y data\client.perf.test\perf-result-* .\perf-result-batch\pending-%%P.batched-%%B\
+        @RMDIR /Q /S data
+    )
+)
+
+:exit
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+set -e
+
+# compares per-request and batched application of committed writes at several batch
+# sizes, with the batch size driven by how long a mutation waits for more requests
+
+mkdir -p perf-result-batch
+rm -rf data
+
+#%batch_pending_ms% - how long (ms) a mutation waits for more requests
+for pending_ms in 1 5 20 50;do
+    #%batched_write% - whether simple_kv applies a committed batch with one store pass
+    for batched in false true;do
+        ./dsn.app.simple_kv perf-config.ini -cargs replica_count=3,tcp_network_provider=dsn::tools::asio_network_provider,udp_network_provider=dsn::tools::asio_udp_provider,aio_provider=dsn::tools::native_aio_provider,batch_pending_ms=${pending_ms},batched_write=${batched}
+        for f in data/client.perf.test/perf-result-*;do
+            cp ${f} ./perf-result-batch/$(basename ${f}).pending-${pending_ms}.batched-${batched}
+        done
+        rm -rf data
+    done
+done
@@ -0,0 +1,594 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     checkpoint file format of simple_kv
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "simple_kv.checkpoint.h"
+# include "simple_kv.code.definition.h"
+# include <fstream>
+# include <set>
+# include <algorithm>
+
+# ifndef _WIN32
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# endif
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "simple.kv.checkpoint"
+
+using namespace ::dsn::service;
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            static_assert(sizeof(checkpoint_header) == 64, "checkpoint header must be 64 bytes");
+
+            static const uint32_t CHECKPOINT_V1_MAGIC = 0xdeadbeef;
+
+            checkpoint_builder::checkpoint_builder(const std::vector<kv_store::entry>& entries, uint32_t block_bytes)
+                : _entries(entries), _block_bytes(block_bytes), _cursor(0),
+                _offset(sizeof(checkpoint_header)), _stage(STAGE_BLOCKS),
+                _index_offset(0), _index_size(0), _index_crc(0)
+            {
+            }
+
+            bool checkpoint_builder::next(/*out*/ blob& data, /*out*/ uint64_t& offset)
+            {
+                switch (_stage)
+                {
+                case STAGE_BLOCKS:
+                    offset = _offset;
+                    data = build_block();
+                    _offset += data.length();
+                    if (_cursor == _entries.size())
+                        _stage = STAGE_INDEX;
+                    return true;
+                case STAGE_INDEX:
+                    _index_offset = _offset;
+                    offset = _offset;
+                    data = build_index();
+                    _stage = STAGE_HEADER;
+                    return true;
+                case STAGE_HEADER:
+                    offset = 0;
+                    data = build_header();
+                    _stage = STAGE_DONE;
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            blob checkpoint_builder::build_block()
+            {
+                size_t bytes = 0;
+                size_t end = _cursor;
+                while (end < _entries.size() && (end == _cursor || bytes < _block_bytes))
+                {
+                    bytes += sizeof(uint32_t) * 2 + _entries[end].first.length() + _entries[end].second.length();
+                    end++;
+                }
+
+                auto buffer = dsn::make_shared_array<char>(bytes);
+                char* ptr = buffer.get();
+
+                block_info info;
+                info.offset = _offset;
+                info.size = (uint32_t)bytes;
+                info.count = (uint32_t)(end - _cursor);
+                if (_cursor < end)
+                    info.first_key = _entries[_cursor].first;
+
+                for (; _cursor < end; _cursor++)
+                {
+                    const std::string& k = _entries[_cursor].first;
+                    const blob& v = _entries[_cursor].second;
+
+                    uint32_t sz = (uint32_t)k.length();
+                    memcpy(ptr, &sz, sizeof(sz));
+                    ptr += sizeof(sz);
+                    memcpy(ptr, k.c_str(), sz);
+                    ptr += sz;
+
+                    sz = v.length();
+                    memcpy(ptr, &sz, sizeof(sz));
+                    ptr += sizeof(sz);
+                    memcpy(ptr, v.data(), sz);
+                    ptr += sz;
+                }
+
+                info.crc = dsn_crc32_compute(buffer.get(), bytes, 0);
+                if (info.count > 0)
+                    _blocks.push_back(std::move(info));
+
+                return blob(std::move(buffer), (unsigned int)bytes);
+            }
+
+            blob checkpoint_builder::build_index()
+            {
+                size_t bytes = 0;
+                for (auto& b : _blocks)
+                {
+                    bytes += sizeof(uint64_t) + sizeof(uint32_t) * 4 + b.first_key.length();
+                }
+
+                auto buffer = dsn::make_shared_array<char>(bytes);
+                char* ptr = buffer.get();
+                for (auto& b : _blocks)
+                {
+                    uint32_t key_size = (uint32_t)b.first_key.length();
+                    memcpy(ptr, &b.offset, sizeof(b.offset));
+                    ptr += sizeof(b.offset);
+                    memcpy(ptr, &b.size, sizeof(b.size));
+                    ptr += sizeof(b.size);
+                    memcpy(ptr, &b.count, sizeof(b.count));
+                    ptr += sizeof(b.count);
+                    memcpy(ptr, &b.crc, sizeof(b.crc));
+                    ptr += sizeof(b.crc);
+                    memcpy(ptr, &key_size, sizeof(key_size));
+                    ptr += sizeof(key_size);
+                    memcpy(ptr, b.first_key.c_str(), key_size);
+                    ptr += key_size;
+                }
+
+                _index_size = (uint32_t)bytes;
+                _index_crc = dsn_crc32_compute(buffer.get(), bytes, 0);
+                return blob(std::move(buffer), (unsigned int)bytes);
+            }
+
+            blob checkpoint_builder::build_header()
+            {
+                auto buffer = dsn::make_shared_array<char>(sizeof(checkpoint_header));
+                checkpoint_header* hdr = (checkpoint_header*)buffer.get();
+                memset(hdr, 0, sizeof(*hdr));
+                hdr->magic = checkpoint_header::MAGIC;
+                hdr->version = checkpoint_header::VERSION;
+                hdr->entry_count = (uint64_t)_entries.size();
+                hdr->index_offset = _index_offset;
+                hdr->index_size = _index_size;
+                hdr->index_crc = _index_crc;
+                hdr->block_count = (uint32_t)_blocks.size();
+                hdr->header_crc = dsn_crc32_compute(hdr, offsetof(checkpoint_header, header_crc), 0);
+                return blob(std::move(buffer), (unsigned int)sizeof(checkpoint_header));
+            }
+
+            //------------------------------------------------------------------------
+
+            // read-only view of a whole file, mapped where possible so that
+            // recovery pays no extra copy and pages are read by whoever parses them
+            class mapped_file
+            {
+            public:
+                mapped_file() : _data(nullptr), _size(0), _mapped(false) {}
+
+                ~mapped_file()
+                {
+# ifndef _WIN32
+                    if (_mapped)
+                        ::munmap((void*)_data, (size_t)_size);
+# endif
+                }
+
+                bool open(const std::string& path)
+                {
+# ifndef _WIN32
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    if (fd < 0)
+                        return false;
+
+                    struct stat st;
+                    if (::fstat(fd, &st) != 0)
+                    {
+                        ::close(fd);
+                        return false;
+                    }
+
+                    _size = (uint64_t)st.st_size;
+                    if (_size > 0)
+                    {
+                        void* addr = ::mmap(nullptr, (size_t)_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                        if (addr == MAP_FAILED)
+                        {
+                            ::close(fd);
+                            return false;
+                        }
+                        ::madvise(addr, (size_t)_size, MADV_WILLNEED);
+                        _data = (const char*)addr;
+                        _mapped = true;
+                    }
+                    ::close(fd);
+                    return true;
+# else
+                    std::ifstream is(path.c_str(), std::ios::binary | std::ios::ate);
+                    if (!is.is_open())
+                        return false;
+
+                    _size = (uint64_t)is.tellg();
+                    _buffer.reset(new char[(size_t)_size + 1]);
+                    is.seekg(0);
+                    is.read(_buffer.get(), (std::streamsize)_size);
+                    if (!is)
+                        return false;
+                    _data = _buffer.get();
+                    return true;
+# endif
+                }
+
+                const char* data() const { return _data; }
+                uint64_t size() const { return _size; }
+
+            private:
+                const char* _data;
+                uint64_t    _size;
+                bool        _mapped;
+                std::unique_ptr<char[]> _buffer;
+            };
+
+            // bounds-checked sequential reads over a memory range
+            class checkpoint_reader
+            {
+            public:
+                checkpoint_reader(const char* begin, uint64_t size) : _ptr(begin), _end(begin + size) {}
+
+                bool read_u32(/*out*/ uint32_t& v) { return read(&v, sizeof(v)); }
+                bool read_u64(/*out*/ uint64_t& v) { return read(&v, sizeof(v)); }
+
+                bool read_string(/*out*/ std::string& s)
+                {
+                    uint32_t sz;
+                    if (!read_u32(sz) || (uint64_t)(_end - _ptr) < sz)
+                        return false;
+                    s.assign(_ptr, sz);
+                    _ptr += sz;
+                    return true;
+                }
+
+                bool read_value(/*out*/ blob& v)
+                {
+                    uint32_t sz;
+                    if (!read_u32(sz) || (uint64_t)(_end - _ptr) < sz)
+                        return false;
+                    auto buffer = dsn::make_shared_array<char>(sz);
+                    memcpy(buffer.get(), _ptr, sz);
+                    _ptr += sz;
+                    v.assign(std::move(buffer), 0, sz);
+                    return true;
+                }
+
+                bool eof() const { return _ptr == _end; }
+
+            private:
+                bool read(void* v, size_t sz)
+                {
+                    if ((size_t)(_end - _ptr) < sz)
+                        return false;
+                    memcpy(v, _ptr, sz);
+                    _ptr += sz;
+                    return true;
+                }
+
+            private:
+                const char* _ptr;
+                const char* _end;
+            };
+
+            static bool parse_entries(checkpoint_reader& reader, uint64_t count, /*out*/ std::vector<kv_store::entry>& entries)
+            {
+                entries.reserve((size_t)count);
+                for (uint64_t i = 0; i < count; i++)
+                {
+                    entries.emplace_back();
+                    if (!reader.read_string(entries.back().first) || !reader.read_value(entries.back().second))
+                        return false;
+                }
+                return true;
+            }
+
+            static ::dsn::error_code load_checkpoint_v1(const mapped_file& file, kv_store* store)
+            {
+                checkpoint_reader reader(file.data(), file.size());
+                uint64_t count;
+                uint32_t magic;
+                if (!reader.read_u64(count) || !reader.read_u32(magic) || magic != CHECKPOINT_V1_MAGIC)
+                    return ERR_INVALID_DATA;
+
+                // no index, so sequential; batches keep the store locking cheap
+                const uint64_t batch_size = 4096;
+                std::vector<kv_store::entry> entries;
+                for (uint64_t i = 0; i < count; i += batch_size)
+                {
+                    entries.clear();
+                    if (!parse_entries(reader, std::min(batch_size, count - i), entries))
+                        return ERR_INVALID_DATA;
+                    store->put_batch(entries);
+                }
+                return ERR_OK;
+            }
+
+            struct checkpoint_block_ref
+            {
+                uint64_t offset;
+                uint32_t size;
+                uint32_t count;
+                uint32_t crc;
+            };
+
+            struct parallel_load_state
+            {
+                const char* data;
+                std::vector<checkpoint_block_ref> blocks;
+                kv_store* store;
+
+                std::atomic<size_t> next;     // next block to claim
+                std::atomic<size_t> finished; // blocks done, successfully or not
+                std::atomic<bool>   failed;
+                utils::notify_event done;     // signalled by whoever finishes the last block
+
+                parallel_load_state() : data(nullptr), store(nullptr), next(0), finished(0), failed(false) {}
+            };
+
+            // claim and load blocks until there is none left, run by the recovery
+            // tasks and the caller alike, so recovery completes even when no task
+            // gets a thread (e.g., the caller occupies the only one of the pool)
+            static void load_blocks(parallel_load_state& st)
+            {
+                std::vector<kv_store::entry> entries;
+                size_t i;
+                while ((i = st.next++) < st.blocks.size())
+                {
+                    auto& b = st.blocks[i];
+                    if (!st.failed.load(std::memory_order_relaxed))
+                    {
+                        entries.clear();
+                        checkpoint_reader reader(st.data + b.offset, b.size);
+                        if (dsn_crc32_compute(st.data + b.offset, b.size, 0) != b.crc
+                            || !parse_entries(reader, b.count, entries)
+                            || !reader.eof())
+                        {
+                            derror("corrupted checkpoint block at offset %" PRIu64, b.offset);
+                            st.failed = true;
+                        }
+                        else
+                        {
+                            st.store->put_batch(entries);
+                        }
+                    }
+                    if (++st.finished == st.blocks.size())
+                        st.done.notify();
+                }
+            }
+
+            static ::dsn::error_code load_checkpoint_v2(const mapped_file& file, kv_store* store, int parallelism)
+            {
+                checkpoint_header hdr;
+                memcpy(&hdr, file.data(), sizeof(hdr));
+                if (hdr.header_crc != dsn_crc32_compute(&hdr, offsetof(checkpoint_header, header_crc), 0)
+                    || hdr.index_offset < sizeof(hdr)
+                    || hdr.index_offset + hdr.index_size > file.size()
+                    || hdr.index_crc != dsn_crc32_compute(file.data() + hdr.index_offset, hdr.index_size, 0))
+                {
+                    return ERR_INVALID_DATA;
+                }
+
+                auto st = std::make_shared<parallel_load_state>();
+                st->data = file.data();
+                st->store = store;
+                st->blocks.reserve(hdr.block_count);
+
+                uint64_t count = 0;
+                std::string first_key;
+                checkpoint_reader index(file.data() + hdr.index_offset, hdr.index_size);
+                for (uint32_t i = 0; i < hdr.block_count; i++)
+                {
+                    checkpoint_block_ref b;
+                    if (!index.read_u64(b.offset) || !index.read_u32(b.size)
+                        || !index.read_u32(b.count) || !index.read_u32(b.crc)
+                        || !index.read_string(first_key)
+                        || b.offset < sizeof(hdr) || b.offset + b.size > hdr.index_offset)
+                    {
+                        return ERR_INVALID_DATA;
+                    }
+                    count += b.count;
+                    st->blocks.push_back(b);
+                }
+                if (!index.eof() || count != hdr.entry_count)
+                    return ERR_INVALID_DATA;
+
+                // blocks are disjoint in keys, so they can go to the store in any order
+                int tasks = std::min(parallelism, (int)st->blocks.size()) - 1;
+                for (int i = 0; i < tasks; i++)
+                {
+                    tasking::enqueue(LPC_SIMPLE_KV_RECOVER, nullptr, [st]() { load_blocks(*st); }, i);
+                }
+                load_blocks(*st);
+
+                // wait for the blocks claimed by the tasks, tasks not started by now
+                // find nothing left to claim and never touch the file
+                if (!st->blocks.empty())
+                    st->done.wait();
+
+                return st->failed ? ERR_INVALID_DATA : ERR_OK;
+            }
+
+            ::dsn::error_code load_checkpoint(const std::string& path, kv_store* store, int parallelism)
+            {
+                mapped_file file;
+                if (!file.open(path))
+                {
+                    derror("open checkpoint %s failed", path.c_str());
+                    return ERR_FILE_OPERATION_FAILED;
+                }
+
+                ::dsn::error_code err = ERR_INVALID_DATA;
+                uint32_t magic = 0;
+                if (file.size() >= sizeof(checkpoint_header))
+                {
+                    memcpy(&magic, file.data(), sizeof(magic));
+                }
+
+                if (magic == checkpoint_header::MAGIC)
+                {
+                    err = load_checkpoint_v2(file, store, parallelism);
+                }
+                else
+                {
+                    err = load_checkpoint_v1(file, store);
+                }
+
+                if (err != ERR_OK)
+                {
+                    derror("load checkpoint %s failed, err = %s", path.c_str(), err.to_string());
+                }
+                return err;
+            }
+
+            //------------------------------------------------------------------------
+
+            std::string checkpoint_file::file_name() const
+            {
+                char name[64];
+                if (is_delta())
+                    sprintf(name, "delta.%" PRId64 ".%" PRId64, prev_decree, decree);
+                else
+                    sprintf(name, "checkpoint.%" PRId64, decree);
+                return std::string(name);
+            }
+
+            static bool parse_decree(const char* s, char stop, /*out*/ int64_t& decree, /*out*/ const char*& end)
+            {
+                if (*s < '0' || *s > '9')
+                    return false;
+
+                char* e = nullptr;
+                decree = static_cast<int64_t>(strtoll(s, &e, 10));
+                end = e;
+                return *end == stop && decree > 0;
+            }
+
+            bool checkpoint_file::parse(const std::string& file_name, /*out*/ checkpoint_file& f)
+            {
+                const char* end = nullptr;
+                f = checkpoint_file();
+                if (file_name.compare(0, strlen("checkpoint."), "checkpoint.") == 0)
+                {
+                    return parse_decree(file_name.c_str() + strlen("checkpoint."), '\0', f.decree, end);
+                }
+                else if (file_name.compare(0, strlen("delta."), "delta.") == 0)
+                {
+                    return parse_decree(file_name.c_str() + strlen("delta."), '.', f.prev_decree, end)
+                        && parse_decree(end + 1, '\0', f.decree, end)
+                        && f.prev_decree < f.decree;
+                }
+                return false;
+            }
+
+            void find_checkpoint_chain(
+                const std::vector<checkpoint_file>& files,
+                int64_t full_decree,
+                /*out*/ std::vector<checkpoint_file>& chain
+                )
+            {
+                chain.clear();
+                for (auto& f : files)
+                {
+                    if (!f.is_delta() && f.decree == full_decree)
+                    {
+                        chain.push_back(f);
+                        break;
+                    }
+                }
+
+                while (!chain.empty())
+                {
+                    // several deltas on the same decree are left only by a replaced
+                    // chain (e.g., after a checkpoint copy), take the latest
+                    const checkpoint_file* next = nullptr;
+                    for (auto& f : files)
+                    {
+                        if (f.is_delta() && f.prev_decree == chain.back().decree
+                            && (next == nullptr || f.decree > next->decree))
+                            next = &f;
+                    }
+                    if (next == nullptr)
+                        break;
+                    chain.push_back(*next);
+                }
+            }
+
+            void find_obsolete_checkpoints(
+                const std::vector<checkpoint_file>& files,
+                const std::vector<checkpoint_file>& current_chain,
+                int64_t durable_decree,
+                uint32_t retained_fulls,
+                /*out*/ std::vector<checkpoint_file>& obsolete
+                )
+            {
+                std::vector<int64_t> fulls;
+                for (auto& f : files)
+                {
+                    if (!f.is_delta())
+                        fulls.push_back(f.decree);
+                }
+                std::sort(fulls.begin(), fulls.end(), std::greater<int64_t>());
+                if (fulls.size() > retained_fulls)
+                    fulls.resize(retained_fulls);
+
+                std::set<std::string> kept;
+                std::vector<checkpoint_file> chain;
+                for (auto d : fulls)
+                {
+                    find_checkpoint_chain(files, d, chain);
+                    for (auto& f : chain)
+                        kept.insert(f.file_name());
+                }
+                for (auto& f : current_chain)
+                {
+                    kept.insert(f.file_name());
+                }
+
+                obsolete.clear();
+                for (auto& f : files)
+                {
+                    if (f.decree <= durable_decree && kept.find(f.file_name()) == kept.end())
+                        obsolete.push_back(f);
+                }
+            }
+        }
+    }
+}
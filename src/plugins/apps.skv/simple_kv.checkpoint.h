@@ -0,0 +1,165 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     checkpoint file format of simple_kv
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include "simple_kv.store.h"
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            //
+            // checkpoint file, version 2:
+            //
+            //   header      checkpoint_header, 64 bytes
+            //   blocks      [u32 key size][key][u32 value size][value] ..., in key order,
+            //               about checkpoint_block_bytes each
+            //   index       for each block: [u64 offset][u32 size][u32 entry count][u32 crc32]
+            //               [u32 first key size][first key]
+            //
+            // the file is loaded through mmap, with blocks verified and parsed in parallel;
+            // version 1 files ([u64 entry count][0xdeadbeef][entries]) are still loadable
+            //
+            struct checkpoint_header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint64_t entry_count;
+                uint64_t index_offset;
+                uint32_t index_size;
+                uint32_t index_crc;
+                uint32_t block_count;
+                uint32_t header_crc; // crc32 of the fields above
+                char     reserved[24];
+
+                static const uint32_t MAGIC = 0x32564b53; // "SKV2"
+                static const uint32_t VERSION = 2;
+            };
+
+            //
+            // produces the pieces of a checkpoint file from entries sorted by key;
+            // the pieces can be written in the given order with sequential writes,
+            // the header goes last as it refers to the index
+            //
+            class checkpoint_builder
+            {
+            public:
+                checkpoint_builder(const std::vector<kv_store::entry>& entries, uint32_t block_bytes);
+
+                // next piece and its file offset, false when the file is complete
+                bool next(/*out*/ blob& data, /*out*/ uint64_t& offset);
+
+                uint64_t file_size() const { return _index_offset + _index_size; }
+
+            private:
+                blob build_block();
+                blob build_index();
+                blob build_header();
+
+            private:
+                struct block_info
+                {
+                    uint64_t offset;
+                    uint32_t size;
+                    uint32_t count;
+                    uint32_t crc;
+                    std::string first_key;
+                };
+
+                enum stage { STAGE_BLOCKS, STAGE_INDEX, STAGE_HEADER, STAGE_DONE };
+
+                const std::vector<kv_store::entry>& _entries;
+                uint32_t _block_bytes;
+                size_t   _cursor;
+                uint64_t _offset;
+                stage    _stage;
+
+                std::vector<block_info> _blocks;
+                uint64_t _index_offset;
+                uint32_t _index_size;
+                uint32_t _index_crc;
+            };
+
+            // load a checkpoint file of any version into store, using up to parallelism tasks
+            ::dsn::error_code load_checkpoint(const std::string& path, kv_store* store, int parallelism);
+
+            //
+            // checkpoint files in the data dir:
+            //
+            //   checkpoint.<decree>     full checkpoint as of decree
+            //   delta.<prev>.<decree>   keys written in (prev, decree], to be applied on top
+            //                           of the full or delta checkpoint at prev
+            //
+            // a chain is a full checkpoint followed by the deltas on it, in decree order,
+            // and the state as of its last decree is loaded by applying all of them in order
+            //
+            struct checkpoint_file
+            {
+                int64_t  decree;
+                int64_t  prev_decree; // 0 for full checkpoints
+                uint64_t size;
+
+                checkpoint_file() : decree(0), prev_decree(0), size(0) {}
+
+                bool is_delta() const { return prev_decree > 0; }
+
+                std::string file_name() const;
+
+                static bool parse(const std::string& file_name, /*out*/ checkpoint_file& f);
+            };
+
+            // the chain starting with the full checkpoint at full_decree, as long as files allow
+            void find_checkpoint_chain(
+                const std::vector<checkpoint_file>& files,
+                int64_t full_decree,
+                /*out*/ std::vector<checkpoint_file>& chain
+                );
+
+            //
+            // files that can be removed: those up to durable_decree which are neither in the
+            // chains on the latest retained_fulls full checkpoints nor in current_chain, so
+            // that learners still copying a previous chain do not lose their files immediately
+            //
+            void find_obsolete_checkpoints(
+                const std::vector<checkpoint_file>& files,
+                const std::vector<checkpoint_file>& current_chain,
+                int64_t durable_decree,
+                uint32_t retained_fulls,
+                /*out*/ std::vector<checkpoint_file>& obsolete
+                );
+        }
+    }
+}
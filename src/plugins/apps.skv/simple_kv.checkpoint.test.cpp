@@ -0,0 +1,312 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the checkpoint files of simple_kv.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "simple_kv.checkpoint.h"
+# include <gtest/gtest.h>
+# include <fstream>
+
+using namespace dsn;
+using namespace dsn::replication::application;
+
+static void checkpoint_test_entries(int count, /*out*/ std::vector<kv_store::entry>& entries)
+{
+    entries.clear();
+    for (int i = 0; i < count; i++)
+    {
+        char key[32];
+        sprintf(key, "key.%06d", i);
+        entries.emplace_back(key, kv_store::make_value(std::string(i % 100, (char)('a' + i % 26))));
+    }
+}
+
+static void checkpoint_test_write(const std::string& path, const std::vector<kv_store::entry>& entries, uint32_t block_bytes)
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    checkpoint_builder builder(entries, block_bytes);
+    blob block;
+    uint64_t offset;
+    while (builder.next(block, offset))
+    {
+        os.seekp((std::streamoff)offset);
+        os.write(block.data(), block.length());
+    }
+    os.close();
+    ASSERT_FALSE(os.fail());
+    ASSERT_EQ(builder.file_size(), (uint64_t)std::ifstream(path, std::ios::binary | std::ios::ate).tellg());
+}
+
+static void checkpoint_test_check(kv_store* store, const std::vector<kv_store::entry>& entries)
+{
+    std::vector<kv_store::entry> loaded;
+    store->scan_ordered([&loaded](const std::string& key, const blob& value) { loaded.emplace_back(key, value); });
+    ASSERT_EQ(entries.size(), loaded.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        ASSERT_EQ(entries[i].first, loaded[i].first);
+        ASSERT_EQ(std::string(entries[i].second.data(), entries[i].second.length()),
+            std::string(loaded[i].second.data(), loaded[i].second.length()));
+    }
+}
+
+// flip one byte of the file at offset
+static void checkpoint_test_corrupt(const std::string& path, uint64_t offset)
+{
+    std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out);
+    fs.seekg((std::streamoff)offset);
+    char c = 0;
+    fs.read(&c, 1);
+    c ^= 0x5a;
+    fs.seekp((std::streamoff)offset);
+    fs.write(&c, 1);
+}
+
+// keep the first size bytes of the file
+static void checkpoint_test_truncate(const std::string& path, int64_t size)
+{
+    std::string data;
+    {
+        std::ifstream is(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os.write(data.c_str(), std::min((int64_t)data.length(), size));
+}
+
+TEST(apps_skv, checkpoint_round_trip)
+{
+    int parallelism = 4;
+    std::string path = "skv_test_checkpoint.dat";
+    std::vector<kv_store::entry> entries;
+
+    // many small blocks, loaded in parallel
+    checkpoint_test_entries(3000, entries);
+    checkpoint_test_write(path, entries, 1024);
+    std::unique_ptr<kv_store> store(new sharded_kv_store(8));
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), parallelism));
+    checkpoint_test_check(store.get(), entries);
+
+    // loaded on top of what the store has, e.g., deltas
+    std::vector<kv_store::entry> delta;
+    delta.emplace_back("key.000001", kv_store::make_value("new"));
+    delta.emplace_back("key.999999", kv_store::make_value("added"));
+    checkpoint_test_write(path, delta, 1024);
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), parallelism));
+    entries[1].second = delta[0].second;
+    entries.push_back(delta[1]);
+    checkpoint_test_check(store.get(), entries);
+
+    // a single block, and no entries at all
+    checkpoint_test_entries(10, entries);
+    checkpoint_test_write(path, entries, 1024 * 1024);
+    store.reset(kv_store::create("ordered_map"));
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), parallelism));
+    checkpoint_test_check(store.get(), entries);
+
+    entries.clear();
+    checkpoint_test_write(path, entries, 1024);
+    store.reset(kv_store::create("ordered_map"));
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), parallelism));
+    ASSERT_EQ(0u, store->size());
+
+    utils::filesystem::remove_path(path);
+}
+
+TEST(apps_skv, checkpoint_corruption)
+{
+    int parallelism = 4;
+    std::string path = "skv_test_checkpoint_corrupted.dat";
+    std::vector<kv_store::entry> entries;
+    checkpoint_test_entries(1000, entries);
+    std::unique_ptr<kv_store> store(new sharded_kv_store(8));
+
+    ASSERT_EQ(ERR_FILE_OPERATION_FAILED, load_checkpoint(path, store.get(), parallelism));
+
+    checkpoint_test_write(path, entries, 1024);
+    int64_t size = 0;
+    ASSERT_TRUE(utils::filesystem::file_size(path, size));
+
+    // a block in the middle, the end of the index, the header
+    uint64_t offsets[] = { (uint64_t)size / 2, (uint64_t)size - 1, 8 };
+    for (auto offset : offsets)
+    {
+        checkpoint_test_write(path, entries, 1024);
+        checkpoint_test_corrupt(path, offset);
+        ASSERT_EQ(ERR_INVALID_DATA, load_checkpoint(path, store.get(), parallelism));
+    }
+
+    // truncated
+    checkpoint_test_write(path, entries, 1024);
+    checkpoint_test_truncate(path, size - 10);
+    ASSERT_EQ(ERR_INVALID_DATA, load_checkpoint(path, store.get(), parallelism));
+
+    utils::filesystem::remove_path(path);
+}
+
+// [u64 entry count][u32 0xdeadbeef][u32 key size][key][u32 value size][value] ...
+static void checkpoint_test_write_v1(const std::string& path, const std::vector<kv_store::entry>& entries)
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    uint64_t count = entries.size();
+    uint32_t magic = 0xdeadbeef;
+    os.write((const char*)&count, sizeof(count));
+    os.write((const char*)&magic, sizeof(magic));
+    for (auto& e : entries)
+    {
+        uint32_t sz = (uint32_t)e.first.length();
+        os.write((const char*)&sz, sizeof(sz));
+        os.write(e.first.c_str(), sz);
+        sz = e.second.length();
+        os.write((const char*)&sz, sizeof(sz));
+        os.write(e.second.data(), sz);
+    }
+}
+
+TEST(apps_skv, checkpoint_v1)
+{
+    std::string path = "skv_test_checkpoint_v1.dat";
+    std::vector<kv_store::entry> entries;
+
+    // more than one load batch
+    checkpoint_test_entries(5000, entries);
+    checkpoint_test_write_v1(path, entries);
+    std::unique_ptr<kv_store> store(new sharded_kv_store(8));
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), 4));
+    checkpoint_test_check(store.get(), entries);
+
+    entries.clear();
+    checkpoint_test_write_v1(path, entries);
+    store.reset(kv_store::create("ordered_map"));
+    ASSERT_EQ(ERR_OK, load_checkpoint(path, store.get(), 4));
+    ASSERT_EQ(0u, store->size());
+
+    // truncated, and a wrong magic
+    checkpoint_test_entries(10, entries);
+    checkpoint_test_write_v1(path, entries);
+    int64_t size = 0;
+    ASSERT_TRUE(utils::filesystem::file_size(path, size));
+    checkpoint_test_truncate(path, size - 1);
+    ASSERT_EQ(ERR_INVALID_DATA, load_checkpoint(path, store.get(), 4));
+
+    checkpoint_test_write_v1(path, entries);
+    checkpoint_test_corrupt(path, 8);
+    ASSERT_EQ(ERR_INVALID_DATA, load_checkpoint(path, store.get(), 4));
+
+    utils::filesystem::remove_path(path);
+}
+
+static checkpoint_file checkpoint_test_file(const char* name)
+{
+    checkpoint_file f;
+    EXPECT_TRUE(checkpoint_file::parse(name, f));
+    EXPECT_EQ(std::string(name), f.file_name());
+    return f;
+}
+
+static std::vector<std::string> checkpoint_test_names(const std::vector<checkpoint_file>& files)
+{
+    std::vector<std::string> names;
+    for (auto& f : files)
+        names.push_back(f.file_name());
+    return names;
+}
+
+TEST(apps_skv, checkpoint_file_name)
+{
+    checkpoint_file f;
+    ASSERT_TRUE(checkpoint_file::parse("checkpoint.100", f));
+    ASSERT_EQ(100, f.decree);
+    ASSERT_FALSE(f.is_delta());
+    ASSERT_TRUE(checkpoint_file::parse("delta.100.120", f));
+    ASSERT_EQ(100, f.prev_decree);
+    ASSERT_EQ(120, f.decree);
+    ASSERT_TRUE(f.is_delta());
+
+    const char* invalid[] = {
+        "checkpoint.", "checkpoint.0", "checkpoint.-1", "checkpoint.100.tmp", "checkpoint.1x",
+        "delta.100", "delta.100.", "delta.120.100", "delta.100.100", "delta.0.100", "delta.100.120.tmp",
+        "other.100", ""
+    };
+    for (auto name : invalid)
+        ASSERT_FALSE(checkpoint_file::parse(name, f)) << name;
+}
+
+TEST(apps_skv, checkpoint_chain_and_gc)
+{
+    // two chains on checkpoint.100 (the one on delta.110 replaced by a copy on delta.130),
+    // and the chains on checkpoint.200 and checkpoint.50
+    std::vector<checkpoint_file> files;
+    const char* names[] = {
+        "checkpoint.50", "delta.50.60",
+        "checkpoint.100", "delta.100.110", "delta.110.120", "delta.100.130", "delta.130.140",
+        "checkpoint.200", "delta.200.210", "delta.210.220",
+        "delta.300.310" // not on any full checkpoint, e.g., partially copied
+    };
+    for (auto name : names)
+        files.push_back(checkpoint_test_file(name));
+
+    std::vector<checkpoint_file> chain;
+    find_checkpoint_chain(files, 100, chain);
+    ASSERT_EQ(std::vector<std::string>({ "checkpoint.100", "delta.100.130", "delta.130.140" }),
+        checkpoint_test_names(chain));
+    find_checkpoint_chain(files, 200, chain);
+    ASSERT_EQ(std::vector<std::string>({ "checkpoint.200", "delta.200.210", "delta.210.220" }),
+        checkpoint_test_names(chain));
+    find_checkpoint_chain(files, 50, chain);
+    ASSERT_EQ(std::vector<std::string>({ "checkpoint.50", "delta.50.60" }), checkpoint_test_names(chain));
+    find_checkpoint_chain(files, 60, chain);
+    ASSERT_TRUE(chain.empty());
+
+    // the latest two full checkpoints with their chains are kept, and files newer
+    // than the durable decree are never removed
+    std::vector<checkpoint_file> current;
+    find_checkpoint_chain(files, 200, current);
+    std::vector<checkpoint_file> obsolete;
+    find_obsolete_checkpoints(files, current, 220, 2, obsolete);
+    ASSERT_EQ(std::vector<std::string>({ "checkpoint.50", "delta.50.60", "delta.100.110", "delta.110.120" }),
+        checkpoint_test_names(obsolete));
+
+    find_obsolete_checkpoints(files, current, 220, 1, obsolete);
+    ASSERT_EQ(std::vector<std::string>({
+        "checkpoint.50", "delta.50.60",
+        "checkpoint.100", "delta.100.110", "delta.110.120", "delta.100.130", "delta.130.140" }),
+        checkpoint_test_names(obsolete));
+
+    // the current chain is kept even when it is not on the latest full checkpoints,
+    // e.g., while a newer full checkpoint is copied from the learnee
+    find_checkpoint_chain(files, 50, current);
+    find_obsolete_checkpoints(files, current, 220, 1, obsolete);
+    ASSERT_EQ(std::vector<std::string>({
+        "checkpoint.100", "delta.100.110", "delta.110.120", "delta.100.130", "delta.130.140" }),
+        checkpoint_test_names(obsolete));
+}
@@ -165,6 +165,153 @@ public:
                     );
     }
 
+    // ---------- call RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET ------------
+    // - synchronous 
+    std::pair< ::dsn::error_code, multi_get_response> multi_get_sync(
+        const multi_get_request& req, 
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::wait_and_unwrap<multi_get_response>(
+            ::dsn::rpc::call(
+                server_addr.unwrap_or(_server),
+                RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET,
+                req,
+                nullptr,
+                empty_callback,
+                timeout,
+                thread_hash,
+                partition_hash
+                )
+            );
+    }
+    
+    // - asynchronous with on-stack multi_get_request and multi_get_response  
+    template<typename TCallback>
+    ::dsn::task_ptr multi_get(
+        const multi_get_request& req, 
+        TCallback&& callback,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        int reply_thread_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::call(
+                    server_addr.unwrap_or(_server), 
+                    RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET, 
+                    req, 
+                    this,
+                    std::forward<TCallback>(callback),
+                    timeout,
+                    thread_hash,
+                    partition_hash,
+                    reply_thread_hash
+                    );
+    }
+ 
+    // ---------- call RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT ------------
+    // - synchronous 
+    std::pair< ::dsn::error_code, int32_t> multi_put_sync(
+        const multi_put_request& req, 
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::wait_and_unwrap<int32_t>(
+            ::dsn::rpc::call(
+                server_addr.unwrap_or(_server),
+                RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT,
+                req,
+                nullptr,
+                empty_callback,
+                timeout,
+                thread_hash,
+                partition_hash
+                )
+            );
+    }
+    
+    // - asynchronous with on-stack multi_put_request and int32_t  
+    template<typename TCallback>
+    ::dsn::task_ptr multi_put(
+        const multi_put_request& req, 
+        TCallback&& callback,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        int reply_thread_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::call(
+                    server_addr.unwrap_or(_server), 
+                    RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT, 
+                    req, 
+                    this,
+                    std::forward<TCallback>(callback),
+                    timeout,
+                    thread_hash,
+                    partition_hash,
+                    reply_thread_hash
+                    );
+    }
+ 
+    // ---------- call RPC_SIMPLE_KV_SIMPLE_KV_SCAN ------------
+    // - synchronous 
+    std::pair< ::dsn::error_code, scan_response> scan_sync(
+        const scan_request& req, 
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::wait_and_unwrap<scan_response>(
+            ::dsn::rpc::call(
+                server_addr.unwrap_or(_server),
+                RPC_SIMPLE_KV_SIMPLE_KV_SCAN,
+                req,
+                nullptr,
+                empty_callback,
+                timeout,
+                thread_hash,
+                partition_hash
+                )
+            );
+    }
+    
+    // - asynchronous with on-stack scan_request and scan_response  
+    template<typename TCallback>
+    ::dsn::task_ptr scan(
+        const scan_request& req, 
+        TCallback&& callback,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        int reply_thread_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::call(
+                    server_addr.unwrap_or(_server), 
+                    RPC_SIMPLE_KV_SIMPLE_KV_SCAN, 
+                    req, 
+                    this,
+                    std::forward<TCallback>(callback),
+                    timeout,
+                    thread_hash,
+                    partition_hash,
+                    reply_thread_hash
+                    );
+    }
+ 
 private:
     ::dsn::rpc_address _server;
 };
@@ -35,6 +35,8 @@
 
 # pragma once
 # include "simple_kv.client.2.h"
+# include "simple_kv.workload.h"
+# include <map>
 
 namespace dsn { namespace replication { namespace application {  
 
@@ -44,10 +46,47 @@ class simple_kv_perf_test_client
       public ::dsn::service::perf_client_helper 
 {
 public:
-    using simple_kv_client2::simple_kv_client2;
+    simple_kv_perf_test_client(::dsn::rpc_address server)
+        : simple_kv_client2(server)
+    {
+        _partition_count = dsn_config_get_value_uint64("simple_kv.perf-test", "partition_count",
+            1, "partition count of the tested table, for grouping keys of multi-key requests per partition");
+        _multi_key_count = (int)dsn_config_get_value_uint64("simple_kv.perf-test", "multi_key_count",
+            16, "keys per multi_get/multi_put request, and the limit of scan requests");
+        if (_partition_count == 0)
+            _partition_count = 1;
+    }
     
+    virtual void on_case_start(const char* config_section, int payload_bytes, int key_space_size) override
+    {
+        _workload = workload::create(config_section, "apps.client.perf.test", payload_bytes, key_space_size);
+        if (_workload != nullptr)
+        {
+            ddebug("perf case [%s] runs workload %s", config_section, _workload->name().c_str());
+            return;
+        }
+
+        // keys and value of the hybrid requests
+        if (key_space_size <= 0)
+            key_space_size = 1;
+        _keys.resize(key_space_size);
+        char buffer[32];
+        for (int i = 0; i < key_space_size; i++)
+        {
+            snprintf(buffer, sizeof(buffer), "key.%d", i);
+            _keys[i] = buffer;
+        }
+        _value.assign(payload_bytes, 'x');
+    }
+
     virtual void send_one(int payload_bytes, int key_space_size, const std::vector<double>& ratios) override
     {
+        if (_workload != nullptr)
+        {
+            send_one_workload();
+            return;
+        }
+
         auto prob = (double)dsn_random32(0, 1000) / 1000.0;
         if (0) {}
         else if (prob <= ratios[0])
@@ -62,18 +101,27 @@ public:
         {
             send_one_append(payload_bytes, key_space_size);
         }
+        else if (prob <= ratios[3])
+        {
+            send_one_multi_get(payload_bytes, key_space_size);
+        }
+        else if (prob <= ratios[4])
+        {
+            send_one_multi_put(payload_bytes, key_space_size);
+        }
+        else if (prob <= ratios[5])
+        {
+            send_one_scan(payload_bytes, key_space_size);
+        }
         else { /* nothing to do */ }
     }
     
 
     void send_one_read(int payload_bytes, int key_space_size)
     {
-        auto rs = random64(0, 10000000) % key_space_size;
-        std::stringstream ss;
-        ss << "key." << rs << "." << std::string(payload_bytes, 'x');
-
+        auto rs = random64(0, 10000000) % _keys.size();
         read(
-            ss.str(),
+            _keys[rs],
             [this, context = prepare_send_one()](error_code err, std::string&& resp)
             {
                 end_send_one(context, err);
@@ -85,11 +133,8 @@ public:
 
     void send_one_write(int payload_bytes, int key_space_size)
     {
-        auto rs = random64(0, 10000000) % key_space_size;
-        std::stringstream ss;
-        ss << "key." << rs;
-
-        kv_pair req = { ss.str(),  std::string(payload_bytes, 'x') };
+        auto rs = random64(0, 10000000) % _keys.size();
+        kv_pair req = { _keys[rs], _value };
         write(
             req,
             [this, context = prepare_send_one()](error_code err, int32_t&& resp)
@@ -103,10 +148,8 @@ public:
 
     void send_one_append(int payload_bytes, int key_space_size)
     {
-        auto rs = random64(0, 10000000) % key_space_size;
-        std::stringstream ss;
-        ss << "key." << rs;
-        kv_pair req = { ss.str(), std::string(payload_bytes, 'x') };;
+        auto rs = random64(0, 10000000) % _keys.size();
+        kv_pair req = { _keys[rs], _value };
         append(
             req,
             [this, context = prepare_send_one()](error_code err, int32_t&& resp)
@@ -117,6 +160,197 @@ public:
             );
     }
 
+
+    // keys are routed with their number as the partition hash, so the keys of
+    // a multi-key request are grouped into one rpc per partition, and the
+    // request completes when all of these rpcs do
+    struct fanout_context
+    {
+        void*             context;
+        std::atomic<int>  pending;
+        std::atomic<bool> failed;
+        error_code        err;
+    };
+
+    std::shared_ptr<fanout_context> prepare_fanout(int rpc_count)
+    {
+        auto fc = std::make_shared<fanout_context>();
+        fc->context = prepare_send_one();
+        fc->pending = rpc_count;
+        fc->failed = false;
+        return fc;
+    }
+
+    void end_fanout_one(const std::shared_ptr<fanout_context>& fc, error_code err)
+    {
+        if (err != ERR_OK && !fc->failed.exchange(true))
+            fc->err = err;
+
+        if (--fc->pending == 0)
+            end_send_one(fc->context, fc->failed ? fc->err : ERR_OK);
+    }
+
+    void send_one_multi_get(int payload_bytes, int key_space_size)
+    {
+        // partition -> (partition hash, request)
+        std::map<uint64_t, std::pair<uint64_t, multi_get_request>> groups;
+        for (int i = 0; i < _multi_key_count; i++)
+        {
+            auto rs = random64(0, 10000000) % _keys.size();
+            auto& g = groups[rs % _partition_count];
+            g.first = rs;
+            g.second.keys.push_back(_keys[rs]);
+        }
+
+        auto fc = prepare_fanout((int)groups.size());
+        for (auto& g : groups)
+        {
+            multi_get(
+                g.second.second,
+                [this, fc](error_code err, multi_get_response&& resp)
+                {
+                    end_fanout_one(fc, err);
+                },
+                _timeout, 0, g.second.first
+                );
+        }
+    }
+
+    void send_one_multi_put(int payload_bytes, int key_space_size)
+    {
+        std::map<uint64_t, std::pair<uint64_t, multi_put_request>> groups;
+        for (int i = 0; i < _multi_key_count; i++)
+        {
+            auto rs = random64(0, 10000000) % _keys.size();
+            auto& g = groups[rs % _partition_count];
+            g.first = rs;
+            g.second.kvs.push_back(kv_pair(_keys[rs], _value));
+        }
+
+        auto fc = prepare_fanout((int)groups.size());
+        for (auto& g : groups)
+        {
+            multi_put(
+                g.second.second,
+                [this, fc](error_code err, int32_t&& resp)
+                {
+                    end_fanout_one(fc, err);
+                },
+                _timeout, 0, g.second.first
+                );
+        }
+    }
+
+    // one page of the partition owning the start key
+    void send_one_scan(int payload_bytes, int key_space_size)
+    {
+        auto rs = random64(0, 10000000) % _keys.size();
+        scan_request req;
+        req.start_key = _keys[rs];
+        req.limit = _multi_key_count;
+        scan(
+            req,
+            [this, context = prepare_send_one()](error_code err, scan_response&& resp)
+            {
+                end_send_one(context, err);
+            },
+            _timeout, 0, rs
+            );
+    }
+
+    //
+    // ycsb workload, keys are routed with their number as the partition hash
+    //
+    void send_one_workload()
+    {
+        auto& w = *_workload;
+        auto op = w.next_op();
+        switch (op)
+        {
+        case WOP_READ:
+        {
+            auto k = w.next_key();
+            read(
+                w.key(k),
+                [this, context = prepare_send_one()](error_code err, std::string&& resp)
+                {
+                    end_send_one(context, err);
+                },
+                _timeout, 0, k
+                );
+            break;
+        }
+        case WOP_UPDATE:
+        case WOP_INSERT:
+        {
+            auto k = (op == WOP_INSERT ? w.next_insert_key() : w.next_key());
+            kv_pair req = { w.key(k), w.next_value() };
+            write(
+                req,
+                [this, context = prepare_send_one()](error_code err, int32_t&& resp)
+                {
+                    end_send_one(context, err);
+                },
+                _timeout, 0, k
+                );
+            break;
+        }
+        case WOP_SCAN:
+        {
+            auto k = w.next_key();
+            scan_request req;
+            req.start_key = w.key(k);
+            req.limit = w.scan_length();
+            scan(
+                req,
+                [this, context = prepare_send_one()](error_code err, scan_response&& resp)
+                {
+                    end_send_one(context, err);
+                },
+                _timeout, 0, k
+                );
+            break;
+        }
+        case WOP_READ_MODIFY_WRITE:
+        {
+            // one operation of the case, completed by the write back
+            auto k = w.next_key();
+            read(
+                w.key(k),
+                [this, k, context = prepare_send_one()](error_code err, std::string&& resp)
+                {
+                    if (err != ERR_OK)
+                    {
+                        end_send_one(context, err);
+                        return;
+                    }
+
+                    kv_pair req = { _workload->key(k), _workload->next_value() };
+                    auto callback = [this, context](error_code err, int32_t&& resp)
+                    {
+                        end_send_one(context, err);
+                    };
+                    if (_workload->read_modify_write_append())
+                        append(req, std::move(callback), _timeout, 0, k);
+                    else
+                        write(req, std::move(callback), _timeout, 0, k);
+                },
+                _timeout, 0, k
+                );
+            break;
+        }
+        default:
+            dassert(false, "invalid workload op %d", (int)op);
+            break;
+        }
+    }
+
+private:
+    uint64_t                  _partition_count;
+    int                       _multi_key_count;
+    std::unique_ptr<workload> _workload;
+    std::vector<std::string>  _keys;
+    std::string               _value;
 };
 
 } } } 
\ No newline at end of file
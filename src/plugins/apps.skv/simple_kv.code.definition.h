@@ -43,6 +43,14 @@ namespace dsn { namespace replication { namespace application {
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_READ, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     // test timer task code
     DEFINE_TASK_CODE(LPC_SIMPLE_KV_TEST_TIMER, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    // background checkpointing, may be moved to a dedicated pool with [task.LPC_SIMPLE_KV_CHECKPOINT] pool_code
+    DEFINE_TASK_CODE(LPC_SIMPLE_KV_CHECKPOINT, TASK_PRIORITY_LOW, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_AIO(LPC_SIMPLE_KV_CHECKPOINT_WRITE, TASK_PRIORITY_LOW, ::dsn::THREAD_POOL_DEFAULT)
+    // parallel parsing of checkpoint blocks during recovery
+    DEFINE_TASK_CODE(LPC_SIMPLE_KV_RECOVER, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
 } } } 
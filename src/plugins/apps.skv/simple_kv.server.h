@@ -55,10 +55,11 @@ public:
 protected:
     // all service handlers to be implemented further
     // RPC_SIMPLE_KV_SIMPLE_KV_READ 
-    virtual void on_read(const std::string& key, ::dsn::rpc_replier<std::string>& reply)
+    // replied as blob, which is marshalled the same as thrift string
+    virtual void on_read(const std::string& key, ::dsn::rpc_replier< ::dsn::blob>& reply)
     {
         std::cout << "... exec RPC_SIMPLE_KV_SIMPLE_KV_READ ... (not implemented) " << std::endl;
-        std::string resp;
+        ::dsn::blob resp;
         reply(resp);
     }
     // RPC_SIMPLE_KV_SIMPLE_KV_WRITE 
@@ -75,6 +76,27 @@ protected:
         int32_t resp;
         reply(resp);
     }
+    // RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET 
+    virtual void on_multi_get(const multi_get_request& req, ::dsn::rpc_replier<multi_get_response>& reply)
+    {
+        std::cout << "... exec RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET ... (not implemented) " << std::endl;
+        multi_get_response resp;
+        reply(resp);
+    }
+    // RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT 
+    virtual void on_multi_put(const multi_put_request& req, ::dsn::rpc_replier<int32_t>& reply)
+    {
+        std::cout << "... exec RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT ... (not implemented) " << std::endl;
+        int32_t resp;
+        reply(resp);
+    }
+    // RPC_SIMPLE_KV_SIMPLE_KV_SCAN 
+    virtual void on_scan(const scan_request& req, ::dsn::rpc_replier<scan_response>& reply)
+    {
+        std::cout << "... exec RPC_SIMPLE_KV_SIMPLE_KV_SCAN ... (not implemented) " << std::endl;
+        scan_response resp;
+        reply(resp);
+    }
     
 public:
     void open_service(dsn_gpid gpid)
@@ -82,6 +104,9 @@ public:
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_READ, "read", &simple_kv_service::on_read, gpid);
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, "write", &simple_kv_service::on_write, gpid);
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, "append", &simple_kv_service::on_append, gpid);
+        this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET, "multi_get", &simple_kv_service::on_multi_get, gpid);
+        this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT, "multi_put", &simple_kv_service::on_multi_put, gpid);
+        this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, "scan", &simple_kv_service::on_scan, gpid);
     }
 
     void close_service(dsn_gpid gpid)
@@ -89,6 +114,9 @@ public:
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_READ, gpid);
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, gpid);
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, gpid);
+        this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_GET, gpid);
+        this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT, gpid);
+        this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, gpid);
     }
 };
 
@@ -34,8 +34,10 @@
  */
 
 #include "simple_kv.server.impl.h"
+#include "simple_kv.checkpoint.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -48,38 +50,79 @@ namespace dsn {
     namespace replication {
         namespace application {
             
+            struct simple_kv_service_impl::checkpoint_context
+            {
+                checkpoint_file info;
+                uint64_t     generation;       // _checkpoint_generation when the snapshot is taken
+                uint64_t     since_version;    // store version of the previous checkpoint for deltas, 0 otherwise
+                uint64_t     snapshot_version;
+                std::string  path;
+                std::string  temp_path;
+                dsn_handle_t file;
+                std::vector<kv_store::entry> entries;
+                std::unique_ptr<checkpoint_builder> builder;
+                uint64_t     size;  // bytes written
+                blob         block; // being written
+
+                checkpoint_context() : generation(0), since_version(0), snapshot_version(0), file(nullptr), size(0) {}
+            };
+
             simple_kv_service_impl::simple_kv_service_impl(dsn_gpid gpid)
                 : ::dsn::replicated_service_app_type_1(gpid), _lock(true)
             {
                 _test_file_learning = false;
+                _checkpointing = false;
+                _full_checkpoint_required = false;
+                _checkpoint_generation = 0;
+                _durable_version = 0;
                 _last_durable_decree = 0;
+
+                _checkpoint_block_bytes = (uint32_t)dsn_config_get_value_uint64("simple_kv", "checkpoint_block_bytes",
+                    4 * 1024 * 1024, "size (bytes) of each sequential write when writing checkpoints");
+                _recover_parallelism = (int)dsn_config_get_value_uint64("simple_kv", "recover_parallelism",
+                    4, "how many checkpoint blocks are loaded in parallel during recovery");
+                if (_recover_parallelism < 1)
+                    _recover_parallelism = 1;
+
+                _checkpoint_max_deltas = (uint32_t)dsn_config_get_value_uint64("simple_kv", "checkpoint_max_deltas",
+                    8, "max delta checkpoints on a full one before the next checkpoint is full again, 0 to disable deltas");
+                _checkpoint_max_delta_ratio = (uint32_t)dsn_config_get_value_uint64("simple_kv", "checkpoint_max_delta_ratio",
+                    50, "max total size of the deltas as a percentage of the full checkpoint before the next checkpoint is full again");
+                _checkpoint_retained_fulls = (uint32_t)dsn_config_get_value_uint64("simple_kv", "checkpoint_retained_fulls",
+                    2, "how many latest full checkpoints are kept on disk with their deltas, older ones are removed");
+                if (_checkpoint_retained_fulls < 1)
+                    _checkpoint_retained_fulls = 1;
+
+                _batched_write_enabled = dsn_config_get_value_bool("simple_kv", "batched_write_enabled",
+                    true, "apply committed write batches with one store pass, or one request at a time");
+
+                _scan_max_limit = (int)dsn_config_get_value_uint64("simple_kv", "scan_max_limit",
+                    1000, "max entries returned by one scan request");
+
+                const char* store_type = dsn_config_get_value_string("simple_kv", "store_type",
+                    "sharded_hash", "storage backend of simple_kv, sharded_hash or ordered_map");
+                _store.reset(kv_store::create(store_type));
+            }
+
+            simple_kv_service_impl::~simple_kv_service_impl()
+            {
             }
 
             // RPC_SIMPLE_KV_READ
-            void simple_kv_service_impl::on_read(const std::string& key, ::dsn::rpc_replier<std::string>& reply)
+            void simple_kv_service_impl::on_read(const std::string& key, ::dsn::rpc_replier< ::dsn::blob>& reply)
             {
-                std::string r;
-                {
-                    zauto_lock l(_lock);
+                // an empty value for missing keys, as before
+                blob r;
+                _store->get(key, r);
 
-                    auto it = _store.find(key);
-                    if (it != _store.end())
-                    {
-                        r = it->second;
-                    }
-                }
-             
-                dinfo("read %s", r.c_str());
+                dinfo("read %s", key.c_str());
                 reply(r);
             }
 
             // RPC_SIMPLE_KV_WRITE
             void simple_kv_service_impl::on_write(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply)
             {
-                {
-                    zauto_lock l(_lock);
-                    _store[pr.key] = pr.value;
-                }                
+                _store->put(pr.key, kv_store::make_value(pr.value));
 
                 dinfo("write %s", pr.key.c_str());
                 reply(0);
@@ -88,19 +131,123 @@ namespace dsn {
             // RPC_SIMPLE_KV_APPEND
             void simple_kv_service_impl::on_append(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply)
             {
-                {
-                    zauto_lock l(_lock);
-                    auto it = _store.find(pr.key);
-                    if (it != _store.end())
-                        it->second.append(pr.value);
-                    else
-                        _store[pr.key] = pr.value;
-                }
+                _store->append(pr.key, kv_store::make_value(pr.value));
 
                 dinfo("append %s", pr.key.c_str());
                 reply(0);
             }
             
+            static void to_kv_pairs(const std::vector<kv_store::entry>& entries, /*out*/ std::vector<kv_pair>& kvs)
+            {
+                kvs.resize(entries.size());
+                for (size_t i = 0; i < entries.size(); i++)
+                {
+                    kvs[i].key = entries[i].first;
+                    kvs[i].value.assign(entries[i].second.data(), entries[i].second.length());
+                }
+            }
+
+            // RPC_SIMPLE_KV_MULTI_GET
+            void simple_kv_service_impl::on_multi_get(const multi_get_request& req, ::dsn::rpc_replier<multi_get_response>& reply)
+            {
+                std::vector<kv_store::entry> entries;
+                _store->multi_get(req.keys, entries);
+
+                multi_get_response resp;
+                to_kv_pairs(entries, resp.kvs);
+
+                dinfo("multi_get %d keys, %d found", (int)req.keys.size(), (int)resp.kvs.size());
+                reply(resp);
+            }
+
+            // RPC_SIMPLE_KV_MULTI_PUT
+            void simple_kv_service_impl::on_multi_put(const multi_put_request& req, ::dsn::rpc_replier<int32_t>& reply)
+            {
+                std::vector<kv_store::write_op> ops(req.kvs.size());
+                for (size_t i = 0; i < req.kvs.size(); i++)
+                {
+                    ops[i].key = req.kvs[i].key;
+                    ops[i].value = kv_store::make_value(req.kvs[i].value);
+                    ops[i].is_append = false;
+                }
+                _store->write_batch(ops);
+
+                dinfo("multi_put %d keys", (int)req.kvs.size());
+                reply(0);
+            }
+
+            // RPC_SIMPLE_KV_SCAN
+            void simple_kv_service_impl::on_scan(const scan_request& req, ::dsn::rpc_replier<scan_response>& reply)
+            {
+                int limit = std::max(1, std::min(req.limit, _scan_max_limit));
+
+                std::vector<kv_store::entry> entries;
+                scan_response resp;
+                resp.has_more = _store->scan(req.start_key, req.end_key, limit, entries);
+                to_kv_pairs(entries, resp.kvs);
+
+                dinfo("scan from %s, %d returned", req.start_key.c_str(), (int)resp.kvs.size());
+                reply(resp);
+            }
+
+            void simple_kv_service_impl::on_batched_write_requests(int64_t decree, dsn_message_t* requests, int count)
+            {
+                std::vector<kv_store::write_op> ops;
+                ops.reserve(count);
+                for (int i = 0; i < count; i++)
+                {
+                    dsn_task_code_t code = dsn_msg_task_code(requests[i]);
+                    if (code == RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT)
+                    {
+                        multi_put_request req;
+                        ::dsn::unmarshall(requests[i], req);
+                        for (auto& pr : req.kvs)
+                        {
+                            ops.push_back(kv_store::write_op());
+                            ops.back().key = std::move(pr.key);
+                            ops.back().value = kv_store::make_value(pr.value);
+                            ops.back().is_append = false;
+                        }
+                        continue;
+                    }
+
+                    dassert(code == RPC_SIMPLE_KV_SIMPLE_KV_WRITE || code == RPC_SIMPLE_KV_SIMPLE_KV_APPEND,
+                        "unexpected write request %s", dsn_task_code_to_string(code));
+
+                    kv_pair pr;
+                    ::dsn::unmarshall(requests[i], pr);
+                    ops.push_back(kv_store::write_op());
+                    ops.back().key = std::move(pr.key);
+                    ops.back().value = kv_store::make_value(pr.value);
+                    ops.back().is_append = (code == RPC_SIMPLE_KV_SIMPLE_KV_APPEND);
+                }
+
+                if (_batched_write_enabled)
+                {
+                    // one lock per touched shard for the whole batch
+                    _store->write_batch(ops);
+                }
+                else
+                {
+                    for (auto& op : ops)
+                    {
+                        if (op.is_append)
+                            _store->append(op.key, op.value);
+                        else
+                            _store->put(op.key, op.value);
+                    }
+                }
+
+                // replies go out after the whole batch is visible to reads
+                for (int i = 0; i < count; i++)
+                {
+                    ::dsn::rpc_replier<int32_t> reply(dsn_msg_create_response(requests[i]));
+                    reply(0);
+                }
+
+                dinfo("write batch %" PRId64 ", count = %d", decree, count);
+            }
+
             ::dsn::error_code simple_kv_service_impl::start(int argc, char** argv)
             {
                 _data_dir = dsn_get_app_data_dir(get_gpid());
@@ -136,14 +283,36 @@ namespace dsn {
             }
 
             // checkpoint related
+            void simple_kv_service_impl::list_checkpoints(/*out*/ std::vector<checkpoint_file>& files)
+            {
+                std::vector<std::string> sub_list;
+                std::string path = data_dir();
+                if (!dsn::utils::filesystem::get_subfiles(path, sub_list, false))
+                {
+                    dassert(false, "Fail to get subfiles in %s.", path.c_str());
+                }
+
+                files.clear();
+                for (auto& fpath : sub_list)
+                {
+                    auto&& s = dsn::utils::filesystem::get_file_name(fpath);
+                    checkpoint_file f;
+                    if (checkpoint_file::parse(s, f))
+                    {
+                        int64_t sz = 0;
+                        dsn::utils::filesystem::file_size(fpath, sz);
+                        f.size = (uint64_t)sz;
+                        files.push_back(f);
+                    }
+                }
+            }
+
             void simple_kv_service_impl::recover()
             {
                 zauto_lock l(_lock);
 
-                _store.clear();
-
-                int64_t maxVersion = 0;
-                std::string name;
+                _store->clear();
+                _chain.clear();
 
                 std::vector<std::string> sub_list;
                 std::string path = data_dir();
@@ -153,110 +322,305 @@ namespace dsn {
                 }
                 for (auto& fpath : sub_list)
                 {
+                    // unfinished checkpoints are written to <name>.tmp
                     auto&& s = dsn::utils::filesystem::get_file_name(fpath);
-                    if (s.substr(0, strlen("checkpoint.")) != std::string("checkpoint."))
-                        continue;
-
-                    int64_t version = static_cast<int64_t>(atoll(s.substr(strlen("checkpoint.")).c_str()));
-                    if (version > maxVersion)
+                    checkpoint_file f;
+                    if ((s.compare(0, strlen("checkpoint."), "checkpoint.") == 0 || s.compare(0, strlen("delta."), "delta.") == 0)
+                        && !checkpoint_file::parse(s, f))
                     {
-                        maxVersion = version;
-                        name = std::string(data_dir()) + "/" + s;
+                        dwarn("remove unfinished checkpoint %s", fpath.c_str());
+                        dsn::utils::filesystem::remove_path(fpath);
                     }
                 }
                 sub_list.clear();
 
-                if (maxVersion > 0)
+                std::vector<checkpoint_file> files;
+                list_checkpoints(files);
+
+                int64_t max_full = 0;
+                for (auto& f : files)
                 {
-                    recover(name, maxVersion);
-                    set_last_durable_decree(maxVersion);
+                    if (!f.is_delta() && f.decree > max_full)
+                        max_full = f.decree;
+                }
+
+                if (max_full > 0)
+                {
+                    std::vector<checkpoint_file> chain;
+                    find_checkpoint_chain(files, max_full, chain);
+
+                    std::vector<std::string> paths;
+                    for (auto& f : chain)
+                    {
+                        paths.push_back(std::string(data_dir()) + "/" + f.file_name());
+                    }
+
+                    auto err = recover(paths, false);
+                    dassert(err == ERR_OK, "invalid checkpoint %s, err = %s", paths.back().c_str(), err.to_string());
+
+                    // everything in the store now is covered by the chain
+                    _chain = std::move(chain);
+                    _durable_version = _store->version();
+                    _full_checkpoint_required = false;
+                    set_last_durable_decree(_chain.back().decree);
+                    gc_checkpoints();
                 }
             }
 
-            void simple_kv_service_impl::recover(const std::string& name, int64_t version)
+            ::dsn::error_code simple_kv_service_impl::recover(const std::vector<std::string>& files, bool incremental)
             {
                 zauto_lock l(_lock);
 
-                std::ifstream is(name.c_str(), std::ios::binary);
-                if (!is.is_open())
-                    return;
-                
-                _store.clear();
+                if (!incremental)
+                    _store->clear();
 
-                uint64_t count;
-                int magic;
-                
-                is.read((char*)&count, sizeof(count));
-                is.read((char*)&magic, sizeof(magic)); 
-                dassert(magic == 0xdeadbeef, "invalid checkpoint");
+                for (auto& f : files)
+                {
+                    auto err = load_checkpoint(f, _store.get(), _recover_parallelism);
+                    if (err != ERR_OK)
+                        return err;
+                }
+                return ERR_OK;
+            }
 
-                for (uint64_t i = 0; i < count; i++)
+            std::shared_ptr<simple_kv_service_impl::checkpoint_context> simple_kv_service_impl::prepare_checkpoint(int64_t decree)
+            {
+                auto ctx = std::make_shared<checkpoint_context>();
+                ctx->info.decree = decree;
+                ctx->generation = _checkpoint_generation;
+
+                // a delta has the keys written since the previous checkpoint, which is cheap
+                // as long as the write set is small, but recovery and learning read the
+                // whole chain, so it is compacted into a full checkpoint every now and then
+                if (!_full_checkpoint_required && !_chain.empty() && _chain.size() <= _checkpoint_max_deltas)
                 {
-                    std::string key;
-                    std::string value;
+                    uint64_t delta_size = 0;
+                    for (size_t i = 1; i < _chain.size(); i++)
+                        delta_size += _chain[i].size;
 
-                    uint32_t sz;
-                    is.read((char*)&sz, (uint32_t)sizeof(sz));
-                    key.resize(sz);
+                    if (delta_size * 100 <= _chain[0].size * _checkpoint_max_delta_ratio)
+                    {
+                        ctx->info.prev_decree = _chain.back().decree;
+                        ctx->since_version = _durable_version;
+                    }
+                }
 
-                    is.read((char*)&key[0], sz);
+                ctx->path = std::string(data_dir()) + "/" + ctx->info.file_name();
+                ctx->temp_path = ctx->path + ".tmp";
+                ctx->snapshot_version = _store->begin_snapshot();
+                return ctx;
+            }
 
-                    is.read((char*)&sz, (uint32_t)sizeof(sz));
-                    value.resize(sz);
+            ::dsn::error_code simple_kv_service_impl::commit_checkpoint(checkpoint_context& ctx)
+            {
+                // the chain may have been replaced by apply_checkpoint meanwhile
+                if (ctx.info.is_delta() && (_chain.empty() || _chain.back().decree != ctx.info.prev_decree))
+                {
+                    derror("drop delta checkpoint %s as its base is gone", ctx.path.c_str());
+                    utils::filesystem::remove_path(ctx.path);
+                    return ERR_CHECKPOINT_FAILED;
+                }
 
-                    is.read((char*)&value[0], sz);
+                if (!ctx.info.is_delta())
+                {
+                    _chain.clear();
+                    _full_checkpoint_required = false;
+                }
+                _chain.push_back(ctx.info);
+                _durable_version = ctx.snapshot_version;
+                set_last_durable_decree(ctx.info.decree);
+
+                gc_checkpoints();
+                return ERR_OK;
+            }
+
+            void simple_kv_service_impl::gc_checkpoints()
+            {
+                std::vector<checkpoint_file> files;
+                list_checkpoints(files);
+
+                // keep the latest full checkpoints with the chains on them, and the current chain
+                std::vector<checkpoint_file> obsolete;
+                find_obsolete_checkpoints(files, _chain, last_durable_decree(), _checkpoint_retained_fulls, obsolete);
 
-                    _store[key] = value;
+                for (auto& f : obsolete)
+                {
+                    std::string path = std::string(data_dir()) + "/" + f.file_name();
+                    ddebug("remove obsolete checkpoint %s", path.c_str());
+                    utils::filesystem::remove_path(path);
                 }
-                is.close();
             }
 
             ::dsn::error_code simple_kv_service_impl::sync_checkpoint(int64_t last_commit)
             {
-                char name[256];
-                sprintf(name, "%s/checkpoint.%" PRId64, data_dir(), last_commit);
-
                 zauto_lock l(_lock);
 
                 if (last_commit == last_durable_decree())
                 {
-                    dassert(utils::filesystem::file_exists(name), 
-                        "checkpoint file %s is missing!",
-                        name
-                        );
+                    dassert(!_chain.empty(), "checkpoint file at %" PRId64 " is missing!", last_commit);
                     return ERR_OK;
                 }
 
-                std::ofstream os(name, std::ios::binary);
+                if (_checkpointing)
+                {
+                    return ERR_BUSY;
+                }
 
-                uint64_t count = (uint64_t)_store.size();
-                int magic = 0xdeadbeef;
-                
-                os.write((const char*)&count, (uint32_t)sizeof(count));
-                os.write((const char*)&magic, (uint32_t)sizeof(magic));
+                // reads and writes go on while the checkpoint is being written
+                auto ctx = prepare_checkpoint(last_commit);
+                _store->get_snapshot(ctx->entries, ctx->since_version);
+                _store->end_snapshot();
+
+                std::ofstream os(ctx->temp_path, std::ios::binary);
 
-                for (auto it = _store.begin(); it != _store.end(); ++it)
+                checkpoint_builder builder(ctx->entries, _checkpoint_block_bytes);
+                blob block;
+                uint64_t offset;
+                while (builder.next(block, offset))
                 {
-                    const std::string& k = it->first;
-                    uint32_t sz = (uint32_t)k.length();
+                    os.seekp((std::streamoff)offset);
+                    os.write(block.data(), block.length());
+                }
+
+                os.close();
+                if (os.fail() || !utils::filesystem::rename_path(ctx->temp_path, ctx->path))
+                {
+                    derror("write checkpoint %s failed", ctx->path.c_str());
+                    utils::filesystem::remove_path(ctx->temp_path);
+                    return ERR_CHECKPOINT_FAILED;
+                }
+
+                ctx->info.size = builder.file_size();
+                return commit_checkpoint(*ctx);
+            }
 
-                    os.write((const char*)&sz, (uint32_t)sizeof(sz));
-                    os.write((const char*)&k[0], sz);
+            ::dsn::error_code simple_kv_service_impl::async_checkpoint(int64_t last_commit)
+            {
+                std::shared_ptr<checkpoint_context> ctx;
+
+                {
+                    zauto_lock l(_lock);
+
+                    if (last_commit == last_durable_decree())
+                        return ERR_OK;
 
-                    const std::string& v = it->second;
-                    sz = (uint32_t)v.length();
+                    if (_checkpointing)
+                        return ERR_BUSY;
 
-                    os.write((const char*)&sz, (uint32_t)sizeof(sz));
-                    os.write((const char*)&v[0], sz);
+                    // O(1) in data size, the state as of last_commit is then serialized in background
+                    _checkpointing = true;
+                    ctx = prepare_checkpoint(last_commit);
                 }
-                
-                os.close();
 
-                // TODO: gc checkpoints
-                set_last_durable_decree(last_commit);
+                tasking::enqueue(
+                    LPC_SIMPLE_KV_CHECKPOINT,
+                    this,
+                    [this, ctx]()
+                    {
+                        _store->get_snapshot(ctx->entries, ctx->since_version);
+                        _store->end_snapshot();
+                        ctx->builder.reset(new checkpoint_builder(ctx->entries, _checkpoint_block_bytes));
+
+                        ctx->file = dsn_file_open(ctx->temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0666);
+                        if (!ctx->file)
+                        {
+                            derror("open checkpoint file %s failed", ctx->temp_path.c_str());
+                            end_async_checkpoint(ctx, ERR_FILE_OPERATION_FAILED);
+                            return;
+                        }
+
+                        write_next_checkpoint_block(ctx);
+                    }
+                    );
+
                 return ERR_OK;
             }
 
+            void simple_kv_service_impl::write_next_checkpoint_block(std::shared_ptr<checkpoint_context> ctx)
+            {
+                // one large sequential write at a time, the next block is prepared on completion
+                uint64_t offset;
+                if (!ctx->builder->next(ctx->block, offset))
+                {
+                    end_async_checkpoint(ctx, ERR_OK);
+                    return;
+                }
+
+                file::write(
+                    ctx->file,
+                    ctx->block.data(),
+                    (int)ctx->block.length(),
+                    offset,
+                    LPC_SIMPLE_KV_CHECKPOINT_WRITE,
+                    this,
+                    [this, ctx](error_code err, size_t sz)
+                    {
+                        if (err != ERR_OK || sz != ctx->block.length())
+                        {
+                            derror("write checkpoint file %s failed, err = %s", ctx->temp_path.c_str(), err.to_string());
+                            end_async_checkpoint(ctx, ERR_FILE_OPERATION_FAILED);
+                            return;
+                        }
+
+                        ctx->size += sz;
+                        ctx->block = blob();
+                        write_next_checkpoint_block(ctx);
+                    }
+                    );
+            }
+
+            void simple_kv_service_impl::end_async_checkpoint(std::shared_ptr<checkpoint_context> ctx, ::dsn::error_code err)
+            {
+                if (ctx->file)
+                {
+                    if (err == ERR_OK)
+                        err = dsn_file_flush(ctx->file);
+                    auto err2 = dsn_file_close(ctx->file);
+                    if (err == ERR_OK)
+                        err = err2;
+                    ctx->file = nullptr;
+                }
+
+                zauto_lock l(_lock);
+
+                // the store was replaced by apply_checkpoint after the snapshot was taken, so
+                // a full checkpoint would clear _full_checkpoint_required for a store state
+                // that is gone, a delta would be based on the wrong version, and the file
+                // may even replace one of the same name just copied from the learnee
+                if (err == ERR_OK && ctx->generation != _checkpoint_generation)
+                {
+                    derror("drop async checkpoint %s as the store was replaced by learning", ctx->path.c_str());
+                    err = ERR_CHECKPOINT_FAILED;
+                }
+
+                // publish atomically, readers never see a partially written checkpoint.<decree>
+                if (err == ERR_OK && !utils::filesystem::rename_path(ctx->temp_path, ctx->path))
+                {
+                    err = ERR_FILE_OPERATION_FAILED;
+                }
+
+                if (err != ERR_OK)
+                {
+                    derror("async checkpoint %s failed, err = %s", ctx->path.c_str(), err.to_string());
+                    utils::filesystem::remove_path(ctx->temp_path);
+                }
+                else
+                {
+                    ddebug("async checkpoint %s done, count = %" PRIu64 ", size = %" PRIu64,
+                        ctx->path.c_str(),
+                        (uint64_t)ctx->entries.size(),
+                        ctx->size
+                        );
+                }
+
+                if (err == ERR_OK)
+                {
+                    ctx->info.size = ctx->size;
+                    commit_checkpoint(*ctx);
+                }
+                _checkpointing = false;
+            }
+
             // helper routines to accelerate learning
             ::dsn::error_code simple_kv_service_impl::get_checkpoint(
                 int64_t learn_start,
@@ -265,25 +629,35 @@ namespace dsn {
                 int     learn_request_size,
                 app_learn_state& state)
             {
-                if (last_durable_decree() > 0)
-                {
-                    char name[256];
-                    sprintf(name, "%s/checkpoint.%" PRId64,
-                        data_dir(),
-                        last_durable_decree()
-                        );
-                    
-                    state.from_decree_excluded = 0;
-                    state.to_decree_included = last_durable_decree();
-                    state.files.push_back(std::string(name));
-                    return ERR_OK;
-                }
-                else
+                zauto_lock l(_lock);
+
+                if (_chain.empty())
                 {
                     state.from_decree_excluded = 0;
                     state.to_decree_included = 0;
                     return ERR_OBJECT_NOT_FOUND;
                 }
+
+                // a learner which already has the state up to learn_start - 1 only
+                // needs the deltas after it, as deltas carry the latest values of
+                // all keys written in their ranges and there are no deletes
+                size_t first = 0;
+                for (size_t i = 1; i < _chain.size(); i++)
+                {
+                    if (_chain[i].prev_decree <= learn_start - 1 && learn_start - 1 < _chain[i].decree)
+                    {
+                        first = i;
+                        break;
+                    }
+                }
+
+                state.from_decree_excluded = (first == 0 ? 0 : _chain[first].prev_decree);
+                state.to_decree_included = _chain.back().decree;
+                for (size_t i = first; i < _chain.size(); i++)
+                {
+                    state.files.push_back(std::string(data_dir()) + "/" + _chain[i].file_name());
+                }
+                return ERR_OK;
             }
 
             ::dsn::error_code simple_kv_service_impl::apply_checkpoint(
@@ -291,30 +665,70 @@ namespace dsn {
                 int64_t commit,
                 const dsn_app_learn_state& state)
             {
+                std::vector<std::string> files;
+                for (int i = 0; i < state.file_state_count; i++)
+                {
+                    files.push_back(state.files[i]);
+                }
+
                 if (mode == DSN_CHKPT_LEARN)
                 {
-                    recover(state.files[0], state.to_decree_included);
-                    return ERR_OK;
+                    bool incremental = (state.from_decree_excluded > 0);
+
+                    // checkpoints in flight are of the store before learning
+                    zauto_lock l(_lock);
+                    _checkpoint_generation++;
+                    auto err = recover(files, incremental);
+
+                    // the store may now lack keys that the local checkpoints still have,
+                    // which a delta cannot express
+                    if (!incremental)
+                        _full_checkpoint_required = true;
+                    return err;
                 }
                 else
                 {
                     dassert(DSN_CHKPT_COPY == mode, "invalid mode %d", (int)mode);
                     dassert(state.to_decree_included > last_durable_decree(), "checkpoint's decree is smaller than current");
 
-                    char name[256];
-                    sprintf(name, "%s/checkpoint.%" PRId64,
-                        data_dir(),
-                        state.to_decree_included
-                        );
-                    std::string lname(name);
+                    zauto_lock l(_lock);
+                    _checkpoint_generation++;
+
+                    std::vector<checkpoint_file> chain;
+                    for (auto& f : files)
+                    {
+                        checkpoint_file cf;
+                        if (!checkpoint_file::parse(utils::filesystem::get_file_name(f), cf))
+                            return ERR_CHECKPOINT_FAILED;
+                        chain.push_back(cf);
+                    }
 
-                    if (!utils::filesystem::rename_path(state.files[0], lname))
+                    // deltas must continue the local chain
+                    if (chain.empty() || (chain[0].is_delta()
+                        && (_chain.empty() || _chain.back().decree != chain[0].prev_decree)))
                         return ERR_CHECKPOINT_FAILED;
-                    else
+
+                    for (size_t i = 0; i < files.size(); i++)
                     {
-                        set_last_durable_decree(state.to_decree_included);
-                        return ERR_OK;
+                        std::string lname = std::string(data_dir()) + "/" + chain[i].file_name();
+                        if (!utils::filesystem::rename_path(files[i], lname))
+                            return ERR_CHECKPOINT_FAILED;
+
+                        int64_t sz = 0;
+                        utils::filesystem::file_size(lname, sz);
+                        chain[i].size = (uint64_t)sz;
                     }
+
+                    if (!chain[0].is_delta())
+                        _chain.clear();
+                    _chain.insert(_chain.end(), chain.begin(), chain.end());
+
+                    // _durable_version is kept, the copied chain is older than the store
+                    // but not older than the previous local one, so the next delta taken
+                    // since _durable_version is a superset of what it needs
+                    set_last_durable_decree(state.to_decree_included);
+                    gc_checkpoints();
+                    return ERR_OK;
                 }
             }
 
@@ -36,6 +36,8 @@
 #pragma once
 
 # include "simple_kv.server.h"
+# include "simple_kv.store.h"
+# include "simple_kv.checkpoint.h"
 # include <dsn/cpp/replicated_service_app.h>
 
 namespace dsn {
@@ -48,12 +50,23 @@ namespace dsn {
             public:
                 simple_kv_service_impl(dsn_gpid gpid);
 
+                virtual ~simple_kv_service_impl();
+
                 // RPC_SIMPLE_KV_READ
-                virtual void on_read(const std::string& key, ::dsn::rpc_replier<std::string>& reply);
+                virtual void on_read(const std::string& key, ::dsn::rpc_replier< ::dsn::blob>& reply);
                 // RPC_SIMPLE_KV_WRITE
                 virtual void on_write(const kv_pair& pr, ::dsn::rpc_replier<int32_t> &reply);
                 // RPC_SIMPLE_KV_APPEND
                 virtual void on_append(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply);
+                // RPC_SIMPLE_KV_MULTI_GET
+                virtual void on_multi_get(const multi_get_request& req, ::dsn::rpc_replier<multi_get_response>& reply);
+                // RPC_SIMPLE_KV_MULTI_PUT
+                virtual void on_multi_put(const multi_put_request& req, ::dsn::rpc_replier<int32_t>& reply);
+                // RPC_SIMPLE_KV_SCAN
+                virtual void on_scan(const scan_request& req, ::dsn::rpc_replier<scan_response>& reply);
+
+                // committed writes from the replication framework, applied as a whole
+                virtual void on_batched_write_requests(int64_t decree, dsn_message_t* requests, int count) override;
 
                 virtual ::dsn::error_code start(int argc, char** argv) override;
 
@@ -61,6 +74,8 @@ namespace dsn {
 
                 virtual ::dsn::error_code sync_checkpoint(int64_t last_commit) override;
 
+                virtual ::dsn::error_code async_checkpoint(int64_t last_commit) override;
+
                 virtual int64_t get_last_checkpoint_decree() override { return last_durable_decree(); }
 
                 virtual ::dsn::error_code get_checkpoint(
@@ -78,20 +93,43 @@ namespace dsn {
                     ) override;
 
             private:
+                struct checkpoint_context;
+
+                void write_next_checkpoint_block(std::shared_ptr<checkpoint_context> ctx);
+                void end_async_checkpoint(std::shared_ptr<checkpoint_context> ctx, ::dsn::error_code err);
+
+                std::shared_ptr<checkpoint_context> prepare_checkpoint(int64_t decree);
+                ::dsn::error_code commit_checkpoint(checkpoint_context& ctx);
+                void gc_checkpoints();
+                void list_checkpoints(/*out*/ std::vector<checkpoint_file>& files);
+
                 void recover();
-                void recover(const std::string& name, int64_t version);
+                ::dsn::error_code recover(const std::vector<std::string>& files, bool incremental);
                 const char* data_dir() const { return _data_dir.c_str(); }
                 int64_t last_durable_decree() const { return _last_durable_decree; }
                 void set_last_durable_decree(int64_t d) { _last_durable_decree = d; }
 
             private:
-                typedef std::map<std::string, std::string> simple_kv;
-                simple_kv _store;
-                ::dsn::service::zlock _lock;
+                std::unique_ptr<kv_store> _store;
+                ::dsn::service::zlock _lock; // for recovery and checkpoints, the store has its own locks
                 bool      _test_file_learning;
+                bool      _batched_write_enabled;
+                int       _scan_max_limit;
+                bool      _checkpointing; // a checkpoint is being written, under _lock
+                uint32_t  _checkpoint_block_bytes;
+                int       _recover_parallelism;
+                uint32_t  _checkpoint_max_deltas;
+                uint32_t  _checkpoint_max_delta_ratio;
+                uint32_t  _checkpoint_retained_fulls;
+
+                // the latest full checkpoint and the deltas on it, under _lock
+                std::vector<checkpoint_file> _chain;
+                uint64_t  _durable_version; // store version covered by _chain
+                bool      _full_checkpoint_required; // the store was replaced by learning
+                uint64_t  _checkpoint_generation; // bumped by apply_checkpoint, checkpoints of older ones are dropped
 
                 std::string _data_dir;
-                int64_t     _last_durable_decree;
+                std::atomic<int64_t> _last_durable_decree;
             };
 
         }
@@ -0,0 +1,151 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the simple_kv service, hosted in the test app.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "simple_kv.server.impl.h"
+# include <gtest/gtest.h>
+
+using namespace dsn;
+using namespace dsn::replication::application;
+
+// the service shares the data dir of the test app, so leftover checkpoints are removed
+static void skv_test_clear_checkpoints()
+{
+    std::string dir = dsn_get_app_data_dir(dsn_gpid{ 0 });
+    utils::filesystem::create_directory(dir);
+
+    std::vector<std::string> files;
+    ASSERT_TRUE(utils::filesystem::get_subfiles(dir, files, false));
+    for (auto& f : files)
+    {
+        auto name = utils::filesystem::get_file_name(f);
+        if (name.compare(0, strlen("checkpoint."), "checkpoint.") == 0 || name.compare(0, strlen("delta."), "delta.") == 0)
+            utils::filesystem::remove_path(f);
+    }
+}
+
+// what the replication framework hands to the app is a received message
+template<typename T>
+static dsn_message_t skv_test_request(dsn_task_code_t code, const T& arg)
+{
+    dsn_message_t msg = dsn_msg_create_request(code);
+    ::dsn::marshall(msg, arg);
+    dsn_msg_add_ref(msg);
+    dsn_message_t req = dsn_msg_copy(msg, true, true);
+    dsn_msg_add_ref(req);
+    dsn_msg_release_ref(msg);
+    return req;
+}
+
+static kv_pair skv_test_pair(const std::string& key, const std::string& value)
+{
+    kv_pair pr;
+    pr.key = key;
+    pr.value = value;
+    return pr;
+}
+
+static void skv_test_apply(simple_kv_service_impl& app, int64_t decree, std::vector<dsn_message_t>& requests)
+{
+    app.on_batched_write_requests(decree, &requests[0], (int)requests.size());
+    for (auto r : requests)
+        dsn_msg_release_ref(r);
+    requests.clear();
+}
+
+// the state as of decree, through a checkpoint of it
+static void skv_test_state(simple_kv_service_impl& app, int64_t decree, /*out*/ std::map<std::string, std::string>& state)
+{
+    ASSERT_EQ(ERR_OK, app.sync_checkpoint(decree));
+    ASSERT_EQ(decree, app.get_last_checkpoint_decree());
+
+    replicated_service_app_type_1::app_learn_state ls;
+    ASSERT_EQ(ERR_OK, app.get_checkpoint(0, decree, nullptr, 0, ls));
+    ASSERT_EQ(decree, ls.to_decree_included);
+
+    std::unique_ptr<kv_store> store(kv_store::create("ordered_map"));
+    for (auto& f : ls.files)
+        ASSERT_EQ(ERR_OK, load_checkpoint(f, store.get(), 1));
+
+    state.clear();
+    store->scan_ordered([&state](const std::string& key, const blob& value)
+    {
+        state[key] = std::string(value.data(), value.length());
+    });
+}
+
+TEST(apps_skv, batched_write_requests)
+{
+    skv_test_clear_checkpoints();
+
+    simple_kv_service_impl app(dsn_gpid{ 0 });
+    ASSERT_EQ(ERR_OK, app.start(0, nullptr));
+
+    // writes, appends and multi_puts in one batch apply in order
+    std::vector<dsn_message_t> requests;
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, skv_test_pair("k1", "1")));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, skv_test_pair("k1", "a")));
+    multi_put_request mp;
+    mp.kvs.push_back(skv_test_pair("k2", "x"));
+    mp.kvs.push_back(skv_test_pair("k1", "2"));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_MULTI_PUT, mp));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, skv_test_pair("k2", "y")));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, skv_test_pair("k3", "z")));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, skv_test_pair("k4", "w")));
+    skv_test_apply(app, 1, requests);
+
+    std::map<std::string, std::string> state;
+    skv_test_state(app, 1, state);
+    ASSERT_EQ(4u, state.size());
+    ASSERT_EQ("2", state["k1"]);
+    ASSERT_EQ("xy", state["k2"]);
+    ASSERT_EQ("z", state["k3"]);
+    ASSERT_EQ("w", state["k4"]);
+
+    // the next batch builds on it, and shows up in the delta checkpoint on the first one
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, skv_test_pair("k1", "b")));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, skv_test_pair("k3", "zz")));
+    requests.push_back(skv_test_request(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, skv_test_pair("k5", "v")));
+    skv_test_apply(app, 2, requests);
+
+    skv_test_state(app, 2, state);
+    ASSERT_EQ(5u, state.size());
+    ASSERT_EQ("2b", state["k1"]);
+    ASSERT_EQ("xy", state["k2"]);
+    ASSERT_EQ("zz", state["k3"]);
+    ASSERT_EQ("w", state["k4"]);
+    ASSERT_EQ("v", state["k5"]);
+
+    ASSERT_EQ(ERR_OK, app.stop(false));
+    skv_test_clear_checkpoints();
+}
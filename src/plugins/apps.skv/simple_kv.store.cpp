@@ -0,0 +1,563 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     storage backends for simple_kv
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "simple_kv.store.h"
+# include <algorithm>
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "simple.kv.store"
+
+using namespace ::dsn::service;
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            kv_store* kv_store::create(const std::string& type)
+            {
+                if (type == "ordered_map")
+                {
+                    return new ordered_kv_store();
+                }
+
+                dassert(type == "sharded_hash", "unknown simple_kv store type %s", type.c_str());
+                int shard_count = (int)dsn_config_get_value_uint64("simple_kv", "store_shard_count",
+                    64, "shard count of the sharded_hash store of simple_kv, rounded up to a power of 2");
+                return new sharded_kv_store(shard_count);
+            }
+
+            blob kv_store::make_value(const std::string& value)
+            {
+                auto buffer = dsn::make_shared_array<char>(value.length());
+                memcpy(buffer.get(), value.c_str(), value.length());
+                return blob(std::move(buffer), (unsigned int)value.length());
+            }
+
+            static blob concat_value(const blob& prefix, const blob& suffix)
+            {
+                unsigned int length = prefix.length() + suffix.length();
+                auto buffer = dsn::make_shared_array<char>(length);
+                memcpy(buffer.get(), prefix.data(), prefix.length());
+                memcpy(buffer.get() + prefix.length(), suffix.data(), suffix.length());
+                return blob(std::move(buffer), length);
+            }
+
+            //------------------------------------------------------------------------
+
+            bool ordered_kv_store::get(const std::string& key, /*out*/ blob& value)
+            {
+                zauto_lock l(_lock);
+                auto it = _entries.find(key);
+                if (it == _entries.end())
+                    return false;
+
+                value = it->second.value;
+                return true;
+            }
+
+            void ordered_kv_store::put(const std::string& key, const blob& value)
+            {
+                zauto_lock l(_lock);
+                _entries[key] = versioned_value(value, ++_version);
+            }
+
+            void ordered_kv_store::append(const std::string& key, const blob& value)
+            {
+                zauto_lock l(_lock);
+                auto it = _entries.find(key);
+                if (it != _entries.end())
+                    it->second = versioned_value(concat_value(it->second.value, value), ++_version);
+                else
+                    _entries[key] = versioned_value(value, ++_version);
+            }
+
+            void ordered_kv_store::put_batch(std::vector<entry>& entries)
+            {
+                zauto_lock l(_lock);
+                for (auto& e : entries)
+                {
+                    _entries[e.first] = versioned_value(std::move(e.second), ++_version);
+                }
+            }
+
+            void ordered_kv_store::write_batch(std::vector<write_op>& ops)
+            {
+                zauto_lock l(_lock);
+                for (auto& op : ops)
+                {
+                    auto it = _entries.find(op.key);
+                    if (it != _entries.end())
+                        it->second = versioned_value(op.is_append ? concat_value(it->second.value, op.value) : op.value, ++_version);
+                    else
+                        _entries[op.key] = versioned_value(op.value, ++_version);
+                }
+            }
+
+            void ordered_kv_store::multi_get(const std::vector<std::string>& keys, /*out*/ std::vector<entry>& entries)
+            {
+                zauto_lock l(_lock);
+                entries.clear();
+                for (auto& k : keys)
+                {
+                    auto it = _entries.find(k);
+                    if (it != _entries.end())
+                        entries.emplace_back(k, it->second.value);
+                }
+            }
+
+            bool ordered_kv_store::scan(const std::string& start_key, const std::string& end_key, int limit,
+                /*out*/ std::vector<entry>& entries)
+            {
+                zauto_lock l(_lock);
+                entries.clear();
+                for (auto it = _entries.lower_bound(start_key); it != _entries.end(); ++it)
+                {
+                    if (!end_key.empty() && it->first >= end_key)
+                        return false;
+                    if ((int)entries.size() == limit)
+                        return true;
+                    entries.emplace_back(it->first, it->second.value);
+                }
+                return false;
+            }
+
+            void ordered_kv_store::clear()
+            {
+                zauto_lock l(_lock);
+                _entries.clear();
+            }
+
+            uint64_t ordered_kv_store::size()
+            {
+                zauto_lock l(_lock);
+                return (uint64_t)_entries.size();
+            }
+
+            void ordered_kv_store::scan_ordered(const visitor& v)
+            {
+                zauto_lock l(_lock);
+                for (auto& e : _entries)
+                {
+                    v(e.first, e.second.value);
+                }
+            }
+
+            uint64_t ordered_kv_store::version()
+            {
+                zauto_lock l(_lock);
+                return _version;
+            }
+
+            uint64_t ordered_kv_store::begin_snapshot()
+            {
+                zauto_lock l(_lock);
+                _snapshot = _entries;
+                return _version;
+            }
+
+            void ordered_kv_store::get_snapshot(/*out*/ std::vector<entry>& entries, uint64_t since_version)
+            {
+                zauto_lock l(_lock);
+                entries.clear();
+                for (auto& e : _snapshot)
+                {
+                    if (e.second.version > since_version)
+                        entries.emplace_back(e.first, e.second.value);
+                }
+            }
+
+            void ordered_kv_store::end_snapshot()
+            {
+                zauto_lock l(_lock);
+                _snapshot.clear();
+            }
+
+            //------------------------------------------------------------------------
+
+            sharded_kv_store::sharded_kv_store(int shard_count)
+            {
+                _shard_count = 1;
+                while (_shard_count < shard_count)
+                    _shard_count *= 2;
+                _shard_mask = (size_t)_shard_count - 1;
+                _shards = new shard[_shard_count];
+
+                _epoch = 1;
+                _snapshot_version = 0;
+            }
+
+            sharded_kv_store::~sharded_kv_store()
+            {
+                delete[] _shards;
+            }
+
+            bool sharded_kv_store::get(const std::string& key, /*out*/ blob& value)
+            {
+                auto& sd = get_shard(key);
+                utils::auto_read_lock l(sd.lock);
+                auto it = sd.entries.find(key);
+                if (it == sd.entries.end())
+                    return false;
+
+                value = it->second.value;
+                return true;
+            }
+
+            void sharded_kv_store::put(const std::string& key, const blob& value)
+            {
+                auto& sd = get_shard(key);
+                utils::auto_write_lock l(sd.lock);
+                put_locked(sd, key, value);
+            }
+
+            void sharded_kv_store::put_locked(shard& sd, const std::string& key, const blob& value)
+            {
+                uint64_t version = _epoch;
+                auto it = sd.entries.find(key);
+                if (it != sd.entries.end())
+                {
+                    preserve_for_snapshot(sd, it);
+                    it->second.value = value;
+                    it->second.version = version;
+                }
+                else
+                    insert_locked(sd, key, value, version);
+            }
+
+            void sharded_kv_store::insert_locked(shard& sd, const std::string& key, const blob& value, uint64_t version)
+            {
+                auto r = sd.entries.emplace(key, versioned_value(value, version));
+                sd.keys.insert(&*r.first);
+            }
+
+            template<typename TKeyOf, typename TApply>
+            void sharded_kv_store::apply_by_shard(size_t count, TKeyOf key_of, TApply apply)
+            {
+                // group the items by shard (stable, so that later writes to a key still win),
+                // then take each shard lock once for all of its items
+                std::vector<size_t> shard_of(count);
+                std::vector<size_t> begins(_shard_count + 1, 0);
+                for (size_t i = 0; i < count; i++)
+                {
+                    shard_of[i] = get_shard_index(key_of(i));
+                    begins[shard_of[i] + 1]++;
+                }
+                for (int s = 0; s < _shard_count; s++)
+                {
+                    begins[s + 1] += begins[s];
+                }
+
+                std::vector<size_t> order(count);
+                std::vector<size_t> pos(begins.begin(), begins.end() - 1);
+                for (size_t i = 0; i < count; i++)
+                {
+                    order[pos[shard_of[i]]++] = i;
+                }
+
+                for (int s = 0; s < _shard_count; s++)
+                {
+                    if (begins[s] == begins[s + 1])
+                        continue;
+
+                    auto& sd = _shards[s];
+                    utils::auto_write_lock l(sd.lock);
+                    for (size_t i = begins[s]; i < begins[s + 1]; i++)
+                    {
+                        apply(sd, order[i]);
+                    }
+                }
+            }
+
+            void sharded_kv_store::put_batch(std::vector<entry>& entries)
+            {
+                apply_by_shard(
+                    entries.size(),
+                    [&entries](size_t i) -> const std::string& { return entries[i].first; },
+                    [this, &entries](shard& sd, size_t i) { put_locked(sd, entries[i].first, entries[i].second); }
+                    );
+            }
+
+            void sharded_kv_store::append(const std::string& key, const blob& value)
+            {
+                auto& sd = get_shard(key);
+                utils::auto_write_lock l(sd.lock);
+                append_locked(sd, key, value);
+            }
+
+            void sharded_kv_store::append_locked(shard& sd, const std::string& key, const blob& value)
+            {
+                uint64_t version = _epoch;
+                auto it = sd.entries.find(key);
+                if (it != sd.entries.end())
+                {
+                    preserve_for_snapshot(sd, it);
+                    it->second.value = concat_value(it->second.value, value);
+                    it->second.version = version;
+                }
+                else
+                    insert_locked(sd, key, value, version);
+            }
+
+            void sharded_kv_store::write_batch(std::vector<write_op>& ops)
+            {
+                apply_by_shard(
+                    ops.size(),
+                    [&ops](size_t i) -> const std::string& { return ops[i].key; },
+                    [this, &ops](shard& sd, size_t i)
+                    {
+                        if (ops[i].is_append)
+                            append_locked(sd, ops[i].key, ops[i].value);
+                        else
+                            put_locked(sd, ops[i].key, ops[i].value);
+                    }
+                    );
+            }
+
+            void sharded_kv_store::multi_get(const std::vector<std::string>& keys, /*out*/ std::vector<entry>& entries)
+            {
+                std::vector<size_t> shards(keys.size());
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    shards[i] = get_shard_index(keys[i]);
+                }
+
+                std::vector<size_t> locked(shards);
+                std::sort(locked.begin(), locked.end());
+                locked.erase(std::unique(locked.begin(), locked.end()), locked.end());
+
+                for (auto s : locked)
+                    _shards[s].lock.lock_read();
+
+                entries.clear();
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    auto& sd = _shards[shards[i]];
+                    auto it = sd.entries.find(keys[i]);
+                    if (it != sd.entries.end())
+                        entries.emplace_back(keys[i], it->second.value);
+                }
+
+                for (auto it = locked.rbegin(); it != locked.rend(); ++it)
+                    _shards[*it].lock.unlock_read();
+            }
+
+            bool sharded_kv_store::scan(const std::string& start_key, const std::string& end_key, int limit,
+                /*out*/ std::vector<entry>& entries)
+            {
+                // the first limit + 1 entries in range are among the first limit + 1 of each
+                // shard, which are taken under one shard lock at a time
+                entries.clear();
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    auto& sd = _shards[i];
+                    utils::auto_read_lock l(sd.lock);
+                    int count = 0;
+                    for (auto it = sd.keys.lower_bound(start_key); it != sd.keys.end() && count <= limit; ++it, ++count)
+                    {
+                        if (!end_key.empty() && (*it)->first >= end_key)
+                            break;
+                        entries.emplace_back((*it)->first, (*it)->second.value);
+                    }
+                }
+
+                std::sort(entries.begin(), entries.end(),
+                    [](const entry& l, const entry& r) { return l.first < r.first; });
+
+                if ((int)entries.size() <= limit)
+                    return false;
+
+                entries.resize(limit);
+                return true;
+            }
+
+            void sharded_kv_store::clear()
+            {
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    auto& sd = _shards[i];
+                    utils::auto_write_lock l(sd.lock);
+                    for (auto it = sd.entries.begin(); it != sd.entries.end(); ++it)
+                    {
+                        preserve_for_snapshot(sd, it);
+                    }
+                    sd.keys.clear();
+                    sd.entries.clear();
+                }
+            }
+
+            uint64_t sharded_kv_store::size()
+            {
+                uint64_t count = 0;
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    utils::auto_read_lock l(_shards[i].lock);
+                    count += _shards[i].entries.size();
+                }
+                return count;
+            }
+
+            void sharded_kv_store::scan_ordered(const visitor& v)
+            {
+                // collect shard by shard so that no lock is held while sorting and visiting
+                std::vector<entry> entries;
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    utils::auto_read_lock l(_shards[i].lock);
+                    entries.reserve(entries.size() + _shards[i].entries.size());
+                    for (auto& e : _shards[i].entries)
+                    {
+                        entries.emplace_back(e.first, e.second.value);
+                    }
+                }
+
+                std::sort(entries.begin(), entries.end(),
+                    [](const entry& l, const entry& r) { return l.first < r.first; });
+
+                for (auto& e : entries)
+                {
+                    v(e.first, e.second);
+                }
+            }
+
+            void sharded_kv_store::preserve_for_snapshot(shard& sd, entry_map::iterator it)
+            {
+                uint64_t snapshot = _snapshot_version.load(std::memory_order_relaxed);
+                if (snapshot != 0 && it->second.version <= snapshot)
+                {
+                    // only the first replacement since the snapshot is visible to it,
+                    // as later ones see versions newer than the snapshot
+                    sd.snapshot_overlay.emplace(it->first, it->second);
+                }
+            }
+
+            void sharded_kv_store::lock_all_shards()
+            {
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    _shards[i].lock.lock_write();
+                }
+            }
+
+            void sharded_kv_store::unlock_all_shards()
+            {
+                for (int i = _shard_count - 1; i >= 0; i--)
+                {
+                    _shards[i].lock.unlock_write();
+                }
+            }
+
+            void sharded_kv_store::lock_all_shards_read()
+            {
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    _shards[i].lock.lock_read();
+                }
+            }
+
+            void sharded_kv_store::unlock_all_shards_read()
+            {
+                for (int i = _shard_count - 1; i >= 0; i--)
+                {
+                    _shards[i].lock.unlock_read();
+                }
+            }
+
+            uint64_t sharded_kv_store::version()
+            {
+                // later writes go to the next epoch
+                lock_all_shards();
+                uint64_t version = _epoch++;
+                unlock_all_shards();
+                return version;
+            }
+
+            uint64_t sharded_kv_store::begin_snapshot()
+            {
+                // no write is half done while all shards are locked, so the snapshot
+                // contains exactly the writes of the current epoch and before, and later
+                // writes go to the next one; the cost is one lock round over the shards,
+                // regardless of the data size
+                lock_all_shards();
+                dassert(_snapshot_version.load() == 0, "there is already an active snapshot");
+                uint64_t snapshot = _epoch++;
+                _snapshot_version = snapshot;
+                unlock_all_shards();
+                return snapshot;
+            }
+
+            void sharded_kv_store::get_snapshot(/*out*/ std::vector<entry>& entries, uint64_t since_version)
+            {
+                uint64_t snapshot = _snapshot_version.load();
+                dassert(snapshot != 0, "there is no active snapshot");
+
+                entries.clear();
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    auto& sd = _shards[i];
+                    utils::auto_read_lock l(sd.lock);
+
+                    // replaced (or cleared) values, then entries untouched since the snapshot
+                    for (auto& e : sd.snapshot_overlay)
+                    {
+                        if (e.second.version > since_version)
+                            entries.emplace_back(e.first, e.second.value);
+                    }
+                    for (auto& e : sd.entries)
+                    {
+                        if (e.second.version <= snapshot && e.second.version > since_version
+                            && sd.snapshot_overlay.find(e.first) == sd.snapshot_overlay.end())
+                            entries.emplace_back(e.first, e.second.value);
+                    }
+                }
+
+                std::sort(entries.begin(), entries.end(),
+                    [](const entry& l, const entry& r) { return l.first < r.first; });
+            }
+
+            void sharded_kv_store::end_snapshot()
+            {
+                lock_all_shards();
+                _snapshot_version = 0;
+                for (int i = 0; i < _shard_count; i++)
+                {
+                    _shards[i].snapshot_overlay.clear();
+                }
+                unlock_all_shards();
+            }
+        }
+    }
+}
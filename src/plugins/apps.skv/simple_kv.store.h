@@ -0,0 +1,265 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     storage backends for simple_kv
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include <dsn/service_api_cpp.h>
+# include <dsn/cpp/zlocks.h>
+# include <dsn/utility/synchronize.h>
+# include <map>
+# include <set>
+# include <unordered_map>
+# include <functional>
+# include <atomic>
+# include <vector>
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            //
+            // key-value storage used by simple_kv_service_impl; values are
+            // immutable refcounted blobs so that readers can reply with them
+            // directly, and writes always install new blobs;
+            // writes made after begin_snapshot() do not show up in the snapshot,
+            // which stays readable until end_snapshot(); one snapshot at a time;
+            // every write is stamped with a version that orders it against the
+            // snapshots (and version() calls), so a snapshot can also be read as
+            // the delta since an earlier one
+            //
+            class kv_store
+            {
+            public:
+                typedef std::function<void(const std::string& key, const blob& value)> visitor;
+                typedef std::pair<std::string, blob> entry;
+
+                struct write_op
+                {
+                    std::string key;
+                    blob        value;
+                    bool        is_append;
+                };
+
+                virtual ~kv_store() {}
+
+                virtual bool get(const std::string& key, /*out*/ blob& value) = 0;
+
+                virtual void put(const std::string& key, const blob& value) = 0;
+
+                virtual void append(const std::string& key, const blob& value) = 0;
+
+                // put all entries, later entries win on duplicated keys, e.g., for recovery
+                virtual void put_batch(std::vector<entry>& entries) = 0;
+
+                // apply puts and appends as if one by one in order, e.g., for a committed write batch
+                virtual void write_batch(std::vector<write_op>& ops) = 0;
+
+                // the entries found for keys, all as of one point in time
+                virtual void multi_get(const std::vector<std::string>& keys, /*out*/ std::vector<entry>& entries) = 0;
+
+                // up to limit entries with keys in [start_key, end_key) in key order, no upper
+                // bound for an empty end_key; returns whether there are more entries in the
+                // range; a page is only a point-in-time view in the ordered_map store
+                virtual bool scan(const std::string& start_key, const std::string& end_key, int limit,
+                    /*out*/ std::vector<entry>& entries) = 0;
+
+                virtual void clear() = 0;
+
+                virtual uint64_t size() = 0;
+
+                // visit all entries in key order, e.g., for checkpointing
+                virtual void scan_ordered(const visitor& v) = 0;
+
+                // a version at or above all the writes so far and below all later ones,
+                // e.g., as the base of the next delta
+                virtual uint64_t version() = 0;
+
+                // take a point-in-time view without copying the data, writes keep going,
+                // returns the version of the snapshot
+                virtual uint64_t begin_snapshot() = 0;
+
+                // entries of the current snapshot written after since_version, in key order,
+                // all entries when since_version is 0
+                virtual void get_snapshot(/*out*/ std::vector<entry>& entries, uint64_t since_version = 0) = 0;
+
+                virtual void end_snapshot() = 0;
+
+                // type: "sharded_hash" (default) or "ordered_map"
+                static kv_store* create(const std::string& type);
+
+                static blob make_value(const std::string& value);
+
+            protected:
+                struct versioned_value
+                {
+                    blob     value;
+                    uint64_t version;
+
+                    versioned_value() : version(0) {}
+                    versioned_value(const blob& v, uint64_t ver) : value(v), version(ver) {}
+                };
+            };
+
+            // std::map under a single lock
+            class ordered_kv_store : public kv_store
+            {
+            public:
+                ordered_kv_store() : _version(0) {}
+
+                virtual bool get(const std::string& key, /*out*/ blob& value) override;
+                virtual void put(const std::string& key, const blob& value) override;
+                virtual void append(const std::string& key, const blob& value) override;
+                virtual void put_batch(std::vector<entry>& entries) override;
+                virtual void write_batch(std::vector<write_op>& ops) override;
+                virtual void multi_get(const std::vector<std::string>& keys, /*out*/ std::vector<entry>& entries) override;
+                virtual bool scan(const std::string& start_key, const std::string& end_key, int limit,
+                    /*out*/ std::vector<entry>& entries) override;
+                virtual void clear() override;
+                virtual uint64_t size() override;
+                virtual void scan_ordered(const visitor& v) override;
+                virtual uint64_t version() override;
+                virtual uint64_t begin_snapshot() override;
+                virtual void get_snapshot(/*out*/ std::vector<entry>& entries, uint64_t since_version = 0) override;
+                virtual void end_snapshot() override;
+
+            private:
+                ::dsn::service::zlock _lock;
+                uint64_t _version;
+                std::map<std::string, versioned_value> _entries;
+                std::map<std::string, versioned_value> _snapshot; // a copy of _entries, values are shared
+            };
+
+            //
+            // hash tables sharded by key hash, each shard with a reader-writer lock,
+            // so that reads to the same shard run in parallel and are only held up
+            // by writes to that shard, and writes to different shards never contend;
+            // multi-key reads hold the read locks of all the shards they touch, always
+            // taken in shard order;
+            //
+            // each shard also keeps its keys in order, which only costs the writes
+            // adding a key, so that a scan takes up to limit + 1 keys from the start
+            // key of one shard at a time and merges them, i.e., O(limit x shards)
+            // per page, and only ever holds one shard lock;
+            //
+            // snapshots are copy-on-write: every entry records the epoch of the write
+            // that installed it, and while a snapshot is active the first write
+            // replacing a value visible in the snapshot moves that value to the
+            // snapshot overlay of its shard; the epoch only changes with all the
+            // shards locked, in begin_snapshot() and version(), so writes just read
+            // it rather than bumping a counter shared by all the shards
+            //
+            class sharded_kv_store : public kv_store
+            {
+            public:
+                sharded_kv_store(int shard_count);
+                virtual ~sharded_kv_store();
+
+                virtual bool get(const std::string& key, /*out*/ blob& value) override;
+                virtual void put(const std::string& key, const blob& value) override;
+                virtual void append(const std::string& key, const blob& value) override;
+                virtual void put_batch(std::vector<entry>& entries) override;
+                virtual void write_batch(std::vector<write_op>& ops) override;
+                virtual void multi_get(const std::vector<std::string>& keys, /*out*/ std::vector<entry>& entries) override;
+                virtual bool scan(const std::string& start_key, const std::string& end_key, int limit,
+                    /*out*/ std::vector<entry>& entries) override;
+                virtual void clear() override;
+                virtual uint64_t size() override;
+                virtual void scan_ordered(const visitor& v) override;
+                virtual uint64_t version() override;
+                virtual uint64_t begin_snapshot() override;
+                virtual void get_snapshot(/*out*/ std::vector<entry>& entries, uint64_t since_version = 0) override;
+                virtual void end_snapshot() override;
+
+            private:
+                typedef std::unordered_map<std::string, versioned_value> entry_map;
+
+                // entries do not move on rehash, so the index points to them
+                struct entry_ptr_less
+                {
+                    typedef void is_transparent;
+                    bool operator()(const entry_map::value_type* l, const entry_map::value_type* r) const { return l->first < r->first; }
+                    bool operator()(const entry_map::value_type* l, const std::string& r) const { return l->first < r; }
+                    bool operator()(const std::string& l, const entry_map::value_type* r) const { return l < r->first; }
+                };
+                typedef std::set<const entry_map::value_type*, entry_ptr_less> key_index;
+
+                struct shard
+                {
+                    utils::rw_lock_nr lock;
+                    entry_map entries;
+                    key_index keys; // entries in key order
+                    std::unordered_map<std::string, versioned_value> snapshot_overlay; // values replaced since the snapshot
+                    char padding[64]; // avoid false sharing between adjacent shard locks
+                };
+
+                // under the shard write lock, before the value at it is replaced by write version
+                void preserve_for_snapshot(shard& sd, entry_map::iterator it);
+
+                // under the shard write lock
+                void put_locked(shard& sd, const std::string& key, const blob& value);
+                void append_locked(shard& sd, const std::string& key, const blob& value);
+                void insert_locked(shard& sd, const std::string& key, const blob& value, uint64_t version);
+
+                // call apply(shard, i) for i in [0, count) under the write lock of the
+                // shard of key_of(i), in order within each shard, one lock per shard
+                template<typename TKeyOf, typename TApply>
+                void apply_by_shard(size_t count, TKeyOf key_of, TApply apply);
+
+                void lock_all_shards();
+                void unlock_all_shards();
+                void lock_all_shards_read();
+                void unlock_all_shards_read();
+
+                size_t get_shard_index(const std::string& key) const
+                {
+                    return std::hash<std::string>()(key) & _shard_mask;
+                }
+
+                shard& get_shard(const std::string& key)
+                {
+                    return _shards[get_shard_index(key)];
+                }
+
+            private:
+                shard    *_shards;
+                int      _shard_count;
+                size_t   _shard_mask;
+
+                uint64_t              _epoch;            // version of new writes, changed with all the shards locked
+                std::atomic<uint64_t> _snapshot_version; // 0 if there is no snapshot
+            };
+        }
+    }
+}
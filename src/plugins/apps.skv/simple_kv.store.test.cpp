@@ -0,0 +1,308 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the storage backends of simple_kv.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "simple_kv.store.h"
+# include <gtest/gtest.h>
+# include <thread>
+
+using namespace dsn;
+using namespace dsn::replication::application;
+
+static std::string blob_to_string(const blob& b)
+{
+    return std::string(b.data(), b.length());
+}
+
+static std::string get_value(kv_store* s, const std::string& key)
+{
+    blob v;
+    if (!s->get(key, v))
+        return "<none>";
+    return blob_to_string(v);
+}
+
+static void kv_store_basic_test(kv_store* s)
+{
+    ASSERT_EQ(0u, s->size());
+    ASSERT_EQ("<none>", get_value(s, "k1"));
+
+    // put, overwrite and append
+    uint64_t version = s->version();
+    s->put("k1", kv_store::make_value("v1"));
+    ASSERT_EQ("v1", get_value(s, "k1"));
+    s->put("k1", kv_store::make_value("v2"));
+    ASSERT_EQ("v2", get_value(s, "k1"));
+    s->append("k1", kv_store::make_value("+a"));
+    ASSERT_EQ("v2+a", get_value(s, "k1"));
+    s->append("k2", kv_store::make_value("a"));
+    ASSERT_EQ("a", get_value(s, "k2"));
+    ASSERT_EQ(2u, s->size());
+    ASSERT_LT(version, s->version());
+
+    // later entries win in a batch, and batched writes apply in order
+    std::vector<kv_store::entry> entries;
+    entries.emplace_back("k3", kv_store::make_value("x"));
+    entries.emplace_back("k3", kv_store::make_value("y"));
+    entries.emplace_back("k4", kv_store::make_value("z"));
+    s->put_batch(entries);
+    ASSERT_EQ("y", get_value(s, "k3"));
+    ASSERT_EQ("z", get_value(s, "k4"));
+
+    std::vector<kv_store::write_op> ops(4);
+    ops[0].key = "k4"; ops[0].value = kv_store::make_value("+1"); ops[0].is_append = true;
+    ops[1].key = "k5"; ops[1].value = kv_store::make_value("p");  ops[1].is_append = false;
+    ops[2].key = "k5"; ops[2].value = kv_store::make_value("+2"); ops[2].is_append = true;
+    ops[3].key = "k4"; ops[3].value = kv_store::make_value("+3"); ops[3].is_append = true;
+    s->write_batch(ops);
+    ASSERT_EQ("z+1+3", get_value(s, "k4"));
+    ASSERT_EQ("p+2", get_value(s, "k5"));
+    ASSERT_EQ(5u, s->size());
+
+    // missing keys are skipped by multi_get
+    std::vector<std::string> keys = { "k5", "none", "k1" };
+    s->multi_get(keys, entries);
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_EQ("k5", entries[0].first);
+    ASSERT_EQ("p+2", blob_to_string(entries[0].second));
+    ASSERT_EQ("k1", entries[1].first);
+    ASSERT_EQ("v2+a", blob_to_string(entries[1].second));
+
+    // scans are in key order within [start_key, end_key)
+    ASSERT_TRUE(s->scan("k2", "", 2, entries));
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_EQ("k2", entries[0].first);
+    ASSERT_EQ("k3", entries[1].first);
+    ASSERT_FALSE(s->scan("k2", "k4", 10, entries));
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_FALSE(s->scan("k0", "", 10, entries));
+    ASSERT_EQ(5u, entries.size());
+    ASSERT_FALSE(s->scan("k6", "", 10, entries));
+    ASSERT_TRUE(entries.empty());
+
+    std::vector<std::string> visited;
+    s->scan_ordered([&visited](const std::string& key, const blob& value) { visited.push_back(key); });
+    ASSERT_EQ(std::vector<std::string>({ "k1", "k2", "k3", "k4", "k5" }), visited);
+
+    s->clear();
+    ASSERT_EQ(0u, s->size());
+    ASSERT_EQ("<none>", get_value(s, "k1"));
+    ASSERT_FALSE(s->scan("", "", 10, entries));
+    ASSERT_TRUE(entries.empty());
+}
+
+static void kv_store_scan_test(kv_store* s)
+{
+    s->clear();
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; i++)
+    {
+        char key[16];
+        sprintf(key, "key%03d", i);
+        keys.push_back(key);
+        s->put(key, kv_store::make_value(std::to_string(i)));
+    }
+
+    // page through [key010, key090) from after the last key of each page
+    std::vector<kv_store::entry> entries;
+    std::vector<std::string> visited;
+    std::string start_key = "key010";
+    int pages = 0;
+    while (true)
+    {
+        bool has_more = s->scan(start_key, "key090", 7, entries);
+        ASSERT_LE(entries.size(), 7u);
+        pages++;
+        for (auto& e : entries)
+        {
+            ASSERT_EQ(keys[visited.size() + 10], e.first);
+            ASSERT_EQ(std::to_string(visited.size() + 10), blob_to_string(e.second));
+            visited.push_back(e.first);
+        }
+        if (!has_more)
+            break;
+        ASSERT_EQ(7u, entries.size());
+        start_key = entries.back().first + '\0';
+    }
+    ASSERT_EQ(12, pages);
+    ASSERT_EQ(std::vector<std::string>(keys.begin() + 10, keys.begin() + 90), visited);
+
+    // a page ending right at the last key in range has nothing more
+    ASSERT_FALSE(s->scan("key080", "key090", 10, entries));
+    ASSERT_EQ(10u, entries.size());
+    ASSERT_TRUE(s->scan("key080", "key090", 9, entries));
+    ASSERT_EQ("key088", entries.back().first);
+
+    // start and end keys not in the store, and an empty range
+    ASSERT_FALSE(s->scan("key05", "key06", 10, entries));
+    ASSERT_EQ(10u, entries.size());
+    ASSERT_EQ("key050", entries.front().first);
+    ASSERT_FALSE(s->scan("key050", "key050", 10, entries));
+    ASSERT_TRUE(entries.empty());
+    ASSERT_FALSE(s->scan("key099\xff", "", 10, entries));
+    ASSERT_TRUE(entries.empty());
+
+    // unbounded to the end
+    ASSERT_FALSE(s->scan("key095", "", 10, entries));
+    ASSERT_EQ(5u, entries.size());
+    ASSERT_EQ("key099", entries.back().first);
+    s->clear();
+}
+
+static void kv_store_snapshot_test(kv_store* s)
+{
+    s->put("k1", kv_store::make_value("1"));
+    s->put("k2", kv_store::make_value("2"));
+    s->put("k3", kv_store::make_value("3"));
+
+    // writes after begin_snapshot do not show up in the snapshot
+    uint64_t v1 = s->begin_snapshot();
+    s->put("k1", kv_store::make_value("1b"));
+    s->append("k2", kv_store::make_value("b"));
+    s->put("k4", kv_store::make_value("4"));
+    s->put("k1", kv_store::make_value("1c"));
+    std::vector<kv_store::write_op> ops(1);
+    ops[0].key = "k3"; ops[0].value = kv_store::make_value("3b"); ops[0].is_append = false;
+    s->write_batch(ops);
+
+    std::vector<kv_store::entry> entries;
+    s->get_snapshot(entries);
+    ASSERT_EQ(3u, entries.size());
+    ASSERT_EQ("k1", entries[0].first);
+    ASSERT_EQ("1", blob_to_string(entries[0].second));
+    ASSERT_EQ("k2", entries[1].first);
+    ASSERT_EQ("2", blob_to_string(entries[1].second));
+    ASSERT_EQ("k3", entries[2].first);
+    ASSERT_EQ("3", blob_to_string(entries[2].second));
+    ASSERT_EQ("1c", get_value(s, "k1"));
+
+    // even when the store is cleared
+    s->clear();
+    s->get_snapshot(entries);
+    ASSERT_EQ(3u, entries.size());
+    s->end_snapshot();
+
+    // the next snapshot read as the delta since the previous one
+    s->put("k1", kv_store::make_value("1"));
+    s->put("k2", kv_store::make_value("2"));
+    uint64_t v2 = s->begin_snapshot();
+    ASSERT_LT(v1, v2);
+    s->end_snapshot();
+    s->put("k2", kv_store::make_value("2b"));
+    s->put("k5", kv_store::make_value("5"));
+    s->begin_snapshot();
+    s->put("k6", kv_store::make_value("6"));
+    s->get_snapshot(entries, v2);
+    ASSERT_EQ(2u, entries.size());
+    ASSERT_EQ("k2", entries[0].first);
+    ASSERT_EQ("2b", blob_to_string(entries[0].second));
+    ASSERT_EQ("k5", entries[1].first);
+    s->get_snapshot(entries);
+    ASSERT_EQ(3u, entries.size());
+    s->end_snapshot();
+
+    // and as the delta since version(), which is below all later writes
+    uint64_t v3 = s->version();
+    s->put("k7", kv_store::make_value("7"));
+    s->begin_snapshot();
+    s->get_snapshot(entries, v3);
+    ASSERT_EQ(1u, entries.size());
+    ASSERT_EQ("k7", entries[0].first);
+    s->end_snapshot();
+    s->clear();
+
+    // a snapshot taken while another thread writes k<i> then hot = i for i = 0, 1, ...
+    // is a prefix of the writes, and does not change while the writes go on
+    std::atomic<bool> stop(false);
+    std::thread writer([s, &stop]()
+    {
+        for (int i = 0; !stop.load(); i++)
+        {
+            char key[32];
+            sprintf(key, "k%08d", i);
+            s->put(key, kv_store::make_value(std::to_string(i)));
+            s->put("hot", kv_store::make_value(std::to_string(i)));
+        }
+    });
+
+    while (s->size() < 1000)
+        std::this_thread::yield();
+
+    s->begin_snapshot();
+    std::vector<kv_store::entry> first, second;
+    s->get_snapshot(first);
+    while (s->size() < 3000)
+        std::this_thread::yield();
+    s->get_snapshot(second);
+    s->end_snapshot();
+
+    stop = true;
+    writer.join();
+
+    ASSERT_EQ(first.size(), second.size());
+    ASSERT_LE(1000u, first.size());
+    ASSERT_EQ("hot", first[0].first);
+    int count = (int)first.size() - 1;
+    int hot = atoi(blob_to_string(first[0].second).c_str());
+    ASSERT_TRUE(hot == count - 1 || hot == count - 2);
+    for (int i = 0; i <= count; i++)
+    {
+        if (i > 0)
+        {
+            ASSERT_EQ(std::to_string(i - 1), blob_to_string(first[i].second));
+        }
+        ASSERT_EQ(first[i].first, second[i].first);
+        ASSERT_EQ(blob_to_string(first[i].second), blob_to_string(second[i].second));
+    }
+}
+
+TEST(apps_skv, kv_store_ordered_map)
+{
+    std::unique_ptr<kv_store> s(kv_store::create("ordered_map"));
+    kv_store_basic_test(s.get());
+    kv_store_scan_test(s.get());
+    kv_store_snapshot_test(s.get());
+}
+
+TEST(apps_skv, kv_store_sharded_hash)
+{
+    std::unique_ptr<kv_store> s(new sharded_kv_store(4));
+    kv_store_basic_test(s.get());
+    kv_store_scan_test(s.get());
+    kv_store_snapshot_test(s.get());
+
+    // a single shard behaves the same
+    s.reset(new sharded_kv_store(1));
+    kv_store_basic_test(s.get());
+    kv_store_scan_test(s.get());
+}
@@ -6,9 +6,42 @@ struct kv_pair
     2:string value;
 }
 
+struct multi_get_request
+{
+    1:list<string> keys;
+}
+
+struct multi_get_response
+{
+    1:list<kv_pair> kvs; // found keys only
+}
+
+struct multi_put_request
+{
+    1:list<kv_pair> kvs;
+}
+
+// keys in [start_key, end_key), end_key empty for no upper bound
+struct scan_request
+{
+    1:string start_key;
+    2:string end_key;
+    3:i32    limit;
+}
+
+// the next page starts right after the last key returned
+struct scan_response
+{
+    1:list<kv_pair> kvs;
+    2:bool          has_more;
+}
+
 service simple_kv
 {
     string read(1:string key);
     i32    write(2:kv_pair pr);
     i32    append(2:kv_pair pr);
+    multi_get_response multi_get(1:multi_get_request req);
+    i32    multi_put(1:multi_put_request req);
+    scan_response scan(1:scan_request req);
 }
@@ -7,6 +7,176 @@
 
 
 namespace dsn { namespace replication { namespace application { 
-    GENERATED_TYPE_SERIALIZATION(kv_pair, THRIFT)
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const kv_pair& val)
+    {
+        writer.write_field(1, val.key);
+        writer.write_field(2, val.value);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ kv_pair& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.key)) val.__isset.key = true;
+                break;
+            case 2:
+                if (reader.read_field(type, val.value)) val.__isset.value = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(kv_pair, THRIFT_CODEC)
+
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const multi_get_request& val)
+    {
+        writer.write_field(1, val.keys);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ multi_get_request& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.keys)) val.__isset.keys = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(multi_get_request, THRIFT_CODEC)
+
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const multi_get_response& val)
+    {
+        writer.write_field(1, val.kvs);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ multi_get_response& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.kvs)) val.__isset.kvs = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(multi_get_response, THRIFT_CODEC)
+
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const multi_put_request& val)
+    {
+        writer.write_field(1, val.kvs);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ multi_put_request& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.kvs)) val.__isset.kvs = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(multi_put_request, THRIFT_CODEC)
+
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const scan_request& val)
+    {
+        writer.write_field(1, val.start_key);
+        writer.write_field(2, val.end_key);
+        writer.write_field(3, val.limit);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ scan_request& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.start_key)) val.__isset.start_key = true;
+                break;
+            case 2:
+                if (reader.read_field(type, val.end_key)) val.__isset.end_key = true;
+                break;
+            case 3:
+                if (reader.read_field(type, val.limit)) val.__isset.limit = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(scan_request, THRIFT_CODEC)
+
+    inline void thrift_binary_write(::dsn::thrift_binary_writer& writer, const scan_response& val)
+    {
+        writer.write_field(1, val.kvs);
+        writer.write_field(2, val.has_more);
+        writer.write_field_stop();
+    }
+
+    inline void thrift_binary_read(::dsn::thrift_binary_reader& reader, /*out*/ scan_response& val)
+    {
+        ::apache::thrift::protocol::TType type;
+        int16_t id;
+        while (reader.read_field_begin(type, id))
+        {
+            switch (id)
+            {
+            case 1:
+                if (reader.read_field(type, val.kvs)) val.__isset.kvs = true;
+                break;
+            case 2:
+                if (reader.read_field(type, val.has_more)) val.__isset.has_more = true;
+                break;
+            default:
+                reader.skip(type);
+                break;
+            }
+        }
+    }
+
+    GENERATED_TYPE_SERIALIZATION(scan_response, THRIFT_CODEC)
 
 } } } 
\ No newline at end of file
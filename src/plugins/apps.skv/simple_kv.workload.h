@@ -0,0 +1,429 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * Description:
+ *     YCSB-style workload for the simple_kv perf test client: skewed key
+ *     distributions, precomputed key/value pools and A-F operation mixes
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# pragma once
+# include <dsn/service_api_cpp.h>
+# include <atomic>
+# include <cinttypes>
+# include <cmath>
+# include <memory>
+# include <string>
+# include <vector>
+
+namespace dsn { namespace replication { namespace application {
+
+    //
+    // key choosers, all returning key numbers in [0, n)
+    //
+    class key_chooser
+    {
+    public:
+        virtual ~key_chooser() {}
+        virtual uint64_t next() = 0;
+    };
+
+    class uniform_key_chooser : public key_chooser
+    {
+    public:
+        uniform_key_chooser(uint64_t n) : _n(n) {}
+        virtual uint64_t next() override { return dsn_random64(0, _n - 1); }
+
+    private:
+        uint64_t _n;
+    };
+
+    // the algorithm from Gray et al., "Quickly Generating Billion-Record
+    // Synthetic Databases", as used by YCSB: item 0 is the most popular one
+    class zipfian_generator
+    {
+    public:
+        zipfian_generator(uint64_t n, double theta)
+            : _n(n), _theta(theta)
+        {
+            double zeta2 = zeta(2, theta);
+            _zetan = zeta(n, theta);
+            _alpha = 1.0 / (1.0 - theta);
+            _eta = (1.0 - std::pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / _zetan);
+            _half_pow_theta = 1.0 + std::pow(0.5, theta);
+        }
+
+        uint64_t next() const
+        {
+            double u = dsn_probability();
+            double uz = u * _zetan;
+            if (uz < 1.0)
+                return 0;
+            if (uz < _half_pow_theta)
+                return 1;
+
+            auto r = (uint64_t)((double)_n * std::pow(_eta * u - _eta + 1.0, _alpha));
+            return r < _n ? r : _n - 1;
+        }
+
+    private:
+        static double zeta(uint64_t n, double theta)
+        {
+            double sum = 0;
+            for (uint64_t i = 1; i <= n; i++)
+                sum += 1.0 / std::pow((double)i, theta);
+            return sum;
+        }
+
+    private:
+        uint64_t _n;
+        double   _theta;
+        double   _zetan;
+        double   _alpha;
+        double   _eta;
+        double   _half_pow_theta;
+    };
+
+    // zipfian popularity with the popular items scattered over the key space
+    // (instead of clustering on the smallest key numbers, which would all
+    // fall into the same range of the ordered store)
+    class zipfian_key_chooser : public key_chooser
+    {
+    public:
+        zipfian_key_chooser(uint64_t n, double theta) : _n(n), _zipf(n, theta) {}
+        virtual uint64_t next() override { return fnv_hash64(_zipf.next()) % _n; }
+
+        static uint64_t fnv_hash64(uint64_t v)
+        {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (int i = 0; i < 8; i++)
+            {
+                h ^= (v & 0xff);
+                h *= 0x100000001b3ULL;
+                v >>= 8;
+            }
+            return h;
+        }
+
+    private:
+        uint64_t          _n;
+        zipfian_generator _zipf;
+    };
+
+    // the most recently inserted keys are the most popular ones
+    class latest_key_chooser : public key_chooser
+    {
+    public:
+        latest_key_chooser(uint64_t n, double theta, const std::atomic<uint64_t>& inserted)
+            : _n(n), _zipf(n, theta), _inserted(inserted)
+        {}
+
+        virtual uint64_t next() override
+        {
+            uint64_t latest = _inserted.load(std::memory_order_relaxed) - 1;
+            return (latest + _n - _zipf.next()) % _n;
+        }
+
+    private:
+        uint64_t                     _n;
+        zipfian_generator            _zipf;
+        const std::atomic<uint64_t>& _inserted;
+    };
+
+    // hot_op_fraction of the operations go to the first hot_data_fraction
+    // of the key space
+    class hotspot_key_chooser : public key_chooser
+    {
+    public:
+        hotspot_key_chooser(uint64_t n, double hot_data_fraction, double hot_op_fraction)
+            : _hot_op_fraction(hot_op_fraction)
+        {
+            _hot_count = (uint64_t)((double)n * hot_data_fraction);
+            if (_hot_count == 0)
+                _hot_count = 1;
+            if (_hot_count > n)
+                _hot_count = n;
+            _cold_count = n - _hot_count;
+        }
+
+        virtual uint64_t next() override
+        {
+            if (_cold_count == 0 || dsn_probability() < _hot_op_fraction)
+                return dsn_random64(0, _hot_count - 1);
+            else
+                return _hot_count + dsn_random64(0, _cold_count - 1);
+        }
+
+    private:
+        double   _hot_op_fraction;
+        uint64_t _hot_count;
+        uint64_t _cold_count;
+    };
+
+    enum workload_op
+    {
+        WOP_READ,
+        WOP_UPDATE,
+        WOP_INSERT,
+        WOP_SCAN,
+        WOP_READ_MODIFY_WRITE,
+        WOP_COUNT
+    };
+
+    //
+    // the workload of one perf test case, configured with
+    //
+    //   workload = ycsb_a | ycsb_b | ycsb_c | ycsb_d | ycsb_e | ycsb_f | custom
+    //   key_distribution = uniform | zipfian | latest | hotspot
+    //   zipfian_constant = 0.99
+    //   hotspot_data_fraction = 0.2
+    //   hotspot_op_fraction = 0.8
+    //   read_proportion, update_proportion, insert_proportion,
+    //   scan_proportion, read_modify_write_proportion
+    //   read_modify_write_append = false
+    //   scan_length = 100
+    //   value_pool_size = 64
+    //
+    // each key is read from the case section first and then from
+    // [apps.client.perf.test], the ycsb presets only provide the defaults.
+    //
+    // the key space is fixed to key_space_size keys ("key.<n>"), so inserts
+    // cycle through the key numbers, which is what the latest distribution
+    // follows; all key strings and a small pool of payload-sized values are
+    // built when the case starts, so no request formats a key or a value.
+    //
+    class workload
+    {
+    public:
+        // returns nullptr when neither section sets 'workload', so the client
+        // keeps using perf_test_hybrid_request_ratio
+        static std::unique_ptr<workload> create(
+            const char* case_section,
+            const char* default_section,
+            int payload_bytes,
+            int key_space_size
+            )
+        {
+            std::string name = dsn_config_get_value_string(case_section, "workload",
+                dsn_config_get_value_string(default_section, "workload", "",
+                    "ycsb_a ~ ycsb_f or custom, empty for the hybrid request ratios"),
+                "ycsb_a ~ ycsb_f or custom, empty for the hybrid request ratios");
+            if (name.empty())
+                return nullptr;
+
+            std::unique_ptr<workload> w(new workload());
+            if (!w->init(name, case_section, default_section, payload_bytes, key_space_size))
+                return nullptr;
+            return w;
+        }
+
+        workload_op next_op() const
+        {
+            double p = dsn_probability();
+            for (int i = 0; i < WOP_COUNT - 1; i++)
+            {
+                if (p < _op_cdf[i])
+                    return (workload_op)i;
+            }
+            return (workload_op)(WOP_COUNT - 1);
+        }
+
+        // an existing key following the key distribution
+        uint64_t next_key() const { return _chooser->next(); }
+
+        // the next key number to be inserted
+        uint64_t next_insert_key()
+        {
+            return _inserted.fetch_add(1, std::memory_order_relaxed) % _keys.size();
+        }
+
+        const std::string& key(uint64_t n) const { return _keys[n]; }
+
+        const std::string& next_value() const
+        {
+            return _values[dsn_random32(0, (uint32_t)_values.size() - 1)];
+        }
+
+        const std::string& name() const { return _name; }
+        bool read_modify_write_append() const { return _rmw_append; }
+        int  scan_length() const { return _scan_length; }
+
+    private:
+        workload() : _inserted(0), _rmw_append(false), _scan_length(100) {}
+
+        struct preset
+        {
+            const char* name;
+            const char* distribution;
+            double      proportions[WOP_COUNT];
+        };
+
+        bool init(
+            const std::string& name,
+            const char* case_section,
+            const char* default_section,
+            int payload_bytes,
+            int key_space_size
+            )
+        {
+            static const preset presets[] = {
+                //                         read  update insert scan  rmw
+                { "ycsb_a", "zipfian", { 0.50, 0.50,  0,     0,    0    } },
+                { "ycsb_b", "zipfian", { 0.95, 0.05,  0,     0,    0    } },
+                { "ycsb_c", "zipfian", { 1.00, 0,     0,     0,    0    } },
+                { "ycsb_d", "latest",  { 0.95, 0,     0.05,  0,    0    } },
+                { "ycsb_e", "zipfian", { 0,    0,     0.05,  0.95, 0    } },
+                { "ycsb_f", "zipfian", { 0.50, 0,     0,     0,    0.50 } },
+                { "custom", "uniform", { 1.00, 0,     0,     0,    0    } }
+            };
+            static const char* proportion_keys[WOP_COUNT] = {
+                "read_proportion",
+                "update_proportion",
+                "insert_proportion",
+                "scan_proportion",
+                "read_modify_write_proportion"
+            };
+
+            const preset* ps = nullptr;
+            for (auto& p : presets)
+            {
+                if (name == p.name)
+                {
+                    ps = &p;
+                    break;
+                }
+            }
+            if (ps == nullptr)
+            {
+                derror("unknown workload '%s' in [%s]", name.c_str(), case_section);
+                return false;
+            }
+
+            _name = name;
+            if (key_space_size <= 0)
+                key_space_size = 1;
+            uint64_t n = (uint64_t)key_space_size;
+
+            double total = 0;
+            for (int i = 0; i < WOP_COUNT; i++)
+            {
+                _op_cdf[i] = get_double(case_section, default_section, proportion_keys[i],
+                    ps->proportions[i], "proportion of this kind of operations");
+                total += _op_cdf[i];
+            }
+            if (total <= 0)
+            {
+                derror("all operation proportions of workload '%s' in [%s] are zero", name.c_str(), case_section);
+                return false;
+            }
+            for (int i = 0; i < WOP_COUNT; i++)
+                _op_cdf[i] = (i > 0 ? _op_cdf[i - 1] : 0) + _op_cdf[i] / total;
+
+            _rmw_append = dsn_config_get_value_bool(case_section, "read_modify_write_append",
+                dsn_config_get_value_bool(default_section, "read_modify_write_append", false,
+                    "write back with append instead of write in read-modify-write"),
+                "write back with append instead of write in read-modify-write");
+            _scan_length = (int)get_double(case_section, default_section, "scan_length", 100,
+                "max kv count returned by each scan");
+
+            std::string dist = dsn_config_get_value_string(case_section, "key_distribution",
+                dsn_config_get_value_string(default_section, "key_distribution", ps->distribution,
+                    "uniform, zipfian, latest or hotspot"),
+                "uniform, zipfian, latest or hotspot");
+            double theta = get_double(case_section, default_section, "zipfian_constant", 0.99,
+                "skew of the zipfian and latest distributions");
+
+            if (dist == "uniform")
+                _chooser.reset(new uniform_key_chooser(n));
+            else if (dist == "zipfian")
+                _chooser.reset(new zipfian_key_chooser(n, theta));
+            else if (dist == "latest")
+                _chooser.reset(new latest_key_chooser(n, theta, _inserted));
+            else if (dist == "hotspot")
+                _chooser.reset(new hotspot_key_chooser(n,
+                    get_double(case_section, default_section, "hotspot_data_fraction", 0.2,
+                        "fraction of the key space which is hot"),
+                    get_double(case_section, default_section, "hotspot_op_fraction", 0.8,
+                        "fraction of the operations going to the hot keys")
+                    ));
+            else
+            {
+                derror("unknown key_distribution '%s' in [%s]", dist.c_str(), case_section);
+                return false;
+            }
+
+            // the whole key space counts as inserted, so the latest keys
+            // are the largest key numbers before the first insert
+            _inserted = n;
+
+            _keys.resize(n);
+            char buffer[32];
+            for (uint64_t i = 0; i < n; i++)
+            {
+                snprintf(buffer, sizeof(buffer), "key.%" PRIu64, i);
+                _keys[i] = buffer;
+            }
+
+            // values of random content, so the stores can not take advantage
+            // of a single repeated value
+            int pool_size = (int)get_double(case_section, default_section, "value_pool_size", 64,
+                "count of precomputed values");
+            if (pool_size <= 0)
+                pool_size = 1;
+            _values.resize(pool_size);
+            for (auto& v : _values)
+            {
+                v.resize(payload_bytes);
+                for (auto& c : v)
+                    c = (char)('a' + dsn_random32(0, 25));
+            }
+            return true;
+        }
+
+        static double get_double(const char* case_section, const char* default_section,
+            const char* key, double default_value, const char* dsptr)
+        {
+            return dsn_config_get_value_double(case_section, key,
+                dsn_config_get_value_double(default_section, key, default_value, dsptr),
+                dsptr);
+        }
+
+    private:
+        std::string                  _name;
+        double                       _op_cdf[WOP_COUNT];
+        std::unique_ptr<key_chooser> _chooser;
+        std::atomic<uint64_t>        _inserted;
+        std::vector<std::string>     _keys;
+        std::vector<std::string>     _values;
+        bool                         _rmw_append;
+        int                          _scan_length;
+    };
+
+} } }
@@ -130,4 +130,624 @@ void kv_pair::printTo(std::ostream& out) const {
   out << ")";
 }
 
+multi_get_request::~multi_get_request() throw() {
+}
+
+
+void multi_get_request::__set_keys(const std::vector<std::string> & val) {
+  this->keys = val;
+}
+
+uint32_t multi_get_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->keys.clear();
+            uint32_t _size4;
+            ::apache::thrift::protocol::TType _etype7;
+            xfer += iprot->readListBegin(_etype7, _size4);
+            this->keys.resize(_size4);
+            uint32_t _i8;
+            for (_i8 = 0; _i8 < _size4; ++_i8)
+            {
+              xfer += iprot->readString(this->keys[_i8]);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.keys = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t multi_get_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("multi_get_request");
+
+  xfer += oprot->writeFieldBegin("keys", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRING, static_cast<uint32_t>(this->keys.size()));
+    std::vector<std::string> ::const_iterator _iter9;
+    for (_iter9 = this->keys.begin(); _iter9 != this->keys.end(); ++_iter9)
+    {
+      xfer += oprot->writeString((*_iter9));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(multi_get_request &a, multi_get_request &b) {
+  using ::std::swap;
+  swap(a.keys, b.keys);
+  swap(a.__isset, b.__isset);
+}
+
+multi_get_request::multi_get_request(const multi_get_request& other10) {
+  keys = other10.keys;
+  __isset = other10.__isset;
+}
+multi_get_request::multi_get_request( multi_get_request&& other11) {
+  keys = std::move(other11.keys);
+  __isset = std::move(other11.__isset);
+}
+multi_get_request& multi_get_request::operator=(const multi_get_request& other12) {
+  keys = other12.keys;
+  __isset = other12.__isset;
+  return *this;
+}
+multi_get_request& multi_get_request::operator=(multi_get_request&& other13) {
+  keys = std::move(other13.keys);
+  __isset = std::move(other13.__isset);
+  return *this;
+}
+void multi_get_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "multi_get_request(";
+  out << "keys=" << to_string(keys);
+  out << ")";
+}
+
+
+multi_get_response::~multi_get_response() throw() {
+}
+
+
+void multi_get_response::__set_kvs(const std::vector<kv_pair> & val) {
+  this->kvs = val;
+}
+
+uint32_t multi_get_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->kvs.clear();
+            uint32_t _size14;
+            ::apache::thrift::protocol::TType _etype17;
+            xfer += iprot->readListBegin(_etype17, _size14);
+            this->kvs.resize(_size14);
+            uint32_t _i18;
+            for (_i18 = 0; _i18 < _size14; ++_i18)
+            {
+              xfer += this->kvs[_i18].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.kvs = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t multi_get_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("multi_get_response");
+
+  xfer += oprot->writeFieldBegin("kvs", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->kvs.size()));
+    std::vector<kv_pair> ::const_iterator _iter19;
+    for (_iter19 = this->kvs.begin(); _iter19 != this->kvs.end(); ++_iter19)
+    {
+      xfer += (*_iter19).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(multi_get_response &a, multi_get_response &b) {
+  using ::std::swap;
+  swap(a.kvs, b.kvs);
+  swap(a.__isset, b.__isset);
+}
+
+multi_get_response::multi_get_response(const multi_get_response& other20) {
+  kvs = other20.kvs;
+  __isset = other20.__isset;
+}
+multi_get_response::multi_get_response( multi_get_response&& other21) {
+  kvs = std::move(other21.kvs);
+  __isset = std::move(other21.__isset);
+}
+multi_get_response& multi_get_response::operator=(const multi_get_response& other22) {
+  kvs = other22.kvs;
+  __isset = other22.__isset;
+  return *this;
+}
+multi_get_response& multi_get_response::operator=(multi_get_response&& other23) {
+  kvs = std::move(other23.kvs);
+  __isset = std::move(other23.__isset);
+  return *this;
+}
+void multi_get_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "multi_get_response(";
+  out << "kvs=" << to_string(kvs);
+  out << ")";
+}
+
+
+multi_put_request::~multi_put_request() throw() {
+}
+
+
+void multi_put_request::__set_kvs(const std::vector<kv_pair> & val) {
+  this->kvs = val;
+}
+
+uint32_t multi_put_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->kvs.clear();
+            uint32_t _size24;
+            ::apache::thrift::protocol::TType _etype27;
+            xfer += iprot->readListBegin(_etype27, _size24);
+            this->kvs.resize(_size24);
+            uint32_t _i28;
+            for (_i28 = 0; _i28 < _size24; ++_i28)
+            {
+              xfer += this->kvs[_i28].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.kvs = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t multi_put_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("multi_put_request");
+
+  xfer += oprot->writeFieldBegin("kvs", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->kvs.size()));
+    std::vector<kv_pair> ::const_iterator _iter29;
+    for (_iter29 = this->kvs.begin(); _iter29 != this->kvs.end(); ++_iter29)
+    {
+      xfer += (*_iter29).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(multi_put_request &a, multi_put_request &b) {
+  using ::std::swap;
+  swap(a.kvs, b.kvs);
+  swap(a.__isset, b.__isset);
+}
+
+multi_put_request::multi_put_request(const multi_put_request& other30) {
+  kvs = other30.kvs;
+  __isset = other30.__isset;
+}
+multi_put_request::multi_put_request( multi_put_request&& other31) {
+  kvs = std::move(other31.kvs);
+  __isset = std::move(other31.__isset);
+}
+multi_put_request& multi_put_request::operator=(const multi_put_request& other32) {
+  kvs = other32.kvs;
+  __isset = other32.__isset;
+  return *this;
+}
+multi_put_request& multi_put_request::operator=(multi_put_request&& other33) {
+  kvs = std::move(other33.kvs);
+  __isset = std::move(other33.__isset);
+  return *this;
+}
+void multi_put_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "multi_put_request(";
+  out << "kvs=" << to_string(kvs);
+  out << ")";
+}
+
+
+scan_request::~scan_request() throw() {
+}
+
+
+void scan_request::__set_start_key(const std::string& val) {
+  this->start_key = val;
+}
+
+void scan_request::__set_end_key(const std::string& val) {
+  this->end_key = val;
+}
+
+void scan_request::__set_limit(const int32_t val) {
+  this->limit = val;
+}
+
+uint32_t scan_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->start_key);
+          this->__isset.start_key = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->end_key);
+          this->__isset.end_key = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->limit);
+          this->__isset.limit = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t scan_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("scan_request");
+
+  xfer += oprot->writeFieldBegin("start_key", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeString(this->start_key);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("end_key", ::apache::thrift::protocol::T_STRING, 2);
+  xfer += oprot->writeString(this->end_key);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("limit", ::apache::thrift::protocol::T_I32, 3);
+  xfer += oprot->writeI32(this->limit);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(scan_request &a, scan_request &b) {
+  using ::std::swap;
+  swap(a.start_key, b.start_key);
+  swap(a.end_key, b.end_key);
+  swap(a.limit, b.limit);
+  swap(a.__isset, b.__isset);
+}
+
+scan_request::scan_request(const scan_request& other34) {
+  start_key = other34.start_key;
+  end_key = other34.end_key;
+  limit = other34.limit;
+  __isset = other34.__isset;
+}
+scan_request::scan_request( scan_request&& other35) {
+  start_key = std::move(other35.start_key);
+  end_key = std::move(other35.end_key);
+  limit = std::move(other35.limit);
+  __isset = std::move(other35.__isset);
+}
+scan_request& scan_request::operator=(const scan_request& other36) {
+  start_key = other36.start_key;
+  end_key = other36.end_key;
+  limit = other36.limit;
+  __isset = other36.__isset;
+  return *this;
+}
+scan_request& scan_request::operator=(scan_request&& other37) {
+  start_key = std::move(other37.start_key);
+  end_key = std::move(other37.end_key);
+  limit = std::move(other37.limit);
+  __isset = std::move(other37.__isset);
+  return *this;
+}
+void scan_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "scan_request(";
+  out << "start_key=" << to_string(start_key);
+  out << ", " << "end_key=" << to_string(end_key);
+  out << ", " << "limit=" << to_string(limit);
+  out << ")";
+}
+
+
+scan_response::~scan_response() throw() {
+}
+
+
+void scan_response::__set_kvs(const std::vector<kv_pair> & val) {
+  this->kvs = val;
+}
+
+void scan_response::__set_has_more(const bool val) {
+  this->has_more = val;
+}
+
+uint32_t scan_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->kvs.clear();
+            uint32_t _size38;
+            ::apache::thrift::protocol::TType _etype41;
+            xfer += iprot->readListBegin(_etype41, _size38);
+            this->kvs.resize(_size38);
+            uint32_t _i42;
+            for (_i42 = 0; _i42 < _size38; ++_i42)
+            {
+              xfer += this->kvs[_i42].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.kvs = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->has_more);
+          this->__isset.has_more = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t scan_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("scan_response");
+
+  xfer += oprot->writeFieldBegin("kvs", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->kvs.size()));
+    std::vector<kv_pair> ::const_iterator _iter43;
+    for (_iter43 = this->kvs.begin(); _iter43 != this->kvs.end(); ++_iter43)
+    {
+      xfer += (*_iter43).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("has_more", ::apache::thrift::protocol::T_BOOL, 2);
+  xfer += oprot->writeBool(this->has_more);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(scan_response &a, scan_response &b) {
+  using ::std::swap;
+  swap(a.kvs, b.kvs);
+  swap(a.has_more, b.has_more);
+  swap(a.__isset, b.__isset);
+}
+
+scan_response::scan_response(const scan_response& other44) {
+  kvs = other44.kvs;
+  has_more = other44.has_more;
+  __isset = other44.__isset;
+}
+scan_response::scan_response( scan_response&& other45) {
+  kvs = std::move(other45.kvs);
+  has_more = std::move(other45.has_more);
+  __isset = std::move(other45.__isset);
+}
+scan_response& scan_response::operator=(const scan_response& other46) {
+  kvs = other46.kvs;
+  has_more = other46.has_more;
+  __isset = other46.__isset;
+  return *this;
+}
+scan_response& scan_response::operator=(scan_response&& other47) {
+  kvs = std::move(other47.kvs);
+  has_more = std::move(other47.has_more);
+  __isset = std::move(other47.__isset);
+  return *this;
+}
+void scan_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "scan_response(";
+  out << "kvs=" << to_string(kvs);
+  out << ", " << "has_more=" << to_string(has_more);
+  out << ")";
+}
+
 }}} // namespace
@@ -21,6 +21,16 @@ namespace dsn { namespace replication { namespace application {
 
 class kv_pair;
 
+class multi_get_request;
+
+class multi_get_response;
+
+class multi_put_request;
+
+class scan_request;
+
+class scan_response;
+
 typedef struct _kv_pair__isset {
   _kv_pair__isset() : key(false), value(false) {}
   bool key :1;
@@ -76,6 +86,254 @@ inline std::ostream& operator<<(std::ostream& out, const kv_pair& obj)
   return out;
 }
 
+typedef struct _multi_get_request__isset {
+  _multi_get_request__isset() : keys(false) {}
+  bool keys :1;
+} _multi_get_request__isset;
+
+class multi_get_request {
+ public:
+
+  multi_get_request(const multi_get_request&);
+  multi_get_request(multi_get_request&&);
+  multi_get_request& operator=(const multi_get_request&);
+  multi_get_request& operator=(multi_get_request&&);
+  multi_get_request() : keys() {
+  }
+
+  virtual ~multi_get_request() throw();
+  std::vector<std::string> keys;
+
+  _multi_get_request__isset __isset;
+
+  void __set_keys(const std::vector<std::string> & val);
+
+  bool operator == (const multi_get_request & rhs) const
+  {
+    if (!(keys == rhs.keys))
+      return false;
+    return true;
+  }
+  bool operator != (const multi_get_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(multi_get_request &a, multi_get_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const multi_get_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _multi_get_response__isset {
+  _multi_get_response__isset() : kvs(false) {}
+  bool kvs :1;
+} _multi_get_response__isset;
+
+class multi_get_response {
+ public:
+
+  multi_get_response(const multi_get_response&);
+  multi_get_response(multi_get_response&&);
+  multi_get_response& operator=(const multi_get_response&);
+  multi_get_response& operator=(multi_get_response&&);
+  multi_get_response() : kvs() {
+  }
+
+  virtual ~multi_get_response() throw();
+  std::vector<kv_pair> kvs;
+
+  _multi_get_response__isset __isset;
+
+  void __set_kvs(const std::vector<kv_pair> & val);
+
+  bool operator == (const multi_get_response & rhs) const
+  {
+    if (!(kvs == rhs.kvs))
+      return false;
+    return true;
+  }
+  bool operator != (const multi_get_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(multi_get_response &a, multi_get_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const multi_get_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _multi_put_request__isset {
+  _multi_put_request__isset() : kvs(false) {}
+  bool kvs :1;
+} _multi_put_request__isset;
+
+class multi_put_request {
+ public:
+
+  multi_put_request(const multi_put_request&);
+  multi_put_request(multi_put_request&&);
+  multi_put_request& operator=(const multi_put_request&);
+  multi_put_request& operator=(multi_put_request&&);
+  multi_put_request() : kvs() {
+  }
+
+  virtual ~multi_put_request() throw();
+  std::vector<kv_pair> kvs;
+
+  _multi_put_request__isset __isset;
+
+  void __set_kvs(const std::vector<kv_pair> & val);
+
+  bool operator == (const multi_put_request & rhs) const
+  {
+    if (!(kvs == rhs.kvs))
+      return false;
+    return true;
+  }
+  bool operator != (const multi_put_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(multi_put_request &a, multi_put_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const multi_put_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _scan_request__isset {
+  _scan_request__isset() : start_key(false), end_key(false), limit(false) {}
+  bool start_key :1;
+  bool end_key :1;
+  bool limit :1;
+} _scan_request__isset;
+
+class scan_request {
+ public:
+
+  scan_request(const scan_request&);
+  scan_request(scan_request&&);
+  scan_request& operator=(const scan_request&);
+  scan_request& operator=(scan_request&&);
+  scan_request() : start_key(), end_key(), limit(0) {
+  }
+
+  virtual ~scan_request() throw();
+  std::string start_key;
+  std::string end_key;
+  int32_t limit;
+
+  _scan_request__isset __isset;
+
+  void __set_start_key(const std::string& val);
+
+  void __set_end_key(const std::string& val);
+
+  void __set_limit(const int32_t val);
+
+  bool operator == (const scan_request & rhs) const
+  {
+    if (!(start_key == rhs.start_key))
+      return false;
+    if (!(end_key == rhs.end_key))
+      return false;
+    if (!(limit == rhs.limit))
+      return false;
+    return true;
+  }
+  bool operator != (const scan_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(scan_request &a, scan_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const scan_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _scan_response__isset {
+  _scan_response__isset() : kvs(false), has_more(false) {}
+  bool kvs :1;
+  bool has_more :1;
+} _scan_response__isset;
+
+class scan_response {
+ public:
+
+  scan_response(const scan_response&);
+  scan_response(scan_response&&);
+  scan_response& operator=(const scan_response&);
+  scan_response& operator=(scan_response&&);
+  scan_response() : kvs(), has_more(false) {
+  }
+
+  virtual ~scan_response() throw();
+  std::vector<kv_pair> kvs;
+  bool has_more;
+
+  _scan_response__isset __isset;
+
+  void __set_kvs(const std::vector<kv_pair> & val);
+
+  void __set_has_more(const bool val);
+
+  bool operator == (const scan_response & rhs) const
+  {
+    if (!(kvs == rhs.kvs))
+      return false;
+    if (!(has_more == rhs.has_more))
+      return false;
+    return true;
+  }
+  bool operator != (const scan_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(scan_response &a, scan_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const scan_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 }}} // namespace
 
 #endif
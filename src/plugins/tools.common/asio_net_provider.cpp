@@ -44,6 +44,34 @@
 namespace dsn {
     namespace tools{
 
+        // io threads are bound to the given NUMA nodes in a round-robin way, so that the
+        // network buffers they allocate are local to the threads reading them
+        static std::vector<int> get_io_service_worker_numa_nodes()
+        {
+            const char* nodes_str = dsn_config_get_value_string("network", "io_service_worker_numa_nodes", "",
+                "NUMA nodes (e.g., 0,1) the io service threads are bound to in a round-robin way, empty for no binding");
+
+            std::vector<std::string> strs;
+            std::vector<int> nodes;
+            utils::split_args(nodes_str, strs, ',');
+            for (auto& s : strs)
+            {
+                int node = atoi(s.c_str());
+                dassert(node >= 0 && node < numa_topology::instance().node_count(),
+                    "invalid NUMA node %s in [network] io_service_worker_numa_nodes", s.c_str());
+                nodes.push_back(node);
+            }
+            return nodes;
+        }
+
+        static void bind_io_service_worker(const std::vector<int>& nodes, int index)
+        {
+            if (!nodes.empty())
+            {
+                bind_current_thread_to_cpus(numa_topology::instance().node_cpus(nodes[index % nodes.size()]));
+            }
+        }
+
         asio_network_provider::asio_network_provider(rpc_engine* srv, network* inner_provider)
             : connection_oriented_network(srv, inner_provider)
         {
@@ -57,11 +85,13 @@ namespace dsn {
 
             int io_service_worker_count = (int)dsn_config_get_value_uint64("network", "io_service_worker_count", 1,
                 "thread number for io service (timer and boost network)");
+            auto numa_nodes = get_io_service_worker_numa_nodes();
             for (int i = 0; i < io_service_worker_count; i++)
             {
-                _workers.push_back(std::shared_ptr<std::thread>(new std::thread([this, ctx, i]()
+                _workers.push_back(std::shared_ptr<std::thread>(new std::thread([this, ctx, i, numa_nodes]()
                 {
                     task::set_tls_dsn_context(node(), nullptr, ctx.queue);
+                    bind_io_service_worker(numa_nodes, i);
 
                     const char* name = ::dsn::tools::get_service_node_name(node());
                     char buffer[128];
@@ -312,11 +342,13 @@ namespace dsn {
                 }
             }
 
+            auto numa_nodes = get_io_service_worker_numa_nodes();
             for (int i = 0; i < io_service_worker_count; i++)
             {
-                _workers.push_back(std::shared_ptr<std::thread>(new std::thread([this, ctx, i]()
+                _workers.push_back(std::shared_ptr<std::thread>(new std::thread([this, ctx, i, numa_nodes]()
                 {
                     task::set_tls_dsn_context(node(), nullptr, ctx.queue);
+                    bind_io_service_worker(numa_nodes, i);
 
                     const char* name = ::dsn::tools::get_service_node_name(node());
                     char buffer[128];
@@ -0,0 +1,229 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     admission controller based on the queueing delay, in the way of CoDel
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "codel_admission_controller.h"
+# include <dsn/tool-api/rpc_message.h>
+# include <dsn/tool-api/network.h>
+# include <mutex>
+# include <set>
+# include <limits>
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "admission.codel"
+
+namespace dsn
+{
+    namespace tools
+    {
+        // enqueue timestamp of the tasks
+        typedef uint64_extension_helper<codel_admission_controller, task> task_ext_for_codel;
+
+        static std::once_flag s_codel_once;
+        static std::mutex     s_codel_lock;
+        static std::set<codel_admission_controller*> s_codel_controllers;
+
+        codel_admission_controller::codel_admission_controller(task_queue* q, std::vector<std::string>& sargs)
+            : admission_controller(q, sargs)
+        {
+            uint64_t target_ms = sargs.size() > 0 ? strtoull(sargs[0].c_str(), nullptr, 10) : 5;
+            uint64_t interval_ms = sargs.size() > 1 ? strtoull(sargs[1].c_str(), nullptr, 10) : 100;
+            dassert(target_ms > 0 && interval_ms > 0,
+                "invalid codel arguments for %s, expect: target_ms interval_ms [reject|delay]",
+                q->get_name().c_str());
+
+            _target_ns = target_ms * 1000000ULL;
+            _interval_ns = interval_ms * 1000000ULL;
+            _reject = (sargs.size() <= 2 || sargs[2] != "delay");
+
+            _interval_end_ns = dsn_now_ns() + _interval_ns;
+            _interval_min_ns = std::numeric_limits<uint64_t>::max();
+            _last_sojourn_ns = 0;
+            _overloaded = false;
+
+            const char* node_name = get_service_node_name(q->node());
+            _min_sojourn = perf_counter::get_counter(node_name, "engine", (q->get_name() + ".codel.min.sojourn(us)").c_str(),
+                COUNTER_TYPE_NUMBER, "minimum sojourn time (us) of the tasks in the last interval", true);
+            _overloaded_counter = perf_counter::get_counter(node_name, "engine", (q->get_name() + ".codel.overloaded").c_str(),
+                COUNTER_TYPE_NUMBER, "whether the queue is overloaded (1) or not (0)", true);
+            _rejected = perf_counter::get_counter(node_name, "engine", (q->get_name() + ".codel.rejected").c_str(),
+                COUNTER_TYPE_RATE, "how many rpc requests are rejected per second", true);
+            _delayed = perf_counter::get_counter(node_name, "engine", (q->get_name() + ".codel.delayed").c_str(),
+                COUNTER_TYPE_RATE, "how many rpc requests are accepted with receiving delayed per second", true);
+
+            std::call_once(s_codel_once, []()
+            {
+                task_ext_for_codel::register_ext();
+                register_command("codel",
+                    "codel - query or change the arguments of the codel admission controllers",
+                    "codel [target_ms interval_ms [reject|delay]]",
+                    command_handler
+                    );
+            });
+
+            std::lock_guard<std::mutex> l(s_codel_lock);
+            s_codel_controllers.insert(this);
+        }
+
+        codel_admission_controller::~codel_admission_controller()
+        {
+            {
+                std::lock_guard<std::mutex> l(s_codel_lock);
+                s_codel_controllers.erase(this);
+            }
+
+            perf_counter::remove_counter(_min_sojourn->full_name());
+            perf_counter::remove_counter(_overloaded_counter->full_name());
+            perf_counter::remove_counter(_rejected->full_name());
+            perf_counter::remove_counter(_delayed->full_name());
+        }
+
+        bool codel_admission_controller::is_task_accepted(task* task)
+        {
+            task_ext_for_codel::set(task, dsn_now_ns());
+
+            if (task->spec().type != TASK_TYPE_RPC_REQUEST
+                || !_overloaded.load(std::memory_order_relaxed))
+                return true;
+
+            // the queue has drained so there is no standing queue any more; as the state
+            // is otherwise only updated on dequeue, a pool which gets nothing but the
+            // rejected requests would stay overloaded forever
+            if (bound_queue()->count() == 0)
+            {
+                leave_overloaded();
+                return true;
+            }
+
+            uint64_t target = _target_ns.load(std::memory_order_relaxed);
+            uint64_t sojourn = _last_sojourn_ns.load(std::memory_order_relaxed);
+            if (sojourn <= target)
+                return true;
+
+            if (_reject.load(std::memory_order_relaxed))
+            {
+                _rejected->increment();
+                return false;
+            }
+
+            // slow down the clients by the excess queueing delay, at most an interval
+            auto session = static_cast<rpc_request_task*>(task)->get_request()->io_session;
+            if (session != nullptr)
+            {
+                uint64_t delay_ns = std::min(sojourn - target, _interval_ns.load(std::memory_order_relaxed));
+                session->delay_recv(static_cast<int>(delay_ns / 1000000ULL) + 1);
+                _delayed->increment();
+            }
+            return true;
+        }
+
+        void codel_admission_controller::on_task_dequeued(task* task)
+        {
+            uint64_t ts = task_ext_for_codel::get(task);
+            if (ts == 0)
+                return;
+
+            uint64_t now = dsn_now_ns();
+            uint64_t sojourn = now > ts ? now - ts : 0;
+            _last_sojourn_ns.store(sojourn, std::memory_order_relaxed);
+
+            uint64_t min = _interval_min_ns.load(std::memory_order_relaxed);
+            while (sojourn < min && !_interval_min_ns.compare_exchange_weak(min, sojourn, std::memory_order_relaxed))
+            {
+            }
+
+            // one of the workers closes the interval
+            uint64_t end = _interval_end_ns.load(std::memory_order_relaxed);
+            if (now >= end && _interval_end_ns.compare_exchange_strong(end, now + _interval_ns.load(std::memory_order_relaxed)))
+            {
+                min = _interval_min_ns.exchange(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+                bool overloaded = (min > _target_ns.load(std::memory_order_relaxed));
+                _overloaded.store(overloaded, std::memory_order_relaxed);
+
+                _min_sojourn->set(min / 1000);
+                _overloaded_counter->set(overloaded ? 1 : 0);
+            }
+        }
+
+        void codel_admission_controller::leave_overloaded()
+        {
+            _overloaded.store(false, std::memory_order_relaxed);
+            _last_sojourn_ns.store(0, std::memory_order_relaxed);
+            _interval_min_ns.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+            _interval_end_ns.store(dsn_now_ns() + _interval_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _overloaded_counter->set(0);
+        }
+
+        /*static*/ safe_string codel_admission_controller::command_handler(const safe_vector<safe_string>& args)
+        {
+            safe_sstream ss;
+            std::lock_guard<std::mutex> l(s_codel_lock);
+
+            if (args.size() >= 2)
+            {
+                uint64_t target_ms = strtoull(args[0].c_str(), nullptr, 10);
+                uint64_t interval_ms = strtoull(args[1].c_str(), nullptr, 10);
+                if (target_ms == 0 || interval_ms == 0)
+                {
+                    ss << "invalid arguments, expect: codel [target_ms interval_ms [reject|delay]]" << std::endl;
+                    return ss.str();
+                }
+
+                for (auto c : s_codel_controllers)
+                {
+                    c->_target_ns = target_ms * 1000000ULL;
+                    c->_interval_ns = interval_ms * 1000000ULL;
+                    if (args.size() >= 3)
+                        c->_reject = (args[2] != "delay");
+                }
+            }
+            else if (args.size() == 1)
+            {
+                ss << "invalid arguments, expect: codel [target_ms interval_ms [reject|delay]]" << std::endl;
+                return ss.str();
+            }
+
+            for (auto c : s_codel_controllers)
+            {
+                ss << c->bound_queue()->get_name() << ": target = " << c->_target_ns / 1000000ULL
+                    << " ms, interval = " << c->_interval_ns / 1000000ULL
+                    << " ms, mode = " << (c->_reject ? "reject" : "delay")
+                    << ", overloaded = " << (c->_overloaded ? "true" : "false")
+                    << std::endl;
+            }
+            return ss.str();
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     admission controller based on the queueing delay, in the way of CoDel
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+#pragma once
+
+# include <dsn/tool_api.h>
+# include <atomic>
+
+namespace dsn {
+    namespace tools {
+
+        //
+        // the sojourn time (enqueue to dequeue) of the tasks is tracked, and the queue
+        // is seen as overloaded when the minimum sojourn time over an interval is above
+        // the target, i.e., there is a standing queue rather than a burst; when overloaded
+        // and the latest sojourn time is above the target, new rpc requests are either
+        // rejected with ERR_BUSY or accepted with their sessions' receiving delayed,
+        // so that the queueing delay is kept around the target; the overloaded state is
+        // left once the minimum sojourn time is back under the target or the queue is empty.
+        //
+        // [threadpool.XXX]
+        // admission_controller_factory_name = dsn::tools::codel_admission_controller
+        // ; target (ms), interval (ms), and reject|delay
+        // admission_controller_arguments = 5 100 reject
+        //
+        // the arguments can be changed at runtime with the 'codel' command
+        //
+        class codel_admission_controller : public admission_controller
+        {
+        public:
+            codel_admission_controller(task_queue* q, std::vector<std::string>& sargs);
+            ~codel_admission_controller();
+
+            virtual bool is_task_accepted(task* task) override;
+            virtual void on_task_dequeued(task* task) override;
+
+        private:
+            void leave_overloaded();
+            static safe_string command_handler(const safe_vector<safe_string>& args);
+
+        private:
+            std::atomic<uint64_t> _target_ns;
+            std::atomic<uint64_t> _interval_ns;
+            std::atomic<bool>     _reject; // or delay
+
+            std::atomic<uint64_t> _interval_end_ns;
+            std::atomic<uint64_t> _interval_min_ns; // minimum sojourn time in the current interval
+            std::atomic<uint64_t> _last_sojourn_ns;
+            std::atomic<bool>     _overloaded;
+
+            perf_counter_ptr      _min_sojourn;
+            perf_counter_ptr      _overloaded_counter;
+            perf_counter_ptr      _rejected;
+            perf_counter_ptr      _delayed;
+        };
+    }
+}
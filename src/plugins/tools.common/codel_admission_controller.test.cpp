@@ -0,0 +1,120 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for codel admission controller.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "codel_admission_controller.h"
+# include <dsn/tool-api/rpc_message.h>
+# include <gtest/gtest.h>
+# include <thread>
+
+using namespace dsn;
+using namespace dsn::tools;
+
+DEFINE_TASK_CODE(LPC_CODEL_TEST, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+DEFINE_TASK_CODE_RPC(RPC_CODEL_TEST, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+// hosts the controller only, and its length is set by the test
+class codel_test_queue : public task_queue
+{
+public:
+    codel_test_queue(task_worker_pool* pool) : task_queue(pool, 1000, nullptr) {}
+
+    virtual void enqueue(task* task) override {}
+    virtual task* dequeue(/*inout*/int& batch_size) override { batch_size = 0; return nullptr; }
+};
+
+// lpc tasks, each staying in the queue for sojourn_ms
+static void codel_run_tasks(codel_admission_controller& c, int sojourn_ms, int duration_ms)
+{
+    uint64_t end = dsn_now_ms() + duration_ms;
+    while (dsn_now_ms() < end)
+    {
+        task* t = new task_c(LPC_CODEL_TEST, [](void*) {}, nullptr, nullptr);
+        t->add_ref();
+        EXPECT_TRUE(c.is_task_accepted(t));
+        std::this_thread::sleep_for(std::chrono::milliseconds(sojourn_ms));
+        c.on_task_dequeued(t);
+        t->release_ref();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST(tools_common, codel_admission_controller)
+{
+    if (task::get_current_worker() == nullptr)
+        return;
+
+    // sojourn time is measured with real sleeps
+    if (tools::get_current_tool()->name() == "simulator")
+        return;
+
+    codel_test_queue q(task::get_current_worker()->pool());
+    std::vector<std::string> args = { "2", "20", "reject" };
+    codel_admission_controller c(&q, args);
+
+    rpc_handler_info h(RPC_CODEL_TEST);
+    task* r = new rpc_request_task(message_ex::create_request(RPC_CODEL_TEST, 1000, 0), &h, nullptr);
+    r->add_ref();
+
+    ASSERT_TRUE(c.is_task_accepted(r));
+
+    // a standing queue, where every task waits longer than the target for several intervals
+    q.increase_count(10);
+    codel_run_tasks(c, 5, 80);
+    ASSERT_FALSE(c.is_task_accepted(r));
+
+    // the minimum sojourn time is back under the target for an interval
+    codel_run_tasks(c, 0, 80);
+    ASSERT_TRUE(c.is_task_accepted(r));
+
+    // overloaded again, and then the queue drains without any further dequeue
+    codel_run_tasks(c, 5, 80);
+    ASSERT_FALSE(c.is_task_accepted(r));
+    ASSERT_FALSE(c.is_task_accepted(r));
+    q.decrease_count(10);
+    ASSERT_TRUE(c.is_task_accepted(r));
+
+    // the overloaded state is left rather than skipped for an empty queue
+    q.increase_count(1);
+    ASSERT_TRUE(c.is_task_accepted(r));
+    q.decrease_count(1);
+
+    // lpc tasks are never rejected
+    q.increase_count(10);
+    codel_run_tasks(c, 5, 80);
+    ASSERT_FALSE(c.is_task_accepted(r));
+    q.decrease_count(10);
+
+    r->release_ref();
+}
@@ -0,0 +1,108 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     task queue ordering rpc requests by their client deadlines within each priority
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "deadline_task_queue.h"
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "task.queue.deadline"
+
+namespace dsn 
+{
+    namespace tools
+    {
+        /*static*/ uint64_t deadline_task_queue::s_default_slack_ns = 100000000ULL;
+
+        deadline_task_queue::deadline_task_queue(task_worker_pool* pool, int index, task_queue* inner_provider)
+            : task_queue(pool, index, inner_provider), _samples("")
+        {
+            s_default_slack_ns = dsn_config_get_value_uint64("tools.deadline_task_queue", "default_slack_ms", 100,
+                "deadline (ms after enqueue) of the local tasks and the rpc requests without timeout, when ordered with the rpc requests by deadline"
+                ) * 1000000ULL;
+
+            _samples.set_idle_policy(pool_spec().worker_idle_spin_us, pool_spec().worker_idle_yield_us);
+
+            // shared by the queues of the same pool, which are created in index order,
+            // so the first queue registers it and the others get the same one
+            _dropped_late = perf_counter::get_counter(get_service_node_name(node()), "engine",
+                (pool_spec().name + ".dropped.late.requests").c_str(),
+                COUNTER_TYPE_NUMBER, "how many rpc requests are dropped as their deadlines are passed before execution", true);
+        }
+
+        deadline_task_queue::~deadline_task_queue()
+        {
+            // removed once by the first queue, the others still hold their references
+            if (index() == 0)
+                perf_counter::remove_counter(_dropped_late->full_name());
+        }
+
+        void deadline_task_queue::enqueue(task* task)
+        {
+            if (task->spec().type == TASK_TYPE_RPC_REQUEST)
+            {
+                auto rtask = static_cast<rpc_request_task*>(task);
+                int timeout_ms = rtask->get_request()->header->client.timeout_ms;
+                rtask->set_deadline_ns(timeout_ms > 0 ?
+                    dsn_now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ULL :
+                    std::numeric_limits<uint64_t>::max());
+            }
+
+            _samples.enqueue(task, task->spec().priority);
+        }
+
+        // always return 1 or 0 task so far
+        task* deadline_task_queue::dequeue(/*inout*/int& batch_size)
+        {
+            long c = 0;
+            auto t = _samples.dequeue(c, TIME_MS_MAX);
+            dassert(t != nullptr, "dequeue does not return empty tasks");
+
+            // still returned to the worker so that it is released as usual,
+            // which is cheap as the handler is not executed
+            if (t->spec().type == TASK_TYPE_RPC_REQUEST)
+            {
+                auto rtask = static_cast<rpc_request_task*>(t);
+                if (rtask->deadline_ns() <= dsn_now_ns())
+                {
+                    rtask->drop_before_execution();
+                    _dropped_late->increment();
+                }
+            }
+
+            batch_size = 1;
+            return t;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     task queue ordering rpc requests by their client deadlines within each priority
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+#pragma once
+
+# include <dsn/tool_api.h>
+# include <dsn/utility/priority_queue.h>
+# include <limits>
+
+namespace dsn {
+    namespace tools {
+
+        //
+        // within each task priority, rpc requests are ordered by their absolute deadlines,
+        // i.e., the enqueue time plus the client timeout, and the other tasks (as well as
+        // the rpc requests without timeout) are seen as due at their enqueue time plus
+        // a fixed slack, so the order is FIFO when there are no rpc requests, and neither
+        // a steady stream of local tasks nor of requests with deadlines can starve the other;
+        // requests already past their deadlines when dequeued are dropped without running
+        // their handlers, as their clients have already given up
+        //
+        // [tools.deadline_task_queue]
+        // default_slack_ms = 100
+        //
+        class deadline_task_queue : public task_queue
+        {
+        public:
+            deadline_task_queue(task_worker_pool* pool, int index, task_queue* inner_provider);
+            ~deadline_task_queue();
+
+            virtual void     enqueue(task* task) override;
+            virtual task*    dequeue(/*inout*/int& batch_size) override;
+
+        private:
+            struct task_deadline
+            {
+                uint64_t operator()(task* t) const
+                {
+                    if (t->spec().type == TASK_TYPE_RPC_REQUEST)
+                    {
+                        uint64_t deadline = static_cast<rpc_request_task*>(t)->deadline_ns();
+                        if (deadline != std::numeric_limits<uint64_t>::max())
+                            return deadline;
+                    }
+                    return dsn_now_ns() + s_default_slack_ns;
+                }
+            };
+
+            static uint64_t s_default_slack_ns;
+
+            typedef utils::blocking_priority_queue<task*, TASK_PRIORITY_COUNT,
+                utils::deadline_queue<task*, task_deadline>> tqueue;
+            tqueue _samples;
+
+            perf_counter_ptr _dropped_late; // shared by the pool, removed by its first queue
+        };
+    }
+}
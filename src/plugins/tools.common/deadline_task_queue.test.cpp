@@ -0,0 +1,176 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for deadline task queue.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "deadline_task_queue.h"
+# include <dsn/tool-api/rpc_message.h>
+# include <gtest/gtest.h>
+# include <memory>
+# include <thread>
+
+using namespace dsn;
+using namespace dsn::tools;
+
+DEFINE_TASK_CODE(LPC_DEADLINE_TEST, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+DEFINE_TASK_CODE_RPC(RPC_DEADLINE_TEST, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+static task* deadline_test_lpc()
+{
+    task* t = new task_c(LPC_DEADLINE_TEST, [](void*) {}, nullptr, nullptr);
+    t->add_ref();
+    return t;
+}
+
+static task* deadline_test_request(rpc_handler_info& h, int timeout_ms)
+{
+    auto msg = message_ex::create_request(RPC_DEADLINE_TEST, 0, 0);
+    msg->header->client.timeout_ms = timeout_ms;
+    task* t = new rpc_request_task(msg, &h, nullptr);
+    t->add_ref();
+    return t;
+}
+
+static task* deadline_test_dequeue(deadline_task_queue& q)
+{
+    int batch_size = 1;
+    return q.dequeue(batch_size);
+}
+
+TEST(tools_common, deadline_task_queue)
+{
+    if (task::get_current_worker() == nullptr)
+        return;
+
+    // deadlines are compared with real sleeps
+    if (tools::get_current_tool()->name() == "simulator")
+        return;
+
+    deadline_task_queue q(task::get_current_worker()->pool(), 1000, nullptr);
+    rpc_handler_info h(RPC_DEADLINE_TEST);
+
+    // an lpc task enqueued before the request is still executed first
+    task* l0 = deadline_test_lpc();
+    task* r1 = deadline_test_request(h, 150);
+    q.enqueue(l0);
+    q.enqueue(r1);
+
+    // while an lpc task enqueued a bit later does not overtake the request
+    // whose deadline is still ahead
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    task* l1 = deadline_test_lpc();
+    q.enqueue(l1);
+
+    ASSERT_EQ(l0, deadline_test_dequeue(q));
+    ASSERT_EQ(r1, deadline_test_dequeue(q));
+    ASSERT_EQ(l1, deadline_test_dequeue(q));
+
+    // requests without timeout are ordered as lpc tasks rather than after all of them,
+    // and a request with a short timeout goes ahead of both
+    task* r2 = deadline_test_request(h, 0);
+    task* l2 = deadline_test_lpc();
+    task* r3 = deadline_test_request(h, 50);
+    q.enqueue(r2);
+    q.enqueue(l2);
+    q.enqueue(r3);
+
+    ASSERT_EQ(r3, deadline_test_dequeue(q));
+    ASSERT_EQ(r2, deadline_test_dequeue(q));
+    ASSERT_EQ(l2, deadline_test_dequeue(q));
+
+    for (auto t : { l0, l1, l2, r1, r2, r3 })
+        t->release_ref();
+}
+
+static int s_deadline_test_handled = 0;
+
+static void deadline_test_handler(dsn_message_t req, void* param)
+{
+    ++s_deadline_test_handled;
+}
+
+TEST(tools_common, deadline_task_queue_drop_late)
+{
+    if (task::get_current_worker() == nullptr)
+        return;
+
+    if (tools::get_current_tool()->name() == "simulator")
+        return;
+
+    auto pool = task::get_current_worker()->pool();
+    rpc_handler_info h(RPC_DEADLINE_TEST);
+    h.c_handler = deadline_test_handler;
+    h.add_ref(); // held by this test as by the rpc engine, so exec never deletes it
+
+    std::unique_ptr<deadline_task_queue> q1(new deadline_task_queue(pool, 1000, nullptr));
+    std::unique_ptr<deadline_task_queue> q2(new deadline_task_queue(pool, 1001, nullptr));
+
+    // the queues of a pool share one counter
+    auto get_counter = [&]()
+    {
+        return perf_counter::get_counter(get_service_node_name(q1->node()), "engine",
+            (q1->pool_spec().name + ".dropped.late.requests").c_str(), COUNTER_TYPE_NUMBER, "", false);
+    };
+    auto counter = get_counter();
+    ASSERT_NE(nullptr, counter);
+    uint64_t dropped = counter->get_integer_value();
+
+    // a request past its deadline is returned to the worker but its handler is not run
+    for (auto q : { q1.get(), q2.get() })
+    {
+        task* r = deadline_test_request(h, 1);
+        q->enqueue(r);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        ASSERT_EQ(r, deadline_test_dequeue(*q));
+        h.add_ref(); // as for every execution
+        r->exec();
+        r->release_ref();
+    }
+    EXPECT_EQ(0, s_deadline_test_handled);
+    EXPECT_EQ(dropped + 2, counter->get_integer_value());
+
+    // while one in time still is
+    task* r = deadline_test_request(h, 10000);
+    q1->enqueue(r);
+    ASSERT_EQ(r, deadline_test_dequeue(*q1));
+    h.add_ref();
+    r->exec();
+    r->release_ref();
+    EXPECT_EQ(1, s_deadline_test_handled);
+    EXPECT_EQ(dropped + 2, counter->get_integer_value());
+
+    // only the first queue of the pool removes the counter
+    q2.reset();
+    EXPECT_EQ(counter.get(), get_counter().get());
+    EXPECT_EQ(1, h.running_count.load());
+}
@@ -45,6 +45,8 @@
 # include "simple_perf_counter_v2_atomic.h"
 # include "simple_perf_counter_v2_fast.h"
 # include "simple_task_queue.h"
+# include "deadline_task_queue.h"
+# include "codel_admission_controller.h"
 # include "network.sim.h"
 # include "simple_logger.h"
 # include "empty_aio_provider.h"
@@ -76,6 +78,8 @@ namespace dsn {
             register_component_provider<asio_udp_provider>("dsn::tools::asio_udp_provider");
             register_component_provider<sim_network_provider>("dsn::tools::sim_network_provider");
             register_component_provider<simple_task_queue>("dsn::tools::simple_task_queue");
+            register_component_provider<deadline_task_queue>("dsn::tools::deadline_task_queue");
+            register_component_provider<codel_admission_controller>("dsn::tools::codel_admission_controller");
             register_component_provider<simple_timer_service>("dsn::tools::simple_timer_service");
             
             register_message_header_parser<dsn_message_parser>(NET_HDR_DSN, {"RDSN"});
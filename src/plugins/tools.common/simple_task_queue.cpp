@@ -96,19 +96,43 @@ namespace dsn
         simple_task_queue::simple_task_queue(task_worker_pool* pool, int index, task_queue* inner_provider)
             : task_queue(pool, index, inner_provider), _samples("")
         {
+            _samples.set_idle_policy(pool_spec().worker_idle_spin_us, pool_spec().worker_idle_yield_us);
+
+            const char* node_name = get_service_node_name(node());
+            _idle_wakeups = perf_counter::get_counter(node_name, "engine", (get_name() + ".idle.wakeups").c_str(),
+                COUNTER_TYPE_RATE, "how many parked workers are woken up per second", true);
+            _idle_spin_hits = perf_counter::get_counter(node_name, "engine", (get_name() + ".idle.spin.hits").c_str(),
+                COUNTER_TYPE_RATE, "how many tasks per second are got by spinning or yielding workers without parking", true);
+            _idle_park_time = perf_counter::get_counter(node_name, "engine", (get_name() + ".idle.park.time(us)").c_str(),
+                COUNTER_TYPE_RATE, "how long (us) per second the workers are parked", true);
+        }
+
+        simple_task_queue::~simple_task_queue()
+        {
+            perf_counter::remove_counter(_idle_wakeups->full_name());
+            perf_counter::remove_counter(_idle_spin_hits->full_name());
+            perf_counter::remove_counter(_idle_park_time->full_name());
         }
 
         void simple_task_queue::enqueue(task* task)
         {
-            _samples.enqueue(task, task->spec().priority);
+            int woken;
+            _samples.enqueue(task, task->spec().priority, woken);
+            if (woken > 0)
+                _idle_wakeups->add(woken);
         }
 
         // always return 1 or 0 task so far
         task* simple_task_queue::dequeue(/*inout*/int& batch_size)
         {
             long c = 0;
-            auto t = _samples.dequeue(c);
+            utils::idle_wait_result wr;
+            auto t = _samples.dequeue(c, TIME_MS_MAX, &wr);
             dassert(t != nullptr, "dequeue does not return empty tasks");
+            if (wr.spin_hit)
+                _idle_spin_hits->increment();
+            if (wr.parked)
+                _idle_park_time->add(wr.park_ns / 1000);
             batch_size = 1;
             return t;
         }
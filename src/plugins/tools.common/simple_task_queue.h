@@ -45,6 +45,7 @@ namespace dsn {
         {
         public:
             simple_task_queue(task_worker_pool* pool, int index, task_queue* inner_provider);
+            ~simple_task_queue();
 
             virtual void     enqueue(task* task) override;
             virtual task*    dequeue(/*inout*/int& batch_size) override;
@@ -52,6 +53,11 @@ namespace dsn {
         private:
             typedef utils::blocking_priority_queue<task*, TASK_PRIORITY_COUNT> tqueue;
             tqueue _samples;
+
+            // idle worker statistics, see threadpool_spec::worker_idle_spin_us
+            perf_counter_ptr _idle_wakeups;
+            perf_counter_ptr _idle_spin_hits;
+            perf_counter_ptr _idle_park_time;
         };
 
         class simple_timer_service : public timer_service
@@ -38,8 +38,27 @@ struct get_file_size_response
     3: list<i64> size_list;
 }
 
+// checksums of the blocks the client already has, see nfs_opts::delta_copy_enabled
+struct get_block_diff_request
+{
+    1: string source_dir;
+    2: string file_name;
+    3: i32 block_size;
+    4: list<i64> block_checksums;
+}
+
+// blocks (at block_size granularity over file_size) which differ from the
+// client copy and must be fetched with copy requests
+struct get_block_diff_response
+{
+    1: i32 error;
+    2: i64 file_size;
+    3: list<i32> changed_blocks;
+}
+
 service nfs
 {
     copy_response copy(1: copy_request request);
     get_file_size_response get_file_size(1: get_file_size_request request);
+    get_block_diff_response get_block_diff(1: get_block_diff_request request);
 }
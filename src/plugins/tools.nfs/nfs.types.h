@@ -11,5 +11,7 @@ namespace dsn { namespace service {
     GENERATED_TYPE_SERIALIZATION(copy_response, THRIFT)
     GENERATED_TYPE_SERIALIZATION(get_file_size_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(get_file_size_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(get_block_diff_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(get_block_diff_response, THRIFT)
 
 } } 
\ No newline at end of file
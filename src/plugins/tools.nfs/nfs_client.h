@@ -143,6 +143,54 @@ public:
                     );
     }
 
+    // ---------- call RPC_NFS_NFS_GET_BLOCK_DIFF ------------
+    // - synchronous 
+    std::pair< ::dsn::error_code, get_block_diff_response> get_block_diff_sync(
+        const get_block_diff_request& request, 
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none)
+    {
+        return ::dsn::rpc::wait_and_unwrap<get_block_diff_response>(
+            ::dsn::rpc::call(
+                server_addr.unwrap_or(_server),
+                RPC_NFS_GET_BLOCK_DIFF,
+                request,
+                nullptr,
+                empty_callback,
+                timeout,
+                thread_hash,
+                partition_hash
+                )
+            );
+    }
+    
+    // - asynchronous with on-stack get_block_diff_request and get_block_diff_response 
+    template<typename TCallback>
+    ::dsn::task_ptr get_block_diff(
+        const get_block_diff_request& request, 
+        TCallback&& callback,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int thread_hash = 0,
+        uint64_t partition_hash = 0,
+        int reply_thread_hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::call(
+                    server_addr.unwrap_or(_server), 
+                    RPC_NFS_GET_BLOCK_DIFF, 
+                    request, 
+                    this,
+                    std::forward<TCallback>(callback),
+                    timeout,
+                    thread_hash,
+                    partition_hash,
+                    reply_thread_hash
+                    );
+    }
+
 private:
     ::dsn::rpc_address _server;
 };
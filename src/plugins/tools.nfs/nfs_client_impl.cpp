@@ -33,12 +33,147 @@
  *     xxxx-xx-xx, author, fix bug about xxx
  */
 # include "nfs_client_impl.h"
+# include "nfs_throttle.h"
 # include <dsn/tool-api/nfs.h>
 # include <queue>
 
 namespace dsn {
     namespace service {
 
+        copy_window::copy_window(nfs_opts& opts)
+            : _opts(opts)
+        {
+            _in_flight = 0;
+            _window = opts.min_concurrent_remote_copy_requests;
+            _min_us_per_mb = 0;
+            _min_sample_us = 0;
+            _rate_bytes_per_s = 0;
+            _rate_start_us = 0;
+            _rate_bytes = 0;
+            _last_decrease_us = 0;
+        }
+
+        void copy_window::on_complete(bool ok, uint32_t size, uint64_t latency_us, uint64_t now)
+        {
+            --_in_flight;
+
+            double min_window = _opts.min_concurrent_remote_copy_requests;
+            double max_window = _opts.max_concurrent_remote_copy_requests;
+
+            // multiplicative decrease on failure, at most once per round trip
+            if (!ok)
+            {
+                if (now - _last_decrease_us > latency_us)
+                {
+                    _window = std::max(min_window, _window / 2);
+                    _last_decrease_us = now;
+                }
+                return;
+            }
+
+            // delivery rate, sampled over periods of at least 100 ms with requests in flight
+            if (_rate_start_us == 0)
+                _rate_start_us = now - latency_us;
+            _rate_bytes += size;
+            if (now - _rate_start_us >= 100000)
+            {
+                double rate = static_cast<double>(_rate_bytes) * 1000000.0 / static_cast<double>(now - _rate_start_us);
+                _rate_bytes_per_s = (_rate_bytes_per_s == 0 ? rate : 0.8 * _rate_bytes_per_s + 0.2 * rate);
+                _rate_start_us = now;
+                _rate_bytes = 0;
+            }
+            if (_in_flight == 0)
+            {
+                // do not count idle time into the next rate sample
+                _rate_start_us = 0;
+                _rate_bytes = 0;
+            }
+
+            // small blocks are dominated by per-request overhead and tell nothing about queueing
+            if (size < _opts.nfs_copy_min_block_bytes)
+                return;
+
+            double us_per_mb = static_cast<double>(latency_us) * 1048576.0 / size;
+            if (_min_us_per_mb == 0 || us_per_mb <= _min_us_per_mb
+                || now - _min_sample_us > static_cast<uint64_t>(_opts.nfs_copy_min_latency_window_ms) * 1000)
+            {
+                _min_us_per_mb = us_per_mb;
+                _min_sample_us = now;
+            }
+
+            if (us_per_mb > 2 * _min_us_per_mb)
+            {
+                if (now - _last_decrease_us > latency_us)
+                {
+                    _window = std::max(min_window, _window * 0.75);
+                    _last_decrease_us = now;
+                }
+            }
+            else
+            {
+                // additive increase, about one request per round trip
+                _window = std::min(max_window, _window + 1.0 / _window);
+            }
+        }
+
+        uint32_t copy_window::block_bytes() const
+        {
+            if (_rate_bytes_per_s == 0)
+                return _opts.nfs_copy_block_bytes;
+
+            double bytes = _rate_bytes_per_s * _opts.nfs_copy_target_block_ms / 1000.0 / std::max(_window, 1.0);
+            if (bytes >= _opts.nfs_copy_block_bytes)
+                return _opts.nfs_copy_block_bytes;
+
+            // align to 64 KB for large sequential aio on both sides
+            uint32_t sz = static_cast<uint32_t>(bytes) & ~(static_cast<uint32_t>(64 * 1024) - 1);
+            return std::max(sz, _opts.nfs_copy_min_block_bytes);
+        }
+
+        //------------------------------------------------------------------------
+
+        nfs_client_impl::nfs_client_impl(nfs_opts& opts) : _opts(opts)
+        {
+            _concurrent_local_write_count = 0;
+            _write_throttled_since_us = 0;
+            _write_throttle_timer_pending = false;
+
+            nfs_throttle::instance().configure(opts);
+
+            _recent_copy_bytes.init("nfs", "client.copy.bytes", COUNTER_TYPE_RATE,
+                "nfs client copy data size in bytes per second");
+            _recent_copy_latency.init("nfs", "client.copy.latency(us)", COUNTER_TYPE_NUMBER_PERCENTILES,
+                "nfs client copy latency of each block");
+            _recent_transfer_throughput.init("nfs", "client.transfer.throughput(KB/s)", COUNTER_TYPE_NUMBER_PERCENTILES,
+                "nfs client throughput of each remote copy request");
+            _recent_copy_throttled_ms.init("nfs", "client.copy.throttled.time(ms)", COUNTER_TYPE_RATE,
+                "time (ms per second) nfs client copies wait for network tokens");
+            _recent_write_throttled_ms.init("nfs", "client.write.throttled.time(ms)", COUNTER_TYPE_RATE,
+                "time (ms per second) nfs client local writes wait for write tokens");
+            _recent_delta_saved_bytes.init("nfs", "client.delta.saved.bytes", COUNTER_TYPE_RATE,
+                "nfs client bytes per second not transferred as the local blocks are unchanged");
+        }
+
+        nfs_client_impl::~nfs_client_impl()
+        {
+            for (auto& s : _sources)
+            {
+                delete s.second;
+            }
+            _sources.clear();
+        }
+
+        nfs_client_impl::source_context* nfs_client_impl::get_source(::dsn::rpc_address source)
+        {
+            zauto_lock l(_sources_lock);
+            auto it = _sources.find(source);
+            if (it != _sources.end())
+                return it->second;
+
+            auto src = new source_context(_opts);
+            _sources.emplace(source, src);
+            return src;
+        }
 
         void nfs_client_impl::begin_remote_copy(std::shared_ptr<remote_copy_request>& rci, aio_task* nfs_task)
         {
@@ -52,6 +187,8 @@ namespace dsn {
             req->file_size_req.source_dir = rci->source_dir.c_str();
             req->file_size_req.overwrite = rci->overwrite;
             req->nfs_task = nfs_task;
+            req->source = get_source(rci->source);
+            req->start_time_us = dsn_now_us();
             req->is_finished = false;
 
             get_file_size(
@@ -92,102 +229,398 @@ namespace dsn {
                 return;
             }
 
+            std::vector<file_context*> delta_files;
             for (size_t i = 0; i < resp.size_list.size(); i++) // file list
             {
-                file_context *filec;
-                uint64_t size = resp.size_list[i];
-
-                filec = new file_context(ureq, resp.file_list[i], resp.size_list[i]);
-                ureq->file_context_map.insert(std::pair<std::string, file_context*>(
-                    utils::filesystem::path_combine(ureq->file_size_req.dst_dir, resp.file_list[i]), 
-                    filec
-                    ));
+                file_context *filec = new file_context(ureq, resp.file_list[i], resp.size_list[i]);
+                std::string file_path = utils::filesystem::path_combine(ureq->file_size_req.dst_dir, resp.file_list[i]);
+                ureq->file_context_map.insert(std::pair<std::string, file_context*>(file_path, filec));
 
                 //dinfo("this file size is %d, name is %s", size, resp.file_list[i].c_str());
 
-                // new all the copy requests                
+                // the local file is patched in place, so only when overwrite is allowed
+                int64_t local_size;
+                if (_opts.delta_copy_enabled
+                    && ureq->file_size_req.overwrite
+                    && filec->file_size >= _opts.delta_copy_min_file_bytes
+                    && utils::filesystem::file_size(file_path, local_size)
+                    && local_size > 0)
+                {
+                    delta_files.push_back(filec);
+                }
+            }
 
-                uint64_t req_offset = 0;
-                uint32_t req_size;
-                if (size > _opts.nfs_copy_block_bytes)
-                    req_size = _opts.nfs_copy_block_bytes;
-                else
-                    req_size = static_cast<uint32_t>(size);
+            if (delta_files.empty())
+            {
+                start_copy(ureq);
+                return;
+            }
 
-                int idx = 0;
-                for (;;) // send one file with multi-round rpc
-                {
-                    auto req = dsn::ref_ptr<copy_request_ex>(new copy_request_ex(filec, idx++));
-                    filec->copy_requests.push_back(req);
+            // nothing else refers to ureq until all block diffs are done
+            ureq->pending_block_diffs = (int)delta_files.size();
+            for (auto fc : delta_files)
+            {
+                begin_block_diff(fc);
+            }
+        }
 
-                    {
-                        zauto_lock l(_copy_requests_lock);
-                        _copy_requests.push(req);
-                    }
+        void nfs_client_impl::begin_block_diff(file_context* fc)
+        {
+            auto ureq = fc->user_req;
+            std::string file_path = utils::filesystem::path_combine(ureq->file_size_req.dst_dir, fc->file_name);
+
+            // keep the checksum list small for large files
+            uint32_t block_bytes = _opts.delta_copy_block_bytes;
+            while (fc->file_size / block_bytes > max_delta_copy_blocks)
+                block_bytes *= 2;
+
+            // bytes beyond the remote file size are never useful
+            int64_t local_size;
+            if (!utils::filesystem::file_size(file_path, local_size)
+                || (local_size > (int64_t)fc->file_size && !utils::filesystem::resize_file(file_path, fc->file_size)))
+            {
+                dwarn("nfs: prepare local file %s for delta copy failed, fall back to full copy", file_path.c_str());
+                end_block_diff(ERR_FILE_OPERATION_FAILED, get_block_diff_response(), fc, block_bytes);
+                return;
+            }
 
-                    req->copy_req.source = ureq->file_size_req.source;
-                    req->copy_req.file_name = resp.file_list[i];
-                    req->copy_req.offset = req_offset;
-                    req->copy_req.size = req_size;
-                    req->copy_req.dst_dir = ureq->file_size_req.dst_dir;
-                    req->copy_req.source_dir = ureq->file_size_req.source_dir;
-                    req->copy_req.overwrite = ureq->file_size_req.overwrite;
-                    req->copy_req.is_last = (size <= req_size);
-
-                    req_offset += req_size;
-                    size -= req_size;
-                    if (size <= 0)
+            compute_block_checksums(
+                file_path,
+                std::min((uint64_t)local_size, fc->file_size),
+                block_bytes,
+                _opts.nfs_copy_block_bytes,
+                this,
+                [this, fc, block_bytes, file_path](error_code err, std::vector<int64_t>&& checksums)
+                {
+                    if (err != ERR_OK)
                     {
-                        dassert(size == 0, "last request must read exactly the remaing size of the file");
-                        break;
+                        dwarn("nfs: compute block checksums of %s failed, err = %s, fall back to full copy",
+                            file_path.c_str(), err.to_string());
+                        end_block_diff(err, get_block_diff_response(), fc, block_bytes);
+                        return;
                     }
 
-                    if (size > _opts.nfs_copy_block_bytes)
-                        req_size = _opts.nfs_copy_block_bytes;
-                    else
-                        req_size = static_cast<uint32_t>(size);
+                    auto ureq = fc->user_req;
+                    get_block_diff_request req;
+                    req.source_dir = ureq->file_size_req.source_dir;
+                    req.file_name = fc->file_name;
+                    req.block_size = (int32_t)block_bytes;
+                    req.block_checksums = std::move(checksums);
+
+                    get_block_diff(
+                        req,
+                        [this, fc, block_bytes](error_code err, get_block_diff_response&& resp)
+                        {
+                            end_block_diff(err, std::move(resp), fc, block_bytes);
+                        },
+                        std::chrono::milliseconds(0),
+                        0,
+                        0,
+                        0,
+                        ureq->file_size_req.source
+                        );
+                }
+                );
+        }
+
+        void nfs_client_impl::end_block_diff(
+            ::dsn::error_code err,
+            get_block_diff_response&& resp,
+            file_context* fc,
+            uint32_t block_bytes)
+        {
+            if (err == ERR_OK)
+            {
+                err = resp.error;
+            }
+
+            // any failure here only costs bandwidth, the file is then copied in full
+            if (err == ERR_OK && (uint64_t)resp.file_size == fc->file_size)
+            {
+                fc->is_delta = true;
+                fc->delta_block_bytes = block_bytes;
+                fc->changed_blocks = std::move(resp.changed_blocks);
+            }
+            else
+            {
+                dwarn("nfs: get block diff of %s from %s failed, err = %s, fall back to full copy",
+                    fc->file_name.c_str(),
+                    fc->user_req->file_size_req.source.to_string(),
+                    err.to_string()
+                    );
+            }
+
+            if (--fc->user_req->pending_block_diffs == 0)
+            {
+                start_copy(fc->user_req);
+            }
+        }
+
+        void nfs_client_impl::start_copy(user_request* ureq)
+        {
+            auto src = ureq->source;
+            uint32_t block_bytes;
+            {
+                zauto_lock l(src->lock);
+                block_bytes = src->window.block_bytes();
+            }
+
+            std::vector< ::dsn::ref_ptr<copy_request_ex> > reqs;
+            uint64_t saved_bytes = 0;
+            for (auto& f : ureq->file_context_map)
+            {
+                file_context* fc = f.second;
+                if (!fc->is_delta)
+                {
+                    add_copy_requests(fc, 0, fc->file_size, block_bytes, reqs);
+                    continue;
+                }
+
+                // merge adjacent changed blocks into ranges to fetch
+                uint64_t copied = 0;
+                size_t i = 0;
+                while (i < fc->changed_blocks.size())
+                {
+                    size_t j = i + 1;
+                    while (j < fc->changed_blocks.size() && fc->changed_blocks[j] == fc->changed_blocks[j - 1] + 1)
+                        j++;
+
+                    uint64_t begin = (uint64_t)fc->changed_blocks[i] * fc->delta_block_bytes;
+                    uint64_t end = std::min((uint64_t)(fc->changed_blocks[j - 1] + 1) * fc->delta_block_bytes, fc->file_size);
+                    add_copy_requests(fc, begin, end - begin, block_bytes, reqs);
+                    copied += end - begin;
+                    i = j;
+                }
+                saved_bytes += fc->file_size - copied;
+
+                if (!fc->copy_requests.empty())
+                {
+                    fc->copy_requests.back()->copy_req.is_last = true;
+                }
+                else
+                {
+                    // already identical to the remote file
+                    ++ureq->finished_files;
+                }
+            }
+
+            if (saved_bytes > 0)
+            {
+                _recent_delta_saved_bytes.add(saved_bytes);
+            }
+
+            if (ureq->finished_files == (int)ureq->file_context_map.size())
+            {
+                handle_completion(ureq, ERR_OK);
+                return;
+            }
+
+            {
+                zauto_lock l(src->lock);
+                for (auto& req : reqs)
+                {
+                    src->copy_requests.push(req);
                 }
             }
 
-            continue_copy(0);
+            continue_copy(src);
         }
 
+        void nfs_client_impl::add_copy_requests(
+            file_context* fc,
+            uint64_t offset,
+            uint64_t size,
+            uint32_t block_bytes,
+            /*out*/ std::vector< ::dsn::ref_ptr<copy_request_ex> >& reqs)
+        {
+            auto ureq = fc->user_req;
+            uint64_t end = offset + size;
+            for (;;) // send one range with multi-round rpc, at least one request even for empty files
+            {
+                uint32_t req_size = static_cast<uint32_t>(std::min((uint64_t)block_bytes, end - offset));
+                auto req = dsn::ref_ptr<copy_request_ex>(new copy_request_ex(fc, ureq->source, (int)fc->copy_requests.size()));
+                fc->copy_requests.push_back(req);
+                reqs.push_back(req);
+
+                req->copy_req.source = ureq->file_size_req.source;
+                req->copy_req.file_name = fc->file_name;
+                req->copy_req.offset = offset;
+                req->copy_req.size = req_size;
+                req->copy_req.dst_dir = ureq->file_size_req.dst_dir;
+                req->copy_req.source_dir = ureq->file_size_req.source_dir;
+                req->copy_req.overwrite = ureq->file_size_req.overwrite;
+                req->copy_req.is_last = (offset + req_size == fc->file_size);
+
+                offset += req_size;
+                if (offset >= end)
+                {
+                    dassert(offset == end, "last request must read exactly the remaing size of the range");
+                    break;
+                }
+            }
+        }
 
-        void nfs_client_impl::continue_copy(int done_count)
+        struct block_checksums_context
         {
-            if (done_count > 0)
+            dsn_handle_t  file;
+            uint64_t      size;
+            uint32_t      block_size;
+            uint32_t      chunk_bytes;
+            uint64_t      offset;
+            std::unique_ptr<char[]> buffer;
+            std::vector<int64_t>    checksums;
+            clientlet     *owner;
+            block_checksums_handler callback;
+
+            // the read may be cancelled with the owner, then callback is never invoked
+            ~block_checksums_context()
             {
-                _concurrent_copy_request_count -= done_count;
+                if (file != nullptr)
+                    dsn_file_close(file);
             }
+        };
 
-            if (++_concurrent_copy_request_count > _opts.max_concurrent_remote_copy_requests)
+        static void block_checksums_complete(std::shared_ptr<block_checksums_context>& ctx, error_code err)
+        {
+            if (ctx->file != nullptr)
             {
-                --_concurrent_copy_request_count;
+                dsn_file_close(ctx->file);
+                ctx->file = nullptr;
+            }
+
+            auto callback = std::move(ctx->callback);
+            callback(err, std::move(ctx->checksums));
+        }
+
+        static void block_checksums_read_next(std::shared_ptr<block_checksums_context> ctx)
+        {
+            if (ctx->offset >= ctx->size)
+            {
+                block_checksums_complete(ctx, ERR_OK);
                 return;
             }
 
-            dsn::ref_ptr<copy_request_ex> req = nullptr;
+            uint32_t len = static_cast<uint32_t>(std::min((uint64_t)ctx->chunk_bytes, ctx->size - ctx->offset));
+            file::read(
+                ctx->file,
+                ctx->buffer.get(),
+                static_cast<int>(len),
+                ctx->offset,
+                LPC_NFS_BLOCK_CHECKSUM,
+                ctx->owner,
+                [ctx, len](error_code err, size_t sz) mutable
+                {
+                    if (err == ERR_OK && sz != len)
+                        err = ERR_FILE_OPERATION_FAILED;
+                    if (err != ERR_OK)
+                    {
+                        block_checksums_complete(ctx, err);
+                        return;
+                    }
+
+                    for (uint32_t pos = 0; pos < len; pos += ctx->block_size)
+                    {
+                        uint32_t sz2 = std::min(ctx->block_size, len - pos);
+                        ctx->checksums.push_back(static_cast<int64_t>(dsn_crc64_compute(ctx->buffer.get() + pos, sz2, 0)));
+                    }
+                    ctx->offset += len;
+                    block_checksums_read_next(std::move(ctx));
+                }
+                );
+        }
+
+        void compute_block_checksums(
+            const std::string& path,
+            uint64_t size,
+            uint32_t block_size,
+            uint32_t chunk_bytes,
+            clientlet* owner,
+            block_checksums_handler&& callback
+            )
+        {
+            dsn_handle_t hfile = dsn_file_open(path.c_str(), O_RDONLY | O_BINARY, 0);
+            if (hfile == nullptr)
+            {
+                callback(ERR_FILE_OPERATION_FAILED, std::vector<int64_t>());
+                return;
+            }
+
+            auto ctx = std::make_shared<block_checksums_context>();
+            ctx->file = hfile;
+            ctx->size = size;
+            ctx->block_size = block_size;
+            ctx->chunk_bytes = std::max(block_size, chunk_bytes / block_size * block_size);
+            ctx->offset = 0;
+            ctx->owner = owner;
+            ctx->callback = std::move(callback);
+            ctx->checksums.reserve((size + block_size - 1) / block_size);
+            if (size > 0)
+                ctx->buffer.reset(new char[ctx->chunk_bytes]);
+
+            block_checksums_read_next(std::move(ctx));
+        }
+
+        void nfs_client_impl::continue_copy(source_context* src)
+        {
             while (true)
             {
+                dsn::ref_ptr<copy_request_ex> req;
                 {
-                    zauto_lock l(_copy_requests_lock);
-                    if (!_copy_requests.empty())
+                    zauto_lock l(src->lock);
+
+                    // cancelled copies leave without consuming any tokens
+                    while (!src->copy_requests.empty() && !src->copy_requests.front()->valid())
+                        src->copy_requests.pop();
+
+                    if (src->copy_requests.empty() || !src->window.can_send())
+                        return;
+
+                    // wait for network tokens, retried by a timer instead of failing the copy
+                    int wait_ms = nfs_throttle::instance().copy_bytes().consume(src->copy_requests.front()->copy_req.size);
+                    if (wait_ms > 0)
                     {
-                        req = _copy_requests.front();
-                        _copy_requests.pop();
+                        if (src->throttled_since_us == 0)
+                            src->throttled_since_us = dsn_now_us();
+
+                        if (!src->throttle_timer_pending)
+                        {
+                            src->throttle_timer_pending = true;
+                            tasking::enqueue(
+                                LPC_NFS_THROTTLE_DELAY,
+                                this,
+                                [this, src]()
+                                {
+                                    {
+                                        zauto_lock l(src->lock);
+                                        src->throttle_timer_pending = false;
+                                    }
+                                    continue_copy(src);
+                                },
+                                0,
+                                std::chrono::milliseconds(wait_ms)
+                                );
+                        }
+                        return;
                     }
-                    else
+
+                    if (src->throttled_since_us != 0)
                     {
-                        --_concurrent_copy_request_count;
-                        break;
+                        _recent_copy_throttled_ms.add((dsn_now_us() - src->throttled_since_us) / 1000);
+                        src->throttled_since_us = 0;
                     }
+
+                    req = src->copy_requests.front();
+                    src->copy_requests.pop();
+                    src->window.on_send();
                 }
 
+                bool sent = false;
                 {
                     zauto_lock l(req->lock);
                     if (req->is_valid)
                     {
                         req->add_ref();
+                        req->send_time_us = dsn_now_us();
                         req->remote_copy_task = copy(
                             req->copy_req,
                             [=](error_code err, copy_response&& resp)
@@ -199,14 +632,15 @@ namespace dsn {
                             0,
                             0,
                             req->file_ctx->user_req->file_size_req.source);
-
-                        if (++_concurrent_copy_request_count > _opts.max_concurrent_remote_copy_requests)
-                        {
-                            --_concurrent_copy_request_count;
-                            break;
-                        }
+                        sent = true;
                     }
                 }
+
+                if (!sent)
+                {
+                    zauto_lock l(src->lock);
+                    src->window.on_cancel();
+                }
             }
         }
 
@@ -221,18 +655,28 @@ namespace dsn {
             reqc = (copy_request_ex*)context;
             reqc->release_ref();
 
-            continue_copy(1);
-            
             if (err == ERR_OK)
             {
                 err = resp.error;
             }
 
+            auto src = reqc->source;
+            uint64_t latency_us = dsn_now_us() - reqc->send_time_us;
+            {
+                zauto_lock l(src->lock);
+                src->window.on_complete(err == ERR_OK, reqc->copy_req.size, latency_us);
+            }
+            _recent_copy_latency.set(latency_us);
+
+            continue_copy(src);
+
             if (err != ::dsn::ERR_OK)
             {
                 handle_completion(reqc->file_ctx->user_req, err);
                 return;
             }
+
+            _recent_copy_bytes.add(reqc->copy_req.size);
             
             reqc->response = resp;
             reqc->response.error.end_tracking(); // always ERR_OK
@@ -280,12 +724,40 @@ namespace dsn {
 
             // get write
             dsn::ref_ptr<copy_request_ex> reqc;
+            int wait_ms = 0;
             while (true)
             {
                 {
                     zauto_lock l(_local_writes_lock);
+
+                    // cancelled writes leave without consuming any tokens
+                    while (!_local_writes.empty() && !_local_writes.front()->valid())
+                        _local_writes.pop();
+
                     if (!_local_writes.empty())
                     {
+                        // wait for write tokens, retried by a timer instead of failing the copy
+                        wait_ms = nfs_throttle::instance().consume_write(_local_writes.front()->response.size);
+                        if (wait_ms > 0)
+                        {
+                            if (_write_throttled_since_us == 0)
+                                _write_throttled_since_us = dsn_now_us();
+
+                            if (_write_throttle_timer_pending)
+                                wait_ms = 0;
+                            else
+                                _write_throttle_timer_pending = true;
+
+                            reqc = nullptr;
+                            break;
+                        }
+
+                        if (_write_throttled_since_us != 0)
+                        {
+                            _recent_write_throttled_ms.add((dsn_now_us() - _write_throttled_since_us) / 1000);
+                            _write_throttled_since_us = 0;
+                        }
+
                         reqc = _local_writes.front();
                         _local_writes.pop();
                     }
@@ -306,6 +778,24 @@ namespace dsn {
             if (nullptr == reqc)
             {
                 --_concurrent_local_write_count;
+
+                if (wait_ms > 0)
+                {
+                    tasking::enqueue(
+                        LPC_NFS_THROTTLE_DELAY,
+                        this,
+                        [this]()
+                        {
+                            {
+                                zauto_lock l(_local_writes_lock);
+                                _write_throttle_timer_pending = false;
+                            }
+                            continue_write();
+                        },
+                        0,
+                        std::chrono::milliseconds(wait_ms)
+                        );
+                }
                 return;
             }   
 
@@ -400,6 +890,7 @@ namespace dsn {
                 req->is_finished = true;
             }
 
+            auto src = req->source;
             size_t total_size = 0;
             for (auto& f : req->file_context_map)
             {
@@ -424,7 +915,10 @@ namespace dsn {
                         {
                             if (ctask->cancel(true))
                             {
-                                _concurrent_copy_request_count--;
+                                {
+                                    zauto_lock l(src->lock);
+                                    src->window.on_cancel();
+                                }
                                 rc->release_ref();
                             }
                         }
@@ -458,6 +952,32 @@ namespace dsn {
                 delete f.second;
             }
 
+            if (err == ERR_OK)
+            {
+                uint64_t elapsed_us = dsn_now_us() - req->start_time_us;
+                uint64_t kbps = elapsed_us == 0 ? 0 : total_size * 1000000 / 1024 / elapsed_us;
+                _recent_transfer_throughput.set(kbps);
+
+                int window;
+                uint32_t block_bytes;
+                {
+                    zauto_lock l(src->lock);
+                    window = src->window.window();
+                    block_bytes = src->window.block_bytes();
+                }
+
+                ddebug("nfs: copy from %s:%s done, size = %" PRIu64 ", elapsed = %" PRIu64 " ms, "
+                    "throughput = %" PRIu64 " KB/s, window = %d, next block size = %u",
+                    req->file_size_req.source.to_string(),
+                    req->file_size_req.source_dir.c_str(),
+                    (uint64_t)total_size,
+                    elapsed_us / 1000,
+                    kbps,
+                    window,
+                    block_bytes
+                    );
+            }
+
             req->file_context_map.clear();
             req->nfs_task->enqueue(err, err == ERR_OK ? total_size : 0);
 
@@ -466,7 +986,7 @@ namespace dsn {
             // clear out all canceled requests
             if (err != ERR_OK)
             {
-                continue_copy(0);
+                continue_copy(src);
                 continue_write();
             }
         }
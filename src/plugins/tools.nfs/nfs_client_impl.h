@@ -36,15 +36,35 @@
 # include "nfs_client.h"
 # include <queue>
 # include <dsn/tool-api/nfs.h>
+# include <dsn/cpp/perf_counter_.h>
 
 namespace dsn {
     namespace service {
 
+        // bounds of the block size and block count in delta copy, enforced on both sides
+        // so that a peer can not make the server checksum a file in tiny blocks
+        const uint32_t min_delta_copy_block_bytes = 4 * 1024;
+        const uint64_t max_delta_copy_blocks = 64 * 1024;
+
         struct nfs_opts
         {
             uint32_t nfs_copy_block_bytes;
+            uint32_t nfs_copy_min_block_bytes;
+            int nfs_copy_target_block_ms;
+            int nfs_copy_min_latency_window_ms;
             int max_concurrent_remote_copy_requests;
+            int min_concurrent_remote_copy_requests;
             int max_concurrent_local_writes;
+            int max_pooled_copy_blocks_on_server;
+            int max_file_handles_on_server;
+
+            uint64_t max_copy_rate_megabytes;
+            uint64_t max_write_rate_megabytes;
+            uint64_t max_write_iops;
+
+            bool delta_copy_enabled;
+            uint32_t delta_copy_block_bytes;
+            uint64_t delta_copy_min_file_bytes;
 
             int file_close_expire_time_ms;
             int file_close_timer_interval_ms_on_server;
@@ -54,8 +74,16 @@ namespace dsn {
             {
                 nfs_copy_block_bytes = (uint32_t)dsn_config_get_value_uint64("nfs", "nfs_copy_block_bytes", 
                     4*1024*1024, "maximum block size (bytes) for each network copy");
+                nfs_copy_min_block_bytes = (uint32_t)dsn_config_get_value_uint64("nfs", "nfs_copy_min_block_bytes",
+                    256*1024, "minimum block size (bytes) for each network copy when the block size is adapted to the link");
+                nfs_copy_target_block_ms = (int)dsn_config_get_value_uint64("nfs", "nfs_copy_target_block_ms",
+                    100, "expected transfer time (ms) for each block, used to adapt the block size to the measured bandwidth");
+                nfs_copy_min_latency_window_ms = (int)dsn_config_get_value_uint64("nfs", "nfs_copy_min_latency_window_ms",
+                    10000, "time window (ms) of the minimum per-byte block latency, which is the base for detecting queueing delay");
                 max_concurrent_remote_copy_requests = (int)dsn_config_get_value_uint64("nfs", "max_concurrent_remote_copy_requests", 
                     50, "maximum concurrent remote copy to the same server on nfs client");
+                min_concurrent_remote_copy_requests = (int)dsn_config_get_value_uint64("nfs", "min_concurrent_remote_copy_requests",
+                    2, "minimum (and initial) concurrent remote copy to the same server on nfs client");
                 max_concurrent_local_writes = (int)dsn_config_get_value_uint64("nfs", "max_concurrent_local_writes", 
                     5, "maximum local file writes on nfs client");
                 file_close_expire_time_ms = (int)dsn_config_get_value_uint64("nfs", "file_close_expire_time_ms", 
@@ -64,36 +92,151 @@ namespace dsn {
                     30 * 1000, "time interval for checking whether cached file handles need to be closed");
                 max_file_copy_request_count_per_file = (int)dsn_config_get_value_uint64("nfs", "max_file_copy_request_count_per_file", 
                     10, "maximum concurrent remote copy requests for the same file on nfs client"); // limit each file copy speed
+                max_pooled_copy_blocks_on_server = (int)dsn_config_get_value_uint64("nfs", "max_pooled_copy_blocks_on_server",
+                    16, "maximum idle copy block buffers kept for reuse on nfs server");
+                max_file_handles_on_server = (int)dsn_config_get_value_uint64("nfs", "max_file_handles_on_server",
+                    1024, "maximum cached file handles on nfs server, handles in use by reads are never closed");
+                max_copy_rate_megabytes = dsn_config_get_value_uint64("nfs", "max_copy_rate_megabytes",
+                    0, "maximum network copy rate (MB/s) of this node on nfs client, 0 for unlimited");
+                max_write_rate_megabytes = dsn_config_get_value_uint64("nfs", "max_write_rate_megabytes",
+                    0, "maximum local write rate (MB/s) of this node on nfs client, 0 for unlimited");
+                max_write_iops = dsn_config_get_value_uint64("nfs", "max_write_iops",
+                    0, "maximum local write operations per second of this node on nfs client, 0 for unlimited");
+                delta_copy_enabled = dsn_config_get_value_bool("nfs", "delta_copy_enabled",
+                    false, "whether to fetch only the changed blocks when the destination file already exists and overwrite is set");
+                delta_copy_block_bytes = (uint32_t)dsn_config_get_value_uint64("nfs", "delta_copy_block_bytes",
+                    64*1024, "block size (bytes) for comparing the local and remote files in delta copy");
+                delta_copy_min_file_bytes = dsn_config_get_value_uint64("nfs", "delta_copy_min_file_bytes",
+                    1024*1024, "minimum size (bytes) of the remote file for using delta copy");
+
+                if (delta_copy_block_bytes < min_delta_copy_block_bytes)
+                    delta_copy_block_bytes = min_delta_copy_block_bytes;
+                if (nfs_copy_min_block_bytes > nfs_copy_block_bytes)
+                    nfs_copy_min_block_bytes = nfs_copy_block_bytes;
+                if (min_concurrent_remote_copy_requests < 1)
+                    min_concurrent_remote_copy_requests = 1;
+                if (min_concurrent_remote_copy_requests > max_concurrent_remote_copy_requests)
+                    min_concurrent_remote_copy_requests = max_concurrent_remote_copy_requests;
             }
         };
 
+
+        typedef std::function<void(error_code, std::vector<int64_t>&&)> block_checksums_handler;
+
+        //
+        // crc64 of each block_size block in the first size bytes of the file, computed with
+        // sequential aio reads of about chunk_bytes (whole blocks) each, so that a large
+        // file occupies a worker for checksumming one chunk at a time rather than for
+        // reading the whole file synchronously; callback is invoked once with the result
+        //
+        void compute_block_checksums(
+            const std::string& path,
+            uint64_t size,
+            uint32_t block_size,
+            uint32_t chunk_bytes,
+            clientlet* owner,
+            block_checksums_handler&& callback
+            );
+
+        //
+        // per-source congestion control for remote copy, which adapts both the
+        // number of in-flight copy requests and the block size of new copies to
+        // the measured link, using AIMD driven by block latency and errors:
+        // - the window grows by one request per round trip when the per-byte
+        //   latency of a block stays close to the minimum seen in the last
+        //   nfs_copy_min_latency_window_ms (like min_rtt in BBR, the minimum
+        //   expires so that it follows route or load changes on the server),
+        // - it shrinks by 1/4 when queueing delay doubles the per-byte latency,
+        //   and by 1/2 on copy failures, at most once per round trip,
+        // - block size is chosen so that each block takes about
+        //   nfs_copy_target_block_ms at the per-request share of the delivery rate.
+        //
+        class copy_window
+        {
+        public:
+            copy_window(nfs_opts& opts);
+
+            // whether one more copy request may be sent now
+            bool can_send() const { return _in_flight < static_cast<int>(_window); }
+
+            void on_send() { ++_in_flight; }
+
+            void on_cancel() { --_in_flight; }
+
+            void on_complete(bool ok, uint32_t size, uint64_t latency_us) { on_complete(ok, size, latency_us, dsn_now_us()); }
+
+            void on_complete(bool ok, uint32_t size, uint64_t latency_us, uint64_t now_us);
+
+            uint32_t block_bytes() const;
+
+            int window() const { return static_cast<int>(_window); }
+
+            int in_flight() const { return _in_flight; }
+
+        private:
+            nfs_opts &_opts;
+            int      _in_flight;
+            double   _window;
+            double   _min_us_per_mb;    // minimum per-MB latency of a single block in the window
+            uint64_t _min_sample_us;    // when _min_us_per_mb is sampled
+            double   _rate_bytes_per_s; // smoothed delivery rate
+            uint64_t _rate_start_us;
+            uint64_t _rate_bytes;
+            uint64_t _last_decrease_us;
+        };
+
         class nfs_client_impl
             : public ::dsn::service::nfs_client
         {
         public:
             struct user_request;
             struct file_context;
+            struct source_context;
             struct copy_request_ex : public ::dsn::ref_counter
             {
                 file_context *file_ctx;
+                source_context *source;
                 int           index;
                 copy_request  copy_req;                             
                 copy_response response;
                 ::dsn::task_ptr remote_copy_task;
                 ::dsn::task_ptr local_write_task;
+                uint64_t      send_time_us;
                 bool          is_ready_for_write;
                 bool          is_valid;
                 zlock         lock;
 
-                copy_request_ex(file_context* file, int idx)
+                copy_request_ex(file_context* file, source_context* src, int idx)
                 {
                     file_ctx = file;
+                    source = src;
                     index = idx;
                     remote_copy_task = nullptr;
                     local_write_task = nullptr;
+                    send_time_us = 0;
                     is_ready_for_write = false;
                     is_valid = true;
                 }
+
+                bool valid()
+                {
+                    zauto_lock l(lock);
+                    return is_valid;
+                }
+            };
+
+            // copy requests and flow control state for the same remote server
+            struct source_context
+            {
+                zlock        lock;
+                copy_window  window;
+                std::queue < ::dsn::ref_ptr<copy_request_ex> > copy_requests;
+                uint64_t     throttled_since_us; // 0 when not throttled
+                bool         throttle_timer_pending;
+
+                source_context(nfs_opts& opts)
+                    : window(opts), throttled_since_us(0), throttle_timer_pending(false)
+                {}
             };
 
             struct file_context
@@ -108,6 +251,11 @@ namespace dsn {
                 int         finished_segments;
                 std::vector< ::dsn::ref_ptr<copy_request_ex> > copy_requests;
 
+                // delta copy: only the changed blocks are fetched when is_delta is set
+                bool        is_delta;
+                uint32_t    delta_block_bytes;
+                std::vector<int32_t> changed_blocks;
+
                 file_context(user_request* req, const std::string& file_nm, uint64_t sz)
                 {
                     user_req = req;
@@ -117,6 +265,9 @@ namespace dsn {
 
                     current_write_index = -1;
                     finished_segments = 0;
+
+                    is_delta = false;
+                    delta_block_bytes = 0;
                 }
             };
 
@@ -126,7 +277,10 @@ namespace dsn {
 
                 get_file_size_request    file_size_req;
                 ::dsn::ref_ptr<aio_task> nfs_task;
+                source_context           *source;
+                uint64_t                 start_time_us;
                 std::atomic<int>         finished_files;
+                std::atomic<int>         pending_block_diffs;
                 bool                     is_finished;
 
                 std::unordered_map<std::string, file_context*> file_context_map; // map file name and file info
@@ -134,17 +288,14 @@ namespace dsn {
                 user_request()
                 {
                     finished_files = 0;
+                    pending_block_diffs = 0;
                 }
             };
                         
         public:
-            nfs_client_impl(nfs_opts& opts) : _opts(opts)
-            {
-                _concurrent_copy_request_count = 0;
-                _concurrent_local_write_count = 0;
-            }
+            nfs_client_impl(nfs_opts& opts);
 
-            virtual ~nfs_client_impl() {}
+            virtual ~nfs_client_impl();
 
             void begin_remote_copy(std::shared_ptr<remote_copy_request>& rci, aio_task* nfs_task); // copy file request entry
 
@@ -161,7 +312,27 @@ namespace dsn {
                 const ::dsn::service::get_file_size_response& resp,
                 void* context); // rewrite end_get_file_size function
 
-            void continue_copy(int done_count);
+            void begin_block_diff(file_context* fc);
+
+            void end_block_diff(
+                ::dsn::error_code err,
+                get_block_diff_response&& resp,
+                file_context* fc,
+                uint32_t block_bytes);
+
+            // create copy requests for all files of the user request and start copying
+            void start_copy(user_request* ureq);
+
+            void add_copy_requests(
+                file_context* fc,
+                uint64_t offset,
+                uint64_t size,
+                uint32_t block_bytes,
+                /*out*/ std::vector< ::dsn::ref_ptr<copy_request_ex> >& reqs);
+
+            source_context* get_source(::dsn::rpc_address source);
+
+            void continue_copy(source_context* src);
 
             void write_copy(::dsn::ref_ptr<copy_request_ex> reqc);
 
@@ -172,14 +343,22 @@ namespace dsn {
         private:
             nfs_opts         &_opts;
 
-            std::atomic<int> _concurrent_copy_request_count; // record concurrent request count, need be limitted above max_concurrent_remote_copy_requests
             std::atomic<int> _concurrent_local_write_count; // 
 
-            zlock                            _copy_requests_lock;
-            std::queue < ::dsn::ref_ptr<copy_request_ex> >    _copy_requests;
+            zlock                            _sources_lock;
+            std::unordered_map< ::dsn::rpc_address, source_context*> _sources; // never removed, one per remote server
 
             zlock                            _local_writes_lock;
             std::queue < ::dsn::ref_ptr<copy_request_ex> >    _local_writes;
+            uint64_t                         _write_throttled_since_us; // 0 when not throttled
+            bool                             _write_throttle_timer_pending;
+
+            perf_counter_ _recent_copy_bytes;
+            perf_counter_ _recent_copy_latency;
+            perf_counter_ _recent_transfer_throughput;
+            perf_counter_ _recent_copy_throttled_ms;
+            perf_counter_ _recent_write_throttled_ms;
+            perf_counter_ _recent_delta_saved_bytes;
         };
     }
 }
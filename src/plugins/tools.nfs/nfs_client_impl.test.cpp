@@ -0,0 +1,191 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the copy window and block checksums of nfs client.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "nfs_client_impl.h"
+# include <dsn/utility/synchronize.h>
+# include <gtest/gtest.h>
+# include <fstream>
+
+using namespace dsn;
+using namespace dsn::service;
+
+static nfs_opts copy_window_test_opts()
+{
+    nfs_opts opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.nfs_copy_block_bytes = 4 * 1024 * 1024;
+    opts.nfs_copy_min_block_bytes = 256 * 1024;
+    opts.nfs_copy_target_block_ms = 100;
+    opts.nfs_copy_min_latency_window_ms = 1000;
+    opts.min_concurrent_remote_copy_requests = 2;
+    opts.max_concurrent_remote_copy_requests = 8;
+    return opts;
+}
+
+// one block of 1 MB completed at now_us, taking latency_us
+static void copy_window_complete(copy_window& w, bool ok, uint64_t latency_us, uint64_t now_us)
+{
+    w.on_send();
+    w.on_complete(ok, 1024 * 1024, latency_us, now_us);
+}
+
+TEST(tools_nfs, copy_window_aimd)
+{
+    nfs_opts opts = copy_window_test_opts();
+    copy_window w(opts);
+    uint64_t now = 1000000;
+
+    ASSERT_EQ(2, w.window());
+    ASSERT_EQ(opts.nfs_copy_block_bytes, w.block_bytes());
+    w.on_send();
+    w.on_send();
+    ASSERT_FALSE(w.can_send());
+    w.on_cancel();
+    ASSERT_TRUE(w.can_send());
+    w.on_cancel();
+    ASSERT_EQ(0, w.in_flight());
+
+    // additive increase while the latency stays at the minimum, capped by the max window
+    for (int i = 0; i < 200; i++)
+    {
+        now += 10000;
+        copy_window_complete(w, true, 10000, now);
+    }
+    ASSERT_EQ(opts.max_concurrent_remote_copy_requests, w.window());
+
+    // failures halve the window, at most once per round trip
+    now += 20000;
+    copy_window_complete(w, false, 10000, now);
+    ASSERT_EQ(4, w.window());
+    copy_window_complete(w, false, 10000, now + 5000);
+    ASSERT_EQ(4, w.window());
+    now += 20000;
+    copy_window_complete(w, false, 10000, now);
+    ASSERT_EQ(2, w.window());
+    now += 20000;
+    copy_window_complete(w, false, 10000, now);
+    ASSERT_EQ(opts.min_concurrent_remote_copy_requests, w.window());
+
+    // queueing delay (more than twice the minimum latency) shrinks the window by 1/4
+    for (int i = 0; i < 100; i++)
+    {
+        now += 10000;
+        copy_window_complete(w, true, 10000, now);
+    }
+    ASSERT_EQ(opts.max_concurrent_remote_copy_requests, w.window());
+    now += 50000;
+    copy_window_complete(w, true, 30000, now);
+    ASSERT_EQ(6, w.window());
+
+    // small blocks are not latency samples
+    w.on_send();
+    w.on_complete(true, 1024, 1000000, now + 10);
+    ASSERT_EQ(6, w.window());
+}
+
+TEST(tools_nfs, copy_window_min_latency_expires)
+{
+    nfs_opts opts = copy_window_test_opts();
+    copy_window w(opts);
+    uint64_t now = 1000000;
+
+    // a single fast sample, then the link (or the server) gets slower for good
+    copy_window_complete(w, true, 1000, now);
+    for (int i = 0; i < 50; i++)
+    {
+        now += 10000;
+        copy_window_complete(w, true, 10000, now);
+    }
+    ASSERT_EQ(opts.min_concurrent_remote_copy_requests, w.window());
+
+    // the fast sample expires after nfs_copy_min_latency_window_ms, so the window grows again
+    for (int i = 0; i < 200; i++)
+    {
+        now += 10000;
+        copy_window_complete(w, true, 10000, now);
+    }
+    ASSERT_EQ(opts.max_concurrent_remote_copy_requests, w.window());
+}
+
+TEST(tools_nfs, compute_block_checksums)
+{
+    if (task::get_current_worker() == nullptr)
+        return;
+
+    // 10.5 blocks, read in chunks of 3 blocks (chunk_bytes is rounded down to whole blocks)
+    const uint32_t block_size = 4096;
+    const uint64_t size = block_size * 10 + block_size / 2;
+    std::string path = "nfs_test_block_checksums.dat";
+    std::unique_ptr<char[]> data(new char[size]);
+    for (uint64_t i = 0; i < size; i++)
+        data[i] = (char)(i * 7 + i / block_size);
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        os.write(data.get(), size);
+    }
+
+    utils::notify_event done;
+    error_code err;
+    std::vector<int64_t> checksums;
+    compute_block_checksums(path, size, block_size, block_size * 3 + 100, nullptr,
+        [&](error_code ec, std::vector<int64_t>&& cs)
+        {
+            err = ec;
+            checksums = std::move(cs);
+            done.notify();
+        }
+        );
+    done.wait();
+
+    ASSERT_EQ(ERR_OK, err);
+    ASSERT_EQ(11u, checksums.size());
+    for (size_t i = 0; i < checksums.size(); i++)
+    {
+        uint32_t sz = (uint32_t)std::min((uint64_t)block_size, size - i * block_size);
+        ASSERT_EQ((int64_t)dsn_crc64_compute(data.get() + i * block_size, sz, 0), checksums[i]);
+    }
+
+    // a missing file fails without reading
+    compute_block_checksums(path + ".none", size, block_size, block_size, nullptr,
+        [&](error_code ec, std::vector<int64_t>&& cs)
+        {
+            err = ec;
+            done.notify();
+        }
+        );
+    done.wait();
+    ASSERT_EQ(ERR_FILE_OPERATION_FAILED, err);
+
+    utils::filesystem::remove_path(path);
+}
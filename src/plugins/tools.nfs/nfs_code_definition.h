@@ -44,6 +44,7 @@ namespace dsn { namespace service {
     // define RPC task code for service 'nfs'
     DEFINE_TASK_CODE_RPC(RPC_NFS_COPY, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     DEFINE_TASK_CODE_RPC(RPC_NFS_GET_FILE_SIZE, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_RPC(RPC_NFS_GET_BLOCK_DIFF, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     // test timer task code
     DEFINE_TASK_CODE(LPC_NFS_REQUEST_TIMER, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
 
@@ -53,4 +54,8 @@ namespace dsn { namespace service {
     DEFINE_TASK_CODE_AIO(LPC_NFS_WRITE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
 
     DEFINE_TASK_CODE_AIO(LPC_NFS_COPY_FILE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+    DEFINE_TASK_CODE(LPC_NFS_THROTTLE_DELAY, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+    DEFINE_TASK_CODE_AIO(LPC_NFS_BLOCK_CHECKSUM, TASK_PRIORITY_LOW, THREAD_POOL_DEFAULT)
 } } 
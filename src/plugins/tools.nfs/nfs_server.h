@@ -60,18 +60,27 @@ protected:
         get_file_size_response resp;
         reply(resp);
     }
+    // RPC_NFS_NFS_GET_BLOCK_DIFF 
+    virtual void on_get_block_diff(const get_block_diff_request& request, ::dsn::rpc_replier<get_block_diff_response>& reply)
+    {
+        std::cout << "... exec RPC_NFS_NFS_GET_BLOCK_DIFF ... (not implemented) " << std::endl;
+        get_block_diff_response resp;
+        reply(resp);
+    }
     
 public:
     void open_service()
     {
         this->register_async_rpc_handler(RPC_NFS_COPY, "copy", &nfs_service::on_copy);
         this->register_async_rpc_handler(RPC_NFS_GET_FILE_SIZE, "get_file_size", &nfs_service::on_get_file_size);
+        this->register_async_rpc_handler(RPC_NFS_GET_BLOCK_DIFF, "get_block_diff", &nfs_service::on_get_block_diff);
     }
 
     void close_service()
     {
         this->unregister_rpc_handler(RPC_NFS_COPY);
         this->unregister_rpc_handler(RPC_NFS_GET_FILE_SIZE);
+        this->unregister_rpc_handler(RPC_NFS_GET_BLOCK_DIFF);
     }
 };
 
@@ -39,45 +39,263 @@
 namespace dsn {
     namespace service {
 
-        void nfs_service_impl::on_copy(const ::dsn::service::copy_request& request, ::dsn::rpc_replier< ::dsn::service::copy_response>& reply)
+        copy_block_pool::copy_block_pool(uint32_t block_bytes, int capacity)
+            : _state(std::make_shared<pool_state>())
         {
-            //dinfo(">>> on call RPC_COPY end, exec RPC_NFS_COPY");
+            _state->block_bytes = block_bytes;
+            _state->capacity = capacity;
+        }
 
-            std::string file_path = dsn::utils::filesystem::path_combine(request.source_dir, request.file_name);
-            dsn_handle_t hfile;
+        blob copy_block_pool::acquire(uint32_t size)
+        {
+            if (size > _state->block_bytes)
+            {
+                return blob(dsn::make_shared_array<char>(size), size);
+            }
 
+            char* block = nullptr;
             {
-                zauto_lock l(_handles_map_lock);
-                auto it = _handles_map.find(file_path); // find file handle cache first
+                zauto_lock l(_state->lock);
+                if (!_state->free_blocks.empty())
+                {
+                    block = _state->free_blocks.back();
+                    _state->free_blocks.pop_back();
+                }
+            }
+
+            if (block == nullptr)
+            {
+                block = new char[_state->block_bytes];
+            }
+
+            auto state = _state;
+            std::shared_ptr<char> buffer(block, [state](char* b) { state->release(b); });
+            return blob(std::move(buffer), size);
+        }
+
+        int copy_block_pool::idle_count() const
+        {
+            zauto_lock l(_state->lock);
+            return static_cast<int>(_state->free_blocks.size());
+        }
 
-                if (it == _handles_map.end()) // not found
+        void copy_block_pool::pool_state::release(char* block)
+        {
+            {
+                zauto_lock l(lock);
+                if ((int)free_blocks.size() < capacity)
                 {
-                    hfile = dsn_file_open(file_path.c_str(), O_RDONLY | O_BINARY, 0);
-                    if (hfile)
-                    {
-                    
-                        file_handle_info_on_server* fh = new file_handle_info_on_server;
-                        fh->file_handle = hfile;
-                        fh->file_access_count = 1;
-                        fh->last_access_time = dsn_now_ms();
-                        _handles_map.insert(std::pair<std::string, file_handle_info_on_server*>(file_path, fh));
-                    }
+                    free_blocks.push_back(block);
+                    return;
+                }
+            }
+            delete[] block;
+        }
+
+        copy_block_pool::pool_state::~pool_state()
+        {
+            for (auto b : free_blocks)
+            {
+                delete[] b;
+            }
+            free_blocks.clear();
+        }
+
+        file_handle_cache::file_handle_cache(int capacity)
+        {
+            _capacity = std::max(1, capacity);
+            _open_handles = 0;
+
+            _hit_count.init("nfs", "server.file_handle.hit", COUNTER_TYPE_RATE,
+                "nfs server file handle cache hits per second");
+            _miss_count.init("nfs", "server.file_handle.miss", COUNTER_TYPE_RATE,
+                "nfs server file handle cache misses per second");
+            _evict_count.init("nfs", "server.file_handle.evict", COUNTER_TYPE_RATE,
+                "nfs server file handles closed per second");
+            _open_count.init("nfs", "server.file_handle.count", COUNTER_TYPE_NUMBER,
+                "nfs server open file handles");
+        }
+
+        file_handle_cache::~file_handle_cache()
+        {
+            // the service is stopped, close everything
+            for (auto& sd : _shards)
+            {
+                for (auto& h : sd.handles)
+                {
+                    auto err = dsn_file_close(h.second->file);
+                    dassert(err == ERR_OK, "dsn_file_close failed, err = %s", dsn_error_to_string(err));
+                    delete h.second;
+                }
+                sd.handles.clear();
+                sd.idle_lru.clear();
+            }
+        }
+
+        file_handle_cache::handle* file_handle_cache::acquire(const std::string& path)
+        {
+            auto& sd = _shards[std::hash<std::string>()(path) % SHARD_COUNT];
+            {
+                zauto_lock l(sd.lock);
+                auto it = sd.handles.find(path);
+                if (it != sd.handles.end())
+                {
+                    auto h = it->second;
+                    if (h->ref++ == 0)
+                        sd.idle_lru.erase(h->lru_pos);
+                    h->last_access_ms = dsn_now_ms();
+                    _hit_count.increment();
+                    return h;
+                }
+            }
+
+            // open outside the lock, a concurrent miss on the same path is resolved below
+            _miss_count.increment();
+            dsn_handle_t hfile = dsn_file_open(path.c_str(), O_RDONLY | O_BINARY, 0);
+            if (!hfile)
+                return nullptr;
+
+            handle* h = nullptr;
+            std::vector<handle*> victims;
+            {
+                zauto_lock l(sd.lock);
+                auto it = sd.handles.find(path);
+                if (it != sd.handles.end())
+                {
+                    h = it->second;
+                    if (h->ref++ == 0)
+                        sd.idle_lru.erase(h->lru_pos);
+                    h->last_access_ms = dsn_now_ms();
                 }
-                else // found
+                else
                 {
-                    hfile = it->second->file_handle;
-                    it->second->file_access_count++;
-                    it->second->last_access_time = dsn_now_ms();
+                    auto nh = new handle();
+                    nh->path = path;
+                    nh->file = hfile;
+                    nh->owner = &sd;
+                    nh->ref = 1;
+                    nh->last_access_ms = dsn_now_ms();
+                    sd.handles.emplace(path, nh);
+                    _open_count.set(++_open_handles);
+
+                    evict_idle(sd, true, 0, victims);
+                    hfile = nullptr;
+                    h = nh;
                 }
             }
 
+            trim_other_shards(sd, victims);
+
+            if (hfile)
+            {
+                auto err = dsn_file_close(hfile);
+                dassert(err == ERR_OK, "dsn_file_close failed, err = %s", dsn_error_to_string(err));
+            }
+            close_handles(victims);
+            return h;
+        }
+
+        void file_handle_cache::release(handle* h)
+        {
+            auto& sd = *h->owner;
+            std::vector<handle*> victims;
+            {
+                zauto_lock l(sd.lock);
+                if (--h->ref > 0)
+                    return;
+
+                h->last_access_ms = dsn_now_ms();
+                sd.idle_lru.push_front(h);
+                h->lru_pos = sd.idle_lru.begin();
+
+                evict_idle(sd, true, 0, victims);
+            }
+            trim_other_shards(sd, victims);
+            close_handles(victims);
+        }
+
+        void file_handle_cache::close_expired(uint64_t expire_ms)
+        {
+            uint64_t now = dsn_now_ms();
+            uint64_t expire_before = now > expire_ms ? now - expire_ms : 0;
+            std::vector<handle*> victims;
+            for (auto& sd : _shards)
+            {
+                zauto_lock l(sd.lock);
+                evict_idle(sd, false, expire_before, victims);
+            }
+            close_handles(victims);
+        }
+
+        bool file_handle_cache::contains(const std::string& path)
+        {
+            auto& sd = _shards[std::hash<std::string>()(path) % SHARD_COUNT];
+            zauto_lock l(sd.lock);
+            return sd.handles.find(path) != sd.handles.end();
+        }
+
+        void file_handle_cache::evict_idle(shard& sd, bool trim, uint64_t expire_before_ms, /*out*/ std::vector<handle*>& victims)
+        {
+            while (!sd.idle_lru.empty())
+            {
+                auto h = sd.idle_lru.back();
+                if (!(trim && _open_handles.load() > _capacity) && h->last_access_ms >= expire_before_ms)
+                    break;
+
+                sd.idle_lru.pop_back();
+                sd.handles.erase(h->path);
+                --_open_handles;
+                victims.push_back(h);
+            }
+        }
+
+        void file_handle_cache::trim_other_shards(shard& sd, /*out*/ std::vector<handle*>& victims)
+        {
+            // usually nothing to do, as the shard just changed has idle handles to evict
+            for (auto& other : _shards)
+            {
+                if (_open_handles.load() <= _capacity)
+                    break;
+                if (&other == &sd)
+                    continue;
+
+                zauto_lock l(other.lock);
+                evict_idle(other, true, 0, victims);
+            }
+        }
+
+        void file_handle_cache::close_handles(std::vector<handle*>& victims)
+        {
+            if (victims.empty())
+                return;
+
+            for (auto h : victims)
+            {
+                dinfo("nfs: close file handle %s", h->path.c_str());
+                auto err = dsn_file_close(h->file);
+                dassert(err == ERR_OK, "dsn_file_close failed, err = %s", dsn_error_to_string(err));
+                delete h;
+            }
+
+            _evict_count.add(victims.size());
+            _open_count.set(_open_handles.load());
+            victims.clear();
+        }
+
+        void nfs_service_impl::on_copy(const ::dsn::service::copy_request& request, ::dsn::rpc_replier< ::dsn::service::copy_response>& reply)
+        {
+            //dinfo(">>> on call RPC_COPY end, exec RPC_NFS_COPY");
+
+            std::string file_path = dsn::utils::filesystem::path_combine(request.source_dir, request.file_name);
+            auto fh = _handles.acquire(file_path);
+
             dinfo("nfs: copy file %s [%" PRId64 ", %" PRId64 ")",
                 file_path.c_str(),
                 request.offset,
                 request.offset + request.size
                 );
 
-            if (hfile == 0)
+            if (fh == nullptr)
             {
                 derror("file open failed");
                 ::dsn::service::copy_response resp;
@@ -87,16 +305,15 @@ namespace dsn {
             }
 
             callback_para cp(reply);
-            cp.bb = blob(dsn::make_shared_array<char>(_opts.nfs_copy_block_bytes), _opts.nfs_copy_block_bytes);
+            cp.bb = _block_pool.acquire(request.size);
             cp.dst_dir = std::move(request.dst_dir);
-            cp.file_path = std::move(file_path);
-            cp.hfile = hfile;
+            cp.fh = fh;
             cp.offset = request.offset;
             cp.size = request.size;
 
             auto buffer_save = cp.bb.buffer().get();
             file::read(
-                hfile,
+                fh->file,
                 buffer_save,
                 request.size,
                 request.offset,
@@ -111,15 +328,7 @@ namespace dsn {
 
         void nfs_service_impl::internal_read_callback(error_code err, size_t sz, callback_para cp)
         {
-            {
-                zauto_lock l(_handles_map_lock);
-                auto it = _handles_map.find(cp.file_path);
-
-                if (it != _handles_map.end())
-                {
-                    it->second->file_access_count--;
-                }
-            }
+            _handles.release(cp.fh);
 
             ::dsn::service::copy_response resp;
             resp.error = err;
@@ -197,28 +406,82 @@ namespace dsn {
             reply(resp);
         }
 
-        void nfs_service_impl::close_file() // release out-of-date file handle
+        void nfs_service_impl::on_get_block_diff(const get_block_diff_request& request, ::dsn::rpc_replier<get_block_diff_response>& reply)
         {
-            zauto_lock l(_handles_map_lock);
+            std::string file_path = dsn::utils::filesystem::path_combine(request.source_dir, request.file_name);
+            get_block_diff_response resp;
+            int64_t size = 0;
+
+            if (request.block_size < (int32_t)min_delta_copy_block_bytes
+                || request.block_checksums.size() > max_delta_copy_blocks)
+            {
+                derror("invalid block diff request of %s, block_size = %d, block count = %d",
+                    file_path.c_str(), request.block_size, (int)request.block_checksums.size());
+                resp.error = ERR_INVALID_PARAMETERS.get();
+                reply(resp);
+                return;
+            }
 
-            for (auto it = _handles_map.begin(); it != _handles_map.end();)
+            if (!dsn::utils::filesystem::file_size(file_path, size))
             {
-                auto fptr = it->second;
+                derror("get file size of %s failed", file_path.c_str());
+                resp.error = ERR_OBJECT_NOT_FOUND.get();
+                reply(resp);
+                return;
+            }
+
+            if ((uint64_t)size / (uint32_t)request.block_size > max_delta_copy_blocks)
+            {
+                derror("too many blocks in block diff request of %s, size = %" PRId64 ", block_size = %d",
+                    file_path.c_str(), size, request.block_size);
+                resp.error = ERR_INVALID_PARAMETERS.get();
+                resp.file_size = size;
+                reply(resp);
+                return;
+            }
 
-                // not used and expired
-                if (fptr->file_access_count == 0 
-                    && dsn_now_ms() - fptr->last_access_time > (uint64_t)_opts.file_close_expire_time_ms)
+            // checksums are computed with aio reads and the reply is sent on completion,
+            // so that a large file does not hold an rpc handler thread
+            std::vector<int64_t> client_checksums(request.block_checksums);
+            compute_block_checksums(
+                file_path,
+                (uint64_t)size,
+                (uint32_t)request.block_size,
+                _opts.nfs_copy_block_bytes,
+                this,
+                [reply, file_path, size, client_checksums](error_code err, std::vector<int64_t>&& checksums) mutable
                 {
-                    dinfo("nfs: close file handle %s", it->first.c_str());
-                    it = _handles_map.erase(it);
+                    get_block_diff_response resp;
+                    if (err != ERR_OK)
+                    {
+                        derror("compute block checksums of %s failed, err = %s", file_path.c_str(), err.to_string());
+                    }
+                    else
+                    {
+                        // blocks beyond the client copy, or whose content differs
+                        for (size_t i = 0; i < checksums.size(); i++)
+                        {
+                            if (i >= client_checksums.size() || checksums[i] != client_checksums[i])
+                                resp.changed_blocks.push_back((int32_t)i);
+                        }
+
+                        dinfo("nfs: block diff of %s, %d of %d blocks changed",
+                            file_path.c_str(),
+                            (int)resp.changed_blocks.size(),
+                            (int)checksums.size()
+                            );
+                    }
 
-                    ::dsn::error_code err = dsn_file_close(fptr->file_handle);
-                    dassert(err == ERR_OK, "dsn_file_close failed, err = %s", err.to_string());
-                    delete fptr;
+                    resp.error = err.get();
+                    resp.file_size = size;
+                    reply(resp);
                 }
-                else
-                    it++;
-            }
+                );
+        }
+
+        void nfs_service_impl::close_file() // release out-of-date file handle
+        {
+            _handles.close_expired((uint64_t)_opts.file_close_expire_time_ms);
         }
     }
 }
@@ -35,15 +35,122 @@
 # pragma once
 # include "nfs_server.h"
 # include "nfs_client_impl.h"
+# include <list>
 
 namespace dsn {
     namespace service {
+        //
+        // reusable read buffers for copy blocks, so that serving large files
+        // does not malloc (and page-fault) a fresh nfs_copy_block_bytes buffer
+        // for every block; buffers return to the pool when the last blob
+        // referencing them (usually the sent response) is released
+        //
+        class copy_block_pool
+        {
+        public:
+            copy_block_pool(uint32_t block_bytes, int capacity);
+
+            // get a buffer of at least size bytes
+            blob acquire(uint32_t size);
+
+            // idle buffers kept for reuse
+            int idle_count() const;
+
+        private:
+            struct pool_state
+            {
+                zlock              lock;
+                std::vector<char*> free_blocks;
+                uint32_t           block_bytes;
+                int                capacity;
+
+                void release(char* block);
+                ~pool_state();
+            };
+
+            std::shared_ptr<pool_state> _state; // shared with outstanding blocks
+        };
+
+        //
+        // cache of read-only file handles on nfs server, sharded by the hash of
+        // the file path; a handle stays open while referenced by in-flight reads
+        // (ref > 0), and once released it joins the idle LRU list of its shard;
+        // the capacity bounds the open handles of the whole cache rather than of
+        // each shard, so that a skewed path hash does not evict early: when it is
+        // exceeded, idle handles are closed least recently used first from the
+        // shard being changed, then from the other shards; idle handles are also
+        // closed once they stay idle for too long. Handles in use are never
+        // closed, so the cache may exceed its capacity while they are pinned
+        //
+        class file_handle_cache
+        {
+        public:
+            struct shard;
+            struct handle
+            {
+                std::string  path;
+                dsn_handle_t file;
+                shard        *owner;
+                int          ref;
+                uint64_t     last_access_ms;
+                std::list<handle*>::iterator lru_pos; // valid only when ref == 0
+            };
+
+            struct shard
+            {
+                zlock        lock;
+                std::unordered_map<std::string, handle*> handles;
+                std::list<handle*> idle_lru; // most recently released first
+            };
+
+            file_handle_cache(int capacity);
+            ~file_handle_cache();
+
+            // open or reuse the handle of path, nullptr if the file cannot be opened;
+            // a non-null handle must be given back with release()
+            handle* acquire(const std::string& path);
+
+            void release(handle* h);
+
+            // close handles idle for more than expire_ms
+            void close_expired(uint64_t expire_ms);
+
+            // open handles, both in use and idle
+            size_t size() const { return (size_t)_open_handles.load(); }
+
+            bool contains(const std::string& path);
+
+        private:
+            // remove idle handles from the back of the lru list of sd (locked) while the
+            // cache is over capacity (when trim) or they are last accessed before
+            // expire_before_ms, victims are closed after the shard lock is released
+            void evict_idle(shard& sd, bool trim, uint64_t expire_before_ms, /*out*/ std::vector<handle*>& victims);
+
+            // evict idle handles of the other shards than sd while over capacity
+            void trim_other_shards(shard& sd, /*out*/ std::vector<handle*>& victims);
+
+            void close_handles(std::vector<handle*>& victims);
+
+        private:
+            enum { SHARD_COUNT = 16 };
+            shard  _shards[SHARD_COUNT];
+            int64_t _capacity;
+
+            perf_counter_ _hit_count;
+            perf_counter_ _miss_count;
+            perf_counter_ _evict_count;
+            perf_counter_ _open_count;
+            std::atomic<int64_t> _open_handles;
+        };
+
         class nfs_service_impl
             : public ::dsn::service::nfs_service, public ::dsn::serverlet<nfs_service_impl>
         {
         public:
             nfs_service_impl(nfs_opts& opts) :
-                ::dsn::serverlet<nfs_service_impl>("nfs"), _opts(opts)
+                ::dsn::serverlet<nfs_service_impl>("nfs"), _opts(opts),
+                _block_pool(opts.nfs_copy_block_bytes, opts.max_pooled_copy_blocks_on_server),
+                _handles(opts.max_file_handles_on_server)
             {
                 _file_close_timer = ::dsn::tasking::enqueue_timer(
                     LPC_NFS_FILE_CLOSE_TIMER, 
@@ -58,28 +165,20 @@ namespace dsn {
             virtual void on_copy(const copy_request& request, ::dsn::rpc_replier<copy_response>& reply);
             // RPC_NFS_V2_NFS_GET_FILE_SIZE 
             virtual void on_get_file_size(const get_file_size_request& request, ::dsn::rpc_replier<get_file_size_response>& reply);
+            // RPC_NFS_GET_BLOCK_DIFF
+            virtual void on_get_block_diff(const get_block_diff_request& request, ::dsn::rpc_replier<get_block_diff_response>& reply);
 
         private:
             struct callback_para
             {
-                dsn_handle_t hfile;
-                std::string file_path;
+                file_handle_cache::handle *fh;
                 std::string dst_dir;
                 blob bb;
                 uint64_t offset;
                 uint32_t size;
                 rpc_replier<copy_response> replier;
 
-                callback_para(const rpc_replier<copy_response>& r) : hfile(nullptr), offset(0), size(0), replier(r){}
-            };
-
-            struct file_handle_info_on_server
-            {
-                dsn_handle_t file_handle;
-                int32_t file_access_count; // concurrent r/w count
-                uint64_t last_access_time; // last touch time
-
-                file_handle_info_on_server() : file_handle(nullptr), file_access_count(0), last_access_time(0) {}
+                callback_para(const rpc_replier<copy_response>& r) : fh(nullptr), offset(0), size(0), replier(r){}
             };
 
             void internal_read_callback(error_code err, size_t sz, callback_para cp);
@@ -88,9 +187,9 @@ namespace dsn {
 
         private:
             nfs_opts  &_opts;
+            copy_block_pool _block_pool;
 
-            zlock _handles_map_lock;
-            std::unordered_map <std::string, file_handle_info_on_server*> _handles_map; // cache file handles
+            file_handle_cache _handles;
 
             ::dsn::task_ptr _file_close_timer;
         };
@@ -0,0 +1,152 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for the copy block pool and file handle cache of nfs server.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "nfs_server_impl.h"
+# include <gtest/gtest.h>
+# include <fstream>
+# include <thread>
+
+using namespace dsn;
+using namespace dsn::service;
+
+TEST(tools_nfs, copy_block_pool)
+{
+    std::unique_ptr<copy_block_pool> pool(new copy_block_pool(1024, 2));
+    ASSERT_EQ(0, pool->idle_count());
+
+    // buffers return to the pool when the last blob referencing them is released
+    const char* p1;
+    {
+        blob b1 = pool->acquire(100);
+        ASSERT_EQ(100u, b1.length());
+        p1 = b1.data();
+        blob b2 = b1; // e.g., held by the response
+        b1 = blob();
+        ASSERT_EQ(0, pool->idle_count());
+    }
+    ASSERT_EQ(1, pool->idle_count());
+
+    // and are reused by the next acquire
+    {
+        blob b = pool->acquire(1024);
+        ASSERT_EQ(p1, b.data());
+        ASSERT_EQ(0, pool->idle_count());
+    }
+    ASSERT_EQ(1, pool->idle_count());
+
+    // buffers larger than the block size are never pooled
+    {
+        blob b = pool->acquire(1025);
+        ASSERT_EQ(1025u, b.length());
+    }
+    ASSERT_EQ(1, pool->idle_count());
+
+    // at most capacity idle buffers are kept
+    {
+        blob b1 = pool->acquire(1024);
+        blob b2 = pool->acquire(1024);
+        blob b3 = pool->acquire(1024);
+        ASSERT_EQ(0, pool->idle_count());
+    }
+    ASSERT_EQ(2, pool->idle_count());
+
+    // outstanding blocks outlive the pool
+    blob b = pool->acquire(10);
+    pool.reset();
+    memset((void*)b.data(), 0, b.length());
+}
+
+TEST(tools_nfs, file_handle_cache)
+{
+    if (task::get_current_worker() == nullptr)
+        return;
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 6; i++)
+    {
+        paths.push_back("nfs_test_file_handle_" + std::to_string(i) + ".dat");
+        std::ofstream os(paths.back(), std::ios::binary | std::ios::trunc);
+        os << i;
+    }
+
+    file_handle_cache cache(4);
+    ASSERT_EQ(nullptr, cache.acquire("nfs_test_file_handle_none.dat"));
+    ASSERT_EQ(0u, cache.size());
+
+    // the same handle is shared while it is cached
+    auto h0 = cache.acquire(paths[0]);
+    ASSERT_NE(nullptr, h0);
+    ASSERT_EQ(h0, cache.acquire(paths[0]));
+    cache.release(h0);
+    cache.release(h0);
+    ASSERT_EQ(1u, cache.size());
+
+    // handles in use are pinned beyond the capacity
+    std::vector<file_handle_cache::handle*> hs;
+    for (auto& p : paths)
+        hs.push_back(cache.acquire(p));
+    ASSERT_EQ(6u, cache.size());
+    for (auto& p : paths)
+        ASSERT_TRUE(cache.contains(p));
+
+    // the capacity is for the whole cache whatever shards the paths hash to, and the
+    // least recently released handles are closed first
+    for (auto h : hs)
+        cache.release(h);
+    ASSERT_EQ(4u, cache.size());
+    ASSERT_FALSE(cache.contains(paths[0]));
+    ASSERT_FALSE(cache.contains(paths[1]));
+    for (int i = 2; i < 6; i++)
+        ASSERT_TRUE(cache.contains(paths[i]));
+
+    // reopening an evicted file closes an idle one
+    auto h1 = cache.acquire(paths[1]);
+    ASSERT_NE(nullptr, h1);
+    ASSERT_EQ(4u, cache.size());
+    int cached = 0;
+    for (int i = 2; i < 6; i++)
+        cached += cache.contains(paths[i]) ? 1 : 0;
+    ASSERT_EQ(3, cached);
+
+    // idle handles expire, the ones in use do not
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cache.close_expired(20);
+    ASSERT_EQ(1u, cache.size());
+    ASSERT_TRUE(cache.contains(paths[1]));
+    cache.release(h1);
+    ASSERT_EQ(1u, cache.size());
+
+    for (auto& p : paths)
+        utils::filesystem::remove_path(p);
+}
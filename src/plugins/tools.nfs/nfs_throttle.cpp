@@ -0,0 +1,166 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     node-wide token buckets for throttling nfs copy and local write traffic
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+# include "nfs_throttle.h"
+# include "nfs_client_impl.h"
+# include <dsn/tool-api/command.h>
+
+namespace dsn {
+    namespace service {
+
+        void token_bucket::set_rate(uint64_t rate, uint64_t now_us)
+        {
+            ::dsn::utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_lock);
+            _rate = rate;
+            _burst = static_cast<double>(rate) / 10; // 100 ms worth of tokens
+            if (_tokens > _burst)
+                _tokens = _burst;
+            _last_us = now_us;
+        }
+
+        void token_bucket::refill(uint64_t now_us)
+        {
+            if (now_us > _last_us)
+            {
+                _tokens += static_cast<double>(now_us - _last_us) * rate() / 1000000.0;
+                if (_tokens > _burst)
+                    _tokens = _burst;
+                _last_us = now_us;
+            }
+        }
+
+        int token_bucket::wait_ms(uint64_t now_us)
+        {
+            uint64_t r = rate();
+            if (r == 0)
+                return 0;
+
+            refill(now_us);
+            if (_tokens >= 0)
+                return 0;
+            else
+                return static_cast<int>(-_tokens * 1000 / r) + 1;
+        }
+
+        void token_bucket::take(uint64_t n)
+        {
+            if (rate() != 0)
+                _tokens -= static_cast<double>(n);
+        }
+
+        int token_bucket::consume(uint64_t n, uint64_t now_us)
+        {
+            if (rate() == 0)
+                return 0;
+
+            ::dsn::utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l(_lock);
+            int ms = wait_ms(now_us);
+            if (ms == 0)
+                take(n);
+            return ms;
+        }
+
+        /*static*/ int token_bucket::consume(token_bucket& b1, uint64_t n1, token_bucket& b2, uint64_t n2, uint64_t now_us)
+        {
+            if (b1.rate() == 0)
+                return b2.consume(n2, now_us);
+            if (b2.rate() == 0)
+                return b1.consume(n1, now_us);
+
+            ::dsn::utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l1(b1._lock);
+            ::dsn::utils::auto_lock< ::dsn::utils::ex_lock_nr_spin> l2(b2._lock);
+            int ms = std::max(b1.wait_ms(now_us), b2.wait_ms(now_us));
+            if (ms == 0)
+            {
+                b1.take(n1);
+                b2.take(n2);
+            }
+            return ms;
+        }
+
+        //------------------------------------------------------------------------
+
+        nfs_throttle::nfs_throttle()
+        {
+            ::dsn::register_command(
+                "nfs.throttle",
+                "nfs.throttle - get or set node-wide nfs throttling limits",
+                "nfs.throttle [copy_rate_mb|write_rate_mb|write_iops value], 0 for unlimited",
+                [this](const safe_vector<safe_string>& args) { return on_command(args); }
+                );
+        }
+
+        void nfs_throttle::configure(const nfs_opts& opts)
+        {
+            std::call_once(_configured, [this, &opts]()
+            {
+                _copy_bytes.set_rate(opts.max_copy_rate_megabytes * 1024 * 1024);
+                _write_bytes.set_rate(opts.max_write_rate_megabytes * 1024 * 1024);
+                _write_ops.set_rate(opts.max_write_iops);
+            });
+        }
+
+        int nfs_throttle::consume_write(uint64_t bytes)
+        {
+            return token_bucket::consume(_write_bytes, bytes, _write_ops, 1, dsn_now_us());
+        }
+
+        safe_string nfs_throttle::on_command(const safe_vector<safe_string>& args)
+        {
+            if (args.size() == 2)
+            {
+                uint64_t v = strtoull(args[1].c_str(), nullptr, 10);
+                if (args[0] == "copy_rate_mb")
+                    _copy_bytes.set_rate(v * 1024 * 1024);
+                else if (args[0] == "write_rate_mb")
+                    _write_bytes.set_rate(v * 1024 * 1024);
+                else if (args[0] == "write_iops")
+                    _write_ops.set_rate(v);
+                else
+                    return "invalid arguments";
+            }
+            else if (args.size() != 0)
+            {
+                return "invalid arguments";
+            }
+
+            safe_sstream ss;
+            ss << "copy_rate_mb = " << _copy_bytes.rate() / 1024 / 1024
+                << ", write_rate_mb = " << _write_bytes.rate() / 1024 / 1024
+                << ", write_iops = " << _write_ops.rate()
+                << " (0 for unlimited)";
+            return ss.str();
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     node-wide token buckets for throttling nfs copy and local write traffic
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+# pragma once
+
+# include <dsn/service_api_cpp.h>
+# include <dsn/utility/singleton.h>
+# include <dsn/utility/synchronize.h>
+# include <atomic>
+# include <mutex>
+
+namespace dsn {
+    namespace service {
+
+        struct nfs_opts;
+
+        //
+        // token bucket allowing debt, so that a request larger than the burst
+        // size is still admitted once the bucket is non-negative, and later
+        // requests pay for it by waiting
+        //
+        class token_bucket
+        {
+        public:
+            token_bucket() : _rate(0), _burst(0), _tokens(0), _last_us(0) {}
+
+            // tokens per second, 0 for unlimited
+            void set_rate(uint64_t rate) { set_rate(rate, dsn_now_us()); }
+
+            void set_rate(uint64_t rate, uint64_t now_us);
+
+            uint64_t rate() const { return _rate.load(std::memory_order_relaxed); }
+
+            // take n tokens and return 0 when the bucket is non-negative now,
+            // otherwise take nothing and return milliseconds to wait
+            int consume(uint64_t n) { return consume(n, dsn_now_us()); }
+
+            int consume(uint64_t n, uint64_t now_us);
+
+            // take n1 tokens from b1 and n2 tokens from b2 when both are non-negative now,
+            // otherwise take nothing and return milliseconds to wait; the buckets are locked
+            // together so all the callers must pass them in the same order
+            static int consume(token_bucket& b1, uint64_t n1, token_bucket& b2, uint64_t n2, uint64_t now_us);
+
+        private:
+            void refill(uint64_t now_us);
+
+            // called with _lock held
+            int wait_ms(uint64_t now_us);
+            void take(uint64_t n);
+
+        private:
+            ::dsn::utils::ex_lock_nr_spin _lock;
+            std::atomic<uint64_t> _rate;
+            double   _burst;
+            double   _tokens;
+            uint64_t _last_us;
+        };
+
+        class nfs_throttle : public ::dsn::utils::singleton<nfs_throttle>
+        {
+        public:
+            nfs_throttle();
+
+            // apply the configured limits once per process, as the nfs clients of all
+            // the nodes share them and later changes are made by the nfs.throttle command
+            void configure(const nfs_opts& opts);
+
+            token_bucket& copy_bytes() { return _copy_bytes; }
+
+            // bytes and operation count of a local write, 0 when both are available now,
+            // otherwise milliseconds to wait before retry
+            int consume_write(uint64_t bytes);
+
+        private:
+            safe_string on_command(const safe_vector<safe_string>& args);
+
+        private:
+            std::once_flag _configured;
+            token_bucket _copy_bytes;
+            token_bucket _write_bytes;
+            token_bucket _write_ops;
+        };
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for nfs throttling.
+ *
+ * Revision history:
+ *     Oct., 2026, first version
+ */
+
+# include "nfs_throttle.h"
+# include "nfs_client_impl.h"
+# include <gtest/gtest.h>
+
+using namespace dsn;
+using namespace dsn::service;
+
+TEST(tools_nfs, token_bucket)
+{
+    token_bucket b;
+    uint64_t now = 1000000;
+
+    // unlimited
+    ASSERT_EQ(0, b.consume(1000000000, now));
+    ASSERT_EQ(0, b.consume(1000000000, now));
+
+    // 1000 tokens per second with 100 tokens burst, starting empty
+    b.set_rate(1000, now);
+    ASSERT_EQ(1000u, b.rate());
+    ASSERT_EQ(0, b.consume(50, now));
+    ASSERT_EQ(51, b.consume(1, now));
+    ASSERT_EQ(51, b.consume(1, now)); // nothing is taken when it must wait
+    ASSERT_EQ(0, b.consume(1, now + 50000));
+    ASSERT_GT(b.consume(1, now + 50000), 0);
+
+    // refilled up to the burst only, and a request larger than the burst is
+    // admitted once the bucket is non-negative, paid by the later ones
+    now += 10000000;
+    ASSERT_EQ(0, b.consume(101, now));
+    ASSERT_GT(b.consume(1, now), 0);
+    now += 10000000;
+    ASSERT_EQ(0, b.consume(500, now));
+    ASSERT_EQ(401, b.consume(1, now));
+    ASSERT_EQ(0, b.consume(1, now + 400000));
+
+    // back to unlimited
+    b.set_rate(0, now);
+    ASSERT_EQ(0, b.consume(1000000, now));
+}
+
+TEST(tools_nfs, token_bucket_consume_both)
+{
+    token_bucket bytes, ops;
+    uint64_t now = 1000000;
+    bytes.set_rate(1000, now);
+    ops.set_rate(10, now);
+
+    ASSERT_EQ(0, token_bucket::consume(bytes, 10, ops, 1, now));
+
+    // bytes are available 20 ms later while ops are not, so neither is taken
+    now += 20000;
+    ASSERT_GT(token_bucket::consume(bytes, 10, ops, 1, now), 0);
+    ASSERT_EQ(0, bytes.consume(10, now));
+    ASSERT_EQ(0, bytes.consume(1, now));
+    ASSERT_GT(bytes.consume(1, now), 0);
+
+    // one unlimited bucket is the same as consuming the other only
+    ops.set_rate(0, now);
+    ASSERT_GT(token_bucket::consume(bytes, 10, ops, 1, now), 0);
+    ASSERT_EQ(0, token_bucket::consume(bytes, 10, ops, 1, now + 100000));
+}
+
+TEST(tools_nfs, nfs_throttle_configure_once)
+{
+    nfs_opts opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.max_copy_rate_megabytes = 10;
+    nfs_throttle::instance().configure(opts);
+    uint64_t rate = nfs_throttle::instance().copy_bytes().rate();
+
+    // e.g., a rate changed by the nfs.throttle command is not overridden by new nfs clients
+    opts.max_copy_rate_megabytes = rate / 1024 / 1024 + 1;
+    nfs_throttle::instance().configure(opts);
+    ASSERT_EQ(rate, nfs_throttle::instance().copy_bytes().rate());
+}
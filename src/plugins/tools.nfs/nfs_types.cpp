@@ -805,4 +805,344 @@ void get_file_size_response::printTo(std::ostream& out) const {
   out << ")";
 }
 
+
+get_block_diff_request::~get_block_diff_request() throw() {
+}
+
+
+void get_block_diff_request::__set_source_dir(const std::string& val) {
+  this->source_dir = val;
+}
+
+void get_block_diff_request::__set_file_name(const std::string& val) {
+  this->file_name = val;
+}
+
+void get_block_diff_request::__set_block_size(const int32_t val) {
+  this->block_size = val;
+}
+
+void get_block_diff_request::__set_block_checksums(const std::vector<int64_t> & val) {
+  this->block_checksums = val;
+}
+
+uint32_t get_block_diff_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->source_dir);
+          this->__isset.source_dir = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->file_name);
+          this->__isset.file_name = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->block_size);
+          this->__isset.block_size = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->block_checksums.clear();
+            uint32_t _size34;
+            ::apache::thrift::protocol::TType _etype37;
+            xfer += iprot->readListBegin(_etype37, _size34);
+            this->block_checksums.resize(_size34);
+            uint32_t _i38;
+            for (_i38 = 0; _i38 < _size34; ++_i38)
+            {
+              xfer += iprot->readI64(this->block_checksums[_i38]);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.block_checksums = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t get_block_diff_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("get_block_diff_request");
+
+  xfer += oprot->writeFieldBegin("source_dir", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeString(this->source_dir);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("file_name", ::apache::thrift::protocol::T_STRING, 2);
+  xfer += oprot->writeString(this->file_name);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("block_size", ::apache::thrift::protocol::T_I32, 3);
+  xfer += oprot->writeI32(this->block_size);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("block_checksums", ::apache::thrift::protocol::T_LIST, 4);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_I64, static_cast<uint32_t>(this->block_checksums.size()));
+    std::vector<int64_t> ::const_iterator _iter39;
+    for (_iter39 = this->block_checksums.begin(); _iter39 != this->block_checksums.end(); ++_iter39)
+    {
+      xfer += oprot->writeI64((*_iter39));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(get_block_diff_request &a, get_block_diff_request &b) {
+  using ::std::swap;
+  swap(a.source_dir, b.source_dir);
+  swap(a.file_name, b.file_name);
+  swap(a.block_size, b.block_size);
+  swap(a.block_checksums, b.block_checksums);
+  swap(a.__isset, b.__isset);
+}
+
+get_block_diff_request::get_block_diff_request(const get_block_diff_request& other40) {
+  source_dir = other40.source_dir;
+  file_name = other40.file_name;
+  block_size = other40.block_size;
+  block_checksums = other40.block_checksums;
+  __isset = other40.__isset;
+}
+get_block_diff_request::get_block_diff_request( get_block_diff_request&& other41) {
+  source_dir = std::move(other41.source_dir);
+  file_name = std::move(other41.file_name);
+  block_size = std::move(other41.block_size);
+  block_checksums = std::move(other41.block_checksums);
+  __isset = std::move(other41.__isset);
+}
+get_block_diff_request& get_block_diff_request::operator=(const get_block_diff_request& other42) {
+  source_dir = other42.source_dir;
+  file_name = other42.file_name;
+  block_size = other42.block_size;
+  block_checksums = other42.block_checksums;
+  __isset = other42.__isset;
+  return *this;
+}
+get_block_diff_request& get_block_diff_request::operator=(get_block_diff_request&& other43) {
+  source_dir = std::move(other43.source_dir);
+  file_name = std::move(other43.file_name);
+  block_size = std::move(other43.block_size);
+  block_checksums = std::move(other43.block_checksums);
+  __isset = std::move(other43.__isset);
+  return *this;
+}
+void get_block_diff_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "get_block_diff_request(";
+  out << "source_dir=" << to_string(source_dir);
+  out << ", " << "file_name=" << to_string(file_name);
+  out << ", " << "block_size=" << to_string(block_size);
+  out << ", " << "block_checksums=" << to_string(block_checksums);
+  out << ")";
+}
+
+
+get_block_diff_response::~get_block_diff_response() throw() {
+}
+
+
+void get_block_diff_response::__set_error(const int32_t val) {
+  this->error = val;
+}
+
+void get_block_diff_response::__set_file_size(const int64_t val) {
+  this->file_size = val;
+}
+
+void get_block_diff_response::__set_changed_blocks(const std::vector<int32_t> & val) {
+  this->changed_blocks = val;
+}
+
+uint32_t get_block_diff_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->error);
+          this->__isset.error = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->file_size);
+          this->__isset.file_size = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->changed_blocks.clear();
+            uint32_t _size44;
+            ::apache::thrift::protocol::TType _etype47;
+            xfer += iprot->readListBegin(_etype47, _size44);
+            this->changed_blocks.resize(_size44);
+            uint32_t _i48;
+            for (_i48 = 0; _i48 < _size44; ++_i48)
+            {
+              xfer += iprot->readI32(this->changed_blocks[_i48]);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.changed_blocks = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t get_block_diff_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("get_block_diff_response");
+
+  xfer += oprot->writeFieldBegin("error", ::apache::thrift::protocol::T_I32, 1);
+  xfer += oprot->writeI32(this->error);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("file_size", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->file_size);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("changed_blocks", ::apache::thrift::protocol::T_LIST, 3);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_I32, static_cast<uint32_t>(this->changed_blocks.size()));
+    std::vector<int32_t> ::const_iterator _iter49;
+    for (_iter49 = this->changed_blocks.begin(); _iter49 != this->changed_blocks.end(); ++_iter49)
+    {
+      xfer += oprot->writeI32((*_iter49));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(get_block_diff_response &a, get_block_diff_response &b) {
+  using ::std::swap;
+  swap(a.error, b.error);
+  swap(a.file_size, b.file_size);
+  swap(a.changed_blocks, b.changed_blocks);
+  swap(a.__isset, b.__isset);
+}
+
+get_block_diff_response::get_block_diff_response(const get_block_diff_response& other50) {
+  error = other50.error;
+  file_size = other50.file_size;
+  changed_blocks = other50.changed_blocks;
+  __isset = other50.__isset;
+}
+get_block_diff_response::get_block_diff_response( get_block_diff_response&& other51) {
+  error = std::move(other51.error);
+  file_size = std::move(other51.file_size);
+  changed_blocks = std::move(other51.changed_blocks);
+  __isset = std::move(other51.__isset);
+}
+get_block_diff_response& get_block_diff_response::operator=(const get_block_diff_response& other52) {
+  error = other52.error;
+  file_size = other52.file_size;
+  changed_blocks = other52.changed_blocks;
+  __isset = other52.__isset;
+  return *this;
+}
+get_block_diff_response& get_block_diff_response::operator=(get_block_diff_response&& other53) {
+  error = std::move(other53.error);
+  file_size = std::move(other53.file_size);
+  changed_blocks = std::move(other53.changed_blocks);
+  __isset = std::move(other53.__isset);
+  return *this;
+}
+void get_block_diff_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "get_block_diff_response(";
+  out << "error=" << to_string(error);
+  out << ", " << "file_size=" << to_string(file_size);
+  out << ", " << "changed_blocks=" << to_string(changed_blocks);
+  out << ")";
+}
+
 }} // namespace
@@ -28,6 +28,10 @@ class get_file_size_request;
 
 class get_file_size_response;
 
+class get_block_diff_request;
+
+class get_block_diff_response;
+
 typedef struct _copy_request__isset {
   _copy_request__isset() : source(false), source_dir(false), dst_dir(false), file_name(false), offset(false), size(false), is_last(false), overwrite(false) {}
   bool source :1;
@@ -316,6 +320,132 @@ inline std::ostream& operator<<(std::ostream& out, const get_file_size_response&
   return out;
 }
 
+typedef struct _get_block_diff_request__isset {
+  _get_block_diff_request__isset() : source_dir(false), file_name(false), block_size(false), block_checksums(false) {}
+  bool source_dir :1;
+  bool file_name :1;
+  bool block_size :1;
+  bool block_checksums :1;
+} _get_block_diff_request__isset;
+
+class get_block_diff_request {
+ public:
+
+  get_block_diff_request(const get_block_diff_request&);
+  get_block_diff_request(get_block_diff_request&&);
+  get_block_diff_request& operator=(const get_block_diff_request&);
+  get_block_diff_request& operator=(get_block_diff_request&&);
+  get_block_diff_request() : source_dir(), file_name(), block_size(0) {
+  }
+
+  virtual ~get_block_diff_request() throw();
+  std::string source_dir;
+  std::string file_name;
+  int32_t block_size;
+  std::vector<int64_t>  block_checksums;
+
+  _get_block_diff_request__isset __isset;
+
+  void __set_source_dir(const std::string& val);
+
+  void __set_file_name(const std::string& val);
+
+  void __set_block_size(const int32_t val);
+
+  void __set_block_checksums(const std::vector<int64_t> & val);
+
+  bool operator == (const get_block_diff_request & rhs) const
+  {
+    if (!(source_dir == rhs.source_dir))
+      return false;
+    if (!(file_name == rhs.file_name))
+      return false;
+    if (!(block_size == rhs.block_size))
+      return false;
+    if (!(block_checksums == rhs.block_checksums))
+      return false;
+    return true;
+  }
+  bool operator != (const get_block_diff_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const get_block_diff_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(get_block_diff_request &a, get_block_diff_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const get_block_diff_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _get_block_diff_response__isset {
+  _get_block_diff_response__isset() : error(false), file_size(false), changed_blocks(false) {}
+  bool error :1;
+  bool file_size :1;
+  bool changed_blocks :1;
+} _get_block_diff_response__isset;
+
+class get_block_diff_response {
+ public:
+
+  get_block_diff_response(const get_block_diff_response&);
+  get_block_diff_response(get_block_diff_response&&);
+  get_block_diff_response& operator=(const get_block_diff_response&);
+  get_block_diff_response& operator=(get_block_diff_response&&);
+  get_block_diff_response() : error(0), file_size(0) {
+  }
+
+  virtual ~get_block_diff_response() throw();
+  int32_t error;
+  int64_t file_size;
+  std::vector<int32_t>  changed_blocks;
+
+  _get_block_diff_response__isset __isset;
+
+  void __set_error(const int32_t val);
+
+  void __set_file_size(const int64_t val);
+
+  void __set_changed_blocks(const std::vector<int32_t> & val);
+
+  bool operator == (const get_block_diff_response & rhs) const
+  {
+    if (!(error == rhs.error))
+      return false;
+    if (!(file_size == rhs.file_size))
+      return false;
+    if (!(changed_blocks == rhs.changed_blocks))
+      return false;
+    return true;
+  }
+  bool operator != (const get_block_diff_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const get_block_diff_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(get_block_diff_response &a, get_block_diff_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const get_block_diff_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 }} // namespace
 
 #endif